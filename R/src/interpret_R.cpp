@@ -338,7 +338,7 @@ SEXP Discretize_R(SEXP featureVals, SEXP cutsLowerBoundInclusive, SEXP binIndexe
          reinterpret_cast<IntEbm *>(R_alloc(static_cast<size_t>(cSamples), static_cast<int>(sizeof(IntEbm))));
       EBM_ASSERT(nullptr != aiBins); // this can't be nullptr since R_alloc uses R error handling
 
-      const ErrorEbm err = Discretize(cSamples, aFeatureVals, cCuts, aCutsLowerBoundInclusive, aiBins);
+      const ErrorEbm err = Discretize(cSamples, aFeatureVals, cCuts, aCutsLowerBoundInclusive, nullptr, aiBins);
       if(Error_None != err) {
          error("Discretize returned error code: %" ErrorEbmPrintf, err);
       }
@@ -749,6 +749,7 @@ SEXP CreateBooster_R(
       CreateBoosterFlags_Default,
       "log_loss",
       nullptr,
+      nullptr,
       &boosterHandle
    );
    if(Error_None != err || nullptr == boosterHandle) {
@@ -1038,6 +1039,7 @@ SEXP CreateInteractionDetector_R(SEXP dataSetWrapped, SEXP bag, SEXP initScores)
       CreateInteractionFlags_Default,
       "log_loss",
       nullptr,
+      nullptr,
       &interactionHandle
    );
    if(Error_None != err || nullptr == interactionHandle) {
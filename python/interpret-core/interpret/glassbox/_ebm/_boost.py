@@ -47,6 +47,38 @@ def boost(
             objective,
             experimental_params,
         ) as booster:
+            if not noise_scale:
+                # without differential privacy noise the whole schedule runs inside
+                # the native library, which avoids a python round trip per term update
+                _log.info("Start boosting")
+                n_rounds, metrics = booster.boost_rounds(
+                    rng,
+                    max_rounds,
+                    term_boost_flags,
+                    learning_rate,
+                    min_samples_leaf,
+                    max_leaves,
+                    greediness,
+                    smoothing_rounds,
+                    early_stopping_rounds,
+                    early_stopping_tolerance,
+                )
+                episode_index = max(n_rounds - 1, 0)
+                min_metric = metrics[-1] if 0 < n_rounds else np.inf
+
+                _log.info(
+                    "End boosting, Best Metric: {0}, Num Rounds: {1}".format(
+                        min_metric, episode_index
+                    )
+                )
+
+                if early_stopping_rounds > 0:
+                    model_update = booster.get_best_model()
+                else:
+                    model_update = booster.get_current_model()
+
+                return None, model_update, episode_index, rng
+
             # the first round is alwasy cyclic since we need to get the initial gains
             greedy_portion = 0.0
 
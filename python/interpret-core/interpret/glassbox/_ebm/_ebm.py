@@ -78,7 +78,7 @@ from sklearn.base import (
     ClassifierMixin,
     RegressorMixin,
 )  # type: ignore
-from itertools import combinations, groupby
+from itertools import groupby
 
 import logging
 
@@ -991,13 +991,13 @@ class EBMModel(BaseEstimator):
 
                     parallel_args = []
                     for idx in range(self.outer_bags):
-                        # TODO: the combinations below should be selected from the non-excluded features
+                        # all pairs other than the excluded ones are ranked natively
                         parallel_args.append(
                             (
                                 dataset,
                                 internal_bags[idx],
                                 scores_bags[idx],
-                                combinations(range(n_features_in), 2),
+                                None,
                                 exclude,
                                 Native.CalcInteractionFlags_Default,
                                 max_cardinality,
@@ -1007,6 +1007,8 @@ class EBMModel(BaseEstimator):
                                 else Native.CreateInteractionFlags_Default,
                                 objective,
                                 None,
+                                0,
+                                n_features_in,
                             )
                         )
 
@@ -60,8 +60,11 @@ def bin_native(
             n_bins = 2 if len(feature_bins) == 0 else (max(feature_bins.values()) + 2)
         else:
             # continuous feature
-            X_col = native.discretize(X_col, feature_bins)
             n_bins = len(feature_bins) + 3
+            # narrow bin indexes take less memory to write here and to read back when packing
+            X_col = native.discretize(
+                X_col, feature_bins, np.uint8 if n_bins <= 256 else np.int64
+            )
 
         if bad is not None:
             X_col[bad != _none_ndarray] = n_bins - 1
@@ -104,8 +107,11 @@ def bin_native(
             n_bins = 2 if len(feature_bins) == 0 else (max(feature_bins.values()) + 2)
         else:
             # continuous feature
-            X_col = native.discretize(X_col, feature_bins)
             n_bins = len(feature_bins) + 3
+            # narrow bin indexes take less memory to write here and to read back when packing
+            X_col = native.discretize(
+                X_col, feature_bins, np.uint8 if n_bins <= 256 else np.int64
+            )
 
         if bad is not None:
             X_col[bad != _none_ndarray] = n_bins - 1
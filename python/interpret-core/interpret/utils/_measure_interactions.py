@@ -13,7 +13,6 @@ import logging
 
 from itertools import count
 import numpy as np
-from itertools import combinations
 
 from sklearn.utils.multiclass import type_of_target
 from sklearn.base import is_classifier, is_regressor
@@ -237,10 +236,10 @@ def measure_interactions(
 
     if isinstance(interactions, int):
         n_output_interactions = interactions
-        iter_term_features = combinations(range(n_features_in), 2)
+        iter_term_features = None
     elif interactions is None:
         n_output_interactions = 0
-        iter_term_features = combinations(range(n_features_in), 2)
+        iter_term_features = None
     else:
         n_output_interactions = 0
         iter_term_features = interactions
@@ -260,6 +259,7 @@ def measure_interactions(
         objective=objective,
         experimental_params=None,
         n_output_interactions=n_output_interactions,
+        n_features=n_features_in,
     )
 
     if isinstance(ranked_interactions, Exception):
@@ -19,6 +19,9 @@ class Native:
     CreateBoosterFlags_Default = 0x00000000
     CreateBoosterFlags_DifferentialPrivacy = 0x00000001
     CreateBoosterFlags_DisableSIMD = 0x00000002
+    CreateBoosterFlags_DoublePrecisionSIMD = 0x00000008
+    CreateBoosterFlags_CompactInnerBags = 0x00000010
+    CreateBoosterFlags_SortByTarget = 0x00000020
 
     # TermBoostFlags
     TermBoostFlags_Default = 0x00000000
@@ -31,11 +34,32 @@ class Native:
     CreateInteractionFlags_Default = 0x00000000
     CreateInteractionFlags_DifferentialPrivacy = 0x00000001
     CreateInteractionFlags_DisableSIMD = 0x00000002
+    CreateInteractionFlags_DoublePrecisionSIMD = 0x00000004
 
     # CalcInteractionFlags
     CalcInteractionFlags_Default = 0x00000000
     CalcInteractionFlags_Pure = 0x00000001
 
+    # AffinityFlags
+    AffinityFlags_Default = 0x00000000
+    AffinityFlags_PinThreads = 0x00000001
+
+    # FeatureFlags
+    FeatureFlags_Default = 0x00000000
+    FeatureFlags_Missing = 0x00000001
+    FeatureFlags_Unknown = 0x00000002
+    FeatureFlags_Nominal = 0x00000004
+
+    # SIMDFlags
+    SIMDFlags_Default = 0x00000000
+    SIMDFlags_DisableLaneHistograms = 0x00000001
+    SIMDFlags_DisableAVX512F = 0x00000002
+    SIMDFlags_DisableAVX2 = 0x00000004
+
+    # MatrixOrder
+    MatrixOrder_C = 0
+    MatrixOrder_Fortran = 1
+
     # TraceLevel
     _Trace_Off = 0
     _Trace_Error = 1
@@ -43,6 +67,13 @@ class Native:
     _Trace_Info = 3
     _Trace_Verbose = 4
 
+    # the Discretize, MeasureFeature and FillFeature variants for each bin index type
+    _bin_index_functions = {
+        np.int64: ("Discretize", "MeasureFeature", "FillFeature"),
+        np.uint8: ("DiscretizeUInt8", "MeasureFeatureUInt8", "FillFeatureUInt8"),
+        np.uint16: ("DiscretizeUInt16", "MeasureFeatureUInt16", "FillFeatureUInt16"),
+    }
+
     _native = None
     # if we supported win32 32-bit functions then this would need to be WINFUNCTYPE
     _LogCallbackType = ct.CFUNCTYPE(None, ct.c_int32, ct.c_char_p)
@@ -90,6 +121,15 @@ class Native:
         # so arr[1:-1] will return a pointer to the 1st element within arr.
         return array.ctypes.data
 
+    @staticmethod
+    def _get_matrix_order(matrix):
+        # numpy exposes a Fortran ordered matrix as a C ordered view of its transpose
+        if matrix.flags.c_contiguous:
+            return Native.MatrixOrder_C, matrix
+        if matrix.flags.f_contiguous:
+            return Native.MatrixOrder_Fortran, matrix.T
+        return Native.MatrixOrder_C, np.ascontiguousarray(matrix)
+
     @staticmethod
     def _get_native_exception(error_code, native_function):  # pragma: no cover
         if error_code == -1:
@@ -102,6 +142,8 @@ class Native:
             return Exception(f"User native parameter value error in {native_function}")
         elif error_code == -5:
             return Exception(f"Thread start failed in {native_function}")
+        elif error_code == -6:
+            return Exception(f"File I/O failed in {native_function}")
         elif error_code == -10:
             return Exception(f"Objective constructor exception in {native_function}")
         elif error_code == -11:
@@ -299,6 +341,79 @@ class Native:
 
         return cuts[: count_cuts.value]
 
+    def cut_quantile_chunks(
+        self, X_col_chunks, min_samples_bin, is_rounded, max_cuts, items_per_level=4096
+    ):
+        # X_col_chunks is any iterable of 1-D float64 arrays, such as a column read from disk in pieces.
+        # Memory stays bounded by items_per_level, and the cuts are identical to cut_quantile as long as
+        # there are at most items_per_level non-missing values in total
+        if max_cuts < 0:
+            raise Exception(f"max_cuts can't be negative: {max_cuts}.")
+
+        sketch = ct.c_void_p(0)
+        return_code = self._unsafe.CreateCutQuantileSketch(
+            items_per_level, ct.byref(sketch)
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "CreateCutQuantileSketch")
+
+        try:
+            for X_col in X_col_chunks:
+                X_col = np.ascontiguousarray(X_col, dtype=np.float64)
+                return_code = self._unsafe.CutQuantileAccumulate(
+                    sketch,
+                    X_col.shape[0],
+                    Native._make_pointer(X_col, np.float64),
+                )
+                if return_code:  # pragma: no cover
+                    raise Native._get_native_exception(
+                        return_code, "CutQuantileAccumulate"
+                    )
+
+            cuts = np.empty(max_cuts, dtype=np.float64, order="C")
+            count_cuts = ct.c_int64(max_cuts)
+            return_code = self._unsafe.CutQuantileFinish(
+                sketch,
+                min_samples_bin,
+                is_rounded,
+                ct.byref(count_cuts),
+                Native._make_pointer(cuts, np.float64),
+            )
+            if return_code:  # pragma: no cover
+                raise Native._get_native_exception(return_code, "CutQuantileFinish")
+        finally:
+            self._unsafe.FreeCutQuantileSketch(sketch)
+
+        return cuts[: count_cuts.value]
+
+    def cut_quantile_many(self, X, min_samples_bin, is_rounded, max_cuts):
+        # X has one row per sample and one column per feature. The features are cut in parallel by the
+        # native code, and the cuts of each feature are identical to calling cut_quantile on its column
+        if max_cuts < 0:
+            raise Exception(f"max_cuts can't be negative: {max_cuts}.")
+
+        order, matrix = Native._get_matrix_order(X)
+        n_features = X.shape[1]
+        count_cuts = np.full(n_features, max_cuts, dtype=np.int64)
+        cuts = np.empty(n_features * max_cuts, dtype=np.float64, order="C")
+        return_code = self._unsafe.CutQuantileMany(
+            X.shape[0],
+            n_features,
+            Native._make_pointer(matrix, np.float64, 2),
+            order,
+            min_samples_bin,
+            is_rounded,
+            None,
+            Native._make_pointer(count_cuts, np.int64),
+            Native._make_pointer(cuts, np.float64),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "CutQuantileMany")
+
+        return [
+            cuts[i * max_cuts : i * max_cuts + count_cuts[i]] for i in range(n_features)
+        ]
+
     def cut_winsorized(self, X_col, max_cuts):
         if max_cuts < 0:
             raise Exception(f"max_cuts can't be negative: {max_cuts}.")
@@ -348,18 +463,43 @@ class Native:
 
         return low_graph_bound.value, high_graph_bound.value
 
-    def discretize(self, X_col, cuts):
+    def discretize(self, X_col, cuts, dtype=np.int64):
         # TODO: for speed and efficiency, we should instead accept in the bin_indexes array
-        bin_indexes = np.empty(X_col.shape[0], dtype=np.int64, order="C")
-        return_code = self._unsafe.Discretize(
+        # dtype can be np.uint8 or np.uint16 when len(cuts) + 1 fits, which shrinks the bin_indexes
+        native_function = Native._bin_index_functions[dtype][0]
+        bin_indexes = np.empty(X_col.shape[0], dtype=dtype, order="C")
+        return_code = getattr(self._unsafe, native_function)(
             X_col.shape[0],
             Native._make_pointer(X_col, np.float64),
             cuts.shape[0],
             Native._make_pointer(cuts, np.float64),
-            Native._make_pointer(bin_indexes, np.int64),
+            None,
+            Native._make_pointer(bin_indexes, dtype),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, native_function)
+
+        return bin_indexes
+
+    def discretize_matrix(self, X, cuts):
+        # X has one row per sample and one column per feature, and cuts holds one array per feature. The bin
+        # indexes are returned with one row per feature
+        order, matrix = Native._get_matrix_order(X)
+        n_cuts = np.array([len(feature_cuts) for feature_cuts in cuts], np.int64)
+        all_cuts = np.concatenate([np.asarray(c, np.float64) for c in cuts] + [np.empty(0, np.float64)])
+        bin_indexes = np.empty((X.shape[1], X.shape[0]), dtype=np.int64, order="C")
+        return_code = self._unsafe.DiscretizeMatrix(
+            X.shape[0],
+            X.shape[1],
+            Native._make_pointer(matrix, np.float64, 2),
+            order,
+            Native._make_pointer(n_cuts, np.int64),
+            Native._make_pointer(all_cuts, np.float64),
+            None,
+            Native._make_pointer(bin_indexes, np.int64, 2),
         )
         if return_code:  # pragma: no cover
-            raise Native._get_native_exception(return_code, "Discretize")
+            raise Native._get_native_exception(return_code, "DiscretizeMatrix")
 
         return bin_indexes
 
@@ -370,16 +510,33 @@ class Native:
         return n_bytes
 
     def measure_feature(self, n_bins, is_missing, is_unknown, is_nominal, bin_indexes):
-        n_bytes = self._unsafe.MeasureFeature(
+        native_function = Native._bin_index_functions[bin_indexes.dtype.type][1]
+        n_bytes = getattr(self._unsafe, native_function)(
             n_bins,
             is_missing,
             is_unknown,
             is_nominal,
             len(bin_indexes),
-            Native._make_pointer(bin_indexes, np.int64),
+            Native._make_pointer(bin_indexes, bin_indexes.dtype.type),
         )
         if n_bytes < 0:  # pragma: no cover
-            raise Native._get_native_exception(n_bytes, "MeasureFeature")
+            raise Native._get_native_exception(n_bytes, native_function)
+        return n_bytes
+
+    def measure_features(self, bin_counts, flags, bin_indexes):
+        # bin_indexes has one row per sample and one column per feature
+        order, matrix = Native._get_matrix_order(bin_indexes)
+        n_bytes = self._unsafe.MeasureFeatures(
+            len(bin_counts),
+            Native._make_pointer(bin_counts, np.int64),
+            Native._make_pointer(flags, np.int32),
+            bin_indexes.shape[0],
+            Native._make_pointer(matrix, np.int64, 2),
+            order,
+            None,
+        )
+        if n_bytes < 0:  # pragma: no cover
+            raise Native._get_native_exception(n_bytes, "MeasureFeatures")
         return n_bytes
 
     def measure_weight(self, weights):
@@ -424,18 +581,36 @@ class Native:
     def fill_feature(
         self, n_bins, is_missing, is_unknown, is_nominal, bin_indexes, dataset
     ):
-        return_code = self._unsafe.FillFeature(
+        native_function = Native._bin_index_functions[bin_indexes.dtype.type][2]
+        return_code = getattr(self._unsafe, native_function)(
             n_bins,
             is_missing,
             is_unknown,
             is_nominal,
             len(bin_indexes),
-            Native._make_pointer(bin_indexes, np.int64),
+            Native._make_pointer(bin_indexes, bin_indexes.dtype.type),
             dataset.nbytes,
             Native._make_pointer(dataset, np.ubyte),
         )
         if return_code:  # pragma: no cover
-            raise Native._get_native_exception(return_code, "FillFeature")
+            raise Native._get_native_exception(return_code, native_function)
+
+    def fill_features(self, bin_counts, flags, bin_indexes, dataset):
+        # bin_indexes has one row per sample and one column per feature
+        order, matrix = Native._get_matrix_order(bin_indexes)
+        return_code = self._unsafe.FillFeatures(
+            len(bin_counts),
+            Native._make_pointer(bin_counts, np.int64),
+            Native._make_pointer(flags, np.int32),
+            bin_indexes.shape[0],
+            Native._make_pointer(matrix, np.int64, 2),
+            order,
+            None,
+            dataset.nbytes,
+            Native._make_pointer(dataset, np.ubyte),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "FillFeatures")
 
     def fill_weight(self, weights, dataset):
         return_code = self._unsafe.FillWeight(
@@ -695,6 +870,29 @@ class Native:
         ]
         self._unsafe.SetTraceLevel.restype = None
 
+        self._unsafe.SetSIMDFlags.argtypes = [
+            # int32 flags
+            ct.c_int32
+        ]
+        self._unsafe.SetSIMDFlags.restype = None
+        if not simd:
+            # the boosters and interaction detectors also get DisableSIMD, but Discretize has no flags of its own
+            self._unsafe.SetSIMDFlags(
+                Native.SIMDFlags_DisableAVX512F | Native.SIMDFlags_DisableAVX2
+            )
+
+        self._unsafe.GetHeapCounters.argtypes = [
+            # int32_t isResetPeak
+            ct.c_int32,
+            # int64_t * countCallsOut
+            ct.POINTER(ct.c_int64),
+            # int64_t * countBytesOut
+            ct.POINTER(ct.c_int64),
+            # int64_t * countBytesPeakOut
+            ct.POINTER(ct.c_int64),
+        ]
+        self._unsafe.GetHeapCounters.restype = None
+
         self._unsafe.CleanFloats.argtypes = [
             # int64_t count
             ct.c_int64,
@@ -738,6 +936,22 @@ class Native:
         ]
         self._unsafe.GenerateSeed.restype = ct.c_int32
 
+        self._unsafe.CreateThreadPool.argtypes = [
+            # int64_t countThreads
+            ct.c_int64,
+            # AffinityFlags affinityFlags
+            ct.c_int32,
+            # ThreadPoolHandle * threadPoolHandleOut
+            ct.POINTER(ct.c_void_p),
+        ]
+        self._unsafe.CreateThreadPool.restype = ct.c_int32
+
+        self._unsafe.FreeThreadPool.argtypes = [
+            # void * threadPoolHandle
+            ct.c_void_p,
+        ]
+        self._unsafe.FreeThreadPool.restype = None
+
         self._unsafe.GenerateGaussianRandom.argtypes = [
             # void * rng
             ct.c_void_p,
@@ -786,6 +1000,74 @@ class Native:
         ]
         self._unsafe.CutQuantile.restype = ct.c_int32
 
+        self._unsafe.CreateCutQuantileSketch.argtypes = [
+            # int64_t countItemsPerLevel
+            ct.c_int64,
+            # CutQuantileSketchHandle * sketchHandleOut
+            ct.POINTER(ct.c_void_p),
+        ]
+        self._unsafe.CreateCutQuantileSketch.restype = ct.c_int32
+
+        self._unsafe.FreeCutQuantileSketch.argtypes = [
+            # void * sketchHandle
+            ct.c_void_p,
+        ]
+        self._unsafe.FreeCutQuantileSketch.restype = None
+
+        self._unsafe.CutQuantileAccumulate.argtypes = [
+            # void * sketchHandle
+            ct.c_void_p,
+            # int64_t countSamples
+            ct.c_int64,
+            # double * featureVals
+            ct.c_void_p,
+        ]
+        self._unsafe.CutQuantileAccumulate.restype = ct.c_int32
+
+        self._unsafe.CutQuantileMerge.argtypes = [
+            # void * sketchHandle
+            ct.c_void_p,
+            # void * otherSketchHandle
+            ct.c_void_p,
+        ]
+        self._unsafe.CutQuantileMerge.restype = ct.c_int32
+
+        self._unsafe.CutQuantileFinish.argtypes = [
+            # void * sketchHandle
+            ct.c_void_p,
+            # int64_t minSamplesBin
+            ct.c_int64,
+            # int32_t isRounded
+            ct.c_int32,
+            # int64_t * countCutsInOut
+            ct.POINTER(ct.c_int64),
+            # double * cutsLowerBoundInclusiveOut
+            ct.c_void_p,
+        ]
+        self._unsafe.CutQuantileFinish.restype = ct.c_int32
+
+        self._unsafe.CutQuantileMany.argtypes = [
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t countFeatures
+            ct.c_int64,
+            # double * featureVals
+            ct.c_void_p,
+            # int32_t order
+            ct.c_int32,
+            # int64_t minSamplesBin
+            ct.c_int64,
+            # int32_t isRounded
+            ct.c_int32,
+            # ThreadPoolHandle threadPool
+            ct.c_void_p,
+            # int64_t * countCutsInOut
+            ct.c_void_p,
+            # double * cutsLowerBoundInclusiveOut
+            ct.c_void_p,
+        ]
+        self._unsafe.CutQuantileMany.restype = ct.c_int32
+
         self._unsafe.CutWinsorized.argtypes = [
             # int64_t countSamples
             ct.c_int64,
@@ -825,11 +1107,89 @@ class Native:
             ct.c_int64,
             # double * cutsLowerBoundInclusive
             ct.c_void_p,
+            # ThreadPoolHandle threadPool
+            ct.c_void_p,
             # int64_t * binIndexesOut
             ct.c_void_p,
         ]
         self._unsafe.Discretize.restype = ct.c_int32
 
+        self._unsafe.DiscretizeUInt8.argtypes = [
+            # int64_t countSamples
+            ct.c_int64,
+            # double * featureVals
+            ct.c_void_p,
+            # int64_t countCuts
+            ct.c_int64,
+            # double * cutsLowerBoundInclusive
+            ct.c_void_p,
+            # ThreadPoolHandle threadPool
+            ct.c_void_p,
+            # uint8_t * binIndexesOut
+            ct.c_void_p,
+        ]
+        self._unsafe.DiscretizeUInt8.restype = ct.c_int32
+
+        self._unsafe.DiscretizeUInt16.argtypes = [
+            # int64_t countSamples
+            ct.c_int64,
+            # double * featureVals
+            ct.c_void_p,
+            # int64_t countCuts
+            ct.c_int64,
+            # double * cutsLowerBoundInclusive
+            ct.c_void_p,
+            # ThreadPoolHandle threadPool
+            ct.c_void_p,
+            # uint16_t * binIndexesOut
+            ct.c_void_p,
+        ]
+        self._unsafe.DiscretizeUInt16.restype = ct.c_int32
+
+        self._unsafe.DiscretizeMatrix.argtypes = [
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t countFeatures
+            ct.c_int64,
+            # double * featureVals
+            ct.c_void_p,
+            # int32_t order
+            ct.c_int32,
+            # int64_t * countCuts
+            ct.c_void_p,
+            # double * cutsLowerBoundInclusive
+            ct.c_void_p,
+            # ThreadPoolHandle threadPool
+            ct.c_void_p,
+            # int64_t * binIndexesOut
+            ct.c_void_p,
+        ]
+        self._unsafe.DiscretizeMatrix.restype = ct.c_int32
+
+        self._unsafe.CreateCutPlan.argtypes = [
+            # int64_t countCuts
+            ct.c_int64,
+            # double * cutsLowerBoundInclusive
+            ct.c_void_p,
+            # CutPlanHandle * cutPlanHandleOut
+            ct.POINTER(ct.c_void_p),
+        ]
+        self._unsafe.CreateCutPlan.restype = ct.c_int32
+
+        self._unsafe.FreeCutPlan.argtypes = [
+            # void * cutPlanHandle
+            ct.c_void_p,
+        ]
+        self._unsafe.FreeCutPlan.restype = None
+
+        self._unsafe.DiscretizeOne.argtypes = [
+            # void * cutPlanHandle
+            ct.c_void_p,
+            # double featureVal
+            ct.c_double,
+        ]
+        self._unsafe.DiscretizeOne.restype = ct.c_int64
+
         self._unsafe.MeasureDataSetHeader.argtypes = [
             # int64_t countFeatures
             ct.c_int64,
@@ -856,6 +1216,56 @@ class Native:
         ]
         self._unsafe.MeasureFeature.restype = ct.c_int64
 
+        self._unsafe.MeasureFeatureUInt8.argtypes = [
+            # int64_t countBins
+            ct.c_int64,
+            # int32_t isMissing
+            ct.c_int32,
+            # int32_t isUnknown
+            ct.c_int32,
+            # int32_t isNominal
+            ct.c_int32,
+            # int64_t countSamples
+            ct.c_int64,
+            # uint8_t * binIndexes
+            ct.c_void_p,
+        ]
+        self._unsafe.MeasureFeatureUInt8.restype = ct.c_int64
+
+        self._unsafe.MeasureFeatureUInt16.argtypes = [
+            # int64_t countBins
+            ct.c_int64,
+            # int32_t isMissing
+            ct.c_int32,
+            # int32_t isUnknown
+            ct.c_int32,
+            # int32_t isNominal
+            ct.c_int32,
+            # int64_t countSamples
+            ct.c_int64,
+            # uint16_t * binIndexes
+            ct.c_void_p,
+        ]
+        self._unsafe.MeasureFeatureUInt16.restype = ct.c_int64
+
+        self._unsafe.MeasureFeatures.argtypes = [
+            # int64_t countFeatures
+            ct.c_int64,
+            # int64_t * binCounts
+            ct.c_void_p,
+            # int32_t * flags
+            ct.c_void_p,
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t * binIndexesMatrix
+            ct.c_void_p,
+            # int32_t order
+            ct.c_int32,
+            # ThreadPoolHandle threadPool
+            ct.c_void_p,
+        ]
+        self._unsafe.MeasureFeatures.restype = ct.c_int64
+
         self._unsafe.MeasureWeight.argtypes = [
             # int64_t countSamples
             ct.c_int64,
@@ -916,6 +1326,68 @@ class Native:
         ]
         self._unsafe.FillFeature.restype = ct.c_int32
 
+        self._unsafe.FillFeatureUInt8.argtypes = [
+            # int64_t countBins
+            ct.c_int64,
+            # int32_t isMissing
+            ct.c_int32,
+            # int32_t isUnknown
+            ct.c_int32,
+            # int32_t isNominal
+            ct.c_int32,
+            # int64_t countSamples
+            ct.c_int64,
+            # uint8_t * binIndexes
+            ct.c_void_p,
+            # int64_t countBytesAllocated
+            ct.c_int64,
+            # void * fillMem
+            ct.c_void_p,
+        ]
+        self._unsafe.FillFeatureUInt8.restype = ct.c_int32
+
+        self._unsafe.FillFeatureUInt16.argtypes = [
+            # int64_t countBins
+            ct.c_int64,
+            # int32_t isMissing
+            ct.c_int32,
+            # int32_t isUnknown
+            ct.c_int32,
+            # int32_t isNominal
+            ct.c_int32,
+            # int64_t countSamples
+            ct.c_int64,
+            # uint16_t * binIndexes
+            ct.c_void_p,
+            # int64_t countBytesAllocated
+            ct.c_int64,
+            # void * fillMem
+            ct.c_void_p,
+        ]
+        self._unsafe.FillFeatureUInt16.restype = ct.c_int32
+
+        self._unsafe.FillFeatures.argtypes = [
+            # int64_t countFeatures
+            ct.c_int64,
+            # int64_t * binCounts
+            ct.c_void_p,
+            # int32_t * flags
+            ct.c_void_p,
+            # int64_t countSamples
+            ct.c_int64,
+            # int64_t * binIndexesMatrix
+            ct.c_void_p,
+            # int32_t order
+            ct.c_int32,
+            # ThreadPoolHandle threadPool
+            ct.c_void_p,
+            # int64_t countBytesAllocated
+            ct.c_int64,
+            # void * fillMem
+            ct.c_void_p,
+        ]
+        self._unsafe.FillFeatures.restype = ct.c_int32
+
         self._unsafe.FillWeight.argtypes = [
             # int64_t countSamples
             ct.c_int64,
@@ -962,6 +1434,32 @@ class Native:
         ]
         self._unsafe.CheckDataSet.restype = ct.c_int32
 
+        self._unsafe.WriteDataSetFile.argtypes = [
+            # char * path
+            ct.c_char_p,
+            # int64_t countBytesAllocated
+            ct.c_int64,
+            # void * dataSet
+            ct.c_void_p,
+        ]
+        self._unsafe.WriteDataSetFile.restype = ct.c_int32
+
+        self._unsafe.CreateDataSetFromFile.argtypes = [
+            # char * path
+            ct.c_char_p,
+            # void ** dataSetFileHandleOut
+            ct.POINTER(ct.c_void_p),
+            # void ** dataSetOut
+            ct.POINTER(ct.c_void_p),
+        ]
+        self._unsafe.CreateDataSetFromFile.restype = ct.c_int32
+
+        self._unsafe.FreeDataSetFile.argtypes = [
+            # void * dataSetFileHandle
+            ct.c_void_p
+        ]
+        self._unsafe.FreeDataSetFile.restype = None
+
         self._unsafe.ExtractDataSetHeader.argtypes = [
             # void * dataSet
             ct.c_void_p,
@@ -1071,11 +1569,85 @@ class Native:
             ct.c_char_p,
             # double * experimentalParams
             ct.c_void_p,
+            # ThreadPoolHandle threadPool
+            ct.c_void_p,
             # BoosterHandle * boosterHandleOut
             ct.POINTER(ct.c_void_p),
         ]
         self._unsafe.CreateBooster.restype = ct.c_int32
 
+        self._unsafe.MeasureBooster.argtypes = [
+            # void * dataSet
+            ct.c_void_p,
+            # int8_t * bag
+            ct.c_void_p,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+            # int64_t countInnerBags
+            ct.c_int64,
+            # CreateBoosterFlags flags
+            ct.c_int32,
+            # char * objective
+            ct.c_char_p,
+            # double * experimentalParams
+            ct.c_void_p,
+            # ThreadPoolHandle threadPool
+            ct.c_void_p,
+            # int64_t maxBytes
+            ct.c_int64,
+            # CreateBoosterFlags * flagsOut
+            ct.POINTER(ct.c_int32),
+        ]
+        self._unsafe.MeasureBooster.restype = ct.c_int64
+
+        self._unsafe.CreatePreparedDataSet.argtypes = [
+            # void * dataSet
+            ct.c_void_p,
+            # int64_t countTerms
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+            # CreateBoosterFlags flags
+            ct.c_int32,
+            # char * objective
+            ct.c_char_p,
+            # PreparedDataSetHandle * preparedDataSetHandleOut
+            ct.POINTER(ct.c_void_p),
+        ]
+        self._unsafe.CreatePreparedDataSet.restype = ct.c_int32
+
+        self._unsafe.FreePreparedDataSet.argtypes = [
+            # void * preparedDataSetHandle
+            ct.c_void_p
+        ]
+        self._unsafe.FreePreparedDataSet.restype = None
+
+        self._unsafe.CreateBoosterPrepared.argtypes = [
+            # void * rng
+            ct.c_void_p,
+            # void * preparedDataSet
+            ct.c_void_p,
+            # int8_t * bag
+            ct.c_void_p,
+            # double * initScores
+            ct.c_void_p,
+            # int64_t countInnerBags
+            ct.c_int64,
+            # CreateBoosterFlags flags
+            ct.c_int32,
+            # ThreadPoolHandle threadPool
+            ct.c_void_p,
+            # BoosterHandle * boosterHandleOut
+            ct.POINTER(ct.c_void_p),
+        ]
+        self._unsafe.CreateBoosterPrepared.restype = ct.c_int32
+
         self._unsafe.FreeBooster.argtypes = [
             # void * boosterHandle
             ct.c_void_p
@@ -1140,6 +1712,36 @@ class Native:
         ]
         self._unsafe.ApplyTermUpdate.restype = ct.c_int32
 
+        self._unsafe.BoostRounds.argtypes = [
+            # void * rng
+            ct.c_void_p,
+            # void * boosterHandle
+            ct.c_void_p,
+            # int64_t countRounds
+            ct.c_int64,
+            # int32_t flags
+            ct.c_int32,
+            # double learningRate
+            ct.c_double,
+            # int64_t minSamplesLeaf
+            ct.c_int64,
+            # int64_t * leavesMax
+            ct.c_void_p,
+            # double greediness
+            ct.c_double,
+            # int64_t countSmoothingRounds
+            ct.c_int64,
+            # int64_t countEarlyStoppingRounds
+            ct.c_int64,
+            # double earlyStoppingTolerance
+            ct.c_double,
+            # int64_t * countRoundsOut
+            ct.POINTER(ct.c_int64),
+            # double * metricsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.BoostRounds.restype = ct.c_int32
+
         self._unsafe.GetBestTermScores.argtypes = [
             # void * boosterHandle
             ct.c_void_p,
@@ -1173,6 +1775,8 @@ class Native:
             ct.c_char_p,
             # double * experimentalParams
             ct.c_void_p,
+            # ThreadPoolHandle threadPool
+            ct.c_void_p,
             # InteractionHandle * interactionHandleOut
             ct.POINTER(ct.c_void_p),
         ]
@@ -1202,6 +1806,50 @@ class Native:
         ]
         self._unsafe.CalcInteractionStrength.restype = ct.c_int32
 
+        self._unsafe.CalcInteractionStrengths.argtypes = [
+            # void * interactionHandle
+            ct.c_void_p,
+            # int64_t countTuples
+            ct.c_int64,
+            # int64_t * dimensionCounts
+            ct.c_void_p,
+            # int64_t * featureIndexes
+            ct.c_void_p,
+            # CalcInteractionFlags flags
+            ct.c_int32,
+            # int64_t maxCardinality
+            ct.c_int64,
+            # int64_t minSamplesLeaf
+            ct.c_int64,
+            # double * strengthsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.CalcInteractionStrengths.restype = ct.c_int32
+
+        self._unsafe.RankInteractions.argtypes = [
+            # void * interactionHandle
+            ct.c_void_p,
+            # int64_t countExcludedPairs
+            ct.c_int64,
+            # int64_t * excludedPairs
+            ct.c_void_p,
+            # CalcInteractionFlags flags
+            ct.c_int32,
+            # int64_t maxCardinality
+            ct.c_int64,
+            # int64_t minSamplesLeaf
+            ct.c_int64,
+            # int64_t countPairsMax
+            ct.c_int64,
+            # int64_t * countPairsOut
+            ct.POINTER(ct.c_int64),
+            # int64_t * featureIndexesOut
+            ct.c_void_p,
+            # double * strengthsOut
+            ct.c_void_p,
+        ]
+        self._unsafe.RankInteractions.restype = ct.c_int32
+
 
 class Booster(AbstractContextManager):
     """Lightweight wrapper for EBM C boosting code."""
@@ -1328,6 +1976,7 @@ class Booster(AbstractContextManager):
             flags,
             self.objective.encode("ascii"),
             Native._make_pointer(self.experimental_params, np.float64, 1, True),
+            None,
             ct.byref(booster_handle),
         )
         if return_code:  # pragma: no cover
@@ -1429,6 +2078,68 @@ class Booster(AbstractContextManager):
         # _log.debug("Boosting step end")
         return avg_validation_metric.value
 
+    def boost_rounds(
+        self,
+        rng,
+        max_rounds,
+        term_boost_flags,
+        learning_rate,
+        min_samples_leaf,
+        max_leaves,
+        greediness,
+        smoothing_rounds,
+        early_stopping_rounds,
+        early_stopping_tolerance,
+    ):
+        """Runs whole cyclic/greedy boosting rounds inside the native library.
+
+        Args:
+            rng: The native random number generator state, or None.
+            max_rounds: Maximum number of rounds over all terms.
+            term_boost_flags: C interface options
+            learning_rate: Learning rate as a float.
+            min_samples_leaf: Min observations required to split.
+            max_leaves: Max leaf nodes on feature step.
+            greediness: Portion of greedy rounds added after each round.
+            smoothing_rounds: Number of initial rounds with random splits.
+            early_stopping_rounds: Rounds without improvement before stopping, or 0.
+            early_stopping_tolerance: Minimum improvement that resets early stopping.
+
+        Returns:
+            Tuple of the number of rounds run and the best validation metric after each round.
+        """
+
+        self._term_idx = -1
+
+        native = Native.get_native_singleton()
+
+        n_dimensions = max((len(x) for x in self.term_features), default=0)
+        max_leaves_arr = np.full(
+            max(n_dimensions, 1), max_leaves, dtype=ct.c_int64, order="C"
+        )
+        metrics = np.empty(max_rounds, dtype=np.float64, order="C")
+        n_rounds = ct.c_int64(0)
+
+        return_code = native._unsafe.BoostRounds(
+            Native._make_pointer(rng, np.ubyte, is_null_allowed=True),
+            self._booster_handle,
+            max_rounds,
+            term_boost_flags,
+            learning_rate,
+            min_samples_leaf,
+            Native._make_pointer(max_leaves_arr, np.int64),
+            greediness,
+            smoothing_rounds,
+            early_stopping_rounds,
+            early_stopping_tolerance,
+            ct.byref(n_rounds),
+            Native._make_pointer(metrics, np.float64),
+        )
+        if return_code:  # pragma: no cover
+            raise Native._get_native_exception(return_code, "BoostRounds")
+
+        return n_rounds.value, metrics[: n_rounds.value]
+
     def get_best_model(self):
         model = []
         for term_idx in range(len(self.term_features)):
@@ -1693,6 +2404,7 @@ class InteractionDetector(AbstractContextManager):
             flags,
             self.objective.encode("ascii"),
             Native._make_pointer(self.experimental_params, np.float64, 1, True),
+            None,
             ct.byref(interaction_handle),
         )
         if return_code:  # pragma: no cover
@@ -1743,3 +2455,89 @@ class InteractionDetector(AbstractContextManager):
 
         _log.info("Fast interaction strength end")
         return strength.value
+
+    def calc_interaction_strengths(
+        self,
+        term_features,
+        calc_interaction_flags,
+        max_cardinality,
+        min_samples_leaf,
+    ):
+        """Provides strength measurements for many feature interactions in one native call. Higher is better."""
+        _log.info("Fast interaction strengths start")
+
+        native = Native.get_native_singleton()
+
+        dimension_counts = np.array([len(x) for x in term_features], np.int64)
+        feature_idxs = np.array(
+            [idx for x in term_features for idx in x], np.int64
+        )
+        strengths = np.empty(len(dimension_counts), np.float64)
+
+        if len(dimension_counts) != 0:
+            return_code = native._unsafe.CalcInteractionStrengths(
+                self._interaction_handle,
+                len(dimension_counts),
+                Native._make_pointer(dimension_counts, np.int64),
+                Native._make_pointer(feature_idxs, np.int64),
+                calc_interaction_flags,
+                max_cardinality,
+                min_samples_leaf,
+                Native._make_pointer(strengths, np.float64),
+            )
+            if return_code:  # pragma: no cover
+                raise Native._get_native_exception(
+                    return_code, "CalcInteractionStrengths"
+                )
+
+        _log.info("Fast interaction strengths end")
+        return strengths
+
+    def rank_interactions(
+        self,
+        n_features,
+        excluded_pairs,
+        calc_interaction_flags,
+        max_cardinality,
+        min_samples_leaf,
+        n_output_interactions,
+    ):
+        """Ranks all pairs of features other than excluded_pairs from strongest to weakest.
+
+        Returns the strongest n_output_interactions pairs, or all of them if n_output_interactions <= 0.
+        """
+        _log.info("Fast interaction ranking start")
+
+        native = Native.get_native_singleton()
+
+        n_pairs = n_features * (n_features - 1) // 2
+        if 0 < n_output_interactions:
+            n_pairs = min(n_pairs, n_output_interactions)
+
+        excluded_pairs = np.array(
+            [idx for pair in excluded_pairs for idx in pair], np.int64
+        )
+        feature_idxs = np.empty(n_pairs * 2, np.int64)
+        strengths = np.empty(n_pairs, np.float64)
+        count_pairs = ct.c_int64(0)
+
+        if n_pairs != 0:
+            return_code = native._unsafe.RankInteractions(
+                self._interaction_handle,
+                len(excluded_pairs) // 2,
+                Native._make_pointer(excluded_pairs, np.int64),
+                calc_interaction_flags,
+                max_cardinality,
+                min_samples_leaf,
+                n_pairs,
+                ct.byref(count_pairs),
+                Native._make_pointer(feature_idxs, np.int64),
+                Native._make_pointer(strengths, np.float64),
+            )
+            if return_code:  # pragma: no cover
+                raise Native._get_native_exception(return_code, "RankInteractions")
+
+        n_pairs = count_pairs.value
+
+        _log.info("Fast interaction ranking end")
+        return feature_idxs[: n_pairs * 2].reshape(-1, 2), strengths[:n_pairs]
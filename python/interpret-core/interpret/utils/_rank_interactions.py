@@ -27,6 +27,7 @@ def rank_interactions(
     objective,
     experimental_params=None,
     n_output_interactions=0,
+    n_features=0,
 ):
     try:
         interaction_strengths = []
@@ -38,23 +39,43 @@ def rank_interactions(
             objective,
             experimental_params,
         ) as interaction_detector:
-            for feature_idxs in iter_term_features:
-                if tuple(sorted(feature_idxs)) in exclude:
-                    continue
-                strength = interaction_detector.calc_interaction_strength(
-                    feature_idxs,
+            if iter_term_features is None:
+                # rank all pairs natively, which also keeps only the top n_output_interactions
+                excluded_pairs = [x for x in exclude if len(x) == 2]
+                feature_idxs, strengths = interaction_detector.rank_interactions(
+                    n_features,
+                    excluded_pairs,
                     calc_interaction_flags,
                     max_cardinality,
                     min_samples_leaf,
+                    n_output_interactions,
                 )
-                item = (strength, feature_idxs)
-                if n_output_interactions <= 0:
-                    interaction_strengths.append(item)
+                return [
+                    (float(strength), (int(pair[0]), int(pair[1])))
+                    for strength, pair in zip(strengths, feature_idxs)
+                ]
+
+            term_features = [
+                feature_idxs
+                for feature_idxs in iter_term_features
+                if tuple(sorted(feature_idxs)) not in exclude
+            ]
+            strengths = interaction_detector.calc_interaction_strengths(
+                term_features,
+                calc_interaction_flags,
+                max_cardinality,
+                min_samples_leaf,
+            )
+
+        for strength, feature_idxs in zip(strengths, term_features):
+            item = (float(strength), feature_idxs)
+            if n_output_interactions <= 0:
+                interaction_strengths.append(item)
+            else:
+                if len(interaction_strengths) == n_output_interactions:
+                    heapq.heappushpop(interaction_strengths, item)
                 else:
-                    if len(interaction_strengths) == n_output_interactions:
-                        heapq.heappushpop(interaction_strengths, item)
-                    else:
-                        heapq.heappush(interaction_strengths, item)
+                    heapq.heappush(interaction_strengths, item)
 
         interaction_strengths.sort(reverse=True)
         return interaction_strengths
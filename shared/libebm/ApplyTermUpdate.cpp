@@ -15,6 +15,7 @@
 #include "Term.hpp"
 #include "Transpose.hpp"
 #include "Tensor.hpp"
+#include "ThreadPool.hpp"
 #include "BoosterCore.hpp"
 #include "BoosterShell.hpp"
 
@@ -23,6 +24,87 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
+struct ApplyUpdateTask {
+   BoosterCore * m_pBoosterCore;
+   const Term * m_pTerm;
+   size_t m_iTerm;
+   size_t m_cFloatSize;
+   FloatScore * m_aUpdateScores;
+   void * m_aMulticlassMidwayTemp;
+   size_t m_cBytesMulticlassMidwayTemp;
+   size_t m_cTasks;
+   double * m_aValidationMetrics;
+};
+
+// Task iTask handles every m_cTasks-th subset, with the training subsets first and then the validation subsets.
+// Each task owns its own MulticlassMidwayTemp, and each validation subset writes its metric into its own slot so
+// that our caller can sum the metrics in subset order after all tasks have completed.
+static ErrorEbm ApplyUpdateSubsets(void * const pContext, const size_t iTask) {
+   const ApplyUpdateTask * const pTask = static_cast<const ApplyUpdateTask *>(pContext);
+   BoosterCore * const pBoosterCore = pTask->m_pBoosterCore;
+   const Term * const pTerm = pTask->m_pTerm;
+
+   const size_t cTrainingSubsets = pBoosterCore->GetTrainingSet()->GetCountSubsets();
+   const size_t cSubsets = cTrainingSubsets + pBoosterCore->GetValidationSet()->GetCountSubsets();
+
+   void * const aMulticlassMidwayTemp = nullptr == pTask->m_aMulticlassMidwayTemp ? nullptr :
+      IndexByte(pTask->m_aMulticlassMidwayTemp, pTask->m_cBytesMulticlassMidwayTemp * iTask);
+
+   for(size_t iSubset = iTask; iSubset < cSubsets; iSubset += pTask->m_cTasks) {
+      const bool bValidation = cTrainingSubsets <= iSubset;
+      DataSubsetBoosting * const pSubset = bValidation ? 
+         &pBoosterCore->GetValidationSet()->GetSubsets()[iSubset - cTrainingSubsets] : 
+         &pBoosterCore->GetTrainingSet()->GetSubsets()[iSubset];
+
+      if(pSubset->GetObjectiveWrapper()->m_cFloatBytes == pTask->m_cFloatSize) {
+         ApplyUpdateBridge data;
+         data.m_cScores = GetCountScores(pBoosterCore->GetCountClasses());
+         data.m_cPack = 0 == pTerm->GetBitsRequiredMin() ? k_cItemsPerBitPackNone :
+            GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+         if(bValidation) {
+            // if there is no validation set, it's pretty hard to know what the metric we'll get for our validation set
+            // we could in theory return anything from zero to infinity or possibly, NaN (probably legally the best), but we return 0 here
+            // because we want to kick our caller out of any loop it might be calling us in.  Infinity and NaN are odd values that might cause problems in
+            // a caller that isn't expecting those values, so 0 is the safest option, and our caller can avoid the situation entirely by not calling
+            // us with zero count validation sets
+
+            // if the count of training samples is zero, don't update the best term scores (it will stay as all zeros), and we don't need to update our 
+            // non-existant training set either C++ doesn't define what happens when you compare NaN to annother number.  It probably follows IEEE 754, 
+            // but it isn't guaranteed, so let's check for zero samples in the validation set this better way
+            // https://stackoverflow.com/questions/31225264/what-is-the-result-of-comparing-a-number-with-nan
+
+            // for the validation set we're calculating the metric and updating the scores, but we don't use
+            // the gradients, except for the special case of RMSE where the gradients are also the error
+            data.m_bHessianNeeded = EBM_FALSE;
+            data.m_bValidation = EBM_TRUE;
+            data.m_aWeights = pSubset->GetInnerBag(0)->GetWeights();
+         } else {
+            data.m_bHessianNeeded = pBoosterCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
+            data.m_bValidation = EBM_FALSE;
+            data.m_aWeights = nullptr;
+         }
+         data.m_bUniformTarget = pSubset->IsUniformTarget() ? EBM_TRUE : EBM_FALSE;
+         data.m_aMulticlassMidwayTemp = aMulticlassMidwayTemp;
+         data.m_aUpdateTensorScores = pTask->m_aUpdateScores;
+         data.m_cSamples = pSubset->GetCountSamples();
+         data.m_aPacked = pSubset->GetTermData(pTask->m_iTerm);
+         data.m_aTargets = pSubset->GetTargetData();
+         data.m_aSampleScores = pSubset->GetSampleScores();
+         data.m_aGradientsAndHessians = pSubset->GetGradHess();
+         const ErrorEbm error = pSubset->ObjectiveApplyUpdate(&data);
+         if(Error_None != error) {
+            return error;
+         }
+         if(bValidation) {
+            pTask->m_aValidationMetrics[iSubset - cTrainingSubsets] = data.m_metricOut;
+         }
+      } else if(bValidation) {
+         pTask->m_aValidationMetrics[iSubset - cTrainingSubsets] = 0.0;
+      }
+   }
+   return Error_None;
+}
+
 // we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before 
 // getting the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us
 // we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more 
@@ -138,85 +220,51 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
    static_assert(std::is_same<FloatBig, FloatScore>::value || std::is_same<FloatSmall, FloatScore>::value,
       "FloatScore must be either FloatBig or FloatSmall");
    size_t cFloatSize = sizeof(aUpdateScores[0]);
-   bool bIgnored = false;
-   while(true) {
-      if(0 != pBoosterCore->GetTrainingSet()->GetCountSamples()) {
-         EBM_ASSERT(1 <= pBoosterCore->GetTrainingSet()->GetCountSubsets());
+   const size_t cTrainingSubsets = pBoosterCore->GetTrainingSet()->GetCountSubsets();
+   const size_t cValidationSubsets = pBoosterCore->GetValidationSet()->GetCountSubsets();
+
+   ApplyUpdateTask task;
+   task.m_pBoosterCore = pBoosterCore;
+   task.m_pTerm = pTerm;
+   task.m_iTerm = iTerm;
+   task.m_aUpdateScores = aUpdateScores;
+   task.m_aMulticlassMidwayTemp = pBoosterShell->GetMulticlassMidwayTemp();
+   task.m_cBytesMulticlassMidwayTemp = pBoosterShell->GetCountBytesMulticlassMidwayTemp();
+   task.m_cTasks = EbmMin(pBoosterCore->GetCountThreads(), cTrainingSubsets + cValidationSubsets);
+   task.m_aValidationMetrics = pBoosterShell->GetValidationMetricsTemp();
 
-         DataSubsetBoosting * pSubset = pBoosterCore->GetTrainingSet()->GetSubsets();
-         const DataSubsetBoosting * const pSubsetsEnd = pSubset + pBoosterCore->GetTrainingSet()->GetCountSubsets();
-         do {
-            if(pSubset->GetObjectiveWrapper()->m_cFloatBytes != cFloatSize) {
-               bIgnored = true;
-            } else {
-               ApplyUpdateBridge data;
-               data.m_cScores = GetCountScores(pBoosterCore->GetCountClasses());
-               data.m_cPack = 0 == pTerm->GetBitsRequiredMin() ? k_cItemsPerBitPackNone :
-                  GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-               data.m_bHessianNeeded = pBoosterCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
-               data.m_bValidation = EBM_FALSE;
-               data.m_aMulticlassMidwayTemp = pBoosterShell->GetMulticlassMidwayTemp();
-               data.m_aUpdateTensorScores = aUpdateScores;
-               data.m_cSamples = pSubset->GetCountSamples();
-               data.m_aPacked = pSubset->GetTermData(iTerm);
-               data.m_aTargets = pSubset->GetTargetData();
-               data.m_aWeights = nullptr;
-               data.m_aSampleScores = pSubset->GetSampleScores();
-               data.m_aGradientsAndHessians = pSubset->GetGradHess();
-               error = pSubset->ObjectiveApplyUpdate(&data);
-               if(Error_None != error) {
-                  return error;
-               }
-            }
-            ++pSubset;
-         } while(pSubsetsEnd != pSubset);
+   while(true) {
+      bool bIgnored = false;
+      for(size_t iSubset = 0; iSubset < cTrainingSubsets; ++iSubset) {
+         if(pBoosterCore->GetTrainingSet()->GetSubsets()[iSubset].GetObjectiveWrapper()->m_cFloatBytes != cFloatSize) {
+            bIgnored = true;
+         }
+      }
+      for(size_t iSubset = 0; iSubset < cValidationSubsets; ++iSubset) {
+         if(pBoosterCore->GetValidationSet()->GetSubsets()[iSubset].GetObjectiveWrapper()->m_cFloatBytes != cFloatSize) {
+            bIgnored = true;
+         }
       }
 
-      if(0 != pBoosterCore->GetValidationSet()->GetCountSamples()) {
-         EBM_ASSERT(1 <= pBoosterCore->GetValidationSet()->GetCountSubsets());
+      task.m_cFloatSize = cFloatSize;
+      if(size_t { 0 } != task.m_cTasks) {
+         ThreadPool * const pThreadPool = pBoosterCore->GetThreadPool();
+         if(nullptr != pThreadPool) {
+            error = pThreadPool->Run(task.m_cTasks, ApplyUpdateSubsets, &task);
+         } else {
+            EBM_ASSERT(1 == task.m_cTasks);
+            error = ApplyUpdateSubsets(&task, 0);
+         }
+         if(Error_None != error) {
+            return error;
+         }
+      }
 
-         DataSubsetBoosting * pSubset = pBoosterCore->GetValidationSet()->GetSubsets();
-         const DataSubsetBoosting * const pSubsetsEnd = pSubset + pBoosterCore->GetValidationSet()->GetCountSubsets();
-         do {
-            if(pSubset->GetObjectiveWrapper()->m_cFloatBytes != cFloatSize) {
-               bIgnored = true;
-            } else {
-               // if there is no validation set, it's pretty hard to know what the metric we'll get for our validation set
-               // we could in theory return anything from zero to infinity or possibly, NaN (probably legally the best), but we return 0 here
-               // because we want to kick our caller out of any loop it might be calling us in.  Infinity and NaN are odd values that might cause problems in
-               // a caller that isn't expecting those values, so 0 is the safest option, and our caller can avoid the situation entirely by not calling
-               // us with zero count validation sets
-
-               // if the count of training samples is zero, don't update the best term scores (it will stay as all zeros), and we don't need to update our 
-               // non-existant training set either C++ doesn't define what happens when you compare NaN to annother number.  It probably follows IEEE 754, 
-               // but it isn't guaranteed, so let's check for zero samples in the validation set this better way
-               // https://stackoverflow.com/questions/31225264/what-is-the-result-of-comparing-a-number-with-nan
-
-               ApplyUpdateBridge data;
-               data.m_cScores = GetCountScores(pBoosterCore->GetCountClasses());
-               data.m_cPack = 0 == pTerm->GetBitsRequiredMin() ? k_cItemsPerBitPackNone :
-                  GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-               // for the validation set we're calculating the metric and updating the scores, but we don't use
-               // the gradients, except for the special case of RMSE where the gradients are also the error
-               data.m_bHessianNeeded = EBM_FALSE;
-               data.m_bValidation = EBM_TRUE;
-               data.m_aMulticlassMidwayTemp = pBoosterShell->GetMulticlassMidwayTemp();
-               data.m_aUpdateTensorScores = aUpdateScores;
-               data.m_cSamples = pSubset->GetCountSamples();
-               data.m_aPacked = pSubset->GetTermData(iTerm);
-               data.m_aTargets = pSubset->GetTargetData();
-               data.m_aWeights = pSubset->GetInnerBag(0)->GetWeights();
-               data.m_aSampleScores = pSubset->GetSampleScores();
-               data.m_aGradientsAndHessians = pSubset->GetGradHess();
-               error = pSubset->ObjectiveApplyUpdate(&data);
-               if(Error_None != error) {
-                  return error;
-               }
-               validationMetricAvg += data.m_metricOut;
-            }
-            ++pSubset;
-         } while(pSubsetsEnd != pSubset);
+      // sum in subset order so that the metric does not depend on the number of threads
+      for(size_t iSubset = 0; iSubset < cValidationSubsets; ++iSubset) {
+         validationMetricAvg += task.m_aValidationMetrics[iSubset];
       }
+
       if(!bIgnored) {
          break;
       }
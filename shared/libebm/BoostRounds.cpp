@@ -0,0 +1,242 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stdlib.h> // malloc, free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <limits> // numeric_limits
+
+#include "libebm.h" // ErrorEbm
+#include "logging.h" // EBM_ASSERT
+#include "zones.h"
+
+#include "common_cpp.hpp" // IsConvertError
+
+#include "Tensor.hpp"
+#include "BoosterCore.hpp"
+#include "BoosterShell.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// Greedy rounds boost the term with the highest gain from its most recent update. Ties go to the lowest term index.
+static size_t PickGreedyTerm(const size_t cTerms, const double * const aGains) {
+   EBM_ASSERT(1 <= cTerms);
+   size_t iBest = 0;
+   double gainBest = aGains[0];
+   for(size_t iTerm = 1; iTerm < cTerms; ++iTerm) {
+      const double gain = aGains[iTerm];
+      if(gainBest < gain) {
+         gainBest = gain;
+         iBest = iTerm;
+      }
+   }
+   return iBest;
+}
+
+// don't bother using a lock here.  We don't care if an extra log message is written out due to thread parallism
+static int g_cLogEnterBoostRounds = 10;
+static int g_cLogExitBoostRounds = 10;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION BoostRounds(
+   void * rng,
+   BoosterHandle boosterHandle,
+   IntEbm countRounds,
+   TermBoostFlags flags,
+   double learningRate,
+   IntEbm minSamplesLeaf,
+   const IntEbm * leavesMax,
+   double greediness,
+   IntEbm countSmoothingRounds,
+   IntEbm countEarlyStoppingRounds,
+   double earlyStoppingTolerance,
+   IntEbm * countRoundsOut,
+   double * metricsOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterBoostRounds,
+      Trace_Info,
+      Trace_Verbose,
+      "Entered BoostRounds: "
+      "rng=%p, "
+      "boosterHandle=%p, "
+      "countRounds=%" IntEbmPrintf ", "
+      "flags=0x%" UTermBoostFlagsPrintf ", "
+      "learningRate=%le, "
+      "minSamplesLeaf=%" IntEbmPrintf ", "
+      "leavesMax=%p, "
+      "greediness=%le, "
+      "countSmoothingRounds=%" IntEbmPrintf ", "
+      "countEarlyStoppingRounds=%" IntEbmPrintf ", "
+      "earlyStoppingTolerance=%le, "
+      "countRoundsOut=%p, "
+      "metricsOut=%p"
+      ,
+      rng,
+      static_cast<void *>(boosterHandle),
+      countRounds,
+      static_cast<UTermBoostFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      learningRate,
+      minSamplesLeaf,
+      static_cast<const void *>(leavesMax),
+      greediness,
+      countSmoothingRounds,
+      countEarlyStoppingRounds,
+      earlyStoppingTolerance,
+      static_cast<void *>(countRoundsOut),
+      static_cast<void *>(metricsOut)
+   );
+
+   ErrorEbm error;
+
+   if(nullptr != countRoundsOut) {
+      *countRoundsOut = IntEbm { 0 };
+   }
+
+   BoosterShell * const pBoosterShell = BoosterShell::GetBoosterShellFromHandle(boosterHandle);
+   if(nullptr == pBoosterShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   if(countRounds < IntEbm { 0 }) {
+      LOG_0(Trace_Error, "ERROR BoostRounds countRounds must be positive");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countRounds) || IsMultiplyError(sizeof(*metricsOut), static_cast<size_t>(countRounds))) {
+      LOG_0(Trace_Error, "ERROR BoostRounds countRounds too large to index");
+      return Error_IllegalParamVal;
+   }
+   const size_t cRounds = static_cast<size_t>(countRounds);
+
+   if(std::isnan(greediness) || greediness < 0.0) {
+      LOG_0(Trace_Error, "ERROR BoostRounds greediness must be a non-negative number");
+      return Error_IllegalParamVal;
+   }
+
+   const BoosterCore * const pBoosterCore = pBoosterShell->GetBoosterCore();
+   EBM_ASSERT(nullptr != pBoosterCore);
+   const size_t cTerms = pBoosterCore->GetCountTerms();
+
+   double * aGains = nullptr;
+   if(size_t { 0 } != cTerms) {
+      if(IsMultiplyError(sizeof(*aGains), cTerms)) {
+         LOG_0(Trace_Warning, "WARNING BoostRounds IsMultiplyError(sizeof(*aGains), cTerms)");
+         return Error_OutOfMemory;
+      }
+      aGains = static_cast<double *>(malloc(sizeof(*aGains) * cTerms));
+      if(nullptr == aGains) {
+         LOG_0(Trace_Warning, "WARNING BoostRounds nullptr == aGains");
+         return Error_OutOfMemory;
+      }
+   }
+
+   // the first round is always cyclic since we need to get the initial gains
+   double greedyPortion = 0.0;
+
+   double metricMin = std::numeric_limits<double>::infinity();
+   double metricBreakpoint = std::numeric_limits<double>::infinity();
+   IntEbm cNoChangeRunLength = 0;
+   IntEbm cSmoothingRoundsRemaining = countSmoothingRounds;
+
+   size_t iRound = 0;
+   while(iRound < cRounds) {
+      TermBoostFlags flagsLocal = flags;
+      if(IntEbm { 0 } < cSmoothingRoundsRemaining) {
+         flagsLocal = static_cast<TermBoostFlags>(static_cast<UTermBoostFlags>(flagsLocal) |
+            static_cast<UTermBoostFlags>(TermBoostFlags_DisableNewtonGain) |
+            static_cast<UTermBoostFlags>(TermBoostFlags_DisableNewtonUpdate) |
+            static_cast<UTermBoostFlags>(TermBoostFlags_RandomSplits));
+      }
+
+      const bool bGreedy = 1.0 <= greedyPortion;
+      for(size_t iStep = 0; iStep < cTerms; ++iStep) {
+         const size_t iTerm = bGreedy ? PickGreedyTerm(cTerms, aGains) : iStep;
+
+         double gain;
+         error = GenerateTermUpdate(
+            rng,
+            boosterHandle,
+            static_cast<IntEbm>(iTerm),
+            flagsLocal,
+            learningRate,
+            minSamplesLeaf,
+            leavesMax,
+            &gain
+         );
+         if(Error_None != error) {
+            free(aGains);
+            return error;
+         }
+         aGains[iTerm] = gain;
+
+         double metric;
+         error = ApplyTermUpdate(boosterHandle, &metric);
+         if(Error_None != error) {
+            free(aGains);
+            return error;
+         }
+
+         // same as python's min(metric, metricMin), which keeps metric unless metricMin is strictly lower
+         metricMin = metricMin < metric ? metricMin : metric;
+      }
+
+      if(IntEbm { 0 } == cNoChangeRunLength) {
+         metricBreakpoint = metricMin;
+      }
+      if(metricMin + earlyStoppingTolerance < metricBreakpoint) {
+         cNoChangeRunLength = 0;
+      } else {
+         ++cNoChangeRunLength;
+      }
+
+      if(bGreedy) {
+         greedyPortion -= 1.0;
+      }
+
+      if(IntEbm { 0 } < cSmoothingRoundsRemaining) {
+         // disable early stopping progress during the smoothing rounds since cuts are chosen randomly, which
+         // will lead to high variance on the validation metric
+         cNoChangeRunLength = 0;
+         --cSmoothingRoundsRemaining;
+      } else {
+         // do not progress into greedy rounds until we're done with the smoothing rounds
+         greedyPortion += greediness;
+      }
+
+      if(nullptr != metricsOut) {
+         metricsOut[iRound] = metricMin;
+      }
+      ++iRound;
+
+      if(IntEbm { 0 } < countEarlyStoppingRounds && countEarlyStoppingRounds <= cNoChangeRunLength) {
+         break;
+      }
+   }
+
+   free(aGains);
+
+   if(nullptr != countRoundsOut) {
+      *countRoundsOut = static_cast<IntEbm>(iRound);
+   }
+
+   LOG_COUNTED_N(
+      &g_cLogExitBoostRounds,
+      Trace_Info,
+      Trace_Verbose,
+      "Exited BoostRounds: "
+      "countRounds=%zu, "
+      "metricMin=%le"
+      ,
+      iRound,
+      metricMin
+   );
+
+   return Error_None;
+}
+
+} // DEFINED_ZONE_NAME
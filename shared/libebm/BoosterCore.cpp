@@ -22,6 +22,7 @@
 #include "InnerBag.hpp" // InnerBag
 #include "TreeNode.hpp" // IsOverflowTreeNodeSize
 #include "SplitPosition.hpp" // IsOverflowSplitPositionSize
+#include "ThreadPool.hpp"
 #include "BoosterCore.hpp"
 
 namespace DEFINED_ZONE_NAME {
@@ -42,7 +43,8 @@ extern ErrorEbm GetObjective(
    const Config * const pConfig,
    const char * sObjective,
    ObjectiveWrapper * const pCpuObjectiveWrapperOut,
-   ObjectiveWrapper * const pSIMDObjectiveWrapperOut
+   ObjectiveWrapper * const pSIMDObjectiveWrapperOut,
+   const bool bDoublePrecisionSIMD
 ) noexcept;
 
 void BoosterCore::DeleteTensors(const size_t cTerms, Tensor ** const apTensors) {
@@ -139,6 +141,11 @@ BoosterCore::~BoosterCore() {
 
    FreeObjectiveWrapperInternals(&m_objectiveCpu);
    FreeObjectiveWrapperInternals(&m_objectiveSIMD);
+
+   ThreadPool::Free(m_pThreadPool);
+
+   // our training set no longer references the prepared term data, so we can release it
+   BoosterCore::Free(m_pPreparedCore);
 };
 
 void BoosterCore::Free(BoosterCore * const pBoosterCore) {
@@ -228,8 +235,8 @@ static bool CheckBoosterRestrictionsInternal(
 
    if(IsMulticlass(cClasses)) {
       // TODO: we currently index into the gradient array using the target, but the gradient array is also
-      // layed out per-SIMD pack.  Once we sort the dataset by the target we'll be able to use non-random
-      // indexing to fetch all the sample targets simultaneously, and we'll no longer need this indexing
+      // layed out per-SIMD pack.  With CreateBoosterFlags_SortByTarget the objectives use non-random indexing
+      // instead, so we could skip this restriction in that case
       size_t cIndexes = static_cast<size_t>(cClasses);
       if(bHessian) {
          if(IsMultiplyError(size_t { 2 }, cIndexes)) {
@@ -264,11 +271,6 @@ static bool CheckBoosterRestrictions(
    }
 }
 
-//static int g_TODO_removeThisThreadTest = 0;
-//void TODO_removeThisThreadTest() {
-//   g_TODO_removeThisThreadTest = 1;
-//}
-
 ErrorEbm BoosterCore::Create(
    void * const rng,
    const size_t cTerms,
@@ -281,6 +283,11 @@ ErrorEbm BoosterCore::Create(
    const double * const aInitScores,
    const CreateBoosterFlags flags,
    const char * const sObjective,
+   ThreadPool * const pThreadPool,
+   size_t * const pcBytesMeasure,
+   size_t * const pcBytesPeakMeasure,
+   const bool bPrepareOnly,
+   BoosterCore * const pPreparedCore,
    BoosterCore ** const ppBoosterCoreOut
 ) {
    // experimentalParams isn't used by default.  It's meant to provide an easy way for python or other higher
@@ -292,27 +299,18 @@ ErrorEbm BoosterCore::Create(
    EBM_ASSERT(nullptr != ppBoosterCoreOut);
    EBM_ASSERT(nullptr == *ppBoosterCoreOut);
    EBM_ASSERT(nullptr != pDataSetShared);
+   EBM_ASSERT(nullptr == pcBytesMeasure || !bPrepareOnly && nullptr == pPreparedCore);
+   EBM_ASSERT((nullptr == pcBytesMeasure) == (nullptr == pcBytesPeakMeasure));
+   EBM_ASSERT(!bPrepareOnly || nullptr == aBag && size_t { 0 } == cInnerBags);
+   EBM_ASSERT(!bPrepareOnly || nullptr == pPreparedCore);
 
    ErrorEbm error;
 
-   //try {
-   //   // TODO: eliminate this code I added to test that threads are available on the majority of our systems
-   //   std::thread testThread(TODO_removeThisThreadTest);
-   //   testThread.join();
-   //   if(0 == g_TODO_removeThisThreadTest) {
-   //      LOG_0(Trace_Warning, "WARNING BoosterCore::Create thread not started");
-   //      return Error_UnexpectedInternal;
-   //   }
-   //} catch(const std::bad_alloc &) {
-   //   LOG_0(Trace_Warning, "WARNING BoosterCore::Create thread start out of memory");
-   //   return Error_OutOfMemory;
-   //} catch(...) {
-   //   // the C++ standard doesn't really seem to say what kind of exceptions we'd get for various errors, so
-   //   // about the best we can do is catch(...) since the exact exceptions seem to be implementation specific
-   //   LOG_0(Trace_Warning, "WARNING BoosterCore::Create thread start failed");
-   //   return Error_ThreadStartFailed;
-   //}
-   //LOG_0(Trace_Info, "INFO BoosterCore::Create thread started");
+   if((bPrepareOnly || nullptr != pPreparedCore) && 0 != (CreateBoosterFlags_SortByTarget & flags)) {
+      // prepared term data holds the samples in their original order, while sorting reorders each bag differently
+      LOG_0(Trace_Error, "ERROR BoosterCore::Create CreateBoosterFlags_SortByTarget cannot be used with a prepared dataset");
+      return Error_IllegalParamVal;
+   }
 
    BoosterCore * pBoosterCore;
    try {
@@ -332,6 +330,20 @@ ErrorEbm BoosterCore::Create(
    // give ownership of our object back to the caller, even if there is a failure
    *ppBoosterCoreOut = pBoosterCore;
 
+   if(nullptr != pPreparedCore) {
+      // the prepared term data stays alive until we release our reference to it in our destructor
+      pPreparedCore->AddReferenceCount();
+      pBoosterCore->m_pPreparedCore = pPreparedCore;
+   }
+
+   if(nullptr != pThreadPool) {
+      // the caller's thread pool stays alive until we release our reference to it in our destructor
+      pThreadPool->AddReferenceCount();
+      pBoosterCore->m_pThreadPool = pThreadPool;
+      pBoosterCore->m_cThreads = pThreadPool->GetCountThreads();
+   }
+   const bool bThreaded = nullptr != pThreadPool;
+
    UIntShared countSamples;
    size_t cFeatures;
    size_t cWeights;
@@ -396,7 +408,6 @@ ErrorEbm BoosterCore::Create(
             &defaultValSparse,
             &cNonDefaultsSparse
          );
-         EBM_ASSERT(!bSparse); // we do not handle yet
          if(IsConvertError<size_t>(countBins)) {
             LOG_0(Trace_Error, "ERROR BoosterCore::Create IsConvertError<size_t>(countBins)");
             return Error_IllegalParamVal;
@@ -610,7 +621,8 @@ ErrorEbm BoosterCore::Create(
          &config,
          sObjective,
          &pBoosterCore->m_objectiveCpu,
-         0 != (CreateBoosterFlags_DisableSIMD & flags) ? nullptr : &pBoosterCore->m_objectiveSIMD
+         0 != (CreateBoosterFlags_DisableSIMD & flags) ? nullptr : &pBoosterCore->m_objectiveSIMD,
+         0 != (CreateBoosterFlags_DoublePrecisionSIMD & flags)
       );
       if(Error_None != error) {
          // already logged
@@ -657,39 +669,61 @@ ErrorEbm BoosterCore::Create(
                return error;
             }
 
-            // if we have 32 bit floats or ints, then we need to break large datasets into smaller data subsets
-            // because float32 values stop incrementing at 2^24 where the value 1 is below the threshold incrementing a float
-            const bool bForceMultipleSubsets =
-               sizeof(UIntSmall) == pBoosterCore->m_objectiveCpu.m_cUIntBytes ||
-               sizeof(FloatSmall) == pBoosterCore->m_objectiveCpu.m_cFloatBytes ||
-               sizeof(UIntSmall) == pBoosterCore->m_objectiveSIMD.m_cUIntBytes ||
-               sizeof(FloatSmall) == pBoosterCore->m_objectiveSIMD.m_cFloatBytes;
-
             const bool bHessian = pBoosterCore->IsHessian();
 
             pBoosterCore->m_cInnerBags = cInnerBags; // this is used to destruct m_trainingSet, so store it first
-            error = pBoosterCore->m_trainingSet.InitDataSetBoosting(
-               true,
-               bHessian,
-               !pBoosterCore->IsRmse(),
-               !pBoosterCore->IsRmse(),
-               rng,
-               cScores,
-               bForceMultipleSubsets ? k_cSubsetSamplesMax : SIZE_MAX,
-               &pBoosterCore->m_objectiveCpu,
-               &pBoosterCore->m_objectiveSIMD,
-               pDataSetShared,
-               BagEbm { 1 },
-               cSamples,
-               aBag,
-               aInitScores,
-               cTrainingSamples,
-               cInnerBags,
-               cWeights,
-               cTerms,
-               pBoosterCore->m_apTerms,
-               aiTermFeatures
-            );
+            if(nullptr != pPreparedCore) {
+               error = pBoosterCore->m_trainingSet.InitDataSetBoostingPrepared(
+                  bHessian,
+                  !pBoosterCore->IsRmse(),
+                  !pBoosterCore->IsRmse(),
+                  rng,
+                  cScores,
+                  &pBoosterCore->m_objectiveCpu,
+                  &pBoosterCore->m_objectiveSIMD,
+                  pDataSetShared,
+                  cSamples,
+                  aBag,
+                  aInitScores,
+                  cTrainingSamples,
+                  cInnerBags,
+                  0 != (CreateBoosterFlags_CompactInnerBags & flags),
+                  cWeights,
+                  cTerms,
+                  pPreparedCore->GetTrainingSet()
+               );
+            } else {
+               // a prepared dataset only needs the packed term data, which it shares with the boosters built on it
+               error = pBoosterCore->m_trainingSet.InitDataSetBoosting(
+                  !bPrepareOnly,
+                  !bPrepareOnly && bHessian,
+                  !bPrepareOnly && !pBoosterCore->IsRmse(),
+                  !bPrepareOnly && !pBoosterCore->IsRmse(),
+                  rng,
+                  cScores,
+                  // subsets keep float32 sums below 2^24, where adding 1 stops changing the sum, and they are the
+                  // unit of work for the thread pool. float64 data is split the same way with or without a pool
+                  // so that the summation order, and therefore the results, never depend on threading
+                  k_cSubsetSamplesMax,
+                  &pBoosterCore->m_objectiveCpu,
+                  &pBoosterCore->m_objectiveSIMD,
+                  pDataSetShared,
+                  BagEbm { 1 },
+                  cSamples,
+                  aBag,
+                  aInitScores,
+                  cTrainingSamples,
+                  cInnerBags,
+                  0 != (CreateBoosterFlags_CompactInnerBags & flags),
+                  0 != (CreateBoosterFlags_SortByTarget & flags),
+                  bPrepareOnly ? size_t { 0 } : cWeights,
+                  cTerms,
+                  pBoosterCore->m_apTerms,
+                  aiTermFeatures,
+                  pcBytesMeasure,
+                  pcBytesPeakMeasure
+               );
+            }
             if(Error_None != error) {
                return error;
             }
@@ -701,7 +735,7 @@ ErrorEbm BoosterCore::Create(
                !pBoosterCore->IsRmse(),
                rng,
                cScores,
-               bForceMultipleSubsets ? k_cSubsetSamplesMax : SIZE_MAX,
+               k_cSubsetSamplesMax,
                &pBoosterCore->m_objectiveCpu,
                &pBoosterCore->m_objectiveSIMD,
                pDataSetShared,
@@ -711,10 +745,14 @@ ErrorEbm BoosterCore::Create(
                aInitScores,
                cValidationSamples,
                0,
+               false,
+               0 != (CreateBoosterFlags_SortByTarget & flags),
                cWeights,
                cTerms,
                pBoosterCore->m_apTerms,
-               aiTermFeatures
+               aiTermFeatures,
+               pcBytesMeasure,
+               pcBytesPeakMeasure
             );
             if(Error_None != error) {
                return error;
@@ -778,7 +816,32 @@ ErrorEbm BoosterCore::Create(
                LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsMultiplyError(cBytesPerFastBinMax, cTensorBinsMax)");
                return Error_OutOfMemory;
             }
-            pBoosterCore->m_cBytesFastBins = cBytesPerFastBinMax * cTensorBinsMax;
+            size_t cBytesFastBins = cBytesPerFastBinMax * cTensorBinsMax;
+
+            const size_t cInnerBagsAfterZero = size_t { 0 } == cInnerBags ? size_t { 1 } : cInnerBags;
+
+            size_t cFastBinsThreads = 1;
+            if(bThreaded && 0 != cTrainingSamples) {
+               // each thread bins a different (inner bag, subset) pair into its own fast bins, so keep each thread's
+               // fast bins on separate SIMD aligned boundaries which also keeps them on separate cache lines
+               const size_t cTrainingSubsets = pBoosterCore->GetTrainingSet()->GetCountSubsets();
+               cFastBinsThreads = pBoosterCore->m_cThreads;
+               if(!IsMultiplyError(cTrainingSubsets, cInnerBagsAfterZero)) {
+                  cFastBinsThreads = EbmMin(cFastBinsThreads, cTrainingSubsets * cInnerBagsAfterZero);
+               }
+               if(IsAddError(cBytesFastBins, SIMD_BYTE_ALIGNMENT - size_t { 1 })) {
+                  LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsAddError(cBytesFastBins, SIMD_BYTE_ALIGNMENT - 1)");
+                  return Error_OutOfMemory;
+               }
+               cBytesFastBins = (cBytesFastBins + (SIMD_BYTE_ALIGNMENT - size_t { 1 })) / SIMD_BYTE_ALIGNMENT * 
+                  SIMD_BYTE_ALIGNMENT;
+               if(IsMultiplyError(cBytesFastBins, cFastBinsThreads)) {
+                  LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsMultiplyError(cBytesFastBins, cFastBinsThreads)");
+                  return Error_OutOfMemory;
+               }
+            }
+            pBoosterCore->m_cBytesFastBins = cBytesFastBins;
+            pBoosterCore->m_cFastBinsThreads = cFastBinsThreads;
 
             if(IsOverflowBinSize<FloatMain, UIntMain>(bHessian, cScores)) {
                LOG_0(Trace_Warning, "WARNING BoosterCore::Create bin size overflow");
@@ -790,7 +853,27 @@ ErrorEbm BoosterCore::Create(
                LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsMultiplyError(cBytesPerMainBin, cMainBinsMax)");
                return Error_OutOfMemory;
             }
-            pBoosterCore->m_cBytesMainBins = cBytesPerMainBin * cMainBinsMax;
+            size_t cBytesMainBins = cBytesPerMainBin * cMainBinsMax;
+
+            size_t cMainBinsBags = 1;
+            if(bThreaded && 0 != cTrainingSamples) {
+               // the inner bags are binned concurrently with each bag going into its own main bins
+               cMainBinsBags = EbmMin(pBoosterCore->m_cThreads, cInnerBagsAfterZero);
+               if(size_t { 1 } != cMainBinsBags) {
+                  if(IsAddError(cBytesMainBins, SIMD_BYTE_ALIGNMENT - size_t { 1 })) {
+                     LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsAddError(cBytesMainBins, SIMD_BYTE_ALIGNMENT - 1)");
+                     return Error_OutOfMemory;
+                  }
+                  cBytesMainBins = (cBytesMainBins + (SIMD_BYTE_ALIGNMENT - size_t { 1 })) / SIMD_BYTE_ALIGNMENT * 
+                     SIMD_BYTE_ALIGNMENT;
+                  if(IsMultiplyError(cBytesMainBins, cMainBinsBags)) {
+                     LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsMultiplyError(cBytesMainBins, cMainBinsBags)");
+                     return Error_OutOfMemory;
+                  }
+               }
+            }
+            pBoosterCore->m_cBytesMainBins = cBytesMainBins;
+            pBoosterCore->m_cMainBinsBags = cMainBinsBags;
 
             if(0 != cSingleDimensionBinsMax) {
                if(IsOverflowTreeNodeSize(bHessian, cScores) || IsOverflowSplitPositionSize(bHessian, cScores)) {
@@ -834,6 +917,28 @@ ErrorEbm BoosterCore::Create(
                EBM_ASSERT(0 == pBoosterCore->m_cBytesTreeNodes);
             }
          }
+         if(nullptr != pcBytesMeasure) {
+            // the current and best models are each expanded to their full tensors
+            size_t cBytes = *pcBytesMeasure;
+            for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+               const size_t cTensorBins = pBoosterCore->m_apTerms[iTerm]->GetCountTensorBins();
+               if(IsMultiplyError(sizeof(FloatScore) * 2, cScores, cTensorBins) || 
+                  IsAddError(cBytes, sizeof(FloatScore) * 2 * cScores * cTensorBins)) 
+               {
+                  LOG_0(Trace_Warning, "WARNING BoosterCore::Create IsAddError(cBytes, sizeof(FloatScore) * 2 * cScores * cTensorBins)");
+                  return Error_OutOfMemory;
+               }
+               cBytes += sizeof(FloatScore) * 2 * cScores * cTensorBins;
+            }
+            *pcBytesMeasure = cBytes;
+
+            LOG_0(Trace_Info, "Exited BoosterCore::Create measuring");
+            return Error_None;
+         }
+         if(bPrepareOnly) {
+            LOG_0(Trace_Info, "Exited BoosterCore::Create prepared");
+            return Error_None;
+         }
          error = InitializeTensors(cTerms, pBoosterCore->m_apTerms, cScores, &pBoosterCore->m_apCurrentTermTensors);
          if(Error_None != error) {
             return error;
@@ -878,6 +983,7 @@ ErrorEbm BoosterCore::InitializeBoosterGradientsAndHessians(
          data.m_cPack = k_cItemsPerBitPackNone;
          data.m_bHessianNeeded = IsHessian() ? EBM_TRUE : EBM_FALSE;
          data.m_bValidation = EBM_FALSE;
+         data.m_bUniformTarget = pSubset->IsUniformTarget() ? EBM_TRUE : EBM_FALSE;
          data.m_aMulticlassMidwayTemp = aMulticlassMidwayTemp;
          // if FloatScore is type FloatSmall then some of the zones might use FloatBig as their type and then read 
          // past the end of the aUpdateScores memory, which should always contain zeros.If we want to handle this 
@@ -28,6 +28,7 @@ class FeatureBoosting;
 class Term;
 struct InnerBag;
 class Tensor;
+class ThreadPool;
 
 class BoosterCore final {
 
@@ -54,7 +55,9 @@ class BoosterCore final {
    double m_bestModelMetric;
 
    size_t m_cBytesFastBins;
+   size_t m_cFastBinsThreads;
    size_t m_cBytesMainBins;
+   size_t m_cMainBinsBags;
 
    size_t m_cBytesSplitPositions;
    size_t m_cBytesTreeNodes;
@@ -65,6 +68,12 @@ class BoosterCore final {
    ObjectiveWrapper m_objectiveCpu;
    ObjectiveWrapper m_objectiveSIMD;
 
+   ThreadPool * m_pThreadPool;
+   size_t m_cThreads;
+
+   // the core of a prepared dataset whose term data our training set references, or nullptr
+   BoosterCore * m_pPreparedCore;
+
    static void DeleteTensors(const size_t cTerms, Tensor ** const apTensors);
 
    static ErrorEbm InitializeTensors(
@@ -88,9 +97,14 @@ class BoosterCore final {
       m_apBestTermTensors(nullptr),
       m_bestModelMetric(std::numeric_limits<double>::infinity()),
       m_cBytesFastBins(0),
+      m_cFastBinsThreads(1),
       m_cBytesMainBins(0),
+      m_cMainBinsBags(1),
       m_cBytesSplitPositions(0),
-      m_cBytesTreeNodes(0)
+      m_cBytesTreeNodes(0),
+      m_pThreadPool(nullptr),
+      m_cThreads(1),
+      m_pPreparedCore(nullptr)
    {
       m_trainingSet.SafeInitDataSetBoosting();
       m_validationSet.SafeInitDataSetBoosting();
@@ -115,10 +129,18 @@ public:
       return m_cBytesFastBins;
    }
 
+   inline size_t GetCountFastBinsThreads() const {
+      return m_cFastBinsThreads;
+   }
+
    inline size_t GetCountBytesMainBins() const {
       return m_cBytesMainBins;
    }
 
+   inline size_t GetCountMainBinsBags() const {
+      return m_cMainBinsBags;
+   }
+
    inline size_t GetCountBytesSplitPositions() const {
       return m_cBytesSplitPositions;
    }
@@ -127,6 +149,14 @@ public:
       return m_cBytesTreeNodes;
    }
 
+   inline ThreadPool * GetThreadPool() const {
+      return m_pThreadPool;
+   }
+
+   inline size_t GetCountThreads() const {
+      return m_cThreads;
+   }
+
    inline size_t GetCountTerms() const {
       return m_cTerms;
    }
@@ -177,6 +207,15 @@ public:
       const double * const aInitScores,
       const CreateBoosterFlags flags,
       const char * const sObjective,
+      ThreadPool * const pThreadPool,
+      // if non-null, the datasets and tensors are not allocated and their bytes are added to *pcBytesMeasure
+      size_t * const pcBytesMeasure,
+      // raised to the bytes held while each dataset is built, including temporaries that are freed afterwards
+      size_t * const pcBytesPeakMeasure,
+      // if true, only the term data of the training set is built so that other boosters can share it
+      const bool bPrepareOnly,
+      // if non-null, the training set references the term data of this core, which was built with bPrepareOnly
+      BoosterCore * const pPreparedCore,
       BoosterCore ** const ppBoosterCoreOut
    );
 
@@ -14,7 +14,9 @@
 #include "Term.hpp" // Term
 #include "Transpose.hpp"
 #include "Tensor.hpp" // Tensor
+#include "TreeNode.hpp" // GetTreeNodeSize
 
+#include "ThreadPool.hpp"
 #include "BoosterCore.hpp" // BoosterCore
 #include "BoosterShell.hpp"
 
@@ -42,8 +44,10 @@ void BoosterShell::Free(BoosterShell * const pBoosterShell) {
       AlignedFree(pBoosterShell->m_aBoostingFastBinsTemp);
       AlignedFree(pBoosterShell->m_aBoostingMainBins);
       AlignedFree(pBoosterShell->m_aMulticlassMidwayTemp);
+      free(pBoosterShell->m_aValidationMetricsTemp);
       AlignedFree(pBoosterShell->m_aSplitPositionsTemp);
       AlignedFree(pBoosterShell->m_aTreeNodesTemp);
+      pBoosterShell->m_scratchArena.Destruct();
       BoosterCore::Free(pBoosterShell->m_pBoosterCore);
 
       // before we free our memory, indicate it was freed so if our higher level language attempts to use it we have
@@ -71,6 +75,51 @@ BoosterShell * BoosterShell::Create(BoosterCore * const pBoosterCore) {
    return pNew;
 }
 
+static bool CountBytesMulticlassMidway(
+   BoosterCore * const pBoosterCore,
+   const size_t cScores,
+   size_t * const pcBytesOut
+) {
+   // returns true on overflow, otherwise the bytes of temp space that each thread needs
+   size_t cBytesMulticlassMidwayMax = 0;
+   DataSetBoosting * const apDataSets[] = { pBoosterCore->GetTrainingSet(), pBoosterCore->GetValidationSet() };
+   for(DataSetBoosting * const pDataSet : apDataSets) {
+      if(0 != pDataSet->GetCountSamples()) {
+         DataSubsetBoosting * pSubset = pDataSet->GetSubsets();
+         const DataSubsetBoosting * const pSubsetsEnd = pSubset + pDataSet->GetCountSubsets();
+         do {
+            const size_t cSIMDPack = pSubset->GetObjectiveWrapper()->m_cSIMDPack;
+            const size_t cFloatBytes = pSubset->GetObjectiveWrapper()->m_cFloatBytes;
+            const size_t cMultiple = cFloatBytes * cSIMDPack;
+            if(IsMultiplyError(cMultiple, cScores)) {
+               return true;
+            }
+            const size_t cBytesMulticlassMidway = cMultiple * cScores;
+            cBytesMulticlassMidwayMax = EbmMax(cBytesMulticlassMidwayMax, cBytesMulticlassMidway);
+
+            ++pSubset;
+         } while(pSubsetsEnd != pSubset);
+      }
+   }
+
+   if(0 != cBytesMulticlassMidwayMax) {
+      const size_t cThreads = pBoosterCore->GetCountThreads();
+      if(size_t { 1 } != cThreads) {
+         // each thread gets its own temp space, on separate SIMD aligned boundaries
+         if(IsAddError(cBytesMulticlassMidwayMax, SIMD_BYTE_ALIGNMENT - size_t { 1 })) {
+            return true;
+         }
+         cBytesMulticlassMidwayMax = (cBytesMulticlassMidwayMax + (SIMD_BYTE_ALIGNMENT - size_t { 1 })) /
+            SIMD_BYTE_ALIGNMENT * SIMD_BYTE_ALIGNMENT;
+         if(IsMultiplyError(cBytesMulticlassMidwayMax, cThreads)) {
+            return true;
+         }
+      }
+   }
+   *pcBytesOut = cBytesMulticlassMidwayMax;
+   return false;
+}
+
 ErrorEbm BoosterShell::FillAllocations() {
    EBM_ASSERT(nullptr != m_pBoosterCore);
 
@@ -91,64 +140,51 @@ ErrorEbm BoosterShell::FillAllocations() {
       }
 
       if(0 != m_pBoosterCore->GetCountBytesFastBins()) {
-         m_aBoostingFastBinsTemp = static_cast<BinBase *>(AlignedAlloc(m_pBoosterCore->GetCountBytesFastBins()));
+         // BoosterCore::Create already checked that this multiplication does not overflow
+         m_aBoostingFastBinsTemp = static_cast<BinBase *>(AlignedAlloc(
+            m_pBoosterCore->GetCountBytesFastBins() * m_pBoosterCore->GetCountFastBinsThreads()));
          if(nullptr == m_aBoostingFastBinsTemp) {
             goto failed_allocation;
          }
       }
 
       if(0 != m_pBoosterCore->GetCountBytesMainBins()) {
-         m_aBoostingMainBins = static_cast<BinBase *>(AlignedAlloc(m_pBoosterCore->GetCountBytesMainBins()));
+         // BoosterCore::Create already checked that this multiplication does not overflow
+         m_aBoostingMainBins = static_cast<BinBase *>(AlignedAlloc(
+            m_pBoosterCore->GetCountBytesMainBins() * m_pBoosterCore->GetCountMainBinsBags()));
          if(nullptr == m_aBoostingMainBins) {
             goto failed_allocation;
          }
       }
 
       if(IsMulticlass(cClasses)) {
-         size_t cBytesMulticlassMidwayMax = 0;
-         if(0 != GetBoosterCore()->GetTrainingSet()->GetCountSamples()) {
-            DataSubsetBoosting * pSubset = GetBoosterCore()->GetTrainingSet()->GetSubsets();
-            const DataSubsetBoosting * const pSubsetsEnd = pSubset + GetBoosterCore()->GetTrainingSet()->GetCountSubsets();
-            do {
-               const size_t cSIMDPack = pSubset->GetObjectiveWrapper()->m_cSIMDPack;
-               const size_t cFloatBytes = pSubset->GetObjectiveWrapper()->m_cFloatBytes;
-               const size_t cMultiple = cFloatBytes * cSIMDPack;
-               if(IsMultiplyError(cMultiple, cScores)) {
-                  goto failed_allocation;
-               }
-               const size_t cBytesMulticlassMidway = cMultiple * cScores;
-               cBytesMulticlassMidwayMax = EbmMax(cBytesMulticlassMidwayMax, cBytesMulticlassMidway);
-
-               ++pSubset;
-            } while(pSubsetsEnd != pSubset);
-         }
-
-         if(0 != GetBoosterCore()->GetValidationSet()->GetCountSamples()) {
-            DataSubsetBoosting * pSubset = GetBoosterCore()->GetValidationSet()->GetSubsets();
-            const DataSubsetBoosting * const pSubsetsEnd = pSubset + GetBoosterCore()->GetValidationSet()->GetCountSubsets();
-            do {
-               const size_t cSIMDPack = pSubset->GetObjectiveWrapper()->m_cSIMDPack;
-               const size_t cFloatBytes = pSubset->GetObjectiveWrapper()->m_cFloatBytes;
-               const size_t cMultiple = cFloatBytes * cSIMDPack;
-               if(IsMultiplyError(cMultiple, cScores)) {
-                  goto failed_allocation;
-               }
-               const size_t cBytesMulticlassMidway = cMultiple * cScores;
-               cBytesMulticlassMidwayMax = EbmMax(cBytesMulticlassMidwayMax, cBytesMulticlassMidway);
-
-               ++pSubset;
-            } while(pSubsetsEnd != pSubset);
+         size_t cBytesMulticlassMidwayMax;
+         if(CountBytesMulticlassMidway(m_pBoosterCore, cScores, &cBytesMulticlassMidwayMax)) {
+            goto failed_allocation;
          }
 
          // if there are zero samples, cFloatBytesMax will be zero
          if(0 != cBytesMulticlassMidwayMax) {
-            m_aMulticlassMidwayTemp = AlignedAlloc(cBytesMulticlassMidwayMax);
+            m_cBytesMulticlassMidwayTemp = cBytesMulticlassMidwayMax;
+            // CountBytesMulticlassMidway already checked that this multiplication does not overflow
+            m_aMulticlassMidwayTemp = AlignedAlloc(cBytesMulticlassMidwayMax * m_pBoosterCore->GetCountThreads());
             if(nullptr == m_aMulticlassMidwayTemp) {
                goto failed_allocation;
             }
          }
       }
 
+      const size_t cValidationSubsets = m_pBoosterCore->GetValidationSet()->GetCountSubsets();
+      if(0 != cValidationSubsets) {
+         if(IsMultiplyError(sizeof(double), cValidationSubsets)) {
+            goto failed_allocation;
+         }
+         m_aValidationMetricsTemp = static_cast<double *>(malloc(sizeof(double) * cValidationSubsets));
+         if(nullptr == m_aValidationMetricsTemp) {
+            goto failed_allocation;
+         }
+      }
+
       if(0 != m_pBoosterCore->GetCountBytesSplitPositions()) {
          m_aSplitPositionsTemp = AlignedAlloc(m_pBoosterCore->GetCountBytesSplitPositions());
          if(nullptr == m_aSplitPositionsTemp) {
@@ -161,6 +197,32 @@ ErrorEbm BoosterShell::FillAllocations() {
          if(nullptr == m_aTreeNodesTemp) {
             goto failed_allocation;
          }
+
+         // single dimensional partitioning keeps a heap of at most one pointer per tree node
+         EBM_ASSERT(!IsOverflowTreeNodeSize(m_pBoosterCore->IsHessian(), cScores));
+         const size_t cTreeNodes = m_pBoosterCore->GetCountBytesTreeNodes() / 
+            GetTreeNodeSize(m_pBoosterCore->IsHessian(), cScores);
+         if(IsMultiplyError(sizeof(void *), cTreeNodes)) {
+            goto failed_allocation;
+         }
+         if(Error_None != m_scratchArena.Reserve(sizeof(void *) * cTreeNodes)) {
+            goto failed_allocation;
+         }
+      }
+
+      // the term updates grow to hold the largest term, so size them for it now instead of during boosting
+      size_t cTensorBinsMax = 1;
+      for(size_t iTerm = 0; iTerm < m_pBoosterCore->GetCountTerms(); ++iTerm) {
+         cTensorBinsMax = EbmMax(cTensorBinsMax, m_pBoosterCore->GetTerms()[iTerm]->GetCountTensorBins());
+      }
+      if(IsMultiplyError(cScores, cTensorBinsMax)) {
+         goto failed_allocation;
+      }
+      if(Error_None != m_pTermUpdate->EnsureTensorScoreCapacity(cScores * cTensorBinsMax)) {
+         goto failed_allocation;
+      }
+      if(Error_None != m_pInnerTermUpdate->EnsureTensorScoreCapacity(cScores * cTensorBinsMax)) {
+         goto failed_allocation;
       }
    }
 
@@ -172,6 +234,121 @@ failed_allocation:;
    return Error_OutOfMemory;
 }
 
+ErrorEbm BoosterShell::MeasureAllocations(BoosterCore * const pBoosterCore, size_t * const pcBytesInOut) {
+   EBM_ASSERT(nullptr != pBoosterCore);
+   EBM_ASSERT(nullptr != pcBytesInOut);
+
+   LOG_0(Trace_Info, "Entered BoosterShell::MeasureAllocations");
+
+   // this mirrors FillAllocations, except that the term update tensors are sized for the largest term
+   // since they grow to hold each update
+   size_t cBytes = sizeof(BoosterShell);
+   const ptrdiff_t cClasses = pBoosterCore->GetCountClasses();
+   if(ptrdiff_t { 0 } != cClasses && ptrdiff_t { 1 } != cClasses) {
+      const size_t cScores = GetCountScores(cClasses);
+
+      size_t cTensorBinsMax = 1;
+      for(size_t iTerm = 0; iTerm < pBoosterCore->GetCountTerms(); ++iTerm) {
+         cTensorBinsMax = EbmMax(cTensorBinsMax, pBoosterCore->GetTerms()[iTerm]->GetCountTensorBins());
+      }
+      if(IsMultiplyError(sizeof(FloatScore) * 2, cScores, cTensorBinsMax)) {
+         goto overflow;
+      }
+      cBytes += sizeof(FloatScore) * 2 * cScores * cTensorBinsMax;
+
+      size_t cBytesMulticlassMidway = 0;
+      if(IsMulticlass(cClasses)) {
+         if(CountBytesMulticlassMidway(pBoosterCore, cScores, &cBytesMulticlassMidway)) {
+            goto overflow;
+         }
+      }
+
+      // BoosterCore::Create already checked that the fast and main bin multiplications do not overflow
+      const size_t acBytes[] = {
+         pBoosterCore->GetCountBytesFastBins() * pBoosterCore->GetCountFastBinsThreads(),
+         pBoosterCore->GetCountBytesMainBins() * pBoosterCore->GetCountMainBinsBags(),
+         cBytesMulticlassMidway * pBoosterCore->GetCountThreads(),
+         sizeof(double) * pBoosterCore->GetValidationSet()->GetCountSubsets(),
+         pBoosterCore->GetCountBytesSplitPositions(),
+         pBoosterCore->GetCountBytesTreeNodes()
+      };
+      for(const size_t cBytesAllocation : acBytes) {
+         if(IsAddError(cBytes, cBytesAllocation)) {
+            goto overflow;
+         }
+         cBytes += cBytesAllocation;
+      }
+   }
+
+   if(IsAddError(*pcBytesInOut, cBytes)) {
+      goto overflow;
+   }
+   *pcBytesInOut += cBytes;
+
+   LOG_0(Trace_Info, "Exited BoosterShell::MeasureAllocations");
+   return Error_None;
+
+overflow:;
+   LOG_0(Trace_Warning, "WARNING Exited BoosterShell::MeasureAllocations with overflow");
+   return Error_OutOfMemory;
+}
+
+// takes ownership of pBoosterCore, and on success writes the handle of the new booster to boosterHandleOut
+static ErrorEbm InitializeBooster(
+   BoosterCore * const pBoosterCore,
+   const unsigned char * const pDataSetShared,
+   const BagEbm * const aBagTraining,
+   const BagEbm * const aBagValidation,
+   const double * const aInitScores,
+   BoosterHandle * const boosterHandleOut
+) {
+   ErrorEbm error;
+
+   BoosterShell * const pBoosterShell = BoosterShell::Create(pBoosterCore);
+   if(UNLIKELY(nullptr == pBoosterShell)) {
+      // if the memory allocation for pBoosterShell failed then there was no place to put the pBoosterCore, so free it
+      BoosterCore::Free(pBoosterCore);
+      return Error_OutOfMemory;
+   }
+
+   error = pBoosterShell->FillAllocations();
+   if(Error_None != error) {
+      BoosterShell::Free(pBoosterShell);
+      return error;
+   }
+
+   if(ptrdiff_t { 0 } != pBoosterCore->GetCountClasses() && ptrdiff_t { 1 } != pBoosterCore->GetCountClasses()) {
+      if(!pBoosterCore->IsRmse()) {
+         error = pBoosterCore->InitializeBoosterGradientsAndHessians(
+            pBoosterShell->GetMulticlassMidwayTemp(),
+            pBoosterShell->GetTermUpdate()->GetTensorScoresPointer() // initialized to zero at this point
+         );
+         if(UNLIKELY(Error_None != error)) {
+            BoosterShell::Free(pBoosterShell);
+            return error;
+         }
+      } else {
+         InitializeRmseGradientsAndHessiansBoosting(
+            pDataSetShared,
+            BagEbm { 1 },
+            aBagTraining,
+            aInitScores,
+            pBoosterCore->GetTrainingSet()
+         );
+         InitializeRmseGradientsAndHessiansBoosting(
+            pDataSetShared,
+            BagEbm { -1 },
+            aBagValidation,
+            aInitScores,
+            pBoosterCore->GetValidationSet()
+         );
+      }
+   }
+
+   *boosterHandleOut = pBoosterShell->GetHandle();
+   return Error_None;
+}
+
 EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
    void * rng,
    const void * dataSet,
@@ -184,6 +361,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
    CreateBoosterFlags flags,
    const char * objective,
    const double * experimentalParams,
+   ThreadPoolHandle threadPool,
    BoosterHandle * boosterHandleOut
 ) {
    LOG_N(
@@ -200,6 +378,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
       "flags=0x%" UCreateBoosterFlagsPrintf ", "
       "objective=%p, "
       "experimentalParams=%p, "
+      "threadPool=%p, "
       "boosterHandleOut=%p"
       ,
       rng,
@@ -213,6 +392,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
       static_cast<UCreateBoosterFlags>(flags), // signed to unsigned conversion is defined behavior in C++
       static_cast<const void *>(objective), // do not print the string for security reasons
       static_cast<const void *>(experimentalParams),
+      static_cast<void *>(threadPool),
       static_cast<const void *>(boosterHandleOut)
    );
 
@@ -225,7 +405,11 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
    *boosterHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
 
    if(0 != (static_cast<UCreateBoosterFlags>(flags) & static_cast<UCreateBoosterFlags>(~(
-      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_DifferentialPrivacy)
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_DifferentialPrivacy) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_DisableSIMD) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_DoublePrecisionSIMD) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_CompactInnerBags) |
+      static_cast<UCreateBoosterFlags>(CreateBoosterFlags_SortByTarget)
    )))) {
       LOG_0(Trace_Error, "ERROR CreateBooster flags contains unknown flags. Ignoring extras.");
    }
@@ -257,6 +441,15 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
    }
    const size_t cInnerBags = static_cast<size_t>(countInnerBags);
 
+   ThreadPool * pThreadPool = nullptr;
+   if(nullptr != threadPool) {
+      pThreadPool = ThreadPool::GetThreadPoolFromHandle(threadPool);
+      if(nullptr == pThreadPool) {
+         // already logged
+         return Error_IllegalParamVal;
+      }
+   }
+
    // TODO: since BoosterCore is a non-POD C++ class, we should probably move the call to new from inside
    //       BoosterCore::Create to here and wrap it with a try catch at this level and rely on standard C++ behavior
    BoosterCore * pBoosterCore = nullptr;
@@ -272,6 +465,11 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
       initScores,
       flags,
       objective,
+      pThreadPool,
+      nullptr,
+      nullptr,
+      false,
+      nullptr,
       &pBoosterCore
    );
    if(UNLIKELY(Error_None != error)) {
@@ -279,52 +477,513 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
       return error;
    }
 
-   BoosterShell * const pBoosterShell = BoosterShell::Create(pBoosterCore);
-   if(UNLIKELY(nullptr == pBoosterShell)) {
-      // if the memory allocation for pBoosterShell failed then there was no place to put the pBoosterCore, so free it
-      BoosterCore::Free(pBoosterCore);
+   error = InitializeBooster(pBoosterCore, static_cast<const unsigned char *>(dataSet), bag, bag, initScores, boosterHandleOut);
+   if(Error_None != error) {
+      return error;
+   }
+
+   LOG_N(Trace_Info, "Exited CreateBooster: *boosterHandleOut=%p", static_cast<void *>(*boosterHandleOut));
+   return Error_None;
+}
+
+static ErrorEbm MeasureBoosterFlags(
+   const unsigned char * const pDataSetShared,
+   const BagEbm * const aBag,
+   const size_t cTerms,
+   const IntEbm * const acTermDimensions,
+   const IntEbm * const aiTermFeatures,
+   const size_t cInnerBags,
+   const CreateBoosterFlags flags,
+   const char * const sObjective,
+   const double * const experimentalParams,
+   ThreadPool * const pThreadPool,
+   size_t * const pcBytesOut
+) {
+   size_t cBytes = 0;
+   size_t cBytesPeak = 0;
+   BoosterCore * pBoosterCore = nullptr;
+   ErrorEbm error = BoosterCore::Create(
+      nullptr,
+      cTerms,
+      cInnerBags,
+      experimentalParams,
+      acTermDimensions,
+      aiTermFeatures,
+      pDataSetShared,
+      aBag,
+      nullptr,
+      flags,
+      sObjective,
+      pThreadPool,
+      &cBytes,
+      &cBytesPeak,
+      false,
+      nullptr,
+      &pBoosterCore
+   );
+   if(Error_None == error) {
+      error = BoosterShell::MeasureAllocations(pBoosterCore, &cBytes);
+   }
+   BoosterCore::Free(pBoosterCore); // legal if nullptr
+   // the peak is either while a dataset is being built with its sort indexes, or once everything has been allocated
+   *pcBytesOut = EbmMax(cBytes, cBytesPeak);
+   return error;
+}
+
+EBM_API_BODY IntEbm EBM_CALLING_CONVENTION MeasureBooster(
+   const void * dataSet,
+   const BagEbm * bag,
+   IntEbm countTerms,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   IntEbm countInnerBags,
+   CreateBoosterFlags flags,
+   const char * objective,
+   const double * experimentalParams,
+   ThreadPoolHandle threadPool,
+   IntEbm maxBytes,
+   CreateBoosterFlags * flagsOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered MeasureBooster: "
+      "dataSet=%p, "
+      "bag=%p, "
+      "countTerms=%" IntEbmPrintf ", "
+      "dimensionCounts=%p, "
+      "featureIndexes=%p, "
+      "countInnerBags=%" IntEbmPrintf ", "
+      "flags=0x%" UCreateBoosterFlagsPrintf ", "
+      "objective=%p, "
+      "experimentalParams=%p, "
+      "threadPool=%p, "
+      "maxBytes=%" IntEbmPrintf ", "
+      "flagsOut=%p"
+      ,
+      dataSet,
+      static_cast<const void *>(bag),
+      countTerms,
+      static_cast<const void *>(dimensionCounts),
+      static_cast<const void *>(featureIndexes),
+      countInnerBags,
+      static_cast<UCreateBoosterFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      static_cast<const void *>(objective), // do not print the string for security reasons
+      static_cast<const void *>(experimentalParams),
+      static_cast<void *>(threadPool),
+      maxBytes,
+      static_cast<const void *>(flagsOut)
+   );
+
+   if(nullptr != flagsOut) {
+      *flagsOut = flags;
+   }
+
+   if(nullptr == dataSet) {
+      LOG_0(Trace_Error, "ERROR MeasureBooster nullptr == dataSet");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsConvertError<size_t>(countTerms)) {
+      LOG_0(Trace_Error, "ERROR MeasureBooster IsConvertError<size_t>(countTerms)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+
+   if(nullptr == dimensionCounts && size_t { 0 } != cTerms) {
+      LOG_0(Trace_Error, "ERROR MeasureBooster dimensionCounts cannot be null if 0 < countTerms");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsConvertError<size_t>(countInnerBags)) {
+      LOG_0(Trace_Warning, "WARNING MeasureBooster IsConvertError<size_t>(countInnerBags)");
       return Error_OutOfMemory;
    }
+   const size_t cInnerBags = static_cast<size_t>(countInnerBags);
 
-   error = pBoosterShell->FillAllocations();
+   if(maxBytes < IntEbm { 0 }) {
+      LOG_0(Trace_Error, "ERROR MeasureBooster maxBytes cannot be negative");
+      return Error_IllegalParamVal;
+   }
+
+   ThreadPool * pThreadPool = nullptr;
+   if(nullptr != threadPool) {
+      pThreadPool = ThreadPool::GetThreadPoolFromHandle(threadPool);
+      if(nullptr == pThreadPool) {
+         // already logged
+         return Error_IllegalParamVal;
+      }
+   }
+
+   // Each step gives up a little speed or precision for memory: bags that share their weights, the float32 
+   // SIMD zone, and finally the temporary sort indexes.
+   CreateBoosterFlags aFlagsTry[4];
+   size_t cFlagsTry = 1;
+   aFlagsTry[0] = flags;
+   if(IntEbm { 0 } != maxBytes && nullptr != flagsOut) {
+      if(size_t { 0 } != cInnerBags) {
+         aFlagsTry[cFlagsTry] = aFlagsTry[cFlagsTry - 1] | CreateBoosterFlags_CompactInnerBags;
+         ++cFlagsTry;
+      }
+      aFlagsTry[cFlagsTry] = aFlagsTry[cFlagsTry - 1] & ~CreateBoosterFlags_DoublePrecisionSIMD;
+      ++cFlagsTry;
+      aFlagsTry[cFlagsTry] = aFlagsTry[cFlagsTry - 1] & ~CreateBoosterFlags_SortByTarget;
+      ++cFlagsTry;
+   }
+
+   size_t cBytes = 0;
+   CreateBoosterFlags flagsChosen = flags;
+   for(size_t iFlagsTry = 0; iFlagsTry < cFlagsTry; ++iFlagsTry) {
+      const CreateBoosterFlags flagsTry = aFlagsTry[iFlagsTry];
+      if(0 != iFlagsTry && flagsTry == flagsChosen) {
+         // this step does not apply to the caller's options
+         continue;
+      }
+      const ErrorEbm error = MeasureBoosterFlags(
+         static_cast<const unsigned char *>(dataSet),
+         bag,
+         cTerms,
+         dimensionCounts,
+         featureIndexes,
+         cInnerBags,
+         flagsTry,
+         objective,
+         experimentalParams,
+         pThreadPool,
+         &cBytes
+      );
+      if(Error_None != error) {
+         return error;
+      }
+      flagsChosen = flagsTry;
+      if(IntEbm { 0 } == maxBytes || !IsConvertError<IntEbm>(cBytes) && static_cast<size_t>(maxBytes) >= cBytes) {
+         break;
+      }
+   }
+
+   if(IsConvertError<IntEbm>(cBytes)) {
+      LOG_0(Trace_Warning, "WARNING MeasureBooster IsConvertError<IntEbm>(cBytes)");
+      return Error_OutOfMemory;
+   }
+
+   if(nullptr != flagsOut) {
+      *flagsOut = flagsChosen;
+   }
+
+   LOG_N(Trace_Info, "Exited MeasureBooster: %zu bytes", cBytes);
+   return static_cast<IntEbm>(cBytes);
+}
+
+void PreparedDataSet::Free(PreparedDataSet * const pPreparedDataSet) {
+   LOG_0(Trace_Info, "Entered PreparedDataSet::Free");
+
+   if(nullptr != pPreparedDataSet) {
+      // any boosters created from the prepared dataset keep its BoosterCore alive until they are freed
+      BoosterCore::Free(pPreparedDataSet->m_pBoosterCore);
+      free(pPreparedDataSet->m_acTermDimensions);
+      free(pPreparedDataSet->m_aiTermFeatures);
+      free(pPreparedDataSet->m_sObjective);
+
+      // before we free our memory, indicate it was freed so if our higher level language attempts to use it we have
+      // a chance to detect the error
+      pPreparedDataSet->m_handleVerification = k_handleVerificationFreed;
+      free(pPreparedDataSet);
+   }
+
+   LOG_0(Trace_Info, "Exited PreparedDataSet::Free");
+}
+
+ErrorEbm PreparedDataSet::Create(
+   const unsigned char * const pDataSetShared,
+   const size_t cTerms,
+   const IntEbm * const acTermDimensions,
+   const IntEbm * const aiTermFeatures,
+   const CreateBoosterFlags flags,
+   const char * const sObjective,
+   PreparedDataSet ** const ppPreparedDataSetOut
+) {
+   LOG_0(Trace_Info, "Entered PreparedDataSet::Create");
+
+   EBM_ASSERT(nullptr != pDataSetShared);
+   EBM_ASSERT(nullptr != ppPreparedDataSetOut);
+   EBM_ASSERT(nullptr == *ppPreparedDataSetOut);
+
+   PreparedDataSet * const pNew = static_cast<PreparedDataSet *>(malloc(sizeof(PreparedDataSet)));
+   if(UNLIKELY(nullptr == pNew)) {
+      LOG_0(Trace_Warning, "WARNING PreparedDataSet::Create nullptr == pNew");
+      return Error_OutOfMemory;
+   }
+   pNew->m_handleVerification = k_handleVerificationOk;
+   pNew->m_pBoosterCore = nullptr;
+   pNew->m_pDataSetShared = pDataSetShared;
+   pNew->m_cTerms = cTerms;
+   pNew->m_acTermDimensions = nullptr;
+   pNew->m_aiTermFeatures = nullptr;
+   pNew->m_sObjective = nullptr;
+   pNew->m_flags = flags;
+   // give ownership of our object back to the caller, even if there is a failure
+   *ppPreparedDataSetOut = pNew;
+
+   // the caller only needs to keep the dataset alive, so keep our own copies of the term definitions
+   size_t cTermFeatures = 0;
+   if(size_t { 0 } != cTerms) {
+      if(IsMultiplyError(sizeof(IntEbm), cTerms)) {
+         LOG_0(Trace_Warning, "WARNING PreparedDataSet::Create IsMultiplyError(sizeof(IntEbm), cTerms)");
+         return Error_OutOfMemory;
+      }
+      IntEbm * const acTermDimensionsCopy = static_cast<IntEbm *>(malloc(sizeof(IntEbm) * cTerms));
+      if(nullptr == acTermDimensionsCopy) {
+         LOG_0(Trace_Warning, "WARNING PreparedDataSet::Create nullptr == acTermDimensionsCopy");
+         return Error_OutOfMemory;
+      }
+      pNew->m_acTermDimensions = acTermDimensionsCopy;
+      memcpy(acTermDimensionsCopy, acTermDimensions, sizeof(IntEbm) * cTerms);
+
+      for(size_t iTerm = 0; iTerm < cTerms; ++iTerm) {
+         const IntEbm countDimensions = acTermDimensions[iTerm];
+         if(countDimensions < IntEbm { 0 } || IntEbm { k_cDimensionsMax } < countDimensions) {
+            // BoosterCore::Create reports the specific problem
+            cTermFeatures = 0;
+            break;
+         }
+         cTermFeatures += static_cast<size_t>(countDimensions);
+      }
+   }
+   if(size_t { 0 } != cTermFeatures && nullptr != aiTermFeatures) {
+      if(IsMultiplyError(sizeof(IntEbm), cTermFeatures)) {
+         LOG_0(Trace_Warning, "WARNING PreparedDataSet::Create IsMultiplyError(sizeof(IntEbm), cTermFeatures)");
+         return Error_OutOfMemory;
+      }
+      IntEbm * const aiTermFeaturesCopy = static_cast<IntEbm *>(malloc(sizeof(IntEbm) * cTermFeatures));
+      if(nullptr == aiTermFeaturesCopy) {
+         LOG_0(Trace_Warning, "WARNING PreparedDataSet::Create nullptr == aiTermFeaturesCopy");
+         return Error_OutOfMemory;
+      }
+      pNew->m_aiTermFeatures = aiTermFeaturesCopy;
+      memcpy(aiTermFeaturesCopy, aiTermFeatures, sizeof(IntEbm) * cTermFeatures);
+   }
+
+   if(nullptr != sObjective) {
+      const size_t cBytesObjective = strlen(sObjective) + size_t { 1 };
+      char * const sObjectiveCopy = static_cast<char *>(malloc(cBytesObjective));
+      if(nullptr == sObjectiveCopy) {
+         LOG_0(Trace_Warning, "WARNING PreparedDataSet::Create nullptr == sObjectiveCopy");
+         return Error_OutOfMemory;
+      }
+      pNew->m_sObjective = sObjectiveCopy;
+      memcpy(sObjectiveCopy, sObjective, cBytesObjective);
+   }
+
+   const ErrorEbm error = BoosterCore::Create(
+      nullptr,
+      cTerms,
+      0,
+      nullptr,
+      pNew->m_acTermDimensions,
+      pNew->m_aiTermFeatures,
+      pDataSetShared,
+      nullptr,
+      nullptr,
+      flags,
+      pNew->m_sObjective,
+      nullptr,
+      nullptr,
+      nullptr,
+      true,
+      nullptr,
+      &pNew->m_pBoosterCore
+   );
    if(Error_None != error) {
-      BoosterShell::Free(pBoosterShell);
       return error;
    }
 
-   if(ptrdiff_t { 0 } != pBoosterCore->GetCountClasses() && ptrdiff_t { 1 } != pBoosterCore->GetCountClasses()) {
-      if(!pBoosterCore->IsRmse()) {
-         error = pBoosterCore->InitializeBoosterGradientsAndHessians(
-            pBoosterShell->GetMulticlassMidwayTemp(),
-            pBoosterShell->GetTermUpdate()->GetTensorScoresPointer() // initialized to zero at this point
-         );
-         if(UNLIKELY(Error_None != error)) {
-            BoosterShell::Free(pBoosterShell);
-            return error;
-         }
-      } else {
-         InitializeRmseGradientsAndHessiansBoosting(
-            static_cast<const unsigned char *>(dataSet),
-            BagEbm { 1 },
-            bag,
-            initScores,
-            pBoosterCore->GetTrainingSet()
-         );
-         InitializeRmseGradientsAndHessiansBoosting(
-            static_cast<const unsigned char *>(dataSet),
-            BagEbm { -1 },
-            bag,
-            initScores,
-            pBoosterCore->GetValidationSet()
-         );
+   LOG_0(Trace_Info, "Exited PreparedDataSet::Create");
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreatePreparedDataSet(
+   const void * dataSet,
+   IntEbm countTerms,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   CreateBoosterFlags flags,
+   const char * objective,
+   PreparedDataSetHandle * preparedDataSetHandleOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered CreatePreparedDataSet: "
+      "dataSet=%p, "
+      "countTerms=%" IntEbmPrintf ", "
+      "dimensionCounts=%p, "
+      "featureIndexes=%p, "
+      "flags=0x%" UCreateBoosterFlagsPrintf ", "
+      "objective=%p, "
+      "preparedDataSetHandleOut=%p"
+      ,
+      dataSet,
+      countTerms,
+      static_cast<const void *>(dimensionCounts),
+      static_cast<const void *>(featureIndexes),
+      static_cast<UCreateBoosterFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      static_cast<const void *>(objective), // do not print the string for security reasons
+      static_cast<const void *>(preparedDataSetHandleOut)
+   );
+
+   if(nullptr == preparedDataSetHandleOut) {
+      LOG_0(Trace_Error, "ERROR CreatePreparedDataSet nullptr == preparedDataSetHandleOut");
+      return Error_IllegalParamVal;
+   }
+   *preparedDataSetHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
+
+   if(nullptr == dataSet) {
+      LOG_0(Trace_Error, "ERROR CreatePreparedDataSet nullptr == dataSet");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsConvertError<size_t>(countTerms)) {
+      // the caller should not have been able to allocate memory for dimensionCounts if this wasn't fittable in size_t
+      LOG_0(Trace_Error, "ERROR CreatePreparedDataSet IsConvertError<size_t>(countTerms)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cTerms = static_cast<size_t>(countTerms);
+
+   if(nullptr == dimensionCounts && size_t { 0 } != cTerms) {
+      LOG_0(Trace_Error, "ERROR CreatePreparedDataSet dimensionCounts cannot be null if 0 < countTerms");
+      return Error_IllegalParamVal;
+   }
+
+   PreparedDataSet * pPreparedDataSet = nullptr;
+   const ErrorEbm error = PreparedDataSet::Create(
+      static_cast<const unsigned char *>(dataSet),
+      cTerms,
+      dimensionCounts,
+      featureIndexes,
+      flags,
+      objective,
+      &pPreparedDataSet
+   );
+   if(Error_None != error) {
+      PreparedDataSet::Free(pPreparedDataSet); // legal if nullptr
+      return error;
+   }
+
+   const PreparedDataSetHandle handle = pPreparedDataSet->GetHandle();
+
+   LOG_N(Trace_Info, "Exited CreatePreparedDataSet: *preparedDataSetHandleOut=%p", static_cast<void *>(handle));
+
+   *preparedDataSetHandleOut = handle;
+   return Error_None;
+}
+
+EBM_API_BODY void EBM_CALLING_CONVENTION FreePreparedDataSet(
+   PreparedDataSetHandle preparedDataSetHandle
+) {
+   LOG_N(Trace_Info, "Entered FreePreparedDataSet: preparedDataSetHandle=%p", static_cast<void *>(preparedDataSetHandle));
+
+   PreparedDataSet * const pPreparedDataSet = PreparedDataSet::GetPreparedDataSetFromHandle(preparedDataSetHandle);
+   // if the conversion above doesn't work, it'll return null, and our free will not in fact free any memory,
+   // but it will not crash. We'll leak memory, but at least we'll log that.
+
+   PreparedDataSet::Free(pPreparedDataSet);
+
+   LOG_0(Trace_Info, "Exited FreePreparedDataSet");
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateBoosterPrepared(
+   void * rng,
+   PreparedDataSetHandle preparedDataSet,
+   const BagEbm * bag,
+   const double * initScores,
+   IntEbm countInnerBags,
+   CreateBoosterFlags flags,
+   ThreadPoolHandle threadPool,
+   BoosterHandle * boosterHandleOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered CreateBoosterPrepared: "
+      "rng=%p, "
+      "preparedDataSet=%p, "
+      "bag=%p, "
+      "initScores=%p, "
+      "countInnerBags=%" IntEbmPrintf ", "
+      "flags=0x%" UCreateBoosterFlagsPrintf ", "
+      "threadPool=%p, "
+      "boosterHandleOut=%p"
+      ,
+      rng,
+      static_cast<void *>(preparedDataSet),
+      static_cast<const void *>(bag),
+      static_cast<const void *>(initScores),
+      countInnerBags,
+      static_cast<UCreateBoosterFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      static_cast<void *>(threadPool),
+      static_cast<const void *>(boosterHandleOut)
+   );
+
+   ErrorEbm error;
+
+   if(nullptr == boosterHandleOut) {
+      LOG_0(Trace_Error, "ERROR CreateBoosterPrepared nullptr == boosterHandleOut");
+      return Error_IllegalParamVal;
+   }
+   *boosterHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
+
+   PreparedDataSet * const pPreparedDataSet = PreparedDataSet::GetPreparedDataSetFromHandle(preparedDataSet);
+   if(nullptr == pPreparedDataSet) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   if(IsConvertError<size_t>(countInnerBags)) {
+      // this is just a warning since the caller doesn't pass us anything material, but if it's this high
+      // then our allocation would fail since it can't even in pricipal fit into memory
+      LOG_0(Trace_Warning, "WARNING CreateBoosterPrepared IsConvertError<size_t>(countInnerBags)");
+      return Error_OutOfMemory;
+   }
+   const size_t cInnerBags = static_cast<size_t>(countInnerBags);
+
+   ThreadPool * pThreadPool = nullptr;
+   if(nullptr != threadPool) {
+      pThreadPool = ThreadPool::GetThreadPoolFromHandle(threadPool);
+      if(nullptr == pThreadPool) {
+         // already logged
+         return Error_IllegalParamVal;
       }
    }
 
-   const BoosterHandle handle = pBoosterShell->GetHandle();
+   BoosterCore * pBoosterCore = nullptr;
+   error = BoosterCore::Create(
+      rng,
+      pPreparedDataSet->GetCountTerms(),
+      cInnerBags,
+      nullptr,
+      pPreparedDataSet->GetTermDimensions(),
+      pPreparedDataSet->GetTermFeatures(),
+      pPreparedDataSet->GetDataSetShared(),
+      bag,
+      initScores,
+      flags,
+      pPreparedDataSet->GetObjective(),
+      pThreadPool,
+      nullptr,
+      nullptr,
+      false,
+      pPreparedDataSet->GetBoosterCore(),
+      &pBoosterCore
+   );
+   if(UNLIKELY(Error_None != error)) {
+      BoosterCore::Free(pBoosterCore); // legal if nullptr.  On error we can get back a legal pBoosterCore to delete
+      return error;
+   }
 
-   LOG_N(Trace_Info, "Exited CreateBooster: *boosterHandleOut=%p", static_cast<void *>(handle));
+   // the training set holds every shared sample in order, so its RMSE gradients are initialized without the bag
+   error = InitializeBooster(pBoosterCore, pPreparedDataSet->GetDataSetShared(), nullptr, bag, initScores, boosterHandleOut);
+   if(Error_None != error) {
+      return error;
+   }
 
-   *boosterHandleOut = handle;
+   LOG_N(Trace_Info, "Exited CreateBoosterPrepared: *boosterHandleOut=%p", static_cast<void *>(*boosterHandleOut));
    return Error_None;
 }
 
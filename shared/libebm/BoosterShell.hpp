@@ -13,6 +13,8 @@
 #include "common_c.h"
 #include "zones.h"
 
+#include "ScratchArena.hpp"
+
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
 #error DEFINED_ZONE_NAME must be defined
@@ -46,10 +48,18 @@ class BoosterShell final {
 
    // TODO: I think this can share memory with m_aBoostingFastBinsTemp since the GradientPair always contains a FLOAT, and it always contains enough for the multiclass scores in the first bin, and we always have at least 1 bin, right?
    void * m_aMulticlassMidwayTemp;
+   size_t m_cBytesMulticlassMidwayTemp;
+
+   // one metric per validation subset so that the metrics can be summed in a fixed order when multithreaded
+   double * m_aValidationMetricsTemp;
 
    void * m_aTreeNodesTemp;
    void * m_aSplitPositionsTemp;
 
+   // scratch memory whose size depends on the term being boosted. It is rewound at the start of each
+   // GenerateTermUpdate call and only grows when a term needs more than any term before it
+   ScratchArena m_scratchArena;
+
 #ifndef NDEBUG
    const BinBase * m_pDebugMainBinsEnd;
 #endif // NDEBUG
@@ -72,13 +82,17 @@ public:
       m_aBoostingFastBinsTemp = nullptr;
       m_aBoostingMainBins = nullptr;
       m_aMulticlassMidwayTemp = nullptr;
+      m_cBytesMulticlassMidwayTemp = 0;
+      m_aValidationMetricsTemp = nullptr;
       m_aTreeNodesTemp = nullptr;
       m_aSplitPositionsTemp = nullptr;
+      m_scratchArena.InitializeUnfailing();
    }
 
    static void Free(BoosterShell * const pBoosterShell);
    static BoosterShell * Create(BoosterCore * const pBoosterCore);
    ErrorEbm FillAllocations();
+   static ErrorEbm MeasureAllocations(BoosterCore * const pBoosterCore, size_t * const pcBytesInOut);
 
    INLINE_ALWAYS static BoosterShell * GetBoosterShellFromHandle(const BoosterHandle boosterHandle) {
       if(nullptr == boosterHandle) {
@@ -135,6 +149,15 @@ public:
       return m_aMulticlassMidwayTemp;
    }
 
+   INLINE_ALWAYS size_t GetCountBytesMulticlassMidwayTemp() const {
+      // the stride between each thread's MulticlassMidwayTemp
+      return m_cBytesMulticlassMidwayTemp;
+   }
+
+   INLINE_ALWAYS double * GetValidationMetricsTemp() {
+      return m_aValidationMetricsTemp;
+   }
+
    template<bool bHessian, size_t cCompilerScores = 1>
    INLINE_ALWAYS TreeNode<bHessian, cCompilerScores> * GetTreeNodesTemp() {
       return static_cast<TreeNode<bHessian, cCompilerScores> *>(m_aTreeNodesTemp);
@@ -145,6 +168,10 @@ public:
       return static_cast<SplitPosition<bHessian, cCompilerScores> *>(m_aSplitPositionsTemp);
    }
 
+   INLINE_ALWAYS ScratchArena * GetScratchArena() {
+      return &m_scratchArena;
+   }
+
 
 #ifndef NDEBUG
    INLINE_ALWAYS const BinBase * GetDebugMainBinsEnd() const {
@@ -163,6 +190,95 @@ static_assert(std::is_trivial<BoosterShell>::value,
 static_assert(std::is_pod<BoosterShell>::value,
    "We use a lot of C constructs, so disallow non-POD types in general");
 
+// A dataset whose term data has been extracted and packed once for every sample, so that the boosters of each 
+// outer bag can share it. We keep the arguments that define the terms so that the boosters are built identically.
+class PreparedDataSet final {
+   static constexpr size_t k_handleVerificationOk = 18541; // random 15 bit number
+   static constexpr size_t k_handleVerificationFreed = 6338; // random 15 bit number
+   size_t m_handleVerification; // this needs to be at the top and make it pointer sized to keep best alignment
+
+   BoosterCore * m_pBoosterCore;
+   const unsigned char * m_pDataSetShared;
+   size_t m_cTerms;
+   IntEbm * m_acTermDimensions;
+   IntEbm * m_aiTermFeatures;
+   char * m_sObjective;
+   CreateBoosterFlags m_flags;
+
+public:
+
+   PreparedDataSet() = default; // preserve our POD status
+   ~PreparedDataSet() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   static void Free(PreparedDataSet * const pPreparedDataSet);
+   static ErrorEbm Create(
+      const unsigned char * const pDataSetShared,
+      const size_t cTerms,
+      const IntEbm * const acTermDimensions,
+      const IntEbm * const aiTermFeatures,
+      const CreateBoosterFlags flags,
+      const char * const sObjective,
+      PreparedDataSet ** const ppPreparedDataSetOut
+   );
+
+   INLINE_ALWAYS static PreparedDataSet * GetPreparedDataSetFromHandle(const PreparedDataSetHandle preparedDataSetHandle) {
+      if(nullptr == preparedDataSetHandle) {
+         LOG_0(Trace_Error, "ERROR GetPreparedDataSetFromHandle null preparedDataSetHandle");
+         return nullptr;
+      }
+      PreparedDataSet * const pPreparedDataSet = reinterpret_cast<PreparedDataSet *>(preparedDataSetHandle);
+      if(k_handleVerificationOk == pPreparedDataSet->m_handleVerification) {
+         return pPreparedDataSet;
+      }
+      if(k_handleVerificationFreed == pPreparedDataSet->m_handleVerification) {
+         LOG_0(Trace_Error, "ERROR GetPreparedDataSetFromHandle attempt to use freed PreparedDataSetHandle");
+      } else {
+         LOG_0(Trace_Error, "ERROR GetPreparedDataSetFromHandle attempt to use invalid PreparedDataSetHandle");
+      }
+      return nullptr;
+   }
+   INLINE_ALWAYS PreparedDataSetHandle GetHandle() {
+      return reinterpret_cast<PreparedDataSetHandle>(this);
+   }
+
+   INLINE_ALWAYS BoosterCore * GetBoosterCore() {
+      EBM_ASSERT(nullptr != m_pBoosterCore);
+      return m_pBoosterCore;
+   }
+
+   INLINE_ALWAYS const unsigned char * GetDataSetShared() const {
+      return m_pDataSetShared;
+   }
+
+   INLINE_ALWAYS size_t GetCountTerms() const {
+      return m_cTerms;
+   }
+
+   INLINE_ALWAYS const IntEbm * GetTermDimensions() const {
+      return m_acTermDimensions;
+   }
+
+   INLINE_ALWAYS const IntEbm * GetTermFeatures() const {
+      return m_aiTermFeatures;
+   }
+
+   INLINE_ALWAYS const char * GetObjective() const {
+      return m_sObjective;
+   }
+
+   INLINE_ALWAYS CreateBoosterFlags GetFlags() const {
+      return m_flags;
+   }
+};
+static_assert(std::is_standard_layout<PreparedDataSet>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<PreparedDataSet>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<PreparedDataSet>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
 } // DEFINED_ZONE_NAME
 
 #endif // BOOSTER_SHELL_HPP
@@ -4,9 +4,12 @@
 
 #include "precompiled_header_cpp.hpp"
 
+#include <stdlib.h> // malloc, free
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
 #include <string.h> // memcpy
+#include <atomic>
+#include <algorithm> // std::sort, std::binary_search, std::push_heap, std::pop_heap
 
 #include "libebm.h" // ErrorEbm
 #include "logging.h" // EBM_ASSERT
@@ -18,6 +21,7 @@
 #include "ebm_internal.hpp" // k_cDimensionsMax
 #include "Feature.hpp"
 #include "DataSetInteraction.hpp"
+#include "ThreadPool.hpp"
 #include "InteractionCore.hpp"
 #include "InteractionShell.hpp"
 
@@ -30,6 +34,7 @@ extern void ConvertAddBin(
    const size_t cScores,
    const bool bHessian,
    const size_t cBins,
+   const bool bWeightSrc,
    const bool bUInt64Src,
    const bool bDoubleSrc,
    const void * const aSrc,
@@ -65,59 +70,96 @@ extern double PartitionTwoDimensionalInteraction(
 #endif // NDEBUG
 );
 
-// there is a race condition for decrementing this variable, but if a thread loses the 
-// race then it just doesn't get decremented as quickly, which we can live with
-static int g_cLogCalcInteractionStrength = 10;
+static constexpr size_t k_cAuxillaryBinsForSplitting = 4;
+
+struct BinSumsInteractionTask {
+   InteractionCore * m_pInteractionCore;
+   const IntEbm * m_aFeatureIndexes;
+   size_t m_cDimensions;
+   size_t m_cScores;
+   size_t m_cTensorBins;
+   const BinSumsInteractionBridge * m_pBinSumsPrototype;
+   DataSubsetInteraction * m_aSubsets;
+   size_t m_cBytesFastBinsStride;
+   BinBase * m_aFastBinsThreads;
+};
+
+static size_t GetFastBinSize(const DataSubsetInteraction * const pSubset, const bool bHessian, const size_t cScores) {
+   if(sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes) {
+      if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
+         return GetBinSize<FloatBig, UIntBig>(bHessian, cScores);
+      } else {
+         EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
+         return GetBinSize<FloatSmall, UIntBig>(bHessian, cScores);
+      }
+   } else {
+      EBM_ASSERT(sizeof(UIntSmall) == pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+      if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
+         return GetBinSize<FloatBig, UIntSmall>(bHessian, cScores);
+      } else {
+         EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
+         return GetBinSize<FloatSmall, UIntSmall>(bHessian, cScores);
+      }
+   }
+}
 
-EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
-   InteractionHandle interactionHandle,
-   IntEbm countDimensions,
-   const IntEbm * featureIndexes,
-   CalcInteractionFlags flags,
-   IntEbm maxCardinality,
-   IntEbm minSamplesLeaf,
-   double * avgInteractionStrengthOut
-) {
-   LOG_COUNTED_N(
-      &g_cLogCalcInteractionStrength,
-      Trace_Info,
-      Trace_Verbose,
-      "CalcInteractionStrength: "
-      "interactionHandle=%p, "
-      "countDimensions=%" IntEbmPrintf ", "
-      "featureIndexes=%p, "
-      "flags=0x%" UCalcInteractionFlagsPrintf ", "
-      "maxCardinality=%" IntEbmPrintf ", "
-      "minSamplesLeaf=%" IntEbmPrintf ", "
-      "avgInteractionStrengthOut=%p"
-      ,
-      static_cast<void *>(interactionHandle),
-      countDimensions,
-      static_cast<const void *>(featureIndexes),
-      static_cast<UCalcInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
-      maxCardinality,
-      minSamplesLeaf,
-      static_cast<void *>(avgInteractionStrengthOut)
-   );
+// bins the subset at index iTask (relative to m_aSubsets) into the fast bins at index iTask
+static ErrorEbm BinSumsInteractionSubset(void * const pContext, const size_t iTask) {
+   const BinSumsInteractionTask * const pTask = static_cast<const BinSumsInteractionTask *>(pContext);
+   InteractionCore * const pInteractionCore = pTask->m_pInteractionCore;
+   DataSubsetInteraction * const pSubset = &pTask->m_aSubsets[iTask];
+   BinBase * const aFastBins = IndexBin(pTask->m_aFastBinsThreads, pTask->m_cBytesFastBinsStride * iTask);
 
-   ErrorEbm error;
+   const size_t cBytesPerFastBin = GetFastBinSize(pSubset, pInteractionCore->IsHessian(), pTask->m_cScores);
+   EBM_ASSERT(!IsMultiplyError(cBytesPerFastBin, pTask->m_cTensorBins));
+   EBM_ASSERT(cBytesPerFastBin * pTask->m_cTensorBins <= pTask->m_cBytesFastBinsStride);
 
-   if(LIKELY(nullptr != avgInteractionStrengthOut)) {
-      *avgInteractionStrengthOut = k_illegalGainDouble;
-   }
+   aFastBins->ZeroMem(cBytesPerFastBin, pTask->m_cTensorBins);
 
-   InteractionShell * const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
-   if(nullptr == pInteractionShell) {
-      // already logged
-      return Error_IllegalParamVal;
-   }
-   LOG_COUNTED_0(
-      pInteractionShell->GetPointerCountLogEnterMessages(), 
-      Trace_Info, 
-      Trace_Verbose, 
-      "Entered CalcInteractionStrength"
-   );
+   // each task needs its own copy since the packing differs between subsets
+   BinSumsInteractionBridge binSums = *pTask->m_pBinSumsPrototype;
+
+#ifndef NDEBUG
+   binSums.m_pDebugFastBinsEnd = IndexBin(aFastBins, cBytesPerFastBin * pTask->m_cTensorBins);
+#endif // NDEBUG
+
+   const FeatureInteraction * const aFeatures = pInteractionCore->GetFeatures();
+   size_t iDimensionLoop = 0;
+   do {
+      const IntEbm indexFeature = pTask->m_aFeatureIndexes[iDimensionLoop];
+      const size_t iFeature = static_cast<size_t>(indexFeature);
+      const FeatureInteraction * const pFeature = &aFeatures[iFeature];
+
+      binSums.m_aaPacked[iDimensionLoop] = pSubset->GetFeatureData(iFeature);
 
+      EBM_ASSERT(1 <= pFeature->GetBitsRequiredMin());
+      binSums.m_acItemsPerBitPack[iDimensionLoop] =
+         GetCountItemsBitPacked(pFeature->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+      
+      ++iDimensionLoop;
+   } while(pTask->m_cDimensions != iDimensionLoop);
+
+   binSums.m_cRuntimeRealDimensions = pTask->m_cDimensions;
+
+   binSums.m_bHessian = pInteractionCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
+   binSums.m_cScores = pTask->m_cScores;
+
+   binSums.m_cSamples = pSubset->GetCountSamples();
+   binSums.m_aGradientsAndHessians = pSubset->GetGradHess();
+   binSums.m_aWeights = pSubset->GetWeights();
+
+   binSums.m_aFastBins = aFastBins;
+
+   return pSubset->BinSumsInteraction(&binSums);
+}
+
+static void ConvertCalcInteractionParams(
+   const CalcInteractionFlags flags,
+   const IntEbm maxCardinality,
+   const IntEbm minSamplesLeaf,
+   size_t * const pcCardinalityMaxOut,
+   size_t * const pcSamplesLeafMinOut
+) {
    if(0 != (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(~(
       static_cast<UCalcInteractionFlags>(CalcInteractionFlags_Pure) | 
       static_cast<UCalcInteractionFlags>(CalcInteractionFlags_EnableNewton)
@@ -137,6 +179,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    } else {
       LOG_0(Trace_Warning, "WARNING CalcInteractionStrength maxCardinality can't be less than 0. Turning off.");
    }
+   *pcCardinalityMaxOut = cCardinalityMax;
 
    size_t cSamplesLeafMin = size_t { 1 }; // this is the min value
    if(IntEbm { 1 } <= minSamplesLeaf) {
@@ -149,6 +192,266 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    } else {
       LOG_0(Trace_Warning, "WARNING CalcInteractionStrength minSamplesLeaf can't be less than 1. Adjusting to 1.");
    }
+   *pcSamplesLeafMinOut = cSamplesLeafMin;
+}
+
+// Bins the data subsets into the tensor at aMainBins, or into the back to back tensors of each pair if
+// pBinSumsPrototype->m_cPairs is non-zero. If pThreadPool is not nullptr the data subsets are binned on it.
+static ErrorEbm BinInteractionMainBins(
+   InteractionShell * const pInteractionShell,
+   const size_t iWorker,
+   ThreadPool * const pThreadPool,
+   const IntEbm * const featureIndexes,
+   const size_t cDimensions,
+   const BinSumsInteractionBridge * const pBinSumsPrototype,
+   const size_t cScores,
+   const size_t cTensorBins,
+   BinBase * const aMainBins
+) {
+   ErrorEbm error;
+
+   InteractionCore * const pInteractionCore = pInteractionShell->GetInteractionCore();
+   const bool bHessian = pInteractionCore->IsHessian();
+
+   EBM_ASSERT(1 <= pInteractionCore->GetDataSetInteraction()->GetCountSubsets());
+   DataSubsetInteraction * pSubset = pInteractionCore->GetDataSetInteraction()->GetSubsets();
+   const DataSubsetInteraction * const pSubsetsEnd = pSubset + pInteractionCore->GetDataSetInteraction()->GetCountSubsets();
+
+   size_t cBytesFastBinsStride = 0;
+   for(const DataSubsetInteraction * pSubsetSize = pSubset; pSubsetsEnd != pSubsetSize; ++pSubsetSize) {
+      const size_t cBytesPerFastBin = GetFastBinSize(pSubsetSize, bHessian, cScores);
+      if(IsMultiplyError(cBytesPerFastBin, cTensorBins)) {
+         LOG_0(Trace_Warning, "WARNING CalcInteractionStrength IsMultiplyError(cBytesPerBin, cTensorBins)");
+         return Error_OutOfMemory;
+      }
+      cBytesFastBinsStride = EbmMax(cBytesFastBinsStride, cBytesPerFastBin * cTensorBins);
+   }
+
+   const size_t cFastBinsThreads = nullptr == pThreadPool ? size_t { 1 } : 
+      EbmMin(pThreadPool->GetCountThreads(), pInteractionCore->GetDataSetInteraction()->GetCountSubsets());
+   if(size_t { 1 } != cFastBinsThreads) {
+      // keep each thread's fast bins on separate SIMD aligned boundaries which also keeps them on separate cache lines
+      if(IsAddError(cBytesFastBinsStride, SIMD_BYTE_ALIGNMENT - size_t { 1 })) {
+         LOG_0(Trace_Warning, "WARNING CalcInteractionStrength IsAddError(cBytesFastBinsStride, SIMD_BYTE_ALIGNMENT - 1)");
+         return Error_OutOfMemory;
+      }
+      cBytesFastBinsStride = (cBytesFastBinsStride + (SIMD_BYTE_ALIGNMENT - size_t { 1 })) / SIMD_BYTE_ALIGNMENT * 
+         SIMD_BYTE_ALIGNMENT;
+      if(IsMultiplyError(cBytesFastBinsStride, cFastBinsThreads)) {
+         LOG_0(Trace_Warning, "WARNING CalcInteractionStrength IsMultiplyError(cBytesFastBinsStride, cFastBinsThreads)");
+         return Error_OutOfMemory;
+      }
+   }
+
+   // this doesn't need to be freed since it's tracked and re-used by the class InteractionShell
+   BinBase * const aFastBins = 
+      pInteractionShell->GetInteractionFastBinsTemp(iWorker, cBytesFastBinsStride * cFastBinsThreads);
+   if(UNLIKELY(nullptr == aFastBins)) {
+      // already logged
+      return Error_OutOfMemory;
+   }
+
+   BinSumsInteractionTask task;
+   task.m_pInteractionCore = pInteractionCore;
+   task.m_aFeatureIndexes = featureIndexes;
+   task.m_cDimensions = cDimensions;
+   task.m_cScores = cScores;
+   task.m_cTensorBins = cTensorBins;
+   task.m_pBinSumsPrototype = pBinSumsPrototype;
+   task.m_cBytesFastBinsStride = cBytesFastBinsStride;
+   task.m_aFastBinsThreads = aFastBins;
+
+   // Subsets are binned in rounds of up to cFastBinsThreads subsets and then added into the main bins in subset
+   // order, so the results are identical regardless of the number of threads.
+   do {
+      const size_t cSubsetsRound = EbmMin(cFastBinsThreads, static_cast<size_t>(pSubsetsEnd - pSubset));
+      task.m_aSubsets = pSubset;
+
+      if(nullptr != pThreadPool) {
+         error = pThreadPool->Run(cSubsetsRound, BinSumsInteractionSubset, &task);
+      } else {
+         EBM_ASSERT(1 == cSubsetsRound);
+         error = BinSumsInteractionSubset(&task, 0);
+      }
+      if(Error_None != error) {
+         return error;
+      }
+
+      const BinBase * pFastBins = aFastBins;
+      const DataSubsetInteraction * const pSubsetsRoundEnd = pSubset + cSubsetsRound;
+      do {
+         ConvertAddBin(
+            cScores,
+            pInteractionCore->IsHessian(),
+            cTensorBins,
+            true,
+            sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes,
+            sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes,
+            pFastBins,
+            std::is_same<UIntMain, uint64_t>::value,
+            std::is_same<FloatMain, double>::value,
+            aMainBins
+         );
+         pFastBins = IndexBin(pFastBins, cBytesFastBinsStride);
+         ++pSubset;
+      } while(pSubsetsRoundEnd != pSubset);
+   } while(pSubsetsEnd != pSubset);
+
+   return Error_None;
+}
+
+// Turns the binned tensor of one term into its strength. The auxiliary bins are scratch space that must start
+// right after the tensor since PartitionTwoDimensionalInteraction finds the tensor total just before them.
+static void FinishInteractionStrength(
+   InteractionShell * const pInteractionShell,
+   const size_t cDimensions,
+   const size_t * const acBins,
+   const size_t cTensorBins,
+   const CalcInteractionFlags flags,
+   const size_t cSamplesLeafMin,
+   const size_t cBytesPerMainBin,
+   const size_t cAuxillaryBins,
+   BinBase * const aAuxiliaryBins,
+   BinBase * const aMainBins,
+   double * const avgInteractionStrengthOut
+#ifndef NDEBUG
+   , const BinBase * const pDebugMainBinsEnd
+#endif // NDEBUG
+) {
+   InteractionCore * const pInteractionCore = pInteractionShell->GetInteractionCore();
+   const DataSetInteraction * const pDataSet = pInteractionCore->GetDataSetInteraction();
+   const size_t cScores = GetCountScores(pInteractionCore->GetCountClasses());
+
+   // TODO: we can exit here back to python to allow caller modification to our bins
+
+
+
+#ifndef NDEBUG
+   // make a copy of the original bins for debugging purposes
+
+   BinBase * aDebugCopyBins = nullptr;
+   if(!IsMultiplyError(cBytesPerMainBin, cTensorBins)) {
+      ANALYSIS_ASSERT(0 != cBytesPerMainBin);
+      ANALYSIS_ASSERT(1 <= cTensorBins);
+      aDebugCopyBins = static_cast<BinBase *>(malloc(cBytesPerMainBin * cTensorBins));
+      if(nullptr != aDebugCopyBins) {
+         // if we can't allocate, don't fail.. just stop checking
+         memcpy(aDebugCopyBins, aMainBins, cTensorBins * cBytesPerMainBin);
+      }
+   }
+#endif // NDEBUG
+
+   aAuxiliaryBins->ZeroMem(cBytesPerMainBin, cAuxillaryBins);
+
+   TensorTotalsBuild(
+      pInteractionCore->IsHessian(),
+      cScores,
+      cDimensions,
+      acBins,
+      aAuxiliaryBins,
+      aMainBins
+#ifndef NDEBUG
+      , aDebugCopyBins
+      , pDebugMainBinsEnd
+#endif // NDEBUG
+   );
+
+   if(2 == cDimensions) {
+      LOG_0(Trace_Verbose, "CalcInteractionStrength Starting bin sweep loop");
+
+      double bestGain = PartitionTwoDimensionalInteraction(
+         pInteractionCore,
+         cDimensions,
+         acBins,
+         flags,
+         cSamplesLeafMin,
+         aAuxiliaryBins,
+         aMainBins
+#ifndef NDEBUG
+         , aDebugCopyBins
+         , pDebugMainBinsEnd
+#endif // NDEBUG
+      );
+
+      // if totalWeight < 1 then bestGain could overflow to +inf, so do the division first
+      const double totalWeight = pDataSet->GetWeightTotal();
+      EBM_ASSERT(0 < totalWeight); // if all are zeros we assume there are no weights and use the count
+      bestGain /= totalWeight;
+      if(0 != (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(CalcInteractionFlags_EnableNewton))) {
+         bestGain /= pInteractionCore->HessianConstant();
+         bestGain *= pInteractionCore->GainAdjustmentHessianBoosting();
+      } else {
+         bestGain *= pInteractionCore->GainAdjustmentGradientBoosting();
+      }
+      const double gradientConstant = pInteractionCore->GradientConstant();
+      bestGain *= gradientConstant;
+      bestGain *= gradientConstant;
+
+      if(UNLIKELY(/* NaN */ !LIKELY(bestGain <= std::numeric_limits<double>::max()))) {
+         // We simplify our caller's handling by returning -lowest as our error indicator. -lowest will sort to being the
+         // least important item, which is good, but it also signals an overflow without the weirness of NaNs.
+         EBM_ASSERT(std::isnan(bestGain) || std::numeric_limits<double>::infinity() == bestGain);
+         bestGain = k_illegalGainDouble;
+      } else if(UNLIKELY(bestGain < 0.0)) {
+         // gain can't mathematically be legally negative, but it can be here in the following situations:
+         //   1) for impure interaction gain we subtract the parent partial gain, and there can be floating point
+         //      noise that makes this slightly negative
+         //   2) for impure interaction gain we subtract the parent partial gain, but if there were no legal cuts
+         //      then the partial gain before subtracting the parent partial gain was zero and we then get a 
+         //      substantially negative value.  In this case we should not have subtracted the parent partial gain
+         //      since we had never even calculated the 4 quadrant partial gain, but we handle this scenario 
+         //      here instead of inside the templated function.
+
+         EBM_ASSERT(!std::isnan(bestGain));
+         // make bestGain k_illegalGainDouble if it's -infinity, otherwise make it zero
+         bestGain = std::numeric_limits<double>::lowest() <= bestGain ? 0.0 : k_illegalGainDouble;
+      } else {
+         EBM_ASSERT(!std::isnan(bestGain));
+         EBM_ASSERT(!std::isinf(bestGain));
+      }
+
+      if(nullptr != avgInteractionStrengthOut) {
+         *avgInteractionStrengthOut = bestGain;
+      }
+
+      EBM_ASSERT(k_illegalGainDouble == bestGain || 0.0 <= bestGain);
+      LOG_COUNTED_N(
+         pInteractionShell->GetPointerCountLogExitMessages(),
+         Trace_Info,
+         Trace_Verbose,
+         "Exited CalcInteractionStrength: "
+         "bestGain=%le"
+         ,
+         bestGain
+      );
+   } else {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrength We only support pairs for interaction detection currently");
+
+      // TODO: handle interaction detection for higher dimensions
+
+      // for now, just return any interactions that have other than 2 dimensions as k_illegalGainDouble, 
+      // which means they won't be considered but indicates they were not handled
+   }
+
+#ifndef NDEBUG
+   free(aDebugCopyBins);
+#endif // NDEBUG
+}
+
+// Calculates the strength of one term using the bins owned by iWorker. If pThreadPool is not nullptr the data
+// subsets are binned on it, otherwise everything executes on the calling thread.
+static ErrorEbm CalcInteractionStrengthInternal(
+   InteractionShell * const pInteractionShell,
+   const size_t iWorker,
+   ThreadPool * const pThreadPool,
+   const IntEbm countDimensions,
+   const IntEbm * const featureIndexes,
+   const CalcInteractionFlags flags,
+   const size_t cCardinalityMax,
+   const size_t cSamplesLeafMin,
+   double * const avgInteractionStrengthOut
+) {
+   ErrorEbm error;
 
    if(countDimensions <= IntEbm { 0 }) {
       if(IntEbm { 0 } == countDimensions) {
@@ -270,8 +573,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
 
    const size_t cScores = GetCountScores(cClasses);
 
-   static constexpr size_t cAuxillaryBinsForSplitting = 4;
-   const size_t cAuxillaryBins = EbmMax(cAuxillaryBinsForBuildFastTotals, cAuxillaryBinsForSplitting);
+   const size_t cAuxillaryBins = EbmMax(cAuxillaryBinsForBuildFastTotals, k_cAuxillaryBinsForSplitting);
 
    if(IsAddError(cTensorBins, cAuxillaryBins)) {
       LOG_0(Trace_Warning, "WARNING CalcInteractionStrength IsAddError(cTensorBins, cAuxillaryBins)");
@@ -285,7 +587,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
       return Error_OutOfMemory;
    }
 
-   BinBase * const aMainBins = pInteractionShell->GetInteractionMainBins(cBytesPerMainBin, cTotalMainBins);
+   BinBase * const aMainBins = pInteractionShell->GetInteractionMainBins(iWorker, cBytesPerMainBin, cTotalMainBins);
    if(UNLIKELY(nullptr == aMainBins)) {
       // already logged
       return Error_OutOfMemory;
@@ -297,212 +599,849 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
 
    memset(aMainBins, 0, cBytesPerMainBin * cTensorBins);
 
-   const bool bHessian = pInteractionCore->IsHessian();
+   binSums.m_cPairs = 0;
+   error = BinInteractionMainBins(
+      pInteractionShell,
+      iWorker,
+      pThreadPool,
+      featureIndexes,
+      cDimensions,
+      &binSums,
+      cScores,
+      cTensorBins,
+      aMainBins
+   );
+   if(Error_None != error) {
+      return error;
+   }
 
-   EBM_ASSERT(1 <= pInteractionCore->GetDataSetInteraction()->GetCountSubsets());
-   DataSubsetInteraction * pSubset = pInteractionCore->GetDataSetInteraction()->GetSubsets();
-   const DataSubsetInteraction * const pSubsetsEnd = pSubset + pInteractionCore->GetDataSetInteraction()->GetCountSubsets();
-   do {
-      size_t cBytesPerFastBin;
-      if(sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes) {
-         if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-            cBytesPerFastBin = GetBinSize<FloatBig, UIntBig>(bHessian, cScores);
-         } else {
-            EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-            cBytesPerFastBin = GetBinSize<FloatSmall, UIntBig>(bHessian, cScores);
-         }
-      } else {
-         EBM_ASSERT(sizeof(UIntSmall) == pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-         if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-            cBytesPerFastBin = GetBinSize<FloatBig, UIntSmall>(bHessian, cScores);
-         } else {
-            EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-            cBytesPerFastBin = GetBinSize<FloatSmall, UIntSmall>(bHessian, cScores);
-         }
+   FinishInteractionStrength(
+      pInteractionShell,
+      cDimensions,
+      binSums.m_acBins,
+      cTensorBins,
+      flags,
+      cSamplesLeafMin,
+      cBytesPerMainBin,
+      cAuxillaryBins,
+      IndexBin(aMainBins, cBytesPerMainBin * cTensorBins),
+      aMainBins,
+      avgInteractionStrengthOut
+#ifndef NDEBUG
+      , pDebugMainBinsEnd
+#endif // NDEBUG
+   );
+
+   return Error_None;
+}
+
+// Binning more pairs at once saves reading the gradients again, but only while all of their fast bins stay in the
+// cache. Larger tensors are binned one at a time.
+static constexpr size_t k_cPairsTensorBinsMax = 16384;
+
+// Returns the number of tensor bins in a pair that CalcInteractionStrengthPairs can bin together with other pairs,
+// or zero if the tuple needs CalcInteractionStrengthInternal. That includes pairs with a trivial strength of zero.
+static size_t GetPairTensorBins(
+   const InteractionCore * const pInteractionCore,
+   const IntEbm countDimensions,
+   const IntEbm * const featureIndexes,
+   const size_t cCardinalityMax
+) {
+   if(IntEbm { 2 } != countDimensions) {
+      return 0;
+   }
+   EBM_ASSERT(nullptr != featureIndexes);
+
+   const FeatureInteraction * const aFeatures = pInteractionCore->GetFeatures();
+   const IntEbm countFeatures = static_cast<IntEbm>(pInteractionCore->GetCountFeatures());
+   size_t cTensorBins = 1;
+   for(size_t iDimension = 0; iDimension < size_t { 2 }; ++iDimension) {
+      const IntEbm indexFeature = featureIndexes[iDimension];
+      if(indexFeature < IntEbm { 0 } || countFeatures <= indexFeature) {
+         return 0;
       }
-      if(IsMultiplyError(cBytesPerFastBin, cTensorBins)) {
-         LOG_0(Trace_Warning, "WARNING CalcInteractionStrength IsMultiplyError(cBytesPerBin, cTensorBins)");
-         return Error_OutOfMemory;
+      const size_t cBins = aFeatures[static_cast<size_t>(indexFeature)].GetCountBins();
+      if(cBins <= size_t { 1 } || IsMultiplyError(cTensorBins, cBins)) {
+         return 0;
       }
+      cTensorBins *= cBins;
+   }
+   if(cCardinalityMax < cTensorBins) {
+      return 0;
+   }
+   return cTensorBins;
+}
 
-      // this doesn't need to be freed since it's tracked and re-used by the class InteractionShell
-      BinBase * const aFastBins = pInteractionShell->GetInteractionFastBinsTemp(cBytesPerFastBin * cTensorBins);
-      if(UNLIKELY(nullptr == aFastBins)) {
-         // already logged
-         return Error_OutOfMemory;
-      }
+// Calculates the strengths of cPairs pairs whose feature indexes are stored back to back in featureIndexes. The
+// tensors of all the pairs are binned with one pass over each data subset, and then each tensor is finished as if
+// it had been binned alone. Our caller has already checked each pair with GetPairTensorBins.
+static ErrorEbm CalcInteractionStrengthPairs(
+   InteractionShell * const pInteractionShell,
+   const size_t iWorker,
+   ThreadPool * const pThreadPool,
+   const size_t cPairs,
+   const IntEbm * const featureIndexes,
+   const CalcInteractionFlags flags,
+   const size_t cSamplesLeafMin,
+   double * const aStrengthsOut
+) {
+   EBM_ASSERT(size_t { 2 } <= cPairs);
+   EBM_ASSERT(cPairs <= k_cPairsPerPassMax);
+   EBM_ASSERT(nullptr != featureIndexes);
+   EBM_ASSERT(nullptr != aStrengthsOut);
+
+   ErrorEbm error;
+
+   InteractionCore * const pInteractionCore = pInteractionShell->GetInteractionCore();
+   const FeatureInteraction * const aFeatures = pInteractionCore->GetFeatures();
+
+   BinSumsInteractionBridge binSums;
+   binSums.m_cPairs = cPairs;
+
+   const size_t cDimensions = cPairs * size_t { 2 };
+   size_t cTensorBins = 0;
+   size_t cAuxillaryBins = k_cAuxillaryBinsForSplitting;
+   for(size_t iDimension = 0; iDimension < cDimensions; iDimension += size_t { 2 }) {
+      const size_t cBins0 = aFeatures[static_cast<size_t>(featureIndexes[iDimension])].GetCountBins();
+      const size_t cBins1 = aFeatures[static_cast<size_t>(featureIndexes[iDimension + size_t { 1 }])].GetCountBins();
+      binSums.m_acBins[iDimension] = cBins0;
+      binSums.m_acBins[iDimension + size_t { 1 }] = cBins1;
+
+      // TensorTotalsBuild needs 1 + cBins0 auxiliary bins for a pair. Enough for the largest pair after the last
+      // tensor is enough for all of them, since the earlier pairs also reuse the tensors that follow them
+      cAuxillaryBins = EbmMax(cAuxillaryBins, size_t { 1 } + cBins0);
+
+      // our caller limited the sum of the tensor bins to k_cPairsTensorBinsMax, so none of this can overflow
+      EBM_ASSERT(cBins0 * cBins1 <= k_cPairsTensorBinsMax);
+      cTensorBins += cBins0 * cBins1;
+   }
+   EBM_ASSERT(cTensorBins <= k_cPairsTensorBinsMax);
+   const size_t cTotalMainBins = cTensorBins + cAuxillaryBins;
+
+   const size_t cScores = GetCountScores(pInteractionCore->GetCountClasses());
+   const size_t cBytesPerMainBin = GetBinSize<FloatMain, UIntMain>(pInteractionCore->IsHessian(), cScores);
+   if(IsMultiplyError(cBytesPerMainBin, cTotalMainBins)) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengthPairs IsMultiplyError(cBytesPerMainBin, cTotalMainBins)");
+      return Error_OutOfMemory;
+   }
 
-      aFastBins->ZeroMem(cBytesPerFastBin, cTensorBins);
+   BinBase * const aMainBins = pInteractionShell->GetInteractionMainBins(iWorker, cBytesPerMainBin, cTotalMainBins);
+   if(UNLIKELY(nullptr == aMainBins)) {
+      // already logged
+      return Error_OutOfMemory;
+   }
 
 #ifndef NDEBUG
-      binSums.m_pDebugFastBinsEnd = IndexBin(aFastBins, cBytesPerFastBin * cTensorBins);
+   const auto * const pDebugMainBinsEnd = IndexBin(aMainBins, cBytesPerMainBin * cTotalMainBins);
 #endif // NDEBUG
 
-      size_t iDimensionLoop = 0;
-      do {
-         const IntEbm indexFeature = featureIndexes[iDimensionLoop];
-         const size_t iFeature = static_cast<size_t>(indexFeature);
-         const FeatureInteraction * const pFeature = &aFeatures[iFeature];
+   memset(aMainBins, 0, cBytesPerMainBin * cTensorBins);
 
-         binSums.m_aaPacked[iDimensionLoop] = pSubset->GetFeatureData(iFeature);
+   error = BinInteractionMainBins(
+      pInteractionShell,
+      iWorker,
+      pThreadPool,
+      featureIndexes,
+      cDimensions,
+      &binSums,
+      cScores,
+      cTensorBins,
+      aMainBins
+   );
+   if(Error_None != error) {
+      return error;
+   }
 
-         EBM_ASSERT(1 <= pFeature->GetBitsRequiredMin());
-         binSums.m_acItemsPerBitPack[iDimensionLoop] =
-            GetCountItemsBitPacked(pFeature->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-         
-         ++iDimensionLoop;
-      } while(cDimensions != iDimensionLoop);
+   // PartitionTwoDimensionalInteraction expects the auxiliary bins to start right after the tensor, so we finish
+   // the pairs from last to first and let each pair use the tensors of the pairs that it follows as its auxiliary bins
+   size_t iPairBinsEnd = cTensorBins;
+   size_t iPair = cPairs;
+   do {
+      --iPair;
+      const size_t * const acBins = &binSums.m_acBins[iPair * size_t { 2 }];
+      const size_t cPairTensorBins = acBins[0] * acBins[1];
+      EBM_ASSERT(cPairTensorBins <= iPairBinsEnd);
+      const size_t iPairBinsFirst = iPairBinsEnd - cPairTensorBins;
+      FinishInteractionStrength(
+         pInteractionShell,
+         size_t { 2 },
+         acBins,
+         cPairTensorBins,
+         flags,
+         cSamplesLeafMin,
+         cBytesPerMainBin,
+         cAuxillaryBins,
+         IndexBin(aMainBins, cBytesPerMainBin * iPairBinsEnd),
+         IndexBin(aMainBins, cBytesPerMainBin * iPairBinsFirst),
+         &aStrengthsOut[iPair]
+#ifndef NDEBUG
+         , pDebugMainBinsEnd
+#endif // NDEBUG
+      );
+      iPairBinsEnd = iPairBinsFirst;
+   } while(size_t { 0 } != iPair);
 
-      binSums.m_cRuntimeRealDimensions = cDimensions;
+   return Error_None;
+}
 
-      binSums.m_bHessian = pInteractionCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
-      binSums.m_cScores = cScores;
+// there is a race condition for decrementing this variable, but if a thread loses the 
+// race then it just doesn't get decremented as quickly, which we can live with
+static int g_cLogCalcInteractionStrength = 10;
 
-      binSums.m_cSamples = pSubset->GetCountSamples();
-      binSums.m_aGradientsAndHessians = pSubset->GetGradHess();
-      binSums.m_aWeights = pSubset->GetWeights();
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
+   InteractionHandle interactionHandle,
+   IntEbm countDimensions,
+   const IntEbm * featureIndexes,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   double * avgInteractionStrengthOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogCalcInteractionStrength,
+      Trace_Info,
+      Trace_Verbose,
+      "CalcInteractionStrength: "
+      "interactionHandle=%p, "
+      "countDimensions=%" IntEbmPrintf ", "
+      "featureIndexes=%p, "
+      "flags=0x%" UCalcInteractionFlagsPrintf ", "
+      "maxCardinality=%" IntEbmPrintf ", "
+      "minSamplesLeaf=%" IntEbmPrintf ", "
+      "avgInteractionStrengthOut=%p"
+      ,
+      static_cast<void *>(interactionHandle),
+      countDimensions,
+      static_cast<const void *>(featureIndexes),
+      static_cast<UCalcInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      maxCardinality,
+      minSamplesLeaf,
+      static_cast<void *>(avgInteractionStrengthOut)
+   );
+
+   if(LIKELY(nullptr != avgInteractionStrengthOut)) {
+      *avgInteractionStrengthOut = k_illegalGainDouble;
+   }
+
+   InteractionShell * const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
+   if(nullptr == pInteractionShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+   LOG_COUNTED_0(
+      pInteractionShell->GetPointerCountLogEnterMessages(), 
+      Trace_Info, 
+      Trace_Verbose, 
+      "Entered CalcInteractionStrength"
+   );
 
-      binSums.m_aFastBins = aFastBins;
+   size_t cCardinalityMax;
+   size_t cSamplesLeafMin;
+   ConvertCalcInteractionParams(flags, maxCardinality, minSamplesLeaf, &cCardinalityMax, &cSamplesLeafMin);
+
+   return CalcInteractionStrengthInternal(
+      pInteractionShell,
+      0,
+      pInteractionShell->GetInteractionCore()->GetThreadPool(),
+      countDimensions,
+      featureIndexes,
+      flags,
+      cCardinalityMax,
+      cSamplesLeafMin,
+      avgInteractionStrengthOut
+   );
+}
+
+struct CalcInteractionStrengthsTask {
+   InteractionShell * m_pInteractionShell;
+   size_t m_cBatches;
+   const size_t * m_aiBatchFirst;
+   const IntEbm * m_aDimensionCounts;
+   const IntEbm * m_aFeatureIndexes;
+   const size_t * m_aiFeatureIndexesFirst;
+   CalcInteractionFlags m_flags;
+   size_t m_cCardinalityMax;
+   size_t m_cSamplesLeafMin;
+   double * m_aStrengthsOut;
+   std::atomic_size_t m_iBatchNext;
+};
+
+// Calculates the tuples of batch iBatch. A batch is either a single tuple, or pairs that are binned together.
+static ErrorEbm CalcInteractionStrengthsBatch(
+   const CalcInteractionStrengthsTask * const pTask,
+   const size_t iWorker,
+   ThreadPool * const pThreadPool,
+   const size_t iBatch
+) {
+   const size_t iTupleFirst = pTask->m_aiBatchFirst[iBatch];
+   const size_t cTuples = pTask->m_aiBatchFirst[iBatch + size_t { 1 }] - iTupleFirst;
+   EBM_ASSERT(1 <= cTuples);
+   if(size_t { 1 } == cTuples) {
+      return CalcInteractionStrengthInternal(
+         pTask->m_pInteractionShell,
+         iWorker,
+         pThreadPool,
+         pTask->m_aDimensionCounts[iTupleFirst],
+         nullptr == pTask->m_aFeatureIndexes ? nullptr : 
+            &pTask->m_aFeatureIndexes[pTask->m_aiFeatureIndexesFirst[iTupleFirst]],
+         pTask->m_flags,
+         pTask->m_cCardinalityMax,
+         pTask->m_cSamplesLeafMin,
+         &pTask->m_aStrengthsOut[iTupleFirst]
+      );
+   }
+   return CalcInteractionStrengthPairs(
+      pTask->m_pInteractionShell,
+      iWorker,
+      pThreadPool,
+      cTuples,
+      &pTask->m_aFeatureIndexes[pTask->m_aiFeatureIndexesFirst[iTupleFirst]],
+      pTask->m_flags,
+      pTask->m_cSamplesLeafMin,
+      &pTask->m_aStrengthsOut[iTupleFirst]
+   );
+}
 
-      error = pSubset->BinSumsInteraction(&binSums);
+// Each task owns the worker bins at index iTask and claims batches until none remain. Every tuple writes only to
+// its own output slot, so the results do not depend on which thread processed which tuple.
+static ErrorEbm CalcInteractionStrengthsWorker(void * const pContext, const size_t iTask) {
+   CalcInteractionStrengthsTask * const pTask = static_cast<CalcInteractionStrengthsTask *>(pContext);
+   while(true) {
+      const size_t iBatch = pTask->m_iBatchNext.fetch_add(size_t { 1 }, std::memory_order_relaxed);
+      if(pTask->m_cBatches <= iBatch) {
+         return Error_None;
+      }
+      const ErrorEbm error = CalcInteractionStrengthsBatch(pTask, iTask, nullptr, iBatch);
       if(Error_None != error) {
          return error;
       }
+   }
+}
 
-      ConvertAddBin(
-         cScores,
-         pInteractionCore->IsHessian(),
-         cTensorBins,
-         sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes,
-         sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes,
-         aFastBins,
-         std::is_same<UIntMain, uint64_t>::value,
-         std::is_same<FloatMain, double>::value,
-         aMainBins
-      );
+// Calculates the strength of each tuple. Runs of consecutive pairs are binned together in batches, and the
+// batches are spread across the thread pool if there is one. aiBatchFirst is scratch space for cTuples + 1 items.
+static ErrorEbm CalcInteractionStrengthsParallel(
+   InteractionShell * const pInteractionShell,
+   const size_t cTuples,
+   const IntEbm * const aDimensionCounts,
+   const IntEbm * const aFeatureIndexes,
+   const size_t * const aiFeatureIndexesFirst,
+   const CalcInteractionFlags flags,
+   const size_t cCardinalityMax,
+   const size_t cSamplesLeafMin,
+   size_t * const aiBatchFirst,
+   double * const aStrengthsOut
+) {
+   EBM_ASSERT(1 <= cTuples);
+   EBM_ASSERT(nullptr != aiBatchFirst);
 
-      ++pSubset;
-   } while(pSubsetsEnd != pSubset);
+   const InteractionCore * const pInteractionCore = pInteractionShell->GetInteractionCore();
+   const ptrdiff_t cClasses = pInteractionCore->GetCountClasses();
+   // Only the SIMD zones bin pairs together. Their scatters leave the gradient loads as a real part of the cost, 
+   // but the scalar CPU zone was measured slower with pairs binned together than with one compiled pass per pair.
+   // CalcInteractionStrengthInternal returns early for the other conditions
+   const bool bPairsBatch = pInteractionCore->IsSIMD() && nullptr != aFeatureIndexes && 
+      ptrdiff_t { 0 } != cClasses && ptrdiff_t { 1 } != cClasses && 
+      size_t { 0 } != pInteractionCore->GetDataSetInteraction()->GetCountSamples();
+
+   // the batches only depend on the tuples, so the results do not depend on the number of threads
+   size_t cBatches = 0;
+   size_t iTuple = 0;
+   do {
+      aiBatchFirst[cBatches] = iTuple;
+      ++cBatches;
+
+      size_t cTensorBinsBatch = !bPairsBatch ? size_t { 0 } : GetPairTensorBins(pInteractionCore, 
+         aDimensionCounts[iTuple], &aFeatureIndexes[aiFeatureIndexesFirst[iTuple]], cCardinalityMax);
+      ++iTuple;
+      if(size_t { 0 } != cTensorBinsBatch && cTensorBinsBatch <= k_cPairsTensorBinsMax) {
+         size_t cPairs = 1;
+         while(cTuples != iTuple && k_cPairsPerPassMax != cPairs && 
+            aiFeatureIndexesFirst[iTuple - size_t { 1 }] + size_t { 2 } == aiFeatureIndexesFirst[iTuple]) 
+         {
+            const size_t cTensorBins = GetPairTensorBins(pInteractionCore, aDimensionCounts[iTuple], 
+               &aFeatureIndexes[aiFeatureIndexesFirst[iTuple]], cCardinalityMax);
+            if(size_t { 0 } == cTensorBins || k_cPairsTensorBinsMax - cTensorBinsBatch < cTensorBins) {
+               break;
+            }
+            cTensorBinsBatch += cTensorBins;
+            ++cPairs;
+            ++iTuple;
+         }
+      }
+   } while(cTuples != iTuple);
+   aiBatchFirst[cBatches] = cTuples;
+
+   CalcInteractionStrengthsTask task;
+   task.m_pInteractionShell = pInteractionShell;
+   task.m_cBatches = cBatches;
+   task.m_aiBatchFirst = aiBatchFirst;
+   task.m_aDimensionCounts = aDimensionCounts;
+   task.m_aFeatureIndexes = aFeatureIndexes;
+   task.m_aiFeatureIndexesFirst = aiFeatureIndexesFirst;
+   task.m_flags = flags;
+   task.m_cCardinalityMax = cCardinalityMax;
+   task.m_cSamplesLeafMin = cSamplesLeafMin;
+   task.m_aStrengthsOut = aStrengthsOut;
+   task.m_iBatchNext.store(0, std::memory_order_relaxed);
+
+   ThreadPool * const pThreadPool = pInteractionShell->GetInteractionCore()->GetThreadPool();
+   const size_t cWorkers = EbmMin(pInteractionShell->GetCountWorkerBins(), cBatches);
+   if(nullptr == pThreadPool || size_t { 1 } == cWorkers) {
+      // with only one batch to process it is better to bin that batch's data subsets in parallel instead
+      for(size_t iBatch = 0; iBatch < cBatches; ++iBatch) {
+         const ErrorEbm error = CalcInteractionStrengthsBatch(&task, 0, pThreadPool, iBatch);
+         if(Error_None != error) {
+            return error;
+         }
+      }
+      return Error_None;
+   }
 
+   return pThreadPool->Run(cWorkers, CalcInteractionStrengthsWorker, &task);
+}
 
+static int g_cLogCalcInteractionStrengths = 10;
 
-   // TODO: we can exit here back to python to allow caller modification to our bins
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrengths(
+   InteractionHandle interactionHandle,
+   IntEbm countTuples,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   double * strengthsOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogCalcInteractionStrengths,
+      Trace_Info,
+      Trace_Verbose,
+      "CalcInteractionStrengths: "
+      "interactionHandle=%p, "
+      "countTuples=%" IntEbmPrintf ", "
+      "dimensionCounts=%p, "
+      "featureIndexes=%p, "
+      "flags=0x%" UCalcInteractionFlagsPrintf ", "
+      "maxCardinality=%" IntEbmPrintf ", "
+      "minSamplesLeaf=%" IntEbmPrintf ", "
+      "strengthsOut=%p"
+      ,
+      static_cast<void *>(interactionHandle),
+      countTuples,
+      static_cast<const void *>(dimensionCounts),
+      static_cast<const void *>(featureIndexes),
+      static_cast<UCalcInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      maxCardinality,
+      minSamplesLeaf,
+      static_cast<void *>(strengthsOut)
+   );
 
+   ErrorEbm error;
 
+   InteractionShell * const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
+   if(nullptr == pInteractionShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
 
-#ifndef NDEBUG
-   // make a copy of the original bins for debugging purposes
+   if(countTuples <= IntEbm { 0 }) {
+      if(IntEbm { 0 } == countTuples) {
+         LOG_0(Trace_Info, "INFO CalcInteractionStrengths empty tuple list");
+         return Error_None;
+      }
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths countTuples must be positive");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countTuples) || IsAddError(static_cast<size_t>(countTuples), static_cast<size_t>(countTuples), size_t { 1 }) ||
+      IsMultiplyError(sizeof(size_t), static_cast<size_t>(countTuples) * size_t { 2 } + size_t { 1 }))
+   {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths countTuples too large and would cause out of memory condition");
+      return Error_OutOfMemory;
+   }
+   const size_t cTuples = static_cast<size_t>(countTuples);
 
-   BinBase * aDebugCopyBins = nullptr;
-   if(!IsMultiplyError(cBytesPerMainBin, cTensorBins)) {
-      ANALYSIS_ASSERT(0 != cBytesPerMainBin);
-      ANALYSIS_ASSERT(1 <= cTensorBins);
-      aDebugCopyBins = static_cast<BinBase *>(malloc(cBytesPerMainBin * cTensorBins));
-      if(nullptr != aDebugCopyBins) {
-         // if we can't allocate, don't fail.. just stop checking
-         memcpy(aDebugCopyBins, aMainBins, cTensorBins * cBytesPerMainBin);
+   if(nullptr == dimensionCounts) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths dimensionCounts cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == strengthsOut) {
+      LOG_0(Trace_Error, "ERROR CalcInteractionStrengths strengthsOut cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+
+   InteractionCore * const pInteractionCore = pInteractionShell->GetInteractionCore();
+   const IntEbm countFeatures = static_cast<IntEbm>(pInteractionCore->GetCountFeatures());
+
+   // the feature indexes of all the tuples are packed back to back, so find where each tuple starts. We also
+   // check all the inputs here so that any illegal parameter is reported before we begin any work
+   // This comes from the scratch arena, which keeps its memory between calls, so repeated calls with a similar
+   // number of tuples do not allocate. The batch boundaries share the same allocation.
+   ScratchArena * const pScratchArena = pInteractionShell->GetScratchArena();
+   pScratchArena->Reset();
+   size_t * const aiFeatureIndexesFirst = static_cast<size_t *>(
+      pScratchArena->Allocate(sizeof(size_t) * (cTuples * size_t { 2 } + size_t { 1 })));
+   if(nullptr == aiFeatureIndexesFirst) {
+      LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths nullptr == aiFeatureIndexesFirst");
+      return Error_OutOfMemory;
+   }
+   size_t * const aiBatchFirst = aiFeatureIndexesFirst + cTuples;
+   size_t iFeatureIndexesFirst = 0;
+   for(size_t iTuple = 0; iTuple < cTuples; ++iTuple) {
+      strengthsOut[iTuple] = k_illegalGainDouble;
+      aiFeatureIndexesFirst[iTuple] = iFeatureIndexesFirst;
+
+      const IntEbm countDimensions = dimensionCounts[iTuple];
+      if(countDimensions < IntEbm { 0 }) {
+         LOG_0(Trace_Error, "ERROR CalcInteractionStrengths dimensionCounts value cannot be negative");
+         pScratchArena->Reset();
+         return Error_IllegalParamVal;
+      }
+      if(IntEbm { k_cDimensionsMax } < countDimensions) {
+         LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths dimensionCounts value too large and would cause out of memory condition");
+         pScratchArena->Reset();
+         return Error_OutOfMemory;
+      }
+      const size_t cDimensions = static_cast<size_t>(countDimensions);
+      if(size_t { 0 } != cDimensions && nullptr == featureIndexes) {
+         LOG_0(Trace_Error, "ERROR CalcInteractionStrengths featureIndexes cannot be nullptr if 0 < dimensionCounts value");
+         pScratchArena->Reset();
+         return Error_IllegalParamVal;
+      }
+      if(IsAddError(iFeatureIndexesFirst, cDimensions)) {
+         LOG_0(Trace_Warning, "WARNING CalcInteractionStrengths IsAddError(iFeatureIndexesFirst, cDimensions)");
+         pScratchArena->Reset();
+         return Error_OutOfMemory;
+      }
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const IntEbm indexFeature = featureIndexes[iFeatureIndexesFirst + iDimension];
+         if(indexFeature < IntEbm { 0 } || countFeatures <= indexFeature) {
+            LOG_0(Trace_Error, "ERROR CalcInteractionStrengths featureIndexes value must be non-negative and less than the number of features");
+            pScratchArena->Reset();
+            return Error_IllegalParamVal;
+         }
       }
+      iFeatureIndexesFirst += cDimensions;
    }
-#endif // NDEBUG
 
-   BinBase * aAuxiliaryBins = IndexBin(aMainBins, cBytesPerMainBin * cTensorBins);
-   aAuxiliaryBins->ZeroMem(cBytesPerMainBin, cAuxillaryBins);
+   size_t cCardinalityMax;
+   size_t cSamplesLeafMin;
+   ConvertCalcInteractionParams(flags, maxCardinality, minSamplesLeaf, &cCardinalityMax, &cSamplesLeafMin);
+
+   error = CalcInteractionStrengthsParallel(
+      pInteractionShell,
+      cTuples,
+      dimensionCounts,
+      featureIndexes,
+      aiFeatureIndexesFirst,
+      flags,
+      cCardinalityMax,
+      cSamplesLeafMin,
+      aiBatchFirst,
+      strengthsOut
+   );
 
-   TensorTotalsBuild(
-      pInteractionCore->IsHessian(),
-      cScores,
-      cDimensions,
-      binSums.m_acBins,
-      aAuxiliaryBins,
-      aMainBins
-#ifndef NDEBUG
-      , aDebugCopyBins
-      , pDebugMainBinsEnd
-#endif // NDEBUG
+   pScratchArena->Reset();
+
+   LOG_COUNTED_N(
+      pInteractionShell->GetPointerCountLogExitMessages(),
+      Trace_Info,
+      Trace_Verbose,
+      "Exited CalcInteractionStrengths: "
+      "error=%d"
+      ,
+      static_cast<int>(error)
    );
 
-   if(2 == cDimensions) {
-      LOG_0(Trace_Verbose, "CalcInteractionStrength Starting bin sweep loop");
+   return error;
+}
 
-      double bestGain = PartitionTwoDimensionalInteraction(
-         pInteractionCore,
-         cDimensions,
-         binSums.m_acBins,
-         flags,
-         cSamplesLeafMin,
-         aAuxiliaryBins,
-         aMainBins
-#ifndef NDEBUG
-         , aDebugCopyBins
-         , pDebugMainBinsEnd
-#endif // NDEBUG
-      );
+struct RankedPair {
+   double m_strength;
+   size_t m_iFeature0;
+   size_t m_iFeature1;
+};
+
+// orders by strength and then by the feature indexes, which is the same ordering that python gives to
+// (strength, (iFeature0, iFeature1)) tuples
+static bool IsRankedPairGreater(const RankedPair & lhs, const RankedPair & rhs) {
+   if(lhs.m_strength != rhs.m_strength) {
+      return rhs.m_strength < lhs.m_strength;
+   }
+   if(lhs.m_iFeature0 != rhs.m_iFeature0) {
+      return rhs.m_iFeature0 < lhs.m_iFeature0;
+   }
+   return rhs.m_iFeature1 < lhs.m_iFeature1;
+}
 
-      // if totalWeight < 1 then bestGain could overflow to +inf, so do the division first
-      const double totalWeight = pDataSet->GetWeightTotal();
-      EBM_ASSERT(0 < totalWeight); // if all are zeros we assume there are no weights and use the count
-      bestGain /= totalWeight;
-      if(0 != (static_cast<UCalcInteractionFlags>(flags) & static_cast<UCalcInteractionFlags>(CalcInteractionFlags_EnableNewton))) {
-         bestGain /= pInteractionCore->HessianConstant();
-         bestGain *= pInteractionCore->GainAdjustmentHessianBoosting();
-      } else {
-         bestGain *= pInteractionCore->GainAdjustmentGradientBoosting();
-      }
-      const double gradientConstant = pInteractionCore->GradientConstant();
-      bestGain *= gradientConstant;
-      bestGain *= gradientConstant;
+struct FeaturePair {
+   size_t m_iFeature0;
+   size_t m_iFeature1;
+};
 
-      if(UNLIKELY(/* NaN */ !LIKELY(bestGain <= std::numeric_limits<double>::max()))) {
-         // We simplify our caller's handling by returning -lowest as our error indicator. -lowest will sort to being the
-         // least important item, which is good, but it also signals an overflow without the weirness of NaNs.
-         EBM_ASSERT(std::isnan(bestGain) || std::numeric_limits<double>::infinity() == bestGain);
-         bestGain = k_illegalGainDouble;
-      } else if(UNLIKELY(bestGain < 0.0)) {
-         // gain can't mathematically be legally negative, but it can be here in the following situations:
-         //   1) for impure interaction gain we subtract the parent partial gain, and there can be floating point
-         //      noise that makes this slightly negative
-         //   2) for impure interaction gain we subtract the parent partial gain, but if there were no legal cuts
-         //      then the partial gain before subtracting the parent partial gain was zero and we then get a 
-         //      substantially negative value.  In this case we should not have subtracted the parent partial gain
-         //      since we had never even calculated the 4 quadrant partial gain, but we handle this scenario 
-         //      here instead of inside the templated function.
+static bool IsFeaturePairLess(const FeaturePair & lhs, const FeaturePair & rhs) {
+   if(lhs.m_iFeature0 != rhs.m_iFeature0) {
+      return lhs.m_iFeature0 < rhs.m_iFeature0;
+   }
+   return lhs.m_iFeature1 < rhs.m_iFeature1;
+}
 
-         EBM_ASSERT(!std::isnan(bestGain));
-         // make bestGain k_illegalGainDouble if it's -infinity, otherwise make it zero
-         bestGain = std::numeric_limits<double>::lowest() <= bestGain ? 0.0 : k_illegalGainDouble;
-      } else {
-         EBM_ASSERT(!std::isnan(bestGain));
-         EBM_ASSERT(!std::isinf(bestGain));
+// the number of pairs that we calculate between each update of the top pairs. This bounds our temporary memory
+// while still giving each thread in the pool many pairs to claim
+static constexpr size_t k_cPairsPerRankBatch = 4096;
+
+static int g_cLogRankInteractions = 10;
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION RankInteractions(
+   InteractionHandle interactionHandle,
+   IntEbm countExcludedPairs,
+   const IntEbm * excludedPairs,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   IntEbm countPairsMax,
+   IntEbm * countPairsOut,
+   IntEbm * featureIndexesOut,
+   double * strengthsOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogRankInteractions,
+      Trace_Info,
+      Trace_Verbose,
+      "RankInteractions: "
+      "interactionHandle=%p, "
+      "countExcludedPairs=%" IntEbmPrintf ", "
+      "excludedPairs=%p, "
+      "flags=0x%" UCalcInteractionFlagsPrintf ", "
+      "maxCardinality=%" IntEbmPrintf ", "
+      "minSamplesLeaf=%" IntEbmPrintf ", "
+      "countPairsMax=%" IntEbmPrintf ", "
+      "countPairsOut=%p, "
+      "featureIndexesOut=%p, "
+      "strengthsOut=%p"
+      ,
+      static_cast<void *>(interactionHandle),
+      countExcludedPairs,
+      static_cast<const void *>(excludedPairs),
+      static_cast<UCalcInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
+      maxCardinality,
+      minSamplesLeaf,
+      countPairsMax,
+      static_cast<void *>(countPairsOut),
+      static_cast<void *>(featureIndexesOut),
+      static_cast<void *>(strengthsOut)
+   );
+
+   ErrorEbm error;
+
+   if(nullptr == countPairsOut) {
+      LOG_0(Trace_Error, "ERROR RankInteractions countPairsOut cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+   *countPairsOut = IntEbm { 0 };
+
+   InteractionShell * const pInteractionShell = InteractionShell::GetInteractionShellFromHandle(interactionHandle);
+   if(nullptr == pInteractionShell) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+
+   if(countPairsMax < IntEbm { 0 }) {
+      LOG_0(Trace_Error, "ERROR RankInteractions countPairsMax cannot be negative");
+      return Error_IllegalParamVal;
+   }
+   if(IntEbm { 0 } == countPairsMax) {
+      LOG_0(Trace_Info, "INFO RankInteractions zero pairs requested");
+      return Error_None;
+   }
+   if(nullptr == featureIndexesOut || nullptr == strengthsOut) {
+      LOG_0(Trace_Error, "ERROR RankInteractions featureIndexesOut and strengthsOut cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+
+   if(countExcludedPairs < IntEbm { 0 }) {
+      LOG_0(Trace_Error, "ERROR RankInteractions countExcludedPairs cannot be negative");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countExcludedPairs) || 
+      IsMultiplyError(sizeof(FeaturePair), static_cast<size_t>(countExcludedPairs))) 
+   {
+      LOG_0(Trace_Warning, "WARNING RankInteractions countExcludedPairs too large and would cause out of memory condition");
+      return Error_OutOfMemory;
+   }
+   const size_t cExcludedPairs = static_cast<size_t>(countExcludedPairs);
+   if(size_t { 0 } != cExcludedPairs && nullptr == excludedPairs) {
+      LOG_0(Trace_Error, "ERROR RankInteractions excludedPairs cannot be nullptr if 0 < countExcludedPairs");
+      return Error_IllegalParamVal;
+   }
+
+   const size_t cFeatures = pInteractionShell->GetInteractionCore()->GetCountFeatures();
+
+   size_t cPairsTotal = std::numeric_limits<size_t>::max();
+   if(!IsMultiplyError(cFeatures, cFeatures)) {
+      cPairsTotal = size_t { 0 } == cFeatures ? size_t { 0 } : cFeatures * (cFeatures - size_t { 1 }) / size_t { 2 };
+   }
+   size_t cPairsMax = cPairsTotal;
+   if(!IsConvertError<size_t>(countPairsMax)) {
+      cPairsMax = EbmMin(cPairsMax, static_cast<size_t>(countPairsMax));
+   }
+   if(size_t { 0 } == cPairsMax) {
+      LOG_0(Trace_Info, "INFO RankInteractions fewer than 2 features");
+      return Error_None;
+   }
+   if(IsMultiplyError(sizeof(RankedPair), cPairsMax)) {
+      LOG_0(Trace_Warning, "WARNING RankInteractions IsMultiplyError(sizeof(RankedPair), cPairsMax)");
+      return Error_OutOfMemory;
+   }
+
+   FeaturePair * aExcluded = nullptr;
+   if(size_t { 0 } != cExcludedPairs) {
+      aExcluded = static_cast<FeaturePair *>(malloc(sizeof(FeaturePair) * cExcludedPairs));
+      if(nullptr == aExcluded) {
+         LOG_0(Trace_Warning, "WARNING RankInteractions nullptr == aExcluded");
+         return Error_OutOfMemory;
+      }
+      for(size_t iExcluded = 0; iExcluded < cExcludedPairs; ++iExcluded) {
+         const IntEbm indexFeature0 = excludedPairs[iExcluded * size_t { 2 }];
+         const IntEbm indexFeature1 = excludedPairs[iExcluded * size_t { 2 } + size_t { 1 }];
+         if(indexFeature0 < IntEbm { 0 } || indexFeature1 < IntEbm { 0 } || 
+            IsConvertError<size_t>(indexFeature0) || IsConvertError<size_t>(indexFeature1) ||
+            cFeatures <= static_cast<size_t>(indexFeature0) || cFeatures <= static_cast<size_t>(indexFeature1)) 
+         {
+            LOG_0(Trace_Error, "ERROR RankInteractions excludedPairs value must be non-negative and less than the number of features");
+            free(aExcluded);
+            return Error_IllegalParamVal;
+         }
+         const size_t iFeature0 = static_cast<size_t>(indexFeature0);
+         const size_t iFeature1 = static_cast<size_t>(indexFeature1);
+         aExcluded[iExcluded].m_iFeature0 = EbmMin(iFeature0, iFeature1);
+         aExcluded[iExcluded].m_iFeature1 = EbmMax(iFeature0, iFeature1);
       }
+      std::sort(aExcluded, aExcluded + cExcludedPairs, IsFeaturePairLess);
+   }
 
-      if(nullptr != avgInteractionStrengthOut) {
-         *avgInteractionStrengthOut = bestGain;
+   RankedPair * const aTop = static_cast<RankedPair *>(malloc(sizeof(RankedPair) * cPairsMax));
+   if(nullptr == aTop) {
+      LOG_0(Trace_Warning, "WARNING RankInteractions nullptr == aTop");
+      free(aExcluded);
+      return Error_OutOfMemory;
+   }
+
+   // everything in a batch has 8 byte alignment, so we can carve the arrays out of a single allocation
+   static constexpr size_t cBytesBatch = k_cPairsPerRankBatch * 
+      (sizeof(IntEbm) + sizeof(IntEbm) * size_t { 2 } + sizeof(size_t) + sizeof(double) + sizeof(size_t)) + 
+      sizeof(size_t);
+   void * const pBatch = malloc(cBytesBatch);
+   if(nullptr == pBatch) {
+      LOG_0(Trace_Warning, "WARNING RankInteractions nullptr == pBatch");
+      free(aTop);
+      free(aExcluded);
+      return Error_OutOfMemory;
+   }
+   IntEbm * const aDimensionCounts = static_cast<IntEbm *>(pBatch);
+   IntEbm * const aFeatureIndexes = aDimensionCounts + k_cPairsPerRankBatch;
+   size_t * const aiFeatureIndexesFirst = 
+      reinterpret_cast<size_t *>(aFeatureIndexes + k_cPairsPerRankBatch * size_t { 2 });
+   double * const aStrengths = reinterpret_cast<double *>(aiFeatureIndexesFirst + k_cPairsPerRankBatch);
+   size_t * const aiBatchFirst = reinterpret_cast<size_t *>(aStrengths + k_cPairsPerRankBatch);
+   for(size_t iBatch = 0; iBatch < k_cPairsPerRankBatch; ++iBatch) {
+      aDimensionCounts[iBatch] = IntEbm { 2 };
+      aiFeatureIndexesFirst[iBatch] = iBatch * size_t { 2 };
+   }
+
+   size_t cCardinalityMax;
+   size_t cSamplesLeafMin;
+   ConvertCalcInteractionParams(flags, maxCardinality, minSamplesLeaf, &cCardinalityMax, &cSamplesLeafMin);
+
+   // aTop is a min-heap of the strongest pairs seen so far, so the weakest kept pair is at the front
+   size_t cTop = 0;
+   size_t iFeature0 = 0;
+   size_t iFeature1 = 1;
+   error = Error_None;
+   while(iFeature1 < cFeatures) {
+      size_t cBatch = 0;
+      do {
+         FeaturePair pair;
+         pair.m_iFeature0 = iFeature0;
+         pair.m_iFeature1 = iFeature1;
+         if(nullptr == aExcluded || !std::binary_search(aExcluded, aExcluded + cExcludedPairs, pair, IsFeaturePairLess)) {
+            aFeatureIndexes[cBatch * size_t { 2 }] = static_cast<IntEbm>(iFeature0);
+            aFeatureIndexes[cBatch * size_t { 2 } + size_t { 1 }] = static_cast<IntEbm>(iFeature1);
+            ++cBatch;
+         }
+         ++iFeature1;
+         if(cFeatures == iFeature1) {
+            ++iFeature0;
+            iFeature1 = iFeature0 + size_t { 1 };
+         }
+      } while(k_cPairsPerRankBatch != cBatch && iFeature1 < cFeatures);
+
+      if(size_t { 0 } == cBatch) {
+         break;
       }
 
-      EBM_ASSERT(k_illegalGainDouble == bestGain || 0.0 <= bestGain);
-      LOG_COUNTED_N(
-         pInteractionShell->GetPointerCountLogExitMessages(),
-         Trace_Info,
-         Trace_Verbose,
-         "Exited CalcInteractionStrength: "
-         "bestGain=%le"
-         ,
-         bestGain
+      error = CalcInteractionStrengthsParallel(
+         pInteractionShell,
+         cBatch,
+         aDimensionCounts,
+         aFeatureIndexes,
+         aiFeatureIndexesFirst,
+         flags,
+         cCardinalityMax,
+         cSamplesLeafMin,
+         aiBatchFirst,
+         aStrengths
       );
-   } else {
-      LOG_0(Trace_Warning, "WARNING CalcInteractionStrength We only support pairs for interaction detection currently");
+      if(Error_None != error) {
+         break;
+      }
 
-      // TODO: handle interaction detection for higher dimensions
+      // the heap is updated in pair order, so the result does not depend on the number of threads
+      for(size_t iBatch = 0; iBatch < cBatch; ++iBatch) {
+         RankedPair item;
+         item.m_strength = aStrengths[iBatch];
+         item.m_iFeature0 = static_cast<size_t>(aFeatureIndexes[iBatch * size_t { 2 }]);
+         item.m_iFeature1 = static_cast<size_t>(aFeatureIndexes[iBatch * size_t { 2 } + size_t { 1 }]);
+         if(cTop != cPairsMax) {
+            aTop[cTop] = item;
+            ++cTop;
+            std::push_heap(aTop, aTop + cTop, IsRankedPairGreater);
+         } else if(IsRankedPairGreater(item, aTop[0])) {
+            std::pop_heap(aTop, aTop + cTop, IsRankedPairGreater);
+            aTop[cTop - size_t { 1 }] = item;
+            std::push_heap(aTop, aTop + cTop, IsRankedPairGreater);
+         }
+      }
+   }
 
-      // for now, just return any interactions that have other than 2 dimensions as k_illegalGainDouble, 
-      // which means they won't be considered but indicates they were not handled
+   free(pBatch);
+   free(aExcluded);
+
+   if(Error_None == error) {
+      std::sort(aTop, aTop + cTop, IsRankedPairGreater);
+      for(size_t iTop = 0; iTop < cTop; ++iTop) {
+         featureIndexesOut[iTop * size_t { 2 }] = static_cast<IntEbm>(aTop[iTop].m_iFeature0);
+         featureIndexesOut[iTop * size_t { 2 } + size_t { 1 }] = static_cast<IntEbm>(aTop[iTop].m_iFeature1);
+         strengthsOut[iTop] = aTop[iTop].m_strength;
+      }
+      *countPairsOut = static_cast<IntEbm>(cTop);
    }
 
-#ifndef NDEBUG
-   free(aDebugCopyBins);
-#endif // NDEBUG
+   free(aTop);
 
-   return Error_None;
+   LOG_COUNTED_N(
+      pInteractionShell->GetPointerCountLogExitMessages(),
+      Trace_Info,
+      Trace_Verbose,
+      "Exited RankInteractions: "
+      "cPairs=%zu, "
+      "error=%d"
+      ,
+      cTop,
+      static_cast<int>(error)
+   );
+
+   return error;
 }
 
 } // DEFINED_ZONE_NAME
@@ -23,6 +23,7 @@ extern void ConvertAddBin(
    const size_t cScores,
    const bool bHessian,
    const size_t cBins,
+   const bool bWeightSrc,
    const bool bUInt64Src,
    const bool bDoubleSrc,
    const void * const aSrc,
@@ -43,7 +44,108 @@ extern void ConvertAddBin(
    ptrdiff_t iSrcGradient;
    ptrdiff_t iSrcHessian = -1;
 
-   if(bUInt64Src) {
+   if(!bWeightSrc) {
+      // the source bins do not have the m_weight field, so we restore the weights from the exact counts
+      if(bUInt64Src) {
+         typedef NoWeight<uint64_t> TUIntSpecific;
+         if(bDoubleSrc) {
+            typedef double TFloatSpecific;
+            cSrcBinBytes = GetBinSize<TFloatSpecific, TUIntSpecific>(bHessian, cScores);
+            if(bHessian) {
+               constexpr bool bHessianSpecific = true;
+               typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
+
+               iSrcSamples = offsetof(BinSpecific, m_cSamples);
+               iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
+               cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
+               using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
+               iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
+               iSrcHessian = offsetof(GradientPairSpecific, m_sumHessians);
+            } else {
+               constexpr bool bHessianSpecific = false;
+               typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
+
+               iSrcSamples = offsetof(BinSpecific, m_cSamples);
+               iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
+               cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
+               using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
+               iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
+            }
+         } else {
+            typedef float TFloatSpecific;
+            cSrcBinBytes = GetBinSize<TFloatSpecific, TUIntSpecific>(bHessian, cScores);
+            if(bHessian) {
+               constexpr bool bHessianSpecific = true;
+               typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
+
+               iSrcSamples = offsetof(BinSpecific, m_cSamples);
+               iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
+               cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
+               using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
+               iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
+               iSrcHessian = offsetof(GradientPairSpecific, m_sumHessians);
+            } else {
+               constexpr bool bHessianSpecific = false;
+               typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
+
+               iSrcSamples = offsetof(BinSpecific, m_cSamples);
+               iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
+               cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
+               using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
+               iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
+            }
+         }
+      } else {
+         typedef NoWeight<uint32_t> TUIntSpecific;
+         if(bDoubleSrc) {
+            typedef double TFloatSpecific;
+            cSrcBinBytes = GetBinSize<TFloatSpecific, TUIntSpecific>(bHessian, cScores);
+            if(bHessian) {
+               constexpr bool bHessianSpecific = true;
+               typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
+
+               iSrcSamples = offsetof(BinSpecific, m_cSamples);
+               iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
+               cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
+               using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
+               iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
+               iSrcHessian = offsetof(GradientPairSpecific, m_sumHessians);
+            } else {
+               constexpr bool bHessianSpecific = false;
+               typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
+
+               iSrcSamples = offsetof(BinSpecific, m_cSamples);
+               iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
+               cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
+               using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
+               iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
+            }
+         } else {
+            typedef float TFloatSpecific;
+            cSrcBinBytes = GetBinSize<TFloatSpecific, TUIntSpecific>(bHessian, cScores);
+            if(bHessian) {
+               constexpr bool bHessianSpecific = true;
+               typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
+
+               iSrcSamples = offsetof(BinSpecific, m_cSamples);
+               iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
+               cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
+               using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
+               iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
+               iSrcHessian = offsetof(GradientPairSpecific, m_sumHessians);
+            } else {
+               constexpr bool bHessianSpecific = false;
+               typedef Bin<TFloatSpecific, TUIntSpecific, bHessianSpecific> BinSpecific;
+
+               iSrcSamples = offsetof(BinSpecific, m_cSamples);
+               iSrcArray = offsetof(BinSpecific, m_aGradientPairs);
+               cSrcArrayItemBytes = sizeof(BinSpecific::m_aGradientPairs[0]);
+               using GradientPairSpecific = typename std::remove_reference<decltype(BinSpecific::m_aGradientPairs[0])>::type;
+               iSrcGradient = offsetof(GradientPairSpecific, m_sumGradients);
+            }
+         }
+      }
+   } else if(bUInt64Src) {
       typedef uint64_t TUIntSpecific;
       if(bDoubleSrc) {
          typedef double TFloatSpecific;
@@ -270,7 +372,7 @@ extern void ConvertAddBin(
    EBM_ASSERT(0 <= iSrcSamples);
    EBM_ASSERT(0 <= iDestSamples);
 
-   EBM_ASSERT(0 <= iSrcWeight);
+   EBM_ASSERT(bWeightSrc == (0 <= iSrcWeight));
    EBM_ASSERT(0 <= iDestWeight);
 
    EBM_ASSERT(0 <= iSrcHessian && 0 <= iDestHessian || iSrcHessian < 0 && iDestHessian < 0);
@@ -296,7 +398,20 @@ extern void ConvertAddBin(
          }
       }
 
-      if(bDoubleSrc) {
+      if(!bWeightSrc) {
+         // without weights every sample added the same amount to the count and the weight, so the weight is the count
+         uint64_t src;
+         if(bUInt64Src) {
+            src = *reinterpret_cast<const uint64_t *>(pSrc + iSrcSamples);
+         } else {
+            src = static_cast<uint64_t>(*reinterpret_cast<const uint32_t *>(pSrc + iSrcSamples));
+         }
+         if(bDoubleDest) {
+            *reinterpret_cast<double *>(pAddDest + iDestWeight) += static_cast<double>(src);
+         } else {
+            *reinterpret_cast<float *>(pAddDest + iDestWeight) += static_cast<float>(src);
+         }
+      } else if(bDoubleSrc) {
          const double src = *reinterpret_cast<const double *>(pSrc + iSrcWeight);
          if(bDoubleDest) {
             *reinterpret_cast<double *>(pAddDest + iDestWeight) += static_cast<double>(src);
@@ -12,6 +12,8 @@
 #include <queue> // std::priority_queue
 #include <set> // std::set
 #include <string.h> // strchr, memmove
+#include <stdlib.h> // malloc, free
+#include <type_traits> // std::is_standard_layout
 
 #include "libebm.h" // EBM_API_BODY
 #include "logging.h" // EBM_ASSERT
@@ -21,6 +23,7 @@
 #include "common_cpp.hpp" // IsConvertError
 
 #include "RandomDeterministic.hpp"
+#include "ThreadPool.hpp"
 
 // TODO: check this file for how we handle subnormal numbers.  NEVER RETURN SUBNORMALS!
 
@@ -3275,4 +3278,615 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
    return error;
 }
 
+// CutQuantileSketch is a KLL style compactor stack.  Level h holds up to m_cItemsPerLevel values that each stand for
+// 2^h of the original samples.  When a level fills up it is sorted and every other value is carried up to the next
+// level, so the total weight is preserved and the memory grows only with the log of the number of samples.
+static constexpr size_t k_cSketchLevelsMax = sizeof(size_t) * 8;
+// CutQuantileFinish expands the sketch into at most this many values before running the exact algorithm on them
+static constexpr size_t k_cSketchExpandedMax = size_t { 1 } << 20;
+
+struct CutQuantileSketch {
+   static constexpr size_t k_handleVerificationOk = 11953; // random 15 bit number
+   static constexpr size_t k_handleVerificationFreed = 25417; // random 15 bit number
+   size_t m_handleVerification; // this needs to be at the top and make it pointer sized to keep best alignment
+
+   size_t m_cItemsPerLevel;
+   size_t m_cSamples; // non-missing values accumulated, which is also the total weight of all the levels
+   size_t m_cLevels;
+   RandomDeterministic m_rng;
+   size_t m_acItems[k_cSketchLevelsMax];
+   double * m_aaItems[k_cSketchLevelsMax];
+
+   inline static CutQuantileSketch * GetCutQuantileSketchFromHandle(const CutQuantileSketchHandle sketchHandle) {
+      if(nullptr == sketchHandle) {
+         LOG_0(Trace_Error, "ERROR GetCutQuantileSketchFromHandle null sketchHandle");
+         return nullptr;
+      }
+      CutQuantileSketch * const pSketch = reinterpret_cast<CutQuantileSketch *>(sketchHandle);
+      if(k_handleVerificationOk == pSketch->m_handleVerification) {
+         return pSketch;
+      }
+      if(k_handleVerificationFreed == pSketch->m_handleVerification) {
+         LOG_0(Trace_Error, "ERROR GetCutQuantileSketchFromHandle attempt to use freed CutQuantileSketchHandle");
+      } else {
+         LOG_0(Trace_Error, "ERROR GetCutQuantileSketchFromHandle attempt to use invalid CutQuantileSketchHandle");
+      }
+      return nullptr;
+   }
+   inline CutQuantileSketchHandle GetHandle() {
+      return reinterpret_cast<CutQuantileSketchHandle>(this);
+   }
+};
+static_assert(std::is_standard_layout<CutQuantileSketch>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<CutQuantileSketch>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+static ErrorEbm SketchCompact(CutQuantileSketch * const pSketch, const size_t iLevel) {
+   EBM_ASSERT(iLevel < pSketch->m_cLevels);
+
+   const size_t iLevelNext = iLevel + size_t { 1 };
+   if(pSketch->m_cLevels == iLevelNext) {
+      if(k_cSketchLevelsMax == iLevelNext) {
+         // every item on the top level would stand for more samples than a size_t can count
+         LOG_0(Trace_Error, "ERROR SketchCompact k_cSketchLevelsMax == iLevelNext");
+         return Error_UnexpectedInternal;
+      }
+      double * const aItems = static_cast<double *>(malloc(sizeof(double) * pSketch->m_cItemsPerLevel));
+      if(nullptr == aItems) {
+         LOG_0(Trace_Warning, "WARNING SketchCompact nullptr == aItems");
+         return Error_OutOfMemory;
+      }
+      pSketch->m_aaItems[iLevelNext] = aItems;
+      pSketch->m_acItems[iLevelNext] = 0;
+      pSketch->m_cLevels = iLevelNext + size_t { 1 };
+   }
+
+   const size_t cItems = pSketch->m_acItems[iLevel];
+   const size_t cPromote = cItems >> 1;
+   if(pSketch->m_cItemsPerLevel - pSketch->m_acItems[iLevelNext] < cPromote) {
+      const ErrorEbm error = SketchCompact(pSketch, iLevelNext);
+      if(Error_None != error) {
+         return error;
+      }
+   }
+   EBM_ASSERT(cPromote <= pSketch->m_cItemsPerLevel - pSketch->m_acItems[iLevelNext]);
+
+   double * const aItems = pSketch->m_aaItems[iLevel];
+   std::sort(aItems, aItems + cItems);
+
+   // carry up either the even or the odd item of each sorted pair at twice the weight.  Picking randomly makes the 
+   // rank errors of successive compactions cancel on average instead of accumulating in one direction
+   const size_t iOffset = pSketch->m_rng.Next<bool>() ? size_t { 1 } : size_t { 0 };
+   double * const pNext = pSketch->m_aaItems[iLevelNext] + pSketch->m_acItems[iLevelNext];
+   for(size_t iPromote = 0; iPromote < cPromote; ++iPromote) {
+      pNext[iPromote] = aItems[(iPromote << 1) + iOffset];
+   }
+   pSketch->m_acItems[iLevelNext] += cPromote;
+
+   // with an odd count the largest item stays behind at its current weight
+   if(size_t { 0 } != (size_t { 1 } & cItems)) {
+      aItems[0] = aItems[cItems - size_t { 1 }];
+   }
+   pSketch->m_acItems[iLevel] = size_t { 1 } & cItems;
+   return Error_None;
+}
+
+static ErrorEbm SketchAppend(CutQuantileSketch * const pSketch, const size_t iLevel, const double val) {
+   EBM_ASSERT(iLevel < pSketch->m_cLevels);
+   if(pSketch->m_cItemsPerLevel == pSketch->m_acItems[iLevel]) {
+      const ErrorEbm error = SketchCompact(pSketch, iLevel);
+      if(Error_None != error) {
+         return error;
+      }
+   }
+   EBM_ASSERT(pSketch->m_acItems[iLevel] < pSketch->m_cItemsPerLevel);
+   pSketch->m_aaItems[iLevel][pSketch->m_acItems[iLevel]] = val;
+   ++pSketch->m_acItems[iLevel];
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateCutQuantileSketch(
+   IntEbm countItemsPerLevel,
+   CutQuantileSketchHandle * sketchHandleOut
+) {
+   // don't expose this random seed for the same reasons as the one in CutQuantile
+   static constexpr uint64_t seed = 4201873461183359319u;
+
+   LOG_N(
+      Trace_Info,
+      "Entered CreateCutQuantileSketch: "
+      "countItemsPerLevel=%" IntEbmPrintf ", "
+      "sketchHandleOut=%p"
+      ,
+      countItemsPerLevel,
+      static_cast<const void *>(sketchHandleOut)
+   );
+
+   if(nullptr == sketchHandleOut) {
+      LOG_0(Trace_Error, "ERROR CreateCutQuantileSketch nullptr == sketchHandleOut");
+      return Error_IllegalParamVal;
+   }
+   *sketchHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
+
+   if(countItemsPerLevel < IntEbm { 2 }) {
+      LOG_0(Trace_Error, "ERROR CreateCutQuantileSketch countItemsPerLevel must be at least 2");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countItemsPerLevel)) {
+      LOG_0(Trace_Error, "ERROR CreateCutQuantileSketch IsConvertError<size_t>(countItemsPerLevel)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cItemsPerLevel = static_cast<size_t>(countItemsPerLevel);
+   if(IsMultiplyError(sizeof(double), cItemsPerLevel)) {
+      LOG_0(Trace_Warning, "WARNING CreateCutQuantileSketch IsMultiplyError(sizeof(double), cItemsPerLevel)");
+      return Error_OutOfMemory;
+   }
+
+   CutQuantileSketch * const pSketch = static_cast<CutQuantileSketch *>(malloc(sizeof(CutQuantileSketch)));
+   if(nullptr == pSketch) {
+      LOG_0(Trace_Warning, "WARNING CreateCutQuantileSketch nullptr == pSketch");
+      return Error_OutOfMemory;
+   }
+   double * const aItems = static_cast<double *>(malloc(sizeof(double) * cItemsPerLevel));
+   if(nullptr == aItems) {
+      LOG_0(Trace_Warning, "WARNING CreateCutQuantileSketch nullptr == aItems");
+      free(pSketch);
+      return Error_OutOfMemory;
+   }
+
+   pSketch->m_handleVerification = CutQuantileSketch::k_handleVerificationOk;
+   pSketch->m_cItemsPerLevel = cItemsPerLevel;
+   pSketch->m_cSamples = 0;
+   pSketch->m_cLevels = 1;
+   pSketch->m_rng.Initialize(seed);
+   pSketch->m_acItems[0] = 0;
+   pSketch->m_aaItems[0] = aItems;
+
+   *sketchHandleOut = pSketch->GetHandle();
+
+   LOG_0(Trace_Info, "Exited CreateCutQuantileSketch");
+   return Error_None;
+}
+
+EBM_API_BODY void EBM_CALLING_CONVENTION FreeCutQuantileSketch(
+   CutQuantileSketchHandle sketchHandle
+) {
+   LOG_N(Trace_Info, "Entered FreeCutQuantileSketch: sketchHandle=%p", static_cast<void *>(sketchHandle));
+
+   if(nullptr == sketchHandle) {
+      // like free(nullptr), freeing a null handle is legal
+      return;
+   }
+   CutQuantileSketch * const pSketch = CutQuantileSketch::GetCutQuantileSketchFromHandle(sketchHandle);
+   if(nullptr == pSketch) {
+      // already logged
+      return;
+   }
+   for(size_t iLevel = 0; iLevel < pSketch->m_cLevels; ++iLevel) {
+      free(pSketch->m_aaItems[iLevel]);
+   }
+   pSketch->m_handleVerification = CutQuantileSketch::k_handleVerificationFreed;
+   free(pSketch);
+
+   LOG_0(Trace_Info, "Exited FreeCutQuantileSketch");
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantileAccumulate(
+   CutQuantileSketchHandle sketchHandle,
+   IntEbm countSamples,
+   const double * featureVals
+) {
+   LOG_N(
+      Trace_Verbose,
+      "Entered CutQuantileAccumulate: "
+      "sketchHandle=%p, "
+      "countSamples=%" IntEbmPrintf ", "
+      "featureVals=%p"
+      ,
+      static_cast<void *>(sketchHandle),
+      countSamples,
+      static_cast<const void *>(featureVals)
+   );
+
+   CutQuantileSketch * const pSketch = CutQuantileSketch::GetCutQuantileSketchFromHandle(sketchHandle);
+   if(nullptr == pSketch) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+   if(countSamples <= IntEbm { 0 }) {
+      if(countSamples < IntEbm { 0 }) {
+         LOG_0(Trace_Error, "ERROR CutQuantileAccumulate countSamples < IntEbm { 0 }");
+         return Error_IllegalParamVal;
+      }
+      return Error_None;
+   }
+   if(nullptr == featureVals) {
+      LOG_0(Trace_Error, "ERROR CutQuantileAccumulate nullptr == featureVals");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countSamples) || IsMultiplyError(sizeof(*featureVals), static_cast<size_t>(countSamples))) {
+      LOG_0(Trace_Error, "ERROR CutQuantileAccumulate countSamples was too large to fit into featureVals");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const double val = featureVals[iSample];
+      if(std::isnan(val)) {
+         // CutQuantile ignores missing values too
+         continue;
+      }
+      const ErrorEbm error = SketchAppend(pSketch, 0, val);
+      if(Error_None != error) {
+         return error;
+      }
+      ++pSketch->m_cSamples;
+   }
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantileMerge(
+   CutQuantileSketchHandle sketchHandle,
+   CutQuantileSketchHandle otherSketchHandle
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered CutQuantileMerge: "
+      "sketchHandle=%p, "
+      "otherSketchHandle=%p"
+      ,
+      static_cast<void *>(sketchHandle),
+      static_cast<void *>(otherSketchHandle)
+   );
+
+   CutQuantileSketch * const pSketch = CutQuantileSketch::GetCutQuantileSketchFromHandle(sketchHandle);
+   if(nullptr == pSketch) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+   const CutQuantileSketch * const pOther = CutQuantileSketch::GetCutQuantileSketchFromHandle(otherSketchHandle);
+   if(nullptr == pOther) {
+      // already logged
+      return Error_IllegalParamVal;
+   }
+   if(pSketch == pOther) {
+      LOG_0(Trace_Error, "ERROR CutQuantileMerge cannot merge a sketch into itself");
+      return Error_IllegalParamVal;
+   }
+   if(pSketch->m_cItemsPerLevel != pOther->m_cItemsPerLevel) {
+      LOG_0(Trace_Error, "ERROR CutQuantileMerge both sketches must have the same countItemsPerLevel");
+      return Error_IllegalParamVal;
+   }
+   if(IsAddError(pSketch->m_cSamples, pOther->m_cSamples)) {
+      LOG_0(Trace_Error, "ERROR CutQuantileMerge IsAddError(pSketch->m_cSamples, pOther->m_cSamples)");
+      return Error_IllegalParamVal;
+   }
+
+   // items keep their level, and so their weight.  Appending compacts the levels of the destination as they fill
+   for(size_t iLevel = 0; iLevel < pOther->m_cLevels; ++iLevel) {
+      const double * const aOtherItems = pOther->m_aaItems[iLevel];
+      const size_t cOtherItems = pOther->m_acItems[iLevel];
+      if(size_t { 0 } == cOtherItems) {
+         continue;
+      }
+      while(pSketch->m_cLevels <= iLevel) {
+         // compacting the top level allocates the level above it, so force that even if the top level isn't full
+         const ErrorEbm error = SketchCompact(pSketch, pSketch->m_cLevels - size_t { 1 });
+         if(Error_None != error) {
+            return error;
+         }
+      }
+      for(size_t iItem = 0; iItem < cOtherItems; ++iItem) {
+         const ErrorEbm error = SketchAppend(pSketch, iLevel, aOtherItems[iItem]);
+         if(Error_None != error) {
+            return error;
+         }
+      }
+   }
+   pSketch->m_cSamples += pOther->m_cSamples;
+
+   LOG_0(Trace_Info, "Exited CutQuantileMerge");
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantileFinish(
+   CutQuantileSketchHandle sketchHandle,
+   IntEbm minSamplesBin,
+   BoolEbm isRounded,
+   IntEbm * countCutsInOut,
+   double * cutsLowerBoundInclusiveOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered CutQuantileFinish: "
+      "sketchHandle=%p, "
+      "minSamplesBin=%" IntEbmPrintf ", "
+      "isRounded=%s, "
+      "countCutsInOut=%p, "
+      "cutsLowerBoundInclusiveOut=%p"
+      ,
+      static_cast<void *>(sketchHandle),
+      minSamplesBin,
+      ObtainTruth(isRounded),
+      static_cast<void *>(countCutsInOut),
+      static_cast<void *>(cutsLowerBoundInclusiveOut)
+   );
+
+   const CutQuantileSketch * const pSketch = CutQuantileSketch::GetCutQuantileSketchFromHandle(sketchHandle);
+   if(nullptr == pSketch) {
+      // already logged
+      if(nullptr != countCutsInOut) {
+         *countCutsInOut = IntEbm { 0 };
+      }
+      return Error_IllegalParamVal;
+   }
+
+   // expand every item back into as many copies as the samples it stands for.  Until the first compaction every
+   // item has weight 1, which reproduces the original non-missing values, so CutQuantile then returns exactly the
+   // cuts it would have returned for the whole column.  Larger sketches are resampled down to k_cSketchExpandedMax
+   // values in proportion to their weights, and minSamplesBin is scaled down to match
+   const size_t cSamples = pSketch->m_cSamples;
+   const size_t cExpanded = EbmMin(cSamples, k_cSketchExpandedMax);
+   const double scale = size_t { 0 } == cSamples ? 1.0 : static_cast<double>(cExpanded) / static_cast<double>(cSamples);
+
+   double * const aExpanded = static_cast<double *>(malloc(sizeof(double) * EbmMax(cExpanded, size_t { 1 })));
+   if(nullptr == aExpanded) {
+      LOG_0(Trace_Warning, "WARNING CutQuantileFinish nullptr == aExpanded");
+      if(nullptr != countCutsInOut) {
+         *countCutsInOut = IntEbm { 0 };
+      }
+      return Error_OutOfMemory;
+   }
+
+   size_t cWritten = 0;
+   size_t cumulativeWeight = 0;
+   for(size_t iLevel = 0; iLevel < pSketch->m_cLevels; ++iLevel) {
+      // items only reach a level once at least 2^iLevel samples were accumulated, so the weight fits
+      const size_t weight = size_t { 1 } << iLevel;
+      const double * const aItems = pSketch->m_aaItems[iLevel];
+      const size_t cItems = pSketch->m_acItems[iLevel];
+      for(size_t iItem = 0; iItem < cItems; ++iItem) {
+         cumulativeWeight += weight;
+         size_t iExpandedEnd = cumulativeWeight;
+         if(cExpanded != cSamples) {
+            iExpandedEnd = static_cast<size_t>(static_cast<double>(cumulativeWeight) * scale);
+         }
+         iExpandedEnd = EbmMin(iExpandedEnd, cExpanded);
+         const double val = aItems[iItem];
+         while(cWritten < iExpandedEnd) {
+            aExpanded[cWritten] = val;
+            ++cWritten;
+         }
+      }
+   }
+   EBM_ASSERT(cumulativeWeight == cSamples);
+
+   if(cExpanded != cSamples && IntEbm { 1 } < minSamplesBin) {
+      const double minScaled = std::round(static_cast<double>(minSamplesBin) * scale);
+      minSamplesBin = minScaled < 1.0 ? IntEbm { 1 } : static_cast<IntEbm>(minScaled);
+   }
+
+   EBM_ASSERT(!IsConvertError<IntEbm>(cWritten));
+   const ErrorEbm error = CutQuantile(
+      static_cast<IntEbm>(cWritten),
+      aExpanded,
+      minSamplesBin,
+      isRounded,
+      countCutsInOut,
+      cutsLowerBoundInclusiveOut
+   );
+
+   free(aExpanded);
+
+   LOG_0(Trace_Info, "Exited CutQuantileFinish");
+   return error;
+}
+
+// below this many values per thread the cost of waking the worker threads exceeds the time spent cutting
+static constexpr size_t k_cValsPerCutQuantileTaskMin = size_t { 1 } << 16;
+
+struct CutQuantileManyTask {
+   size_t m_cSamples;
+   size_t m_cFeatures;
+   size_t m_cTasks;
+   const double * m_aFeatureVals;
+   MatrixOrder m_order;
+   IntEbm m_minSamplesBin;
+   BoolEbm m_isRounded;
+   IntEbm * m_aCountCuts;
+   const size_t * m_aiCutsStart;
+   double * m_aCutsLowerBoundInclusive;
+};
+
+static ErrorEbm CutQuantileManyChunk(void * const pContext, const size_t iTask) {
+   const CutQuantileManyTask * const pTask = static_cast<const CutQuantileManyTask *>(pContext);
+
+   const size_t cSamples = pTask->m_cSamples;
+   const size_t cFeatures = pTask->m_cFeatures;
+   EBM_ASSERT(iTask < pTask->m_cTasks);
+
+   // each task gathers its C ordered columns into its own buffer, which it reuses for every feature it handles
+   double * aColumn = nullptr;
+   if(MatrixOrder_C == pTask->m_order) {
+      aColumn = static_cast<double *>(malloc(sizeof(double) * cSamples));
+      if(nullptr == aColumn) {
+         LOG_0(Trace_Warning, "WARNING CutQuantileManyChunk nullptr == aColumn");
+         return Error_OutOfMemory;
+      }
+   }
+
+   ErrorEbm error = Error_None;
+   // features are dealt out round robin, which balances the work since every column has the same length
+   for(size_t iFeature = iTask; iFeature < cFeatures; iFeature += pTask->m_cTasks) {
+      const double * aVals;
+      if(nullptr == aColumn) {
+         aVals = pTask->m_aFeatureVals + iFeature * cSamples;
+      } else {
+         for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+            aColumn[iSample] = pTask->m_aFeatureVals[iSample * cFeatures + iFeature];
+         }
+         aVals = aColumn;
+      }
+
+      // CutQuantile only looks at the one column, so calling it here returns exactly what a per column call would
+      error = CutQuantile(
+         static_cast<IntEbm>(cSamples),
+         aVals,
+         pTask->m_minSamplesBin,
+         pTask->m_isRounded,
+         &pTask->m_aCountCuts[iFeature],
+         pTask->m_aCutsLowerBoundInclusive + pTask->m_aiCutsStart[iFeature]
+      );
+      if(Error_None != error) {
+         break;
+      }
+   }
+
+   free(aColumn);
+   return error;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CutQuantileMany(
+   IntEbm countSamples,
+   IntEbm countFeatures,
+   const double * featureVals,
+   MatrixOrder order,
+   IntEbm minSamplesBin,
+   BoolEbm isRounded,
+   ThreadPoolHandle threadPool,
+   IntEbm * countCutsInOut,
+   double * cutsLowerBoundInclusiveOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered CutQuantileMany: "
+      "countSamples=%" IntEbmPrintf ", "
+      "countFeatures=%" IntEbmPrintf ", "
+      "featureVals=%p, "
+      "order=%" MatrixOrderPrintf ", "
+      "minSamplesBin=%" IntEbmPrintf ", "
+      "isRounded=%s, "
+      "threadPool=%p, "
+      "countCutsInOut=%p, "
+      "cutsLowerBoundInclusiveOut=%p"
+      ,
+      countSamples,
+      countFeatures,
+      static_cast<const void *>(featureVals),
+      order,
+      minSamplesBin,
+      ObtainTruth(isRounded),
+      static_cast<void *>(threadPool),
+      static_cast<void *>(countCutsInOut),
+      static_cast<void *>(cutsLowerBoundInclusiveOut)
+   );
+
+   ThreadPool * pThreadPool = nullptr;
+   if(nullptr != threadPool) {
+      pThreadPool = ThreadPool::GetThreadPoolFromHandle(threadPool);
+      if(nullptr == pThreadPool) {
+         // already logged
+         return Error_IllegalParamVal;
+      }
+   }
+
+   if(IsConvertError<size_t>(countSamples)) {
+      LOG_0(Trace_Error, "ERROR CutQuantileMany countSamples is outside the range of a valid index");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   if(IsConvertError<size_t>(countFeatures)) {
+      LOG_0(Trace_Error, "ERROR CutQuantileMany countFeatures is outside the range of a valid index");
+      return Error_IllegalParamVal;
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+
+   if(MatrixOrder_C != order && MatrixOrder_Fortran != order) {
+      LOG_0(Trace_Error, "ERROR CutQuantileMany order must be MatrixOrder_C or MatrixOrder_Fortran");
+      return Error_IllegalParamVal;
+   }
+
+   if(size_t { 0 } == cFeatures) {
+      return Error_None;
+   }
+   if(nullptr == countCutsInOut) {
+      LOG_0(Trace_Error, "ERROR CutQuantileMany countCutsInOut cannot be null");
+      return Error_IllegalParamVal;
+   }
+   if(IsMultiplyError(sizeof(*featureVals), cSamples, cFeatures)) {
+      LOG_0(Trace_Error, "ERROR CutQuantileMany the matrix is too large to fit into memory");
+      return Error_IllegalParamVal;
+   }
+   if(size_t { 0 } != cSamples && nullptr == featureVals) {
+      LOG_0(Trace_Error, "ERROR CutQuantileMany featureVals cannot be null");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsMultiplyError(sizeof(size_t), cFeatures)) {
+      LOG_0(Trace_Error, "ERROR CutQuantileMany IsMultiplyError(sizeof(size_t), cFeatures)");
+      return Error_IllegalParamVal;
+   }
+   size_t * const aiCutsStart = static_cast<size_t *>(malloc(sizeof(size_t) * cFeatures));
+   if(nullptr == aiCutsStart) {
+      LOG_0(Trace_Warning, "WARNING CutQuantileMany nullptr == aiCutsStart");
+      return Error_OutOfMemory;
+   }
+
+   ErrorEbm error = Error_IllegalParamVal;
+
+   // each feature's cuts are written starting after the space requested by the features before it
+   size_t cCutsTotal = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const IntEbm countCutsFeature = countCutsInOut[iFeature];
+      if(IsConvertError<size_t>(countCutsFeature)) {
+         LOG_0(Trace_Error, "ERROR CutQuantileMany countCutsInOut contains an invalid count");
+         goto exit_free;
+      }
+      aiCutsStart[iFeature] = cCutsTotal;
+      if(IsAddError(cCutsTotal, static_cast<size_t>(countCutsFeature))) {
+         LOG_0(Trace_Error, "ERROR CutQuantileMany IsAddError(cCutsTotal, countCutsFeature)");
+         goto exit_free;
+      }
+      cCutsTotal += static_cast<size_t>(countCutsFeature);
+   }
+   if(size_t { 0 } != cCutsTotal && nullptr == cutsLowerBoundInclusiveOut) {
+      LOG_0(Trace_Error, "ERROR CutQuantileMany cutsLowerBoundInclusiveOut cannot be null");
+      goto exit_free;
+   }
+
+   {
+      CutQuantileManyTask task;
+      task.m_cSamples = cSamples;
+      task.m_cFeatures = cFeatures;
+      task.m_cTasks = 1;
+      task.m_aFeatureVals = featureVals;
+      task.m_order = order;
+      task.m_minSamplesBin = minSamplesBin;
+      task.m_isRounded = isRounded;
+      task.m_aCountCuts = countCutsInOut;
+      task.m_aiCutsStart = aiCutsStart;
+      task.m_aCutsLowerBoundInclusive = cutsLowerBoundInclusiveOut;
+
+      if(nullptr != pThreadPool && size_t { 1 } != pThreadPool->GetCountThreads() && size_t { 1 } != cFeatures &&
+         k_cValsPerCutQuantileTaskMin < cSamples * cFeatures) {
+
+         const size_t cThreads = pThreadPool->GetCountThreads();
+         size_t cTasks = EbmMin(cThreads, cFeatures);
+         cTasks = EbmMin(cTasks, cSamples * cFeatures / k_cValsPerCutQuantileTaskMin);
+         EBM_ASSERT(size_t { 1 } <= cTasks);
+
+         task.m_cTasks = cTasks;
+         error = pThreadPool->Run(cTasks, CutQuantileManyChunk, &task);
+      } else {
+         error = CutQuantileManyChunk(&task, 0);
+      }
+   }
+
+exit_free:;
+   free(aiCutsStart);
+   return error;
+}
+
 } // DEFINED_ZONE_NAME
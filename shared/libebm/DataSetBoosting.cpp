@@ -24,8 +24,9 @@ void DataSubsetBoosting::DestructDataSubsetBoosting(const size_t cTerms, const s
    LOG_0(Trace_Info, "Entered DataSubsetBoosting::DestructDataSubsetBoosting");
 
    InnerBag::FreeInnerBags(cInnerBags, m_aInnerBags);
+   AlignedFree(m_aWeights);
 
-   void ** paTermData = m_aaTermData;
+   void ** paTermData = m_bTermDataShared ? nullptr : m_aaTermData;
    if(nullptr != paTermData) {
       EBM_ASSERT(1 <= cTerms);
       const void * const * const paTermDataEnd = paTermData + cTerms;
@@ -96,6 +97,7 @@ ErrorEbm DataSetBoosting::InitSampleScores(
    const size_t cScores,
    const BagEbm direction,
    const BagEbm * const aBag,
+   const size_t * const aiSortedInit,
    const double * const aInitScores
 ) {
    LOG_0(Trace_Info, "Entered DataSetBoosting::InitSampleScores");
@@ -134,6 +136,7 @@ ErrorEbm DataSetBoosting::InitSampleScores(
       } while(pSubsetsEnd != pSubset);
    } else {
       const BagEbm * pSampleReplication = aBag;
+      const size_t * piSortedInit = aiSortedInit;
       const double * pInitScore;
       const double * pFromEnd = aInitScores;
       const bool isLoopValidation = direction < BagEbm { 0 };
@@ -164,19 +167,27 @@ ErrorEbm DataSetBoosting::InitSampleScores(
             size_t iPartition = 0;
             do {
                if(BagEbm { 0 } == replication) {
-                  pInitScore = pFromEnd;
-                  replication = 1;
-                  if(nullptr != pSampleReplication) {
-                     bool isItemValidation;
-                     do {
+                  if(nullptr != piSortedInit) {
+                     // sorted datasets list every replicated sample individually, in their new order
+                     pInitScore = &aInitScores[*piSortedInit * cScores];
+                     ++piSortedInit;
+                     replication = direction;
+                  } else {
+                     pInitScore = pFromEnd;
+                     replication = 1;
+                     if(nullptr != pSampleReplication) {
+                        // init scores only exist for samples with non-zero bag entries
+                        bool isItemValidation;
                         do {
-                           replication = *pSampleReplication;
-                           ++pSampleReplication;
-                        } while(BagEbm { 0 } == replication);
-                        isItemValidation = replication < BagEbm { 0 };
-                        pInitScore += cScores;
-                     } while(isLoopValidation != isItemValidation);
-                     pInitScore -= cScores;
+                           do {
+                              replication = *pSampleReplication;
+                              ++pSampleReplication;
+                           } while(BagEbm { 0 } == replication);
+                           isItemValidation = replication < BagEbm { 0 };
+                           pInitScore += cScores;
+                        } while(isLoopValidation != isItemValidation);
+                        pInitScore -= cScores;
+                     }
                   }
                   pFromEnd = &pInitScore[cScores];
                }
@@ -217,7 +228,8 @@ WARNING_DISABLE_UNINITIALIZED_LOCAL_VARIABLE
 ErrorEbm DataSetBoosting::InitTargetData(
    const unsigned char * const pDataSetShared,
    const BagEbm direction,
-   const BagEbm * const aBag
+   const BagEbm * const aBag,
+   const size_t * const aiSortedShared
 ) {
    LOG_0(Trace_Info, "Entered DataSetBoosting::InitTargetData");
 
@@ -239,6 +251,7 @@ ErrorEbm DataSetBoosting::InitTargetData(
 
    BagEbm replication = 0;
    if(IsClassification(cClasses)) {
+      const size_t * piSortedShared = aiSortedShared;
       const UIntShared * pTargetFrom = static_cast<const UIntShared *>(aTargets);
       UIntShared iData;
       do {
@@ -259,21 +272,28 @@ ErrorEbm DataSetBoosting::InitTargetData(
          const void * const pTargetToEnd = IndexByte(pTargetTo, cBytes);
          do {
             if(BagEbm { 0 } == replication) {
-               replication = 1;
-               if(nullptr != pSampleReplication) {
-                  bool isItemValidation;
-                  do {
+               if(nullptr != piSortedShared) {
+                  // sorted datasets list every replicated sample individually, in their new order
+                  iData = static_cast<const UIntShared *>(aTargets)[*piSortedShared];
+                  ++piSortedShared;
+                  replication = direction;
+               } else {
+                  replication = 1;
+                  if(nullptr != pSampleReplication) {
+                     bool isItemValidation;
                      do {
-                        replication = *pSampleReplication;
-                        ++pSampleReplication;
-                        ++pTargetFrom;
-                     } while(BagEbm { 0 } == replication);
-                     isItemValidation = replication < BagEbm { 0 };
-                  } while(isLoopValidation != isItemValidation);
-                  --pTargetFrom;
+                        do {
+                           replication = *pSampleReplication;
+                           ++pSampleReplication;
+                           ++pTargetFrom;
+                        } while(BagEbm { 0 } == replication);
+                        isItemValidation = replication < BagEbm { 0 };
+                     } while(isLoopValidation != isItemValidation);
+                     --pTargetFrom;
+                  }
+                  iData = *pTargetFrom;
+                  ++pTargetFrom;
                }
-               iData = *pTargetFrom;
-               ++pTargetFrom;
 
 #ifndef NDEBUG
                // this was checked when creating the shared dataset
@@ -303,6 +323,7 @@ ErrorEbm DataSetBoosting::InitTargetData(
          ++pSubset;
       } while(pSubsetsEnd != pSubset);
    } else {
+      EBM_ASSERT(nullptr == aiSortedShared); // we only sort classification datasets
       const FloatShared * pTargetFrom = static_cast<const FloatShared *>(aTargets);
       FloatShared data;
       do {
@@ -366,6 +387,10 @@ struct FeatureDimension {
    void operator delete (void *) = delete; // we only use malloc/free in this library
 
    const UIntShared * m_pFeatureDataFrom;
+   const SparseFeatureDataSetSharedEntry * m_pNonDefaultFrom; // nullptr if the feature is dense
+   const SparseFeatureDataSetSharedEntry * m_pNonDefaultFromEnd;
+   UIntShared m_iSampleFrom;
+   size_t m_iDefaultBin;
    size_t m_maskBitsFrom;
    size_t m_cBins;
    int m_cItemsPerBitPackFrom;
@@ -377,6 +402,40 @@ static_assert(std::is_standard_layout<FeatureDimension>::value,
 static_assert(std::is_trivial<FeatureDimension>::value,
    "We use memcpy in several places, so disallow non-trivial types in general");
 
+// datasets sorted by target visit the shared samples out of order, so decode the bin of any sample directly
+static size_t GetFeatureBinAt(const FeatureDimension * const pDimensionInfo, const size_t iSample) {
+   const SparseFeatureDataSetSharedEntry * pNonDefaultFrom = pDimensionInfo->m_pNonDefaultFrom;
+   if(nullptr != pNonDefaultFrom) {
+      // the entries are sorted by sample, so binary search for the first one at or after iSample
+      const SparseFeatureDataSetSharedEntry * const pNonDefaultFromEnd = pDimensionInfo->m_pNonDefaultFromEnd;
+      size_t cRemaining = static_cast<size_t>(pNonDefaultFromEnd - pNonDefaultFrom);
+      while(size_t { 0 } != cRemaining) {
+         const size_t cHalf = cRemaining >> 1;
+         const SparseFeatureDataSetSharedEntry * const pMiddle = pNonDefaultFrom + cHalf;
+         if(pMiddle->m_iSample < static_cast<UIntShared>(iSample)) {
+            pNonDefaultFrom = pMiddle + 1;
+            cRemaining -= cHalf + size_t { 1 };
+         } else {
+            cRemaining = cHalf;
+         }
+      }
+      if(pNonDefaultFromEnd != pNonDefaultFrom && static_cast<UIntShared>(iSample) == pNonDefaultFrom->m_iSample) {
+         return static_cast<size_t>(pNonDefaultFrom->m_nonDefaultVal);
+      }
+      return pDimensionInfo->m_iDefaultBin;
+   }
+
+   // the first sample is stored at m_iShiftFrom within the first data unit, and the shifts count down from there
+   const size_t cItemsPerBitPackFrom = static_cast<size_t>(pDimensionInfo->m_cItemsPerBitPackFrom);
+   EBM_ASSERT(0 <= pDimensionInfo->m_iShiftFrom);
+   EBM_ASSERT(static_cast<size_t>(pDimensionInfo->m_iShiftFrom) < cItemsPerBitPackFrom);
+   const size_t iPacked = iSample + (cItemsPerBitPackFrom - size_t { 1 } - static_cast<size_t>(pDimensionInfo->m_iShiftFrom));
+   const int iShiftFrom = static_cast<int>(cItemsPerBitPackFrom - size_t { 1 } - iPacked % cItemsPerBitPackFrom);
+   const UIntShared bitsFrom = pDimensionInfo->m_pFeatureDataFrom[iPacked / cItemsPerBitPackFrom];
+   return static_cast<size_t>(bitsFrom >> (iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom)) &
+      pDimensionInfo->m_maskBitsFrom;
+}
+
 WARNING_PUSH
 WARNING_DISABLE_UNINITIALIZED_LOCAL_VARIABLE
 ErrorEbm DataSetBoosting::InitTermData(
@@ -384,6 +443,7 @@ ErrorEbm DataSetBoosting::InitTermData(
    const BagEbm direction,
    const size_t cSharedSamples,
    const BagEbm * const aBag,
+   const size_t * const aiSortedShared,
    const size_t cTerms,
    const Term * const * const apTerms,
    const IntEbm * const aiTermFeatures
@@ -447,12 +507,24 @@ ErrorEbm DataSetBoosting::InitTermData(
                   &cNonDefaultsSparse
                );
                EBM_ASSERT(nullptr != pFeatureDataFrom);
-               EBM_ASSERT(!bSparse); // we don't support sparse yet
 
                EBM_ASSERT(!IsConvertError<size_t>(cBinsUnused)); // since we previously extracted cBins and checked
                EBM_ASSERT(static_cast<size_t>(cBinsUnused) == cBins);
 
-               pDimensionInfoInit->m_pFeatureDataFrom = static_cast<const UIntShared *>(pFeatureDataFrom);
+               if(bSparse) {
+                  EBM_ASSERT(!IsConvertError<size_t>(defaultValSparse));
+                  EBM_ASSERT(static_cast<size_t>(defaultValSparse) < cBins);
+                  const SparseFeatureDataSetSharedEntry * const pNonDefaultFrom =
+                     static_cast<const SparseFeatureDataSetSharedEntry *>(pFeatureDataFrom);
+                  pDimensionInfoInit->m_pFeatureDataFrom = nullptr;
+                  pDimensionInfoInit->m_pNonDefaultFrom = pNonDefaultFrom;
+                  pDimensionInfoInit->m_pNonDefaultFromEnd = pNonDefaultFrom + cNonDefaultsSparse;
+                  pDimensionInfoInit->m_iSampleFrom = 0;
+                  pDimensionInfoInit->m_iDefaultBin = static_cast<size_t>(defaultValSparse);
+               } else {
+                  pDimensionInfoInit->m_pFeatureDataFrom = static_cast<const UIntShared *>(pFeatureDataFrom);
+                  pDimensionInfoInit->m_pNonDefaultFrom = nullptr;
+               }
                pDimensionInfoInit->m_cBins = cBins;
 
                const int cBitsRequiredMin = CountBitsRequired(cBins - size_t { 1 });
@@ -488,8 +560,11 @@ ErrorEbm DataSetBoosting::InitTermData(
          EBM_ASSERT(pDimensionInfoInit == &dimensionInfo[pTerm->GetCountRealDimensions()]);
 
          EBM_ASSERT(nullptr != aBag || !isLoopValidation); // if aBag is nullptr then we have no validation samples
+
          const BagEbm * pSampleReplication = aBag;
+         const size_t * piSortedShared = aiSortedShared;
          BagEbm replication = 0;
+         size_t iSampleSorted;
          size_t iTensor;
 
          DataSubsetBoosting * pSubset = m_aSubsets;
@@ -539,36 +614,47 @@ ErrorEbm DataSetBoosting::InitTermData(
                   size_t iPartition = 0;
                   do {
                      if(BagEbm { 0 } == replication) {
-                        replication = 1;
-                        if(nullptr != pSampleReplication) {
-                           const BagEbm * pSampleReplicationOriginal = pSampleReplication;
-                           bool isItemValidation;
-                           do {
-                              do {
-                                 replication = *pSampleReplication;
-                                 ++pSampleReplication;
-                              } while(BagEbm { 0 } == replication);
-                              isItemValidation = replication < BagEbm { 0 };
-                           } while(isLoopValidation != isItemValidation);
-                           const size_t cAdvances = pSampleReplication - pSampleReplicationOriginal - 1;
-                           if(0 != cAdvances) {
-                              FeatureDimension * pDimensionInfo = dimensionInfo;
+                        if(nullptr != piSortedShared) {
+                           // sorted datasets list every replicated sample individually, in their new order
+                           iSampleSorted = *piSortedShared;
+                           ++piSortedShared;
+                           replication = direction;
+                        } else {
+                           replication = 1;
+                           if(nullptr != pSampleReplication) {
+                              const BagEbm * pSampleReplicationOriginal = pSampleReplication;
+                              bool isItemValidation;
                               do {
-                                 const int cItemsPerBitPackFrom = pDimensionInfo->m_cItemsPerBitPackFrom;
-                                 size_t cCompleteAdvanced = cAdvances / static_cast<size_t>(cItemsPerBitPackFrom);
-                                 int iShiftFrom = pDimensionInfo->m_iShiftFrom;
-                                 EBM_ASSERT(0 <= iShiftFrom);
-                                 iShiftFrom -= static_cast<int>(cAdvances % static_cast<size_t>(cItemsPerBitPackFrom));
-                                 pDimensionInfo->m_iShiftFrom = iShiftFrom;
-                                 if(iShiftFrom < 0) {
-                                    pDimensionInfo->m_iShiftFrom = iShiftFrom + cItemsPerBitPackFrom;
-                                    EBM_ASSERT(0 <= pDimensionInfo->m_iShiftFrom);
-                                    ++cCompleteAdvanced;
-                                 }
-                                 pDimensionInfo->m_pFeatureDataFrom += cCompleteAdvanced;
-
-                                 ++pDimensionInfo;
-                              } while(pDimensionInfoInit != pDimensionInfo);
+                                 do {
+                                    replication = *pSampleReplication;
+                                    ++pSampleReplication;
+                                 } while(BagEbm { 0 } == replication);
+                                 isItemValidation = replication < BagEbm { 0 };
+                              } while(isLoopValidation != isItemValidation);
+                              const size_t cAdvances = pSampleReplication - pSampleReplicationOriginal - 1;
+                              if(0 != cAdvances) {
+                                 FeatureDimension * pDimensionInfo = dimensionInfo;
+                                 do {
+                                    if(nullptr != pDimensionInfo->m_pNonDefaultFrom) {
+                                       pDimensionInfo->m_iSampleFrom += static_cast<UIntShared>(cAdvances);
+                                    } else {
+                                       const int cItemsPerBitPackFrom = pDimensionInfo->m_cItemsPerBitPackFrom;
+                                       size_t cCompleteAdvanced = cAdvances / static_cast<size_t>(cItemsPerBitPackFrom);
+                                       int iShiftFrom = pDimensionInfo->m_iShiftFrom;
+                                       EBM_ASSERT(0 <= iShiftFrom);
+                                       iShiftFrom -= static_cast<int>(cAdvances % static_cast<size_t>(cItemsPerBitPackFrom));
+                                       pDimensionInfo->m_iShiftFrom = iShiftFrom;
+                                       if(iShiftFrom < 0) {
+                                          pDimensionInfo->m_iShiftFrom = iShiftFrom + cItemsPerBitPackFrom;
+                                          EBM_ASSERT(0 <= pDimensionInfo->m_iShiftFrom);
+                                          ++cCompleteAdvanced;
+                                       }
+                                       pDimensionInfo->m_pFeatureDataFrom += cCompleteAdvanced;
+                                    }
+
+                                    ++pDimensionInfo;
+                                 } while(pDimensionInfoInit != pDimensionInfo);
+                              }
                            }
                         }
 
@@ -576,27 +662,48 @@ ErrorEbm DataSetBoosting::InitTermData(
                         size_t tensorMultiple = 1;
                         FeatureDimension * pDimensionInfo = dimensionInfo;
                         do {
-                           const UIntShared * const pFeatureDataFrom = pDimensionInfo->m_pFeatureDataFrom;
-                           const UIntShared bitsFrom = *pFeatureDataFrom;
-
-                           int iShiftFrom = pDimensionInfo->m_iShiftFrom;
-                           EBM_ASSERT(0 <= iShiftFrom);
-                           EBM_ASSERT(iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom < COUNT_BITS(UIntShared));
-                           const size_t iFeatureBin = static_cast<size_t>(bitsFrom >>
-                              (iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom)) &
-                              pDimensionInfo->m_maskBitsFrom;
+                           size_t iFeatureBin;
+                           const SparseFeatureDataSetSharedEntry * pNonDefaultFrom = pDimensionInfo->m_pNonDefaultFrom;
+                           if(nullptr != piSortedShared) {
+                              iFeatureBin = GetFeatureBinAt(pDimensionInfo, iSampleSorted);
+                           } else if(nullptr != pNonDefaultFrom) {
+                              const UIntShared iSampleFrom = pDimensionInfo->m_iSampleFrom;
+                              const SparseFeatureDataSetSharedEntry * const pNonDefaultFromEnd =
+                                 pDimensionInfo->m_pNonDefaultFromEnd;
+                              // the entries are sorted by sample, so skip the ones that belonged to excluded samples
+                              while(pNonDefaultFromEnd != pNonDefaultFrom && pNonDefaultFrom->m_iSample < iSampleFrom) {
+                                 ++pNonDefaultFrom;
+                              }
+                              iFeatureBin = pDimensionInfo->m_iDefaultBin;
+                              if(pNonDefaultFromEnd != pNonDefaultFrom && iSampleFrom == pNonDefaultFrom->m_iSample) {
+                                 iFeatureBin = static_cast<size_t>(pNonDefaultFrom->m_nonDefaultVal);
+                                 ++pNonDefaultFrom;
+                              }
+                              pDimensionInfo->m_pNonDefaultFrom = pNonDefaultFrom;
+                              pDimensionInfo->m_iSampleFrom = iSampleFrom + UIntShared { 1 };
+                           } else {
+                              const UIntShared * const pFeatureDataFrom = pDimensionInfo->m_pFeatureDataFrom;
+                              const UIntShared bitsFrom = *pFeatureDataFrom;
+
+                              int iShiftFrom = pDimensionInfo->m_iShiftFrom;
+                              EBM_ASSERT(0 <= iShiftFrom);
+                              EBM_ASSERT(iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom < COUNT_BITS(UIntShared));
+                              iFeatureBin = static_cast<size_t>(bitsFrom >>
+                                 (iShiftFrom * pDimensionInfo->m_cBitsPerItemMaxFrom)) &
+                                 pDimensionInfo->m_maskBitsFrom;
+
+                              --iShiftFrom;
+                              pDimensionInfo->m_iShiftFrom = iShiftFrom;
+                              if(iShiftFrom < 0) {
+                                 EBM_ASSERT(-1 == iShiftFrom);
+                                 pDimensionInfo->m_iShiftFrom = iShiftFrom + pDimensionInfo->m_cItemsPerBitPackFrom;
+                                 pDimensionInfo->m_pFeatureDataFrom = pFeatureDataFrom + 1;
+                              }
+                           }
 
                            // we check our dataSet when we get the header, and cBins has been checked to fit into size_t
                            EBM_ASSERT(iFeatureBin < pDimensionInfo->m_cBins);
 
-                           --iShiftFrom;
-                           pDimensionInfo->m_iShiftFrom = iShiftFrom;
-                           if(iShiftFrom < 0) {
-                              EBM_ASSERT(-1 == iShiftFrom);
-                              pDimensionInfo->m_iShiftFrom = iShiftFrom + pDimensionInfo->m_cItemsPerBitPackFrom;
-                              pDimensionInfo->m_pFeatureDataFrom = pFeatureDataFrom + 1;
-                           }
-
                            // we check for overflows during Term construction, but let's check here again
                            EBM_ASSERT(!IsMultiplyError(tensorMultiple, pDimensionInfo->m_cBins));
 
@@ -651,17 +758,28 @@ ErrorEbm DataSetBoosting::InitBags(
    const unsigned char * const pDataSetShared,
    const BagEbm direction,
    const BagEbm * const aBag,
+   const size_t * const aiSortedShared,
+   const size_t * const aiSortedIncluded,
    const size_t cInnerBags,
-   const size_t cWeights
+   const bool bCompactInnerBags,
+   const size_t cWeights,
+   const BagEbm * const aBagMask,
+   const size_t cSharedSamples
 ) {
    LOG_0(Trace_Info, "Entered DataSetBoosting::InitBags");
 
    EBM_ASSERT(nullptr != pDataSetShared);
    EBM_ASSERT(BagEbm { -1 } == direction || BagEbm { 1 } == direction);
+   EBM_ASSERT(nullptr == aBagMask || nullptr == aBag && nullptr == aiSortedShared);
 
    const size_t cIncludedSamples = m_cSamples;
    EBM_ASSERT(1 <= cIncludedSamples);
 
+   // masked datasets keep a slot for every shared sample. The inner bags are drawn over the included samples, 
+   // exactly as they would be without the mask, and then the draws of each replicated sample are summed into its slot
+   const size_t cSlotSamples = nullptr == aBagMask ? cIncludedSamples : cSharedSamples;
+   const size_t cDrawnSamples = nullptr == aBagMask || size_t { 0 } == cInnerBags ? size_t { 0 } : cIncludedSamples;
+
    const size_t cInnerBagsAfterZero = size_t { 0 } == cInnerBags ? size_t { 1 } : cInnerBags;
 
    if(IsMultiplyError(sizeof(double), cInnerBagsAfterZero)) {
@@ -698,12 +816,13 @@ ErrorEbm DataSetBoosting::InitBags(
          const RandomDeterministic * const pRng = reinterpret_cast<RandomDeterministic *>(rng);
          cpuRng.Initialize(*pRng); // move the RNG from memory into CPU registers
       }
-
-      if(IsMultiplyError(sizeof(uint8_t), cIncludedSamples)) {
-         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags IsMultiplyError(sizeof(uint8_t), cIncludedSamples)");
+   }
+   if(size_t { 0 } != cInnerBags || nullptr != aBagMask) {
+      if(IsAddError(cSlotSamples, cDrawnSamples) || IsMultiplyError(sizeof(uint8_t), cSlotSamples + cDrawnSamples)) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags IsMultiplyError(sizeof(uint8_t), cSlotSamples + cDrawnSamples)");
          return Error_OutOfMemory;
       }
-      aOccurrencesFrom = static_cast<uint8_t *>(malloc(sizeof(uint8_t) * cIncludedSamples));
+      aOccurrencesFrom = static_cast<uint8_t *>(malloc(sizeof(uint8_t) * (cSlotSamples + cDrawnSamples)));
       if(nullptr == aOccurrencesFrom) {
          LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags nullptr == aCountOccurrences");
          return Error_OutOfMemory;
@@ -718,6 +837,7 @@ ErrorEbm DataSetBoosting::InitBags(
 
    const bool isLoopValidation = direction < BagEbm { 0 };
    EBM_ASSERT(nullptr != aBag || !isLoopValidation); // if aBag is nullptr then we have no validation samples
+   EBM_ASSERT((nullptr == aiSortedShared) == (nullptr == aiSortedIncluded));
 
    EBM_ASSERT(nullptr != m_aSubsets);
    EBM_ASSERT(1 <= m_cSubsets);
@@ -725,28 +845,55 @@ ErrorEbm DataSetBoosting::InitBags(
 
    size_t iBag = 0;
    do {
-      if(nullptr != aOccurrencesFrom) {
-         memset(aOccurrencesFrom, 0, sizeof(*aOccurrencesFrom) * cIncludedSamples);
+      if(size_t { 0 } != cInnerBags) {
+         uint8_t * const aOccurrencesDrawn = nullptr == aBagMask ? aOccurrencesFrom : &aOccurrencesFrom[cSlotSamples];
+         memset(aOccurrencesDrawn, 0, sizeof(*aOccurrencesDrawn) * cIncludedSamples);
 
          size_t cSamplesRemaining = cIncludedSamples;
          do {
             const size_t iSample = cpuRng.NextFast(cIncludedSamples);
-            const uint8_t existing = aOccurrencesFrom[iSample];
+            const uint8_t existing = aOccurrencesDrawn[iSample];
             if(std::numeric_limits<uint8_t>::max() == existing) {
                // it should be essentially impossible for sampling with replacement to get to 255 items in the bin
                // but check it anyways..
                continue;
             }
-            aOccurrencesFrom[iSample] = existing + uint8_t { 1 };
+            aOccurrencesDrawn[iSample] = existing + uint8_t { 1 };
             --cSamplesRemaining;
          } while(size_t { 0 } != cSamplesRemaining);
       }
+      if(nullptr != aBagMask) {
+         const uint8_t * pOccurrencesDrawn = &aOccurrencesFrom[cSlotSamples];
+         for(size_t iShared = 0; iShared < cSharedSamples; ++iShared) {
+            BagEbm replication = aBagMask[iShared];
+            size_t cOccurrences = 0;
+            if(BagEbm { 0 } < replication) {
+               if(size_t { 0 } == cInnerBags) {
+                  cOccurrences = static_cast<size_t>(replication);
+               } else {
+                  do {
+                     cOccurrences += static_cast<size_t>(*pOccurrencesDrawn);
+                     ++pOccurrencesDrawn;
+                     --replication;
+                  } while(BagEbm { 0 } != replication);
+               }
+            }
+            if(size_t { std::numeric_limits<uint8_t>::max() } < cOccurrences) {
+               // a sample would need to be drawn more than 255 times across its replicas, which is essentially impossible
+               LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags too many occurrences for a masked sample");
+               free(aOccurrencesFrom);
+               return Error_UnexpectedInternal;
+            }
+            aOccurrencesFrom[iShared] = static_cast<uint8_t>(cOccurrences);
+         }
+      }
 
       double totalWeight;
       if(nullptr == aWeightsFrom) {
          totalWeight = static_cast<double>(cIncludedSamples);
          if(nullptr != aOccurrencesFrom) {
             const uint8_t * pOccurrencesFrom = aOccurrencesFrom;
+            const size_t * piSortedIncluded = aiSortedIncluded;
             DataSubsetBoosting * pSubset = m_aSubsets;
             do {
                EBM_ASSERT(nullptr != pSubset->m_aInnerBags);
@@ -755,21 +902,25 @@ ErrorEbm DataSetBoosting::InitBags(
                const size_t cSubsetSamples = pSubset->GetCountSamples();
                EBM_ASSERT(1 <= cSubsetSamples);
 
-               if(IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cSubsetSamples)) {
-                  LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cSubsetSamples)");
-                  free(aOccurrencesFrom);
-                  return Error_OutOfMemory;
-               }
-               const size_t cBytes = pSubset->m_pObjective->m_cFloatBytes * cSubsetSamples;
-               void * pWeightTo = AlignedAlloc(cBytes);
-               if(nullptr == pWeightTo) {
-                  LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags nullptr == pWeightsInternal");
-                  free(aOccurrencesFrom);
-                  return Error_OutOfMemory;
+               // compact inner bags do not materialize the weights since they are just the occurrence counts
+               void * pWeightTo = nullptr;
+               if(!bCompactInnerBags) {
+                  if(IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cSubsetSamples)) {
+                     LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cSubsetSamples)");
+                     free(aOccurrencesFrom);
+                     return Error_OutOfMemory;
+                  }
+                  const size_t cBytes = pSubset->m_pObjective->m_cFloatBytes * cSubsetSamples;
+                  pWeightTo = AlignedAlloc(cBytes);
+                  if(nullptr == pWeightTo) {
+                     LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags nullptr == pWeightsInternal");
+                     free(aOccurrencesFrom);
+                     return Error_OutOfMemory;
+                  }
+                  pInnerBag->m_aWeights = pWeightTo;
                }
-               pInnerBag->m_aWeights = pWeightTo;
 
-               EBM_ASSERT(cSubsetSamples <= cIncludedSamples);
+               EBM_ASSERT(cSubsetSamples <= cSlotSamples);
 
                EBM_ASSERT(sizeof(uint8_t) <= pSubset->m_pObjective->m_cFloatBytes);
                uint8_t * pOccurrencesTo = static_cast<uint8_t *>(AlignedAlloc(sizeof(uint8_t) * cSubsetSamples));
@@ -780,22 +931,31 @@ ErrorEbm DataSetBoosting::InitBags(
                }
                pInnerBag->m_aCountOccurrences = pOccurrencesTo;
 
-               const void * const pWeightsToEnd = IndexByte(pWeightTo, cBytes);
+               const uint8_t * const pOccurrencesToEnd = pOccurrencesTo + cSubsetSamples;
                do {
-                  const uint8_t cOccurrences = *pOccurrencesFrom;
+                  uint8_t cOccurrences;
+                  if(nullptr != piSortedIncluded) {
+                     // the occurrences were drawn in the original order, so look up where each sorted sample came from
+                     cOccurrences = aOccurrencesFrom[*piSortedIncluded];
+                     ++piSortedIncluded;
+                  } else {
+                     cOccurrences = *pOccurrencesFrom;
+                     ++pOccurrencesFrom;
+                  }
                   *pOccurrencesTo = cOccurrences;
 
-                  if(sizeof(FloatBig) == pSubset->m_pObjective->m_cFloatBytes) {
-                     *reinterpret_cast<FloatBig *>(pWeightTo) = static_cast<FloatBig>(cOccurrences);
-                  } else {
-                     EBM_ASSERT(sizeof(FloatSmall) == pSubset->m_pObjective->m_cFloatBytes);
-                     *reinterpret_cast<FloatSmall *>(pWeightTo) = static_cast<FloatSmall>(cOccurrences);
+                  if(nullptr != pWeightTo) {
+                     if(sizeof(FloatBig) == pSubset->m_pObjective->m_cFloatBytes) {
+                        *reinterpret_cast<FloatBig *>(pWeightTo) = static_cast<FloatBig>(cOccurrences);
+                     } else {
+                        EBM_ASSERT(sizeof(FloatSmall) == pSubset->m_pObjective->m_cFloatBytes);
+                        *reinterpret_cast<FloatSmall *>(pWeightTo) = static_cast<FloatSmall>(cOccurrences);
+                     }
+                     pWeightTo = IndexByte(pWeightTo, pSubset->m_pObjective->m_cFloatBytes);
                   }
-                  pWeightTo = IndexByte(pWeightTo, pSubset->m_pObjective->m_cFloatBytes);
 
-                  ++pOccurrencesFrom;
                   ++pOccurrencesTo;
-               } while(pWeightsToEnd != pWeightTo);
+               } while(pOccurrencesToEnd != pOccurrencesTo);
 
                ++pSubset;
             } while(pSubsetsEnd != pSubset);
@@ -803,35 +963,48 @@ ErrorEbm DataSetBoosting::InitBags(
       } else {
          const uint8_t * pOccurrencesFrom = aOccurrencesFrom;
          const BagEbm * pSampleReplication = aBag;
+         const size_t * piSortedShared = aiSortedShared;
+         const size_t * piSortedIncluded = aiSortedIncluded;
          const FloatShared * pWeightFrom = aWeightsFrom;
          DataSubsetBoosting * pSubset = m_aSubsets;
          totalWeight = 0.0;
 
+         // compact inner bags share a single copy of the sample weights, which we write on the first bag
+         const bool bCompact = bCompactInnerBags && nullptr != pOccurrencesFrom;
+
          BagEbm replication = 0;
          double weight;
          do {
             const size_t cSubsetSamples = pSubset->GetCountSamples();
             EBM_ASSERT(1 <= cSubsetSamples);
 
-            if(IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cSubsetSamples)) {
-               LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cSubsetSamples)");
-               free(aOccurrencesFrom);
-               return Error_OutOfMemory;
-            }
-            const size_t cBytes = pSubset->m_pObjective->m_cFloatBytes * cSubsetSamples;
-            void * pWeightTo = AlignedAlloc(cBytes);
-            if(nullptr == pWeightTo) {
-               LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags nullptr == pWeightTo");
-               free(aOccurrencesFrom);
-               return Error_OutOfMemory;
-            }
             EBM_ASSERT(nullptr != pSubset->m_aInnerBags);
             InnerBag * pInnerBag = &pSubset->m_aInnerBags[iBag];
-            pInnerBag->m_aWeights = pWeightTo;
+
+            void * pWeightTo = nullptr;
+            if(!bCompact || size_t { 0 } == iBag) {
+               if(IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cSubsetSamples)) {
+                  LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags IsMultiplyError(pSubset->m_pObjective->m_cFloatBytes, cSubsetSamples)");
+                  free(aOccurrencesFrom);
+                  return Error_OutOfMemory;
+               }
+               const size_t cBytes = pSubset->m_pObjective->m_cFloatBytes * cSubsetSamples;
+               pWeightTo = AlignedAlloc(cBytes);
+               if(nullptr == pWeightTo) {
+                  LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitBags nullptr == pWeightTo");
+                  free(aOccurrencesFrom);
+                  return Error_OutOfMemory;
+               }
+               if(bCompact) {
+                  pSubset->m_aWeights = pWeightTo;
+               } else {
+                  pInnerBag->m_aWeights = pWeightTo;
+               }
+            }
 
             uint8_t * pOccurrencesTo;
             if(nullptr != pOccurrencesFrom) {
-               EBM_ASSERT(cSubsetSamples <= cIncludedSamples);
+               EBM_ASSERT(cSubsetSamples <= cSlotSamples);
                EBM_ASSERT(sizeof(uint8_t) <= pSubset->m_pObjective->m_cFloatBytes);
                pOccurrencesTo = static_cast<uint8_t *>(AlignedAlloc(sizeof(uint8_t) * cSubsetSamples));
                if(nullptr == pOccurrencesTo) {
@@ -842,28 +1015,34 @@ ErrorEbm DataSetBoosting::InitBags(
                pInnerBag->m_aCountOccurrences = pOccurrencesTo;
             }
 
-            const void * const pWeightsToEnd = IndexByte(pWeightTo, cBytes);
-
             // add the weights in 2 stages to preserve precision
             double subsetWeight = 0.0;
+            size_t cSamplesRemaining = cSubsetSamples;
             do {
                if(BagEbm { 0 } == replication) {
-                  replication = 1;
-                  if(nullptr != pSampleReplication) {
-                     bool isItemValidation;
-                     do {
+                  if(nullptr != piSortedShared) {
+                     // sorted datasets list every replicated sample individually, in their new order
+                     weight = static_cast<double>(aWeightsFrom[*piSortedShared]);
+                     ++piSortedShared;
+                     replication = direction;
+                  } else {
+                     replication = 1;
+                     if(nullptr != pSampleReplication) {
+                        bool isItemValidation;
                         do {
-                           replication = *pSampleReplication;
-                           ++pSampleReplication;
-                           ++pWeightFrom;
-                        } while(BagEbm { 0 } == replication);
-                        isItemValidation = replication < BagEbm { 0 };
-                     } while(isLoopValidation != isItemValidation);
-                     --pWeightFrom;
-                  }
+                           do {
+                              replication = *pSampleReplication;
+                              ++pSampleReplication;
+                              ++pWeightFrom;
+                           } while(BagEbm { 0 } == replication);
+                           isItemValidation = replication < BagEbm { 0 };
+                        } while(isLoopValidation != isItemValidation);
+                        --pWeightFrom;
+                     }
 
-                  weight = static_cast<double>(*pWeightFrom);
-                  ++pWeightFrom;
+                     weight = static_cast<double>(*pWeightFrom);
+                     ++pWeightFrom;
+                  }
 
                   // these were checked when creating the shared dataset
                   EBM_ASSERT(!std::isnan(weight));
@@ -875,8 +1054,14 @@ ErrorEbm DataSetBoosting::InitBags(
                double result = weight;
                if(nullptr != pOccurrencesFrom) {
                   EBM_ASSERT(nullptr != pOccurrencesTo);
-                  const uint8_t cOccurrences = *pOccurrencesFrom;
-                  ++pOccurrencesFrom;
+                  uint8_t cOccurrences;
+                  if(nullptr != piSortedIncluded) {
+                     cOccurrences = aOccurrencesFrom[*piSortedIncluded];
+                     ++piSortedIncluded;
+                  } else {
+                     cOccurrences = *pOccurrencesFrom;
+                     ++pOccurrencesFrom;
+                  }
 
                   *pOccurrencesTo = cOccurrences;
                   ++pOccurrencesTo;
@@ -886,16 +1071,20 @@ ErrorEbm DataSetBoosting::InitBags(
 
                subsetWeight += result;
 
-               if(sizeof(FloatBig) == pSubset->m_pObjective->m_cFloatBytes) {
-                  *reinterpret_cast<FloatBig *>(pWeightTo) = static_cast<FloatBig>(result);
-               } else {
-                  EBM_ASSERT(sizeof(FloatSmall) == pSubset->m_pObjective->m_cFloatBytes);
-                  *reinterpret_cast<FloatSmall *>(pWeightTo) = static_cast<FloatSmall>(result);
+               if(nullptr != pWeightTo) {
+                  const double stored = bCompact ? weight : result;
+                  if(sizeof(FloatBig) == pSubset->m_pObjective->m_cFloatBytes) {
+                     *reinterpret_cast<FloatBig *>(pWeightTo) = static_cast<FloatBig>(stored);
+                  } else {
+                     EBM_ASSERT(sizeof(FloatSmall) == pSubset->m_pObjective->m_cFloatBytes);
+                     *reinterpret_cast<FloatSmall *>(pWeightTo) = static_cast<FloatSmall>(stored);
+                  }
+                  pWeightTo = IndexByte(pWeightTo, pSubset->m_pObjective->m_cFloatBytes);
                }
-               pWeightTo = IndexByte(pWeightTo, pSubset->m_pObjective->m_cFloatBytes);
 
                replication -= direction;
-            } while(pWeightsToEnd != pWeightTo);
+               --cSamplesRemaining;
+            } while(size_t { 0 } != cSamplesRemaining);
 
             totalWeight += subsetWeight;
 
@@ -919,7 +1108,7 @@ ErrorEbm DataSetBoosting::InitBags(
       ++iBag;
    } while(cInnerBagsAfterZero != iBag);
 
-   if(nullptr != aOccurrencesFrom) {
+   if(size_t { 0 } != cInnerBags) {
       if(nullptr != rng) {
          RandomDeterministic * pRng = reinterpret_cast<RandomDeterministic *>(rng);
          pRng->Initialize(cpuRng); // move the RNG from memory into CPU registers
@@ -933,6 +1122,146 @@ ErrorEbm DataSetBoosting::InitBags(
 }
 WARNING_POP
 
+static bool AddBytesMeasured(size_t * const pcBytes, const size_t cBytesPerItem, const size_t cItems) {
+   // returns true if the total no longer fits into a size_t, in which case the allocation could never succeed
+   if(IsMultiplyError(cBytesPerItem, cItems)) {
+      return true;
+   }
+   const size_t cBytes = cBytesPerItem * cItems;
+   if(IsAddError(*pcBytes, cBytes)) {
+      return true;
+   }
+   *pcBytes += cBytes;
+   return false;
+}
+
+ErrorEbm DataSetBoosting::MeasureData(
+   const bool bAllocateGradients,
+   const bool bAllocateHessians,
+   const bool bAllocateSampleScores,
+   const bool bAllocateTargetData,
+   const size_t cScores,
+   const unsigned char * const pDataSetShared,
+   const size_t cInnerBags,
+   const bool bCompactInnerBags,
+   const size_t cWeights,
+   const size_t cTerms,
+   const Term * const * const apTerms,
+   size_t * const pcBytesOut
+) const {
+   LOG_0(Trace_Info, "Entered DataSetBoosting::MeasureData");
+
+   EBM_ASSERT(1 <= cScores);
+   EBM_ASSERT(nullptr != pDataSetShared);
+   EBM_ASSERT(1 <= cTerms);
+   EBM_ASSERT(nullptr != apTerms);
+   EBM_ASSERT(nullptr != pcBytesOut);
+
+   EBM_ASSERT(nullptr != m_aSubsets);
+   EBM_ASSERT(1 <= m_cSubsets);
+
+   const size_t cIncludedSamples = m_cSamples;
+   EBM_ASSERT(1 <= cIncludedSamples);
+
+   const size_t cInnerBagsAfterZero = size_t { 0 } == cInnerBags ? size_t { 1 } : cInnerBags;
+
+   ptrdiff_t cClasses;
+   const void * const aTargets = GetDataSetSharedTarget(pDataSetShared, 0, &cClasses);
+   EBM_ASSERT(nullptr != aTargets); // we previously called GetDataSetSharedTarget and got back non-null result
+   UNUSED(aTargets);
+
+   size_t cBytes = *pcBytesOut;
+
+   // the bag weight totals, and the occurrences that InitBags draws before spreading them across the subsets
+   bool bOverflow = AddBytesMeasured(&cBytes, sizeof(double), cInnerBagsAfterZero);
+   if(size_t { 0 } != cInnerBags) {
+      bOverflow = bOverflow || AddBytesMeasured(&cBytes, sizeof(uint8_t), cIncludedSamples);
+   }
+
+   // the subset descriptions were allocated by InitDataSetBoosting before we were called
+   bOverflow = bOverflow || AddBytesMeasured(&cBytes, sizeof(DataSubsetBoosting), m_cSubsets);
+
+   const DataSubsetBoosting * pSubset = m_aSubsets;
+   const DataSubsetBoosting * const pSubsetsEnd = pSubset + m_cSubsets;
+   do {
+      const size_t cSubsetSamples = pSubset->GetCountSamples();
+      EBM_ASSERT(1 <= cSubsetSamples);
+      const ObjectiveWrapper * const pObjective = pSubset->m_pObjective;
+      EBM_ASSERT(nullptr != pObjective);
+      const size_t cFloatBytes = pObjective->m_cFloatBytes;
+      const size_t cUIntBytes = pObjective->m_cUIntBytes;
+
+      // this also guarantees that the per sample byte counts below, and the bag sample counts, do not overflow
+      if(IsMultiplyError(size_t { 2 }, cFloatBytes, cScores) || IsMultiplyError(cSubsetSamples, cInnerBagsAfterZero)) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::MeasureData IsMultiplyError(size_t { 2 }, cFloatBytes, cScores) || IsMultiplyError(cSubsetSamples, cInnerBagsAfterZero)");
+         return Error_OutOfMemory;
+      }
+
+      bOverflow = bOverflow || AddBytesMeasured(&cBytes, sizeof(void *), cTerms);
+      bOverflow = bOverflow || AddBytesMeasured(&cBytes, sizeof(InnerBag), cInnerBagsAfterZero);
+
+      if(bAllocateGradients) {
+         const size_t cTotalScores = bAllocateHessians ? cScores << 1 : cScores;
+         bOverflow = bOverflow || AddBytesMeasured(&cBytes, cFloatBytes * cTotalScores, cSubsetSamples);
+      }
+      if(bAllocateSampleScores) {
+         bOverflow = bOverflow || AddBytesMeasured(&cBytes, cFloatBytes * cScores, cSubsetSamples);
+      }
+      if(bAllocateTargetData) {
+         bOverflow = bOverflow ||
+            AddBytesMeasured(&cBytes, IsClassification(cClasses) ? cUIntBytes : cFloatBytes, cSubsetSamples);
+      }
+
+      const size_t cSIMDPack = pObjective->m_cSIMDPack;
+      EBM_ASSERT(1 <= cSIMDPack);
+      EBM_ASSERT(0 == cSubsetSamples % cSIMDPack);
+      const size_t cParallelSamples = cSubsetSamples / cSIMDPack;
+
+      size_t iTerm = 0;
+      do {
+         const Term * const pTerm = apTerms[iTerm];
+         EBM_ASSERT(nullptr != pTerm);
+         if(0 != pTerm->GetCountRealDimensions()) {
+            EBM_ASSERT(1 <= pTerm->GetBitsRequiredMin());
+            const int cItemsPerBitPackTo = GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), cUIntBytes);
+            EBM_ASSERT(1 <= cItemsPerBitPackTo);
+            const size_t cDataUnitsTo =
+               ((cParallelSamples - size_t { 1 }) / static_cast<size_t>(cItemsPerBitPackTo) + size_t { 1 }) * cSIMDPack;
+            bOverflow = bOverflow || AddBytesMeasured(&cBytes, cUIntBytes, cDataUnitsTo);
+         }
+         ++iTerm;
+      } while(cTerms != iTerm);
+
+      // these follow the InitBags rules for which bags get their own copy of the weights
+      if(size_t { 0 } == cWeights) {
+         if(size_t { 0 } != cInnerBags) {
+            bOverflow = bOverflow || AddBytesMeasured(&cBytes, bCompactInnerBags ? 
+               sizeof(uint8_t) : sizeof(uint8_t) + cFloatBytes, cSubsetSamples * cInnerBags);
+         }
+      } else {
+         if(size_t { 0 } == cInnerBags) {
+            bOverflow = bOverflow || AddBytesMeasured(&cBytes, cFloatBytes, cSubsetSamples);
+         } else if(bCompactInnerBags) {
+            bOverflow = bOverflow || AddBytesMeasured(&cBytes, cFloatBytes, cSubsetSamples) ||
+               AddBytesMeasured(&cBytes, sizeof(uint8_t), cSubsetSamples * cInnerBags);
+         } else {
+            bOverflow = bOverflow || 
+               AddBytesMeasured(&cBytes, sizeof(uint8_t) + cFloatBytes, cSubsetSamples * cInnerBags);
+         }
+      }
+      ++pSubset;
+   } while(pSubsetsEnd != pSubset);
+
+   if(bOverflow) {
+      LOG_0(Trace_Warning, "WARNING DataSetBoosting::MeasureData the byte count overflows a size_t");
+      return Error_OutOfMemory;
+   }
+   *pcBytesOut = cBytes;
+
+   LOG_0(Trace_Info, "Exited DataSetBoosting::MeasureData");
+   return Error_None;
+}
+
 ErrorEbm DataSetBoosting::InitDataSetBoosting(
    const bool bAllocateGradients,
    const bool bAllocateHessians,
@@ -950,10 +1279,14 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
    const double * const aInitScores,
    const size_t cIncludedSamples,
    const size_t cInnerBags,
+   const bool bCompactInnerBags,
+   const bool bSortByTarget,
    const size_t cWeights,
    const size_t cTerms,
    const Term * const * const apTerms,
-   const IntEbm * const aiTermFeatures
+   const IntEbm * const aiTermFeatures,
+   size_t * const pcBytesMeasure,
+   size_t * const pcBytesPeakMeasure
 ) {
    LOG_0(Trace_Info, "Entered DataSetBoosting::InitDataSetBoosting");
 
@@ -967,6 +1300,7 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
    EBM_ASSERT(nullptr != pDataSetShared);
    EBM_ASSERT(BagEbm { -1 } == direction || BagEbm { 1 } == direction);
    EBM_ASSERT(1 <= cTerms);
+   EBM_ASSERT((nullptr == pcBytesMeasure) == (nullptr == pcBytesPeakMeasure));
 
    EBM_ASSERT(0 == m_cSamples);
    EBM_ASSERT(0 == m_cSubsets);
@@ -978,36 +1312,129 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
 
       m_cSamples = cIncludedSamples;
 
+      // When sorting by target, aSort holds the shared sample index of each internal sample in its new order,
+      // followed by the index that the same sample had within the included samples (which is the order that
+      // the bags are drawn in), followed by the index of its init scores (which only exist for samples with non-zero
+      // bag entries), followed by the count of samples in each class. Each class gets its own subsets.
+      // When measuring we only need the class counts, so the sample indexes are left out of the allocation.
+      const size_t cSortSamples = nullptr == pcBytesMeasure ? cIncludedSamples : size_t { 0 };
+      size_t cBytesSort = 0;
+      size_t * aSort = nullptr;
+      const size_t * aRunSamples = &cIncludedSamples;
+      size_t cRuns = 1;
+      if(bSortByTarget) {
+         ptrdiff_t cClasses;
+         const void * const aTargets = GetDataSetSharedTarget(pDataSetShared, 0, &cClasses);
+         EBM_ASSERT(nullptr != aTargets); // we previously called GetDataSetSharedTarget and got back non-null result
+         if(IsClassification(cClasses)) {
+            const size_t cClassesSort = static_cast<size_t>(cClasses);
+            if(IsMultiplyError(size_t { 3 }, cIncludedSamples) ||
+               IsAddError(cIncludedSamples * size_t { 3 }, cClassesSort, cClassesSort) ||
+               IsMultiplyError(sizeof(size_t), cIncludedSamples * size_t { 3 } + cClassesSort + cClassesSort)) 
+            {
+               LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting IsMultiplyError(sizeof(size_t), cIncludedSamples * size_t { 3 } + cClassesSort + cClassesSort)");
+               return Error_OutOfMemory;
+            }
+            cBytesSort = sizeof(size_t) * (cIncludedSamples * size_t { 3 } + cClassesSort + cClassesSort);
+            aSort = static_cast<size_t *>(malloc(sizeof(size_t) * (cSortSamples * size_t { 3 } + cClassesSort + cClassesSort)));
+            if(nullptr == aSort) {
+               LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting nullptr == aSort");
+               return Error_OutOfMemory;
+            }
+            size_t * const aClassSamples = &aSort[cSortSamples * size_t { 3 }];
+            size_t * const aiClassNext = &aClassSamples[cClassesSort];
+            memset(aClassSamples, 0, sizeof(size_t) * cClassesSort);
+
+            const UIntShared * const aTargetsFrom = static_cast<const UIntShared *>(aTargets);
+            const bool isLoopValidation = direction < BagEbm { 0 };
+            for(size_t iShared = 0; iShared < cSharedSamples; ++iShared) {
+               const BagEbm replication = nullptr == aBag ? BagEbm { 1 } : aBag[iShared];
+               if(BagEbm { 0 } != replication && isLoopValidation == (replication < BagEbm { 0 })) {
+                  // this was checked when creating the shared dataset
+                  EBM_ASSERT(aTargetsFrom[iShared] < static_cast<UIntShared>(cClasses));
+                  aClassSamples[static_cast<size_t>(aTargetsFrom[iShared])] +=
+                     static_cast<size_t>(isLoopValidation ? -replication : replication);
+               }
+            }
+
+            size_t iSortedNext = 0;
+            for(size_t iClass = 0; iClass < cClassesSort; ++iClass) {
+               aiClassNext[iClass] = iSortedNext;
+               iSortedNext += aClassSamples[iClass];
+            }
+            EBM_ASSERT(cIncludedSamples == iSortedNext);
+
+            if(nullptr == pcBytesMeasure) {
+               // a stable counting sort, so each class keeps the original order of its samples
+               size_t iIncluded = 0;
+               size_t iInit = 0;
+               for(size_t iShared = 0; iShared < cSharedSamples; ++iShared) {
+                  const BagEbm replicationShared = nullptr == aBag ? BagEbm { 1 } : aBag[iShared];
+                  if(BagEbm { 0 } != replicationShared && isLoopValidation == (replicationShared < BagEbm { 0 })) {
+                     BagEbm replication = replicationShared;
+                     size_t * const piSortedNext = &aiClassNext[static_cast<size_t>(aTargetsFrom[iShared])];
+                     do {
+                        const size_t iSorted = *piSortedNext;
+                        *piSortedNext = iSorted + size_t { 1 };
+                        aSort[iSorted] = iShared;
+                        aSort[cIncludedSamples + iSorted] = iIncluded;
+                        aSort[(cIncludedSamples << 1) + iSorted] = iInit;
+                        ++iIncluded;
+                        replication -= direction;
+                     } while(BagEbm { 0 } != replication);
+                  }
+                  if(BagEbm { 0 } != replicationShared) {
+                     ++iInit;
+                  }
+               }
+               EBM_ASSERT(cIncludedSamples == iIncluded);
+            }
+
+            aRunSamples = aClassSamples;
+            cRuns = cClassesSort;
+         }
+      }
+      const bool bSortedIndexes = nullptr != aSort && size_t { 0 } != cSortSamples;
+      const size_t * const aiSortedShared = bSortedIndexes ? aSort : nullptr;
+      const size_t * const aiSortedIncluded = bSortedIndexes ? &aSort[cIncludedSamples] : nullptr;
+      const size_t * const aiSortedInit = bSortedIndexes ? &aSort[cIncludedSamples << 1] : nullptr;
+
       EBM_ASSERT(1 == pObjectiveCpu->m_cSIMDPack);
       EBM_ASSERT(nullptr == pObjectiveSIMD->m_pObjective && 0 == pObjectiveSIMD->m_cSIMDPack ||
          nullptr != pObjectiveSIMD->m_pObjective && 2 <= pObjectiveSIMD->m_cSIMDPack);
       const size_t cSIMDPack = pObjectiveSIMD->m_cSIMDPack;
 
       size_t cSubsets = 0;
-      size_t cIncludedSamplesRemainingInit = cIncludedSamples;
+      size_t iRunInit = 0;
       do {
-         size_t cSubsetSamples = EbmMin(cIncludedSamplesRemainingInit, cSubsetItemsMax);
+         size_t cRunSamplesRemainingInit = aRunSamples[iRunInit];
+         while(size_t { 0 } != cRunSamplesRemainingInit) {
+            size_t cSubsetSamples = EbmMin(cRunSamplesRemainingInit, cSubsetItemsMax);
 
-         if(size_t { 0 } == cSIMDPack || cSubsetSamples < cSIMDPack) {
-            // these remaing items cannot be processed with the SIMD compute, so they go into the CPU compute
-         } else {
-            // drop any items which cannot fit into the SIMD pack
-            cSubsetSamples = cSubsetSamples - cSubsetSamples % cSIMDPack;
+            if(size_t { 0 } == cSIMDPack || cSubsetSamples < cSIMDPack) {
+               // these remaing items cannot be processed with the SIMD compute, so they go into the CPU compute
+            } else {
+               // drop any items which cannot fit into the SIMD pack
+               cSubsetSamples = cSubsetSamples - cSubsetSamples % cSIMDPack;
+            }
+            ++cSubsets;
+            EBM_ASSERT(1 <= cSubsetSamples);
+            EBM_ASSERT(cSubsetSamples <= cRunSamplesRemainingInit);
+            cRunSamplesRemainingInit -= cSubsetSamples;
          }
-         ++cSubsets;
-         EBM_ASSERT(1 <= cSubsetSamples);
-         EBM_ASSERT(cSubsetSamples <= cIncludedSamplesRemainingInit);
-         cIncludedSamplesRemainingInit -= cSubsetSamples;
-      } while(size_t { 0 } != cIncludedSamplesRemainingInit);
+         ++iRunInit;
+      } while(cRuns != iRunInit);
       EBM_ASSERT(1 <= cSubsets);
 
       if(IsMultiplyError(sizeof(DataSubsetBoosting), cSubsets)) {
          LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting IsMultiplyError(sizeof(DataSubsetBoosting), cSubsets)");
+         free(aSort);
          return Error_OutOfMemory;
       }
       DataSubsetBoosting * pSubset = static_cast<DataSubsetBoosting *>(malloc(sizeof(DataSubsetBoosting) * cSubsets));
       if(nullptr == pSubset) {
          LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting nullptr == pSubset");
+         free(aSort);
          return Error_OutOfMemory;
       }
       m_aSubsets = pSubset;
@@ -1021,11 +1448,16 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
          ++pSubsetInit;
       } while(pSubsetsEnd != pSubsetInit);
 
-      size_t cIncludedSamplesRemaining = cIncludedSamples;
+      size_t iRun = 0;
+      size_t cRunSamplesRemaining = aRunSamples[0];
       do {
-         EBM_ASSERT(1 <= cIncludedSamplesRemaining);
+         while(size_t { 0 } == cRunSamplesRemaining) {
+            ++iRun;
+            EBM_ASSERT(iRun < cRuns);
+            cRunSamplesRemaining = aRunSamples[iRun];
+         }
 
-         size_t cSubsetSamples = EbmMin(cIncludedSamplesRemaining, cSubsetItemsMax);
+         size_t cSubsetSamples = EbmMin(cRunSamplesRemaining, cSubsetItemsMax);
 
          if(size_t { 0 } == cSIMDPack || cSubsetSamples < cSIMDPack) {
             // these remaing items cannot be processed with the SIMD compute, so they go into the CPU compute
@@ -1038,19 +1470,22 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
          EBM_ASSERT(nullptr != pSubset->m_pObjective->m_pObjective);
          EBM_ASSERT(1 <= cSubsetSamples);
          EBM_ASSERT(0 == cSubsetSamples % pSubset->m_pObjective->m_cSIMDPack);
-         EBM_ASSERT(cSubsetSamples <= cIncludedSamplesRemaining);
-         cIncludedSamplesRemaining -= cSubsetSamples;
+         EBM_ASSERT(cSubsetSamples <= cRunSamplesRemaining);
+         cRunSamplesRemaining -= cSubsetSamples;
 
          pSubset->m_cSamples = cSubsetSamples;
+         pSubset->m_bUniformTarget = nullptr != aSort;
 
          EBM_ASSERT(1 <= cTerms);
          if(IsMultiplyError(sizeof(void *), cTerms)) {
             LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting IsMultiplyError(sizeof(void *), cTerms)");
+            free(aSort);
             return Error_OutOfMemory;
          }
          void ** paTermData = static_cast<void **>(malloc(sizeof(void *) * cTerms));
          if(nullptr == paTermData) {
             LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting nullptr == paTermData");
+            free(aSort);
             return Error_OutOfMemory;
          }
          pSubset->m_aaTermData = paTermData;
@@ -1064,17 +1499,52 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
          InnerBag * const aInnerBags = InnerBag::AllocateInnerBags(cInnerBags);
          if(nullptr == aInnerBags) {
             LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting nullptr == aInnerBags");
+            free(aSort);
             return Error_OutOfMemory;
          }
          pSubset->m_aInnerBags = aInnerBags;
 
          ++pSubset;
       } while(pSubsetsEnd != pSubset);
-      EBM_ASSERT(0 == cIncludedSamplesRemaining);
+      EBM_ASSERT(0 == cRunSamplesRemaining);
+
+      if(nullptr != pcBytesMeasure) {
+         size_t cBytes = *pcBytesMeasure;
+         error = MeasureData(
+            bAllocateGradients,
+            bAllocateHessians,
+            bAllocateSampleScores,
+            bAllocateTargetData,
+            cScores,
+            pDataSetShared,
+            cInnerBags,
+            bCompactInnerBags,
+            cWeights,
+            cTerms,
+            apTerms,
+            &cBytes
+         );
+         free(aSort);
+         if(Error_None != error) {
+            return error;
+         }
+         // the sort indexes are freed once this dataset is built, so they only add to the peak of this dataset
+         // and not to the bytes held while the next dataset is built
+         if(IsAddError(cBytes, cBytesSort)) {
+            LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoosting IsAddError(cBytes, cBytesSort)");
+            return Error_OutOfMemory;
+         }
+         *pcBytesPeakMeasure = EbmMax(*pcBytesPeakMeasure, cBytes + cBytesSort);
+         *pcBytesMeasure = cBytes;
+
+         LOG_0(Trace_Info, "Exited DataSetBoosting::InitDataSetBoosting measuring");
+         return Error_None;
+      }
 
       if(bAllocateGradients) {
          error = InitGradHess(bAllocateHessians, cScores);
          if(Error_None != error) {
+            free(aSort);
             return error;
          }
       } else {
@@ -1086,9 +1556,11 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
             cScores,
             direction,
             aBag,
+            aiSortedInit,
             aInitScores
          );
          if(Error_None != error) {
+            free(aSort);
             return error;
          }
       }
@@ -1097,9 +1569,11 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
          error = InitTargetData(
             pDataSetShared,
             direction,
-            aBag
+            aBag,
+            aiSortedShared
          );
          if(Error_None != error) {
+            free(aSort);
             return error;
          }
       }
@@ -1109,11 +1583,13 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
          direction,
          cSharedSamples,
          aBag,
+         aiSortedShared,
          cTerms,
          apTerms,
          aiTermFeatures
       );
       if(Error_None != error) {
+         free(aSort);
          return error;
       }
 
@@ -1122,9 +1598,15 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
          pDataSetShared,
          direction,
          aBag,
+         aiSortedShared,
+         aiSortedIncluded,
          cInnerBags,
-         cWeights
+         bCompactInnerBags,
+         cWeights,
+         nullptr,
+         cSharedSamples
       );
+      free(aSort);
       if(Error_None != error) {
          return error;
       }
@@ -1134,6 +1616,173 @@ ErrorEbm DataSetBoosting::InitDataSetBoosting(
    return Error_None;
 }
 
+ErrorEbm DataSetBoosting::InitDataSetBoostingPrepared(
+   const bool bAllocateHessians,
+   const bool bAllocateSampleScores,
+   const bool bAllocateTargetData,
+   void * const rng,
+   const size_t cScores,
+   const ObjectiveWrapper * const pObjectiveCpu,
+   const ObjectiveWrapper * const pObjectiveSIMD,
+   const unsigned char * const pDataSetShared,
+   const size_t cSharedSamples,
+   const BagEbm * const aBag,
+   const double * const aInitScores,
+   const size_t cIncludedSamples,
+   const size_t cInnerBags,
+   const bool bCompactInnerBags,
+   const size_t cWeights,
+   const size_t cTerms,
+   const DataSetBoosting * const pPreparedSet
+) {
+   LOG_0(Trace_Info, "Entered DataSetBoosting::InitDataSetBoostingPrepared");
+
+   ErrorEbm error;
+
+   EBM_ASSERT(1 <= cScores);
+   EBM_ASSERT(nullptr != pObjectiveCpu);
+   EBM_ASSERT(nullptr != pObjectiveCpu->m_pObjective); // the objective for the CPU zone cannot be null unlike SIMD
+   EBM_ASSERT(nullptr != pObjectiveSIMD);
+   EBM_ASSERT(nullptr != pDataSetShared);
+   EBM_ASSERT(1 <= cTerms);
+   EBM_ASSERT(nullptr != pPreparedSet);
+
+   EBM_ASSERT(0 == m_cSamples);
+   EBM_ASSERT(0 == m_cSubsets);
+   EBM_ASSERT(nullptr == m_aSubsets);
+   EBM_ASSERT(nullptr == m_aBagWeightTotals);
+
+   if(0 != cIncludedSamples) {
+      // the prepared dataset was built from the same shared dataset with every sample included
+      EBM_ASSERT(cSharedSamples == pPreparedSet->GetCountSamples());
+      EBM_ASSERT(1 <= pPreparedSet->m_cSubsets);
+
+      // the bag totals and the bin counts see each included sample as often as it is replicated
+      m_cSamples = cIncludedSamples;
+
+      const size_t cSubsets = pPreparedSet->m_cSubsets;
+      if(IsMultiplyError(sizeof(DataSubsetBoosting), cSubsets)) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoostingPrepared IsMultiplyError(sizeof(DataSubsetBoosting), cSubsets)");
+         return Error_OutOfMemory;
+      }
+      DataSubsetBoosting * pSubset = static_cast<DataSubsetBoosting *>(malloc(sizeof(DataSubsetBoosting) * cSubsets));
+      if(nullptr == pSubset) {
+         LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoostingPrepared nullptr == pSubset");
+         return Error_OutOfMemory;
+      }
+      m_aSubsets = pSubset;
+      m_cSubsets = cSubsets;
+
+      const DataSubsetBoosting * const pSubsetsEnd = pSubset + cSubsets;
+
+      DataSubsetBoosting * pSubsetInit = pSubset;
+      do {
+         pSubsetInit->SafeInitDataSubsetBoosting();
+         ++pSubsetInit;
+      } while(pSubsetsEnd != pSubsetInit);
+
+      const DataSubsetBoosting * pPreparedSubset = pPreparedSet->m_aSubsets;
+      do {
+         // the packed term data is laid out for the zone of the prepared subset, so we need the same zone here
+         const ObjectiveWrapper * const pObjectivePrepared = pPreparedSubset->GetObjectiveWrapper();
+         const ObjectiveWrapper * const pObjective = 
+            size_t { 1 } == pObjectivePrepared->m_cSIMDPack ? pObjectiveCpu : pObjectiveSIMD;
+         if(pObjectivePrepared->m_cSIMDPack != pObjective->m_cSIMDPack ||
+            pObjectivePrepared->m_cUIntBytes != pObjective->m_cUIntBytes ||
+            pObjectivePrepared->m_cFloatBytes != pObjective->m_cFloatBytes)
+         {
+            LOG_0(Trace_Error, "ERROR DataSetBoosting::InitDataSetBoostingPrepared the prepared dataset was built for a different compute zone");
+            return Error_IllegalParamVal;
+         }
+         EBM_ASSERT(nullptr != pObjective->m_pObjective);
+
+         pSubset->m_cSamples = pPreparedSubset->m_cSamples;
+         pSubset->m_pObjective = pObjective;
+         pSubset->m_aaTermData = pPreparedSubset->m_aaTermData;
+         pSubset->m_bTermDataShared = true;
+
+         InnerBag * const aInnerBags = InnerBag::AllocateInnerBags(cInnerBags);
+         if(nullptr == aInnerBags) {
+            LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoostingPrepared nullptr == aInnerBags");
+            return Error_OutOfMemory;
+         }
+         pSubset->m_aInnerBags = aInnerBags;
+
+         ++pPreparedSubset;
+         ++pSubset;
+      } while(pSubsetsEnd != pSubset);
+
+      error = InitGradHess(bAllocateHessians, cScores);
+      if(Error_None != error) {
+         return error;
+      }
+
+      // every shared sample has a slot, so the scores and targets are copied in order without consulting the bag
+      if(bAllocateSampleScores) {
+         // init scores are only given for samples with non-zero bag entries, so spread them out to one per slot
+         // and give the excluded samples, which never reach the bins, zeros
+         double * aInitScoresSlots = nullptr;
+         if(nullptr != aInitScores && nullptr != aBag) {
+            if(IsMultiplyError(sizeof(double), cScores, cSharedSamples)) {
+               LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoostingPrepared IsMultiplyError(sizeof(double), cScores, cSharedSamples)");
+               return Error_OutOfMemory;
+            }
+            aInitScoresSlots = static_cast<double *>(malloc(sizeof(double) * cScores * cSharedSamples));
+            if(nullptr == aInitScoresSlots) {
+               LOG_0(Trace_Warning, "WARNING DataSetBoosting::InitDataSetBoostingPrepared nullptr == aInitScoresSlots");
+               return Error_OutOfMemory;
+            }
+            const double * pInitScore = aInitScores;
+            double * pInitScoreSlot = aInitScoresSlots;
+            for(size_t iShared = 0; iShared < cSharedSamples; ++iShared) {
+               for(size_t iScore = 0; iScore < cScores; ++iScore) {
+                  if(BagEbm { 0 } == aBag[iShared]) {
+                     *pInitScoreSlot = 0.0;
+                  } else {
+                     *pInitScoreSlot = *pInitScore;
+                     ++pInitScore;
+                  }
+                  ++pInitScoreSlot;
+               }
+            }
+         }
+         error = InitSampleScores(cScores, BagEbm { 1 }, nullptr, nullptr, 
+            nullptr != aInitScoresSlots ? aInitScoresSlots : aInitScores);
+         free(aInitScoresSlots);
+         if(Error_None != error) {
+            return error;
+         }
+      }
+
+      if(bAllocateTargetData) {
+         error = InitTargetData(pDataSetShared, BagEbm { 1 }, nullptr, nullptr);
+         if(Error_None != error) {
+            return error;
+         }
+      }
+
+      error = InitBags(
+         rng,
+         pDataSetShared,
+         BagEbm { 1 },
+         nullptr,
+         nullptr,
+         nullptr,
+         cInnerBags,
+         bCompactInnerBags,
+         cWeights,
+         aBag, // without a bag every slot holds exactly one included sample, so nothing is masked
+         cSharedSamples
+      );
+      if(Error_None != error) {
+         return error;
+      }
+   }
+
+   LOG_0(Trace_Info, "Exited DataSetBoosting::InitDataSetBoostingPrepared");
+   return Error_None;
+}
+
 void DataSetBoosting::DestructDataSetBoosting(const size_t cTerms, const size_t cInnerBags) {
    LOG_0(Trace_Info, "Entered DataSetBoosting::DestructDataSetBoosting");
 
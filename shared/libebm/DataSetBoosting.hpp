@@ -39,6 +39,9 @@ struct DataSubsetBoosting final {
       m_aTargetData = nullptr;
       m_aaTermData = nullptr;
       m_aInnerBags = nullptr;
+      m_aWeights = nullptr;
+      m_bUniformTarget = false;
+      m_bTermDataShared = false;
    }
 
    void DestructDataSubsetBoosting(const size_t cTerms, const size_t cInnerBags);
@@ -90,6 +93,16 @@ struct DataSubsetBoosting final {
       return &m_aInnerBags[iBag];
    }
 
+   // the sample weights shared by compact inner bags, or nullptr if the bags are not compact or unweighted
+   inline const void * GetWeights() const {
+      return m_aWeights;
+   }
+
+   // true if the dataset was sorted by target, which gives every sample in this subset the same class
+   inline bool IsUniformTarget() const {
+      return m_bUniformTarget;
+   }
+
 private:
 
    size_t m_cSamples;
@@ -99,6 +112,10 @@ private:
    void * m_aTargetData;
    void ** m_aaTermData;
    InnerBag * m_aInnerBags;
+   void * m_aWeights;
+   bool m_bUniformTarget;
+   // true if m_aaTermData belongs to the subset of a prepared dataset, which frees it
+   bool m_bTermDataShared;
 };
 static_assert(std::is_standard_layout<DataSubsetBoosting>::value,
    "We use the struct hack in several places, so disallow non-standard_layout types in general");
@@ -135,10 +152,38 @@ struct DataSetBoosting final {
       const double * const aInitScores,
       const size_t cIncludedSamples,
       const size_t cInnerBags,
+      const bool bCompactInnerBags,
+      const bool bSortByTarget,
       const size_t cWeights,
       const size_t cTerms,
       const Term * const * const apTerms,
-      const IntEbm * const aiTermFeatures
+      const IntEbm * const aiTermFeatures,
+      // if non-null, only the subsets are built and the bytes the data would need are added to *pcBytesMeasure
+      size_t * const pcBytesMeasure,
+      // raised to the bytes held while the data is built, which includes the temporary sort indexes
+      size_t * const pcBytesPeakMeasure
+   );
+
+   // Builds a training set whose subsets reference the term data of pPreparedSet, which holds every shared sample.
+   // The samples that aBag leaves out stay in place with zero occurrences, so aBag only changes the bags.
+   ErrorEbm InitDataSetBoostingPrepared(
+      const bool bAllocateHessians,
+      const bool bAllocateSampleScores,
+      const bool bAllocateTargetData,
+      void * const rng,
+      const size_t cScores,
+      const ObjectiveWrapper * const pObjectiveCpu,
+      const ObjectiveWrapper * const pObjectiveSIMD,
+      const unsigned char * const pDataSetShared,
+      const size_t cSharedSamples,
+      const BagEbm * const aBag,
+      const double * const aInitScores,
+      const size_t cIncludedSamples,
+      const size_t cInnerBags,
+      const bool bCompactInnerBags,
+      const size_t cWeights,
+      const size_t cTerms,
+      const DataSetBoosting * const pPreparedSet
    );
 
    void DestructDataSetBoosting(const size_t cTerms, const size_t cInnerBags);
@@ -169,13 +214,15 @@ private:
       const size_t cScores,
       const BagEbm direction,
       const BagEbm * const aBag,
+      const size_t * const aiSortedInit,
       const double * const aInitScores
    );
 
    ErrorEbm InitTargetData(
       const unsigned char * const pDataSetShared,
       const BagEbm direction,
-      const BagEbm * const aBag
+      const BagEbm * const aBag,
+      const size_t * const aiSortedShared
    );
 
    ErrorEbm InitTermData(
@@ -183,18 +230,40 @@ private:
       const BagEbm direction,
       const size_t cSharedSamples,
       const BagEbm * const aBag,
+      const size_t * const aiSortedShared,
       const size_t cTerms,
       const Term * const * const apTerms,
       const IntEbm * const aiTermFeatures
    );
 
+   ErrorEbm MeasureData(
+      const bool bAllocateGradients,
+      const bool bAllocateHessians,
+      const bool bAllocateSampleScores,
+      const bool bAllocateTargetData,
+      const size_t cScores,
+      const unsigned char * const pDataSetShared,
+      const size_t cInnerBags,
+      const bool bCompactInnerBags,
+      const size_t cWeights,
+      const size_t cTerms,
+      const Term * const * const apTerms,
+      size_t * const pcBytesOut
+   ) const;
+
    ErrorEbm InitBags(
       void * const rng,
       const unsigned char * const pDataSetShared,
       const BagEbm direction,
       const BagEbm * const aBag,
+      const size_t * const aiSortedShared,
+      const size_t * const aiSortedIncluded,
       const size_t cInnerBags,
-      const size_t cWeights
+      const bool bCompactInnerBags,
+      const size_t cWeights,
+      // if non-null, every shared sample has a slot and this bag gives the slots their occurrences
+      const BagEbm * const aBagMask,
+      const size_t cSharedSamples
    );
 
    size_t m_cSamples;
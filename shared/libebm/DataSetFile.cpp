@@ -0,0 +1,437 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stdlib.h> // malloc, free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <stdio.h> // FILE, fopen, fwrite, fclose
+#include <string.h> // memcpy
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif // WIN32_LEAN_AND_MEAN
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include <windows.h> // CreateFileA, CreateFileMappingA, MapViewOfFile
+#else // _WIN32
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <fcntl.h> // open
+#include <unistd.h> // close
+#endif // _WIN32
+
+#include "libebm.h" // EBM_API_BODY
+#include "logging.h" // EBM_ASSERT
+#include "common_c.h"
+#include "zones.h"
+
+#include "common_cpp.hpp" // IsConvertError
+
+#include "ebm_internal.hpp"
+#include "dataset_shared.hpp" // UIntShared
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// A dataset file is a fixed size header followed by the unmodified dataset bytes. The header is padded to
+// SIMD_BYTE_ALIGNMENT so that the dataset inside a page aligned mapping has the same alignment guarantees as
+// memory from AlignedAlloc. The dataset holds native integers and floats, so files are only portable between
+// machines with the same byte order, which m_byteOrder detects.
+static constexpr UIntShared k_dataSetFileMagic = 0x315441444D4245; // "EBMDAT1" read as a little endian integer
+static constexpr UIntShared k_dataSetFileByteOrder = 0x0102030405060708;
+static constexpr UIntShared k_dataSetFileVersion = 1;
+
+struct DataSetFileHeader {
+   UIntShared m_magic;
+   UIntShared m_byteOrder;
+   UIntShared m_version;
+   UIntShared m_cBytesHeader; // the offset of the dataset from the start of the file
+   UIntShared m_cBytesDataSet;
+   UIntShared m_checksum; // of the dataset bytes only
+
+   UIntShared m_reserved[2];
+};
+static_assert(std::is_standard_layout<DataSetFileHeader>::value,
+   "These structs are shared between processes, so they definetly need to be standard layout and trivial");
+static_assert(std::is_trivial<DataSetFileHeader>::value,
+   "These structs are shared between processes, so they definetly need to be standard layout and trivial");
+static_assert(sizeof(DataSetFileHeader) == SIMD_BYTE_ALIGNMENT,
+   "The dataset following the header must start on an aligned boundary");
+
+class DataSetFile final {
+   static constexpr size_t k_handleVerificationOk = 23159; // random 15 bit number
+   static constexpr size_t k_handleVerificationFreed = 9742; // random 15 bit number
+   size_t m_handleVerification; // this needs to be at the top and make it pointer sized to keep best alignment
+
+   void * m_pMapped;
+   size_t m_cBytesMapped;
+
+public:
+
+   DataSetFile() = default; // preserve our POD status
+   ~DataSetFile() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   static void Free(DataSetFile * const pDataSetFile);
+   static ErrorEbm Create(const char * const sPath, DataSetFile ** const ppDataSetFileOut);
+
+   inline static DataSetFile * GetDataSetFileFromHandle(const DataSetFileHandle dataSetFileHandle) {
+      if(nullptr == dataSetFileHandle) {
+         LOG_0(Trace_Error, "ERROR GetDataSetFileFromHandle null dataSetFileHandle");
+         return nullptr;
+      }
+      DataSetFile * const pDataSetFile = reinterpret_cast<DataSetFile *>(dataSetFileHandle);
+      if(k_handleVerificationOk == pDataSetFile->m_handleVerification) {
+         return pDataSetFile;
+      }
+      if(k_handleVerificationFreed == pDataSetFile->m_handleVerification) {
+         LOG_0(Trace_Error, "ERROR GetDataSetFileFromHandle attempt to use freed DataSetFileHandle");
+      } else {
+         LOG_0(Trace_Error, "ERROR GetDataSetFileFromHandle attempt to use invalid DataSetFileHandle");
+      }
+      return nullptr;
+   }
+   inline DataSetFileHandle GetHandle() {
+      return reinterpret_cast<DataSetFileHandle>(this);
+   }
+
+   inline const void * GetDataSet() const {
+      return static_cast<const unsigned char *>(m_pMapped) + sizeof(DataSetFileHeader);
+   }
+};
+static_assert(std::is_standard_layout<DataSetFile>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<DataSetFile>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+static UIntShared ChecksumDataSet(const unsigned char * const pDataSet, const size_t cBytes) {
+   // FNV-1a over 64 bit words, which is several times faster than the byte at a time version. The dataset is
+   // almost always a multiple of 8 bytes, but any trailing bytes are zero padded into one last word.
+   static constexpr UIntShared k_fnvOffsetBasis = 0xCBF29CE484222325;
+   static constexpr UIntShared k_fnvPrime = 0x00000100000001B3;
+
+   UIntShared checksum = k_fnvOffsetBasis;
+   const unsigned char * p = pDataSet;
+   const unsigned char * const pWordsEnd = pDataSet + cBytes / sizeof(UIntShared) * sizeof(UIntShared);
+   while(pWordsEnd != p) {
+      UIntShared word;
+      memcpy(&word, p, sizeof(word));
+      checksum = (checksum ^ word) * k_fnvPrime;
+      p += sizeof(UIntShared);
+   }
+   const size_t cBytesTail = cBytes % sizeof(UIntShared);
+   if(size_t { 0 } != cBytesTail) {
+      UIntShared word = 0;
+      memcpy(&word, p, cBytesTail);
+      checksum = (checksum ^ word) * k_fnvPrime;
+   }
+   return checksum;
+}
+
+static void UnmapFile(void * const pMapped, const size_t cBytesMapped) {
+#if defined(_WIN32)
+   UNUSED(cBytesMapped);
+   UnmapViewOfFile(pMapped);
+#else // _WIN32
+   munmap(pMapped, cBytesMapped);
+#endif // _WIN32
+}
+
+// maps the whole file read-only. The mapping stays valid after the file is closed
+static ErrorEbm MapFile(const char * const sPath, void ** const ppMappedOut, size_t * const pcBytesOut) {
+#if defined(_WIN32)
+   const HANDLE hFile = CreateFileA(sPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL, nullptr);
+   if(INVALID_HANDLE_VALUE == hFile) {
+      LOG_0(Trace_Warning, "WARNING MapFile CreateFileA failed");
+      return Error_FileIO;
+   }
+   LARGE_INTEGER size;
+   if(!GetFileSizeEx(hFile, &size) || size.QuadPart < 0 ||
+      IsConvertError<size_t>(static_cast<unsigned long long>(size.QuadPart)))
+   {
+      LOG_0(Trace_Warning, "WARNING MapFile GetFileSizeEx failed");
+      CloseHandle(hFile);
+      return Error_FileIO;
+   }
+   const size_t cBytes = static_cast<size_t>(size.QuadPart);
+   if(size_t { 0 } == cBytes) {
+      // a zero length file cannot be mapped, and it cannot hold a header either
+      LOG_0(Trace_Error, "ERROR MapFile empty file");
+      CloseHandle(hFile);
+      return Error_IllegalParamVal;
+   }
+   const HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   CloseHandle(hFile);
+   if(nullptr == hMapping) {
+      LOG_0(Trace_Warning, "WARNING MapFile CreateFileMappingA failed");
+      return Error_FileIO;
+   }
+   void * const pMapped = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+   CloseHandle(hMapping);
+   if(nullptr == pMapped) {
+      LOG_0(Trace_Warning, "WARNING MapFile MapViewOfFile failed");
+      return Error_FileIO;
+   }
+#else // _WIN32
+   const int fd = open(sPath, O_RDONLY);
+   if(fd < 0) {
+      LOG_0(Trace_Warning, "WARNING MapFile open failed");
+      return Error_FileIO;
+   }
+   struct stat fileStat;
+   if(0 != fstat(fd, &fileStat) || fileStat.st_size < 0 ||
+      IsConvertError<size_t>(static_cast<unsigned long long>(fileStat.st_size)))
+   {
+      LOG_0(Trace_Warning, "WARNING MapFile fstat failed");
+      close(fd);
+      return Error_FileIO;
+   }
+   const size_t cBytes = static_cast<size_t>(fileStat.st_size);
+   if(size_t { 0 } == cBytes) {
+      // a zero length file cannot be mapped, and it cannot hold a header either
+      LOG_0(Trace_Error, "ERROR MapFile empty file");
+      close(fd);
+      return Error_IllegalParamVal;
+   }
+   // MAP_SHARED so that every process mapping the same file shares the page cache copy
+   void * const pMapped = mmap(nullptr, cBytes, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if(MAP_FAILED == pMapped) {
+      LOG_0(Trace_Warning, "WARNING MapFile mmap failed");
+      return Error_FileIO;
+   }
+#endif // _WIN32
+
+   *ppMappedOut = pMapped;
+   *pcBytesOut = cBytes;
+   return Error_None;
+}
+
+void DataSetFile::Free(DataSetFile * const pDataSetFile) {
+   LOG_0(Trace_Info, "Entered DataSetFile::Free");
+
+   if(nullptr != pDataSetFile) {
+      UnmapFile(pDataSetFile->m_pMapped, pDataSetFile->m_cBytesMapped);
+
+      // before we free our memory, indicate it was freed so if our higher level language attempts to use it we have
+      // a chance to detect the error
+      pDataSetFile->m_handleVerification = k_handleVerificationFreed;
+      free(pDataSetFile);
+   }
+
+   LOG_0(Trace_Info, "Exited DataSetFile::Free");
+}
+
+ErrorEbm DataSetFile::Create(const char * const sPath, DataSetFile ** const ppDataSetFileOut) {
+   EBM_ASSERT(nullptr != sPath);
+   EBM_ASSERT(nullptr != ppDataSetFileOut);
+
+   LOG_0(Trace_Info, "Entered DataSetFile::Create");
+
+   void * pMapped;
+   size_t cBytesMapped;
+   ErrorEbm error = MapFile(sPath, &pMapped, &cBytesMapped);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   if(cBytesMapped < sizeof(DataSetFileHeader)) {
+      LOG_0(Trace_Error, "ERROR DataSetFile::Create file too short to hold the header");
+      UnmapFile(pMapped, cBytesMapped);
+      return Error_IllegalParamVal;
+   }
+   // the mapping is page aligned, so the header can be read in place
+   const DataSetFileHeader * const pHeader = static_cast<const DataSetFileHeader *>(pMapped);
+   if(k_dataSetFileMagic != pHeader->m_magic) {
+      LOG_0(Trace_Error, "ERROR DataSetFile::Create not a dataset file");
+      UnmapFile(pMapped, cBytesMapped);
+      return Error_IllegalParamVal;
+   }
+   if(k_dataSetFileByteOrder != pHeader->m_byteOrder) {
+      LOG_0(Trace_Error, "ERROR DataSetFile::Create dataset file was written on a machine with a different byte order");
+      UnmapFile(pMapped, cBytesMapped);
+      return Error_IllegalParamVal;
+   }
+   if(k_dataSetFileVersion != pHeader->m_version) {
+      LOG_0(Trace_Error, "ERROR DataSetFile::Create unsupported dataset file version");
+      UnmapFile(pMapped, cBytesMapped);
+      return Error_IllegalParamVal;
+   }
+   if(UIntShared { sizeof(DataSetFileHeader) } != pHeader->m_cBytesHeader ||
+      UIntShared { cBytesMapped - sizeof(DataSetFileHeader) } != pHeader->m_cBytesDataSet)
+   {
+      LOG_0(Trace_Error, "ERROR DataSetFile::Create dataset file size does not match its header");
+      UnmapFile(pMapped, cBytesMapped);
+      return Error_IllegalParamVal;
+   }
+   const size_t cBytesDataSet = cBytesMapped - sizeof(DataSetFileHeader);
+   const unsigned char * const pDataSet = static_cast<const unsigned char *>(pMapped) + sizeof(DataSetFileHeader);
+   if(ChecksumDataSet(pDataSet, cBytesDataSet) != pHeader->m_checksum) {
+      LOG_0(Trace_Error, "ERROR DataSetFile::Create dataset file checksum mismatch");
+      UnmapFile(pMapped, cBytesMapped);
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<IntEbm>(cBytesDataSet)) {
+      LOG_0(Trace_Error, "ERROR DataSetFile::Create IsConvertError<IntEbm>(cBytesDataSet)");
+      UnmapFile(pMapped, cBytesMapped);
+      return Error_IllegalParamVal;
+   }
+   error = CheckDataSet(static_cast<IntEbm>(cBytesDataSet), pDataSet);
+   if(Error_None != error) {
+      // already logged
+      UnmapFile(pMapped, cBytesMapped);
+      return error;
+   }
+
+   DataSetFile * const pDataSetFile = static_cast<DataSetFile *>(malloc(sizeof(DataSetFile)));
+   if(UNLIKELY(nullptr == pDataSetFile)) {
+      LOG_0(Trace_Warning, "WARNING DataSetFile::Create nullptr == pDataSetFile");
+      UnmapFile(pMapped, cBytesMapped);
+      return Error_OutOfMemory;
+   }
+   pDataSetFile->m_handleVerification = k_handleVerificationOk;
+   pDataSetFile->m_pMapped = pMapped;
+   pDataSetFile->m_cBytesMapped = cBytesMapped;
+
+   *ppDataSetFileOut = pDataSetFile;
+
+   LOG_0(Trace_Info, "Exited DataSetFile::Create");
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION WriteDataSetFile(
+   const char * path,
+   IntEbm countBytesAllocated,
+   const void * dataSet
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered WriteDataSetFile: "
+      "path=%p, "
+      "countBytesAllocated=%" IntEbmPrintf ", "
+      "dataSet=%p"
+      ,
+      static_cast<const void *>(path), // do not print the string for security reasons
+      countBytesAllocated,
+      static_cast<const void *>(dataSet)
+   );
+
+   if(nullptr == path) {
+      LOG_0(Trace_Error, "ERROR WriteDataSetFile path cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+   if(countBytesAllocated <= IntEbm { 0 }) {
+      LOG_0(Trace_Error, "ERROR WriteDataSetFile countBytesAllocated must be the exact positive size of the dataSet");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countBytesAllocated)) {
+      LOG_0(Trace_Error, "ERROR WriteDataSetFile IsConvertError<size_t>(countBytesAllocated)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cBytesDataSet = static_cast<size_t>(countBytesAllocated);
+
+   // a positive countBytesAllocated requires the dataSet to fill it exactly, so nothing past it is written
+   ErrorEbm error = CheckDataSet(countBytesAllocated, dataSet);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   DataSetFileHeader header;
+   memset(&header, 0, sizeof(header));
+   header.m_magic = k_dataSetFileMagic;
+   header.m_byteOrder = k_dataSetFileByteOrder;
+   header.m_version = k_dataSetFileVersion;
+   header.m_cBytesHeader = UIntShared { sizeof(DataSetFileHeader) };
+   header.m_cBytesDataSet = static_cast<UIntShared>(cBytesDataSet);
+   header.m_checksum = ChecksumDataSet(static_cast<const unsigned char *>(dataSet), cBytesDataSet);
+
+   FILE * const pFile = fopen(path, "wb");
+   if(nullptr == pFile) {
+      LOG_0(Trace_Warning, "WARNING WriteDataSetFile fopen failed");
+      return Error_FileIO;
+   }
+   const bool bWriteFailed = size_t { 1 } != fwrite(&header, sizeof(header), 1, pFile) ||
+      size_t { 1 } != fwrite(dataSet, cBytesDataSet, 1, pFile);
+   // fclose flushes, so it can also fail
+   const bool bCloseFailed = 0 != fclose(pFile);
+   if(bWriteFailed || bCloseFailed) {
+      LOG_0(Trace_Warning, "WARNING WriteDataSetFile write failed");
+      return Error_FileIO;
+   }
+
+   LOG_0(Trace_Info, "Exited WriteDataSetFile");
+   return Error_None;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateDataSetFromFile(
+   const char * path,
+   DataSetFileHandle * dataSetFileHandleOut,
+   const void ** dataSetOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered CreateDataSetFromFile: "
+      "path=%p, "
+      "dataSetFileHandleOut=%p, "
+      "dataSetOut=%p"
+      ,
+      static_cast<const void *>(path), // do not print the string for security reasons
+      static_cast<const void *>(dataSetFileHandleOut),
+      static_cast<const void *>(dataSetOut)
+   );
+
+   if(nullptr == dataSetFileHandleOut) {
+      LOG_0(Trace_Error, "ERROR CreateDataSetFromFile nullptr == dataSetFileHandleOut");
+      return Error_IllegalParamVal;
+   }
+   *dataSetFileHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
+   if(nullptr == dataSetOut) {
+      LOG_0(Trace_Error, "ERROR CreateDataSetFromFile nullptr == dataSetOut");
+      return Error_IllegalParamVal;
+   }
+   *dataSetOut = nullptr;
+   if(nullptr == path) {
+      LOG_0(Trace_Error, "ERROR CreateDataSetFromFile path cannot be nullptr");
+      return Error_IllegalParamVal;
+   }
+
+   DataSetFile * pDataSetFile;
+   const ErrorEbm error = DataSetFile::Create(path, &pDataSetFile);
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   *dataSetFileHandleOut = pDataSetFile->GetHandle();
+   *dataSetOut = pDataSetFile->GetDataSet();
+
+   LOG_0(Trace_Info, "Exited CreateDataSetFromFile");
+   return Error_None;
+}
+
+EBM_API_BODY void EBM_CALLING_CONVENTION FreeDataSetFile(
+   DataSetFileHandle dataSetFileHandle
+) {
+   LOG_N(Trace_Info, "Entered FreeDataSetFile: dataSetFileHandle=%p", static_cast<void *>(dataSetFileHandle));
+
+   DataSetFile * const pDataSetFile = DataSetFile::GetDataSetFileFromHandle(dataSetFileHandle);
+   // if the conversion above doesn't work, it'll return null, and our free will not in fact free any memory,
+   // but it will not crash. We'll leak memory, but at least we'll log that.
+
+   // it's legal to call free on nullptr, just like for free().  This is checked inside DataSetFile::Free()
+   DataSetFile::Free(pDataSetFile);
+
+   LOG_0(Trace_Info, "Exited FreeDataSetFile");
+}
+
+} // DEFINED_ZONE_NAME
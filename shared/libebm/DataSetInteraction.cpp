@@ -121,7 +121,6 @@ ErrorEbm DataSetInteraction::InitFeatureData(
          &cNonDefaultsSparse
       );
       EBM_ASSERT(nullptr != aFeatureDataFrom);
-      EBM_ASSERT(!bSparse); // we don't support sparse yet
 
       EBM_ASSERT(!IsConvertError<size_t>(countBins)); // checked in a previous call to GetDataSetSharedFeature
       const size_t cBins = static_cast<size_t>(countBins);
@@ -152,7 +151,21 @@ ErrorEbm DataSetInteraction::InitFeatureData(
 
          int iShiftFrom = static_cast<int>((cSharedSamples - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPackFrom));
 
-         const UIntShared * pFeatureDataFrom = static_cast<const UIntShared *>(aFeatureDataFrom);
+         // interactions are calculated on pairs, and we do not want to template the pair kernels on each dimension
+         // being sparse or dense, so sparse features are expanded into the dense bit packed form here
+         const UIntShared * pFeatureDataFrom = nullptr;
+         const SparseFeatureDataSetSharedEntry * pNonDefault = nullptr;
+         const SparseFeatureDataSetSharedEntry * pNonDefaultEnd = nullptr;
+         UIntShared iSampleFrom = 0;
+         if(bSparse) {
+            EBM_ASSERT(!IsConvertError<size_t>(defaultValSparse));
+            EBM_ASSERT(static_cast<size_t>(defaultValSparse) < cBins);
+            pNonDefault = static_cast<const SparseFeatureDataSetSharedEntry *>(aFeatureDataFrom);
+            pNonDefaultEnd = pNonDefault + cNonDefaultsSparse;
+         } else {
+            pFeatureDataFrom = static_cast<const UIntShared *>(aFeatureDataFrom);
+         }
+
          const BagEbm * pSampleReplication = aBag;
          BagEbm replication = 0;
          UIntShared iFeatureBin;
@@ -212,31 +225,48 @@ ErrorEbm DataSetInteraction::InitFeatureData(
                            } while(replication <= BagEbm { 0 });
                            const size_t cAdvances = pSampleReplication - pSampleReplicationOriginal - 1;
 
-                           size_t cCompleteAdvanced = cAdvances / static_cast<size_t>(cItemsPerBitPackFrom);
-                           iShiftFrom -= static_cast<int>(cAdvances % static_cast<size_t>(cItemsPerBitPackFrom));
-                           if(iShiftFrom < 0) {
-                              iShiftFrom += cItemsPerBitPackFrom;
-                              EBM_ASSERT(0 <= iShiftFrom);
-                              ++cCompleteAdvanced;
+                           if(bSparse) {
+                              iSampleFrom += static_cast<UIntShared>(cAdvances);
+                           } else {
+                              size_t cCompleteAdvanced = cAdvances / static_cast<size_t>(cItemsPerBitPackFrom);
+                              iShiftFrom -= static_cast<int>(cAdvances % static_cast<size_t>(cItemsPerBitPackFrom));
+                              if(iShiftFrom < 0) {
+                                 iShiftFrom += cItemsPerBitPackFrom;
+                                 EBM_ASSERT(0 <= iShiftFrom);
+                                 ++cCompleteAdvanced;
+                              }
+                              pFeatureDataFrom += cCompleteAdvanced;
                            }
-                           pFeatureDataFrom += cCompleteAdvanced;
                         }
 
-                        const UIntShared bitsFrom = *pFeatureDataFrom;
+                        if(bSparse) {
+                           // the entries are sorted by sample, so skip the ones that belonged to excluded samples
+                           while(pNonDefaultEnd != pNonDefault && pNonDefault->m_iSample < iSampleFrom) {
+                              ++pNonDefault;
+                           }
+                           iFeatureBin = defaultValSparse;
+                           if(pNonDefaultEnd != pNonDefault && iSampleFrom == pNonDefault->m_iSample) {
+                              iFeatureBin = pNonDefault->m_nonDefaultVal;
+                              ++pNonDefault;
+                           }
+                           ++iSampleFrom;
+                        } else {
+                           const UIntShared bitsFrom = *pFeatureDataFrom;
+
+                           EBM_ASSERT(0 <= iShiftFrom);
+                           EBM_ASSERT(iShiftFrom * cBitsPerItemMaxFrom < COUNT_BITS(UIntShared));
+                           iFeatureBin = (bitsFrom >> (iShiftFrom * cBitsPerItemMaxFrom)) & maskBitsFrom;
 
-                        EBM_ASSERT(0 <= iShiftFrom);
-                        EBM_ASSERT(iShiftFrom * cBitsPerItemMaxFrom < COUNT_BITS(UIntShared));
-                        iFeatureBin = (bitsFrom >> (iShiftFrom * cBitsPerItemMaxFrom)) & maskBitsFrom;
+                           --iShiftFrom;
+                           if(iShiftFrom < 0) {
+                              EBM_ASSERT(-1 == iShiftFrom);
+                              iShiftFrom += cItemsPerBitPackFrom;
+                              ++pFeatureDataFrom;
+                           }
+                        }
 
                         EBM_ASSERT(!IsConvertError<size_t>(iFeatureBin));
                         EBM_ASSERT(static_cast<size_t>(iFeatureBin) < cBins);
-
-                        --iShiftFrom;
-                        if(iShiftFrom < 0) {
-                           EBM_ASSERT(-1 == iShiftFrom);
-                           iShiftFrom += cItemsPerBitPackFrom;
-                           ++pFeatureDataFrom;
-                        }
                      }
 
                      EBM_ASSERT(1 <= replication);
@@ -7,16 +7,20 @@
 // TODO: use noexcept throughout our codebase (exception extern "C" functions) !  The compiler can optimize functions better if it knows there are no exceptions
 // TODO: review all the C++ library calls, including things like std::abs and verify that none of them throw exceptions, otherwise use the C versions that provide this guarantee
 
+#include <stdlib.h> // malloc, free
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // std::numeric_limits
+#include <type_traits> // std::is_standard_layout
 #include <string.h> // memcpy
 
 #include "libebm.h"
 #include "logging.h"
 #include "common_c.h" // LIKELY
+#include "bridge_c.h" // DiscretizeKernels
 #include "zones.h"
 
 #include "common_cpp.hpp" // IsConvertError
+#include "ThreadPool.hpp"
 
 // TODO: check this file for how we handle subnormal numbers!  It's tricky if we get them
 
@@ -215,16 +219,81 @@ EBM_API_BODY IntEbm EBM_CALLING_CONVENTION DiscretizeOneSample(
    return static_cast<IntEbm>(middle);
 }
 
+extern const DiscretizeKernels * GetDiscretizeKernels() noexcept;
+
+// up to this many cuts it's faster to compare each value against every cut than to search for its bin
+static constexpr IntEbm k_cBroadcastCutsMax = 16;
+
+static void BuildEytzingerTree(
+   const size_t cLevels,
+   const size_t cCuts,
+   const double * const aCuts,
+   double * const aTree
+) {
+   // lay the cuts out breadth first in a complete binary tree of 2^cLevels - 1 nodes starting at index 1.  Node
+   // iNode on a level that starts at iFirst holds sorted element (2 * (iNode - iFirst) + 1) * 2^(remaining levels) - 1.
+   // Nodes past the last cut hold NaN, which fails every comparison and so acts like a cut above every value
+   EBM_ASSERT(1 <= cLevels);
+   EBM_ASSERT(cCuts < size_t { 1 } << cLevels);
+
+   aTree[0] = std::numeric_limits<double>::quiet_NaN(); // unused
+   size_t iLevel = 0;
+   do {
+      const size_t iFirst = size_t { 1 } << iLevel;
+      const size_t cShift = cLevels - size_t { 1 } - iLevel;
+      for(size_t iNode = iFirst; iNode < iFirst << 1; ++iNode) {
+         const size_t iCut = ((((iNode - iFirst) << 1) | size_t { 1 }) << cShift) - size_t { 1 };
+         aTree[iNode] = iCut < cCuts ? aCuts[iCut] : std::numeric_limits<double>::quiet_NaN();
+      }
+      ++iLevel;
+   } while(cLevels != iLevel);
+}
+
+static void CallDiscretizeKernel(
+   const DISCRETIZE_KERNEL_C pKernel,
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cCutsOrLevels,
+   const double * const aCutsOrTree,
+   IntEbm * const aBinIndexesOut
+) {
+   (*pKernel)(cSamples, aFeatureVals, cCutsOrLevels, aCutsOrTree, aBinIndexesOut);
+}
+
+template<typename TBinIndex>
+static void CallDiscretizeKernel(
+   const DISCRETIZE_KERNEL_C pKernel,
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cCutsOrLevels,
+   const double * const aCutsOrTree,
+   TBinIndex * const aBinIndexesOut
+) {
+   // the kernels only write IntEbm, so narrow their output through a buffer that stays in L1
+   static constexpr size_t k_cSamplesPerChunk = 256;
+   IntEbm aBinIndexesChunk[k_cSamplesPerChunk];
+   size_t iStart = 0;
+   do {
+      const size_t cChunk = EbmMin(k_cSamplesPerChunk, cSamples - iStart);
+      (*pKernel)(cChunk, aFeatureVals + iStart, cCutsOrLevels, aCutsOrTree, aBinIndexesChunk);
+      for(size_t i = 0; i < cChunk; ++i) {
+         aBinIndexesOut[iStart + i] = static_cast<TBinIndex>(aBinIndexesChunk[i]);
+      }
+      iStart += cChunk;
+   } while(cSamples != iStart);
+}
+
 // don't bother using a lock here.  We don't care if an extra log message is written out due to thread parallism
 static int g_cLogEnterDiscretize = 25;
 static int g_cLogExitDiscretize = 25;
 
-EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
-   IntEbm countSamples,
-   const double * featureVals,
-   IntEbm countCuts,
-   const double * cutsLowerBoundInclusive,
-   IntEbm * binIndexesOut
+template<typename TBinIndex>
+static ErrorEbm DiscretizeInternal(
+   const IntEbm countSamples,
+   const double * const featureVals,
+   const IntEbm countCuts,
+   const double * const cutsLowerBoundInclusive,
+   TBinIndex * const binIndexesOut
 ) {
    // make the 0th bin always the missing value.  This makes cutting mains easier, since we always know where the 
    // missing bin will be, and also the first non-missing bin.  We can also increment the pointer to the histogram
@@ -272,24 +341,6 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
    //         then doing our upper bound comparison all in one check.  We can then filter our 0 ==countCuts
    //         after that as a special case
 
-   LOG_COUNTED_N(
-      &g_cLogEnterDiscretize,
-      Trace_Info,
-      Trace_Verbose,
-      "Entered Discretize: "
-      "countSamples=%" IntEbmPrintf ", "
-      "featureVals=%p, "
-      "countCuts=%" IntEbmPrintf ", "
-      "cutsLowerBoundInclusive=%p, "
-      "binIndexesOut=%p"
-      ,
-      countSamples,
-      static_cast<const void *>(featureVals),
-      countCuts,
-      static_cast<const void *>(cutsLowerBoundInclusive),
-      static_cast<void *>(binIndexesOut)
-   );
-
    ErrorEbm error;
    
    if(UNLIKELY(countSamples <= IntEbm { 0 })) {
@@ -338,7 +389,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
       const double * pVal = featureVals;
       const double * const pValsEnd = featureVals + cSamples;
-      IntEbm * piBin = binIndexesOut;
+      TBinIndex * piBin = binIndexesOut;
 
       if(UNLIKELY(countCuts <= IntEbm { 0 })) {
          if(UNLIKELY(countCuts < IntEbm { 0 })) {
@@ -353,7 +404,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
             IntEbm iBin;
             iBin = UNPREDICTABLE(std::isnan(val)) ? IntEbm { 0 } : IntEbm { 1 };
             EBM_ASSERT(iBin == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
-            *piBin = iBin;
+            *piBin = static_cast<TBinIndex>(iBin);
             ++piBin;
             ++pVal;
          } while(LIKELY(pValsEnd != pVal));
@@ -361,6 +412,14 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
          goto exit_with_log;
       }
 
+      // the highest bin index is countCuts + 1, which has to fit into the narrower bin index types
+      if(UNLIKELY(sizeof(TBinIndex) < sizeof(IntEbm) && 
+         static_cast<UIntEbm>(std::numeric_limits<TBinIndex>::max()) - UIntEbm { 1 } < static_cast<UIntEbm>(countCuts))) {
+         LOG_0(Trace_Error, "ERROR Discretize countCuts has more bins than binIndexesOut can hold");
+         error = Error_IllegalParamVal;
+         goto exit_with_log;
+      }
+
       if(UNLIKELY(nullptr == cutsLowerBoundInclusive)) {
          LOG_0(Trace_Error, "ERROR Discretize cutsLowerBoundInclusive cannot be null");
          error = Error_IllegalParamVal;
@@ -387,6 +446,58 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
       }
 # endif // NDEBUG
 
+      const DiscretizeKernels * const pKernels = GetDiscretizeKernels();
+      if(nullptr != pKernels->m_pDiscretizeBroadcastC) {
+         bool bDone = false;
+         if(countCuts <= k_cBroadcastCutsMax) {
+            CallDiscretizeKernel(
+               pKernels->m_pDiscretizeBroadcastC,
+               cSamples,
+               featureVals,
+               static_cast<size_t>(countCuts),
+               cutsLowerBoundInclusive,
+               binIndexesOut
+            );
+            bDone = true;
+         } else if(!IsConvertError<size_t>(countCuts) && static_cast<size_t>(countCuts) < cSamples / size_t { 4 }) {
+            // like the padded binary searches below, only build the tree if there are at least 4 samples per node
+            const size_t cCuts = static_cast<size_t>(countCuts);
+            size_t cLevels = 1;
+            size_t cNodesPadded = 2;
+            while(cNodesPadded <= cCuts) {
+               cNodesPadded <<= 1;
+               ++cLevels;
+            }
+            if(cNodesPadded <= cSamples / size_t { 4 }) {
+               double * const aTree = static_cast<double *>(malloc(sizeof(double) * cNodesPadded));
+               if(nullptr != aTree) {
+                  BuildEytzingerTree(cLevels, cCuts, cutsLowerBoundInclusive, aTree);
+                  CallDiscretizeKernel(
+                     pKernels->m_pDiscretizeEytzingerC,
+                     cSamples,
+                     featureVals,
+                     cLevels,
+                     aTree,
+                     binIndexesOut
+                  );
+                  free(aTree);
+                  bDone = true;
+               }
+               // if we cannot allocate the tree, the scalar searches below need no memory
+            }
+         }
+         if(bDone) {
+#ifndef NDEBUG
+            for(size_t iDebug = 0; iDebug < cSamples; ++iDebug) {
+               EBM_ASSERT(static_cast<IntEbm>(binIndexesOut[iDebug]) == 
+                  DiscretizeOneSample(featureVals[iDebug], countCuts, cutsLowerBoundInclusive));
+            }
+#endif // NDEBUG
+            error = Error_None;
+            goto exit_with_log;
+         }
+      }
+
       if(PREDICTABLE(IntEbm { 1 } == countCuts)) {
          const double cut0 = cutsLowerBoundInclusive[0];
          do {
@@ -398,7 +509,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
             EBM_ASSERT(iBin == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-            *piBin = iBin;
+            *piBin = static_cast<TBinIndex>(iBin);
             ++piBin;
             ++pVal;
          } while(LIKELY(pValsEnd != pVal));
@@ -419,7 +530,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
             EBM_ASSERT(iBin == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-            *piBin = iBin;
+            *piBin = static_cast<TBinIndex>(iBin);
             ++piBin;
             ++pVal;
          } while(LIKELY(pValsEnd != pVal));
@@ -442,7 +553,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
             EBM_ASSERT(iBin == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-            *piBin = iBin;
+            *piBin = static_cast<TBinIndex>(iBin);
             ++piBin;
             ++pVal;
          } while(LIKELY(pValsEnd != pVal));
@@ -467,7 +578,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
             EBM_ASSERT(iBin == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-            *piBin = iBin;
+            *piBin = static_cast<TBinIndex>(iBin);
             ++piBin;
             ++pVal;
          } while(LIKELY(pValsEnd != pVal));
@@ -494,7 +605,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
             EBM_ASSERT(iBin == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-            *piBin = iBin;
+            *piBin = static_cast<TBinIndex>(iBin);
             ++piBin;
             ++pVal;
          } while(LIKELY(pValsEnd != pVal));
@@ -523,7 +634,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
             EBM_ASSERT(iBin == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-            *piBin = iBin;
+            *piBin = static_cast<TBinIndex>(iBin);
             ++piBin;
             ++pVal;
          } while(LIKELY(pValsEnd != pVal));
@@ -577,7 +688,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
                EBM_ASSERT(static_cast<IntEbm>(iBin) == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-               *piBin = static_cast<IntEbm>(iBin);
+               *piBin = static_cast<TBinIndex>(iBin);
                ++piBin;
                ++pVal;
             } while(LIKELY(pValsEnd != pVal));
@@ -623,7 +734,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
                EBM_ASSERT(static_cast<IntEbm>(iBin) == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-               *piBin = static_cast<IntEbm>(iBin);
+               *piBin = static_cast<TBinIndex>(iBin);
                ++piBin;
                ++pVal;
             } while(LIKELY(pValsEnd != pVal));
@@ -670,7 +781,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
                EBM_ASSERT(static_cast<IntEbm>(iBin) == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-               *piBin = static_cast<IntEbm>(iBin);
+               *piBin = static_cast<TBinIndex>(iBin);
                ++piBin;
                ++pVal;
             } while(LIKELY(pValsEnd != pVal));
@@ -718,7 +829,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
                EBM_ASSERT(static_cast<IntEbm>(iBin) == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-               *piBin = static_cast<IntEbm>(iBin);
+               *piBin = static_cast<TBinIndex>(iBin);
                ++piBin;
                ++pVal;
             } while(LIKELY(pValsEnd != pVal));
@@ -767,7 +878,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
                EBM_ASSERT(static_cast<IntEbm>(iBin) == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-               *piBin = static_cast<IntEbm>(iBin);
+               *piBin = static_cast<TBinIndex>(iBin);
                ++piBin;
                ++pVal;
             } while(LIKELY(pValsEnd != pVal));
@@ -817,7 +928,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
                EBM_ASSERT(static_cast<IntEbm>(iBin) == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-               *piBin = static_cast<IntEbm>(iBin);
+               *piBin = static_cast<TBinIndex>(iBin);
                ++piBin;
                ++pVal;
             } while(LIKELY(pValsEnd != pVal));
@@ -868,7 +979,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
                EBM_ASSERT(static_cast<IntEbm>(iBin) == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-               *piBin = static_cast<IntEbm>(iBin);
+               *piBin = static_cast<TBinIndex>(iBin);
                ++piBin;
                ++pVal;
             } while(LIKELY(pValsEnd != pVal));
@@ -1007,13 +1118,117 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
 
          EBM_ASSERT(iBin == DiscretizeOneSample(val, countCuts, cutsLowerBoundInclusive));
 
-         *piBin = iBin;
+         *piBin = static_cast<TBinIndex>(iBin);
          ++piBin;
          ++pVal;
       } while(LIKELY(pValsEnd != pVal));
       error = Error_None;
    }
 
+exit_with_log:;
+   return error;
+}
+
+// below this many samples per task the cost of waking the worker threads exceeds the time spent discretizing
+static constexpr size_t k_cSamplesPerDiscretizeTaskMin = size_t { 1 } << 16;
+
+template<typename TBinIndex>
+struct DiscretizeTask {
+   size_t m_cSamples;
+   size_t m_cSamplesPerTask;
+   const double * m_aFeatureVals;
+   IntEbm m_countCuts;
+   const double * m_aCutsLowerBoundInclusive;
+   TBinIndex * m_aBinIndexes;
+};
+
+template<typename TBinIndex>
+static ErrorEbm DiscretizeChunk(void * const pContext, const size_t iTask) {
+   const DiscretizeTask<TBinIndex> * const pTask = static_cast<const DiscretizeTask<TBinIndex> *>(pContext);
+
+   const size_t iStart = pTask->m_cSamplesPerTask * iTask;
+   EBM_ASSERT(iStart < pTask->m_cSamples);
+   const size_t cSamples = EbmMin(pTask->m_cSamplesPerTask, pTask->m_cSamples - iStart);
+
+   return DiscretizeInternal<TBinIndex>(
+      static_cast<IntEbm>(cSamples),
+      pTask->m_aFeatureVals + iStart,
+      pTask->m_countCuts,
+      pTask->m_aCutsLowerBoundInclusive,
+      pTask->m_aBinIndexes + iStart
+   );
+}
+
+template<typename TBinIndex>
+static ErrorEbm DiscretizeThreaded(
+   const IntEbm countSamples,
+   const double * const featureVals,
+   const IntEbm countCuts,
+   const double * const cutsLowerBoundInclusive,
+   const ThreadPoolHandle threadPool,
+   TBinIndex * const binIndexesOut
+) {
+   // this function has exactly the same behavior as numpy.digitize, including the lower bound inclusive semantics.
+   // See DiscretizeInternal for the details.
+
+   LOG_COUNTED_N(
+      &g_cLogEnterDiscretize,
+      Trace_Info,
+      Trace_Verbose,
+      "Entered Discretize: "
+      "countSamples=%" IntEbmPrintf ", "
+      "featureVals=%p, "
+      "countCuts=%" IntEbmPrintf ", "
+      "cutsLowerBoundInclusive=%p, "
+      "threadPool=%p, "
+      "binIndexesOut=%p"
+      ,
+      countSamples,
+      static_cast<const void *>(featureVals),
+      countCuts,
+      static_cast<const void *>(cutsLowerBoundInclusive),
+      static_cast<void *>(threadPool),
+      static_cast<void *>(binIndexesOut)
+   );
+
+   ErrorEbm error;
+
+   ThreadPool * pThreadPool = nullptr;
+   if(nullptr != threadPool) {
+      pThreadPool = ThreadPool::GetThreadPoolFromHandle(threadPool);
+      if(nullptr == pThreadPool) {
+         // already logged
+         error = Error_IllegalParamVal;
+         goto exit_with_log;
+      }
+   }
+
+   if(nullptr != pThreadPool && size_t { 1 } != pThreadPool->GetCountThreads() &&
+      !IsConvertError<size_t>(countSamples) && k_cSamplesPerDiscretizeTaskMin < static_cast<size_t>(countSamples) &&
+      nullptr != featureVals && nullptr != binIndexesOut) {
+
+      // Each sample is discretized independently, so splitting the samples into contiguous chunks gives results
+      // identical to the serial version. Any illegal parameters other than those checked above fail identically
+      // in every chunk, and Run returns the error from the first chunk.
+      const size_t cSamples = static_cast<size_t>(countSamples);
+      const size_t cThreads = pThreadPool->GetCountThreads();
+      size_t cSamplesPerTask = (cSamples + (cThreads - size_t { 1 })) / cThreads;
+      cSamplesPerTask = EbmMax(cSamplesPerTask, k_cSamplesPerDiscretizeTaskMin);
+      const size_t cTasks = (cSamples + (cSamplesPerTask - size_t { 1 })) / cSamplesPerTask;
+
+      DiscretizeTask<TBinIndex> task;
+      task.m_cSamples = cSamples;
+      task.m_cSamplesPerTask = cSamplesPerTask;
+      task.m_aFeatureVals = featureVals;
+      task.m_countCuts = countCuts;
+      task.m_aCutsLowerBoundInclusive = cutsLowerBoundInclusive;
+      task.m_aBinIndexes = binIndexesOut;
+
+      error = pThreadPool->Run(cTasks, DiscretizeChunk<TBinIndex>, &task);
+   } else {
+      error = DiscretizeInternal<TBinIndex>(countSamples, featureVals, countCuts, cutsLowerBoundInclusive, binIndexesOut);
+   }
+
 exit_with_log:;
 
    LOG_COUNTED_N(
@@ -1029,4 +1244,451 @@ exit_with_log:;
    return error;
 }
 
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION Discretize(
+   IntEbm countSamples,
+   const double * featureVals,
+   IntEbm countCuts,
+   const double * cutsLowerBoundInclusive,
+   ThreadPoolHandle threadPool,
+   IntEbm * binIndexesOut
+) {
+   return DiscretizeThreaded(countSamples, featureVals, countCuts, cutsLowerBoundInclusive, threadPool, binIndexesOut);
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION DiscretizeUInt8(
+   IntEbm countSamples,
+   const double * featureVals,
+   IntEbm countCuts,
+   const double * cutsLowerBoundInclusive,
+   ThreadPoolHandle threadPool,
+   uint8_t * binIndexesOut
+) {
+   return DiscretizeThreaded(countSamples, featureVals, countCuts, cutsLowerBoundInclusive, threadPool, binIndexesOut);
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION DiscretizeUInt16(
+   IntEbm countSamples,
+   const double * featureVals,
+   IntEbm countCuts,
+   const double * cutsLowerBoundInclusive,
+   ThreadPoolHandle threadPool,
+   uint16_t * binIndexesOut
+) {
+   return DiscretizeThreaded(countSamples, featureVals, countCuts, cutsLowerBoundInclusive, threadPool, binIndexesOut);
+}
+
+// Reading a C ordered matrix one feature at a time would fetch a fresh cache line for every value, so we copy a stripe
+// of up to k_cStripeFeatures adjacent features for a block of samples into a column ordered buffer, which reads each
+// cache line once, and then discretize each column of the buffer. See the transpose timings at the top of this file.
+static constexpr size_t k_cStripeFeatures = 64;
+static constexpr size_t k_cStripeSamples = 256;
+
+struct DiscretizeMatrixTask {
+   size_t m_cSamples;
+   size_t m_cFeatures;
+   size_t m_cSamplesPerTask;
+   const double * m_aFeatureVals;
+   MatrixOrder m_order;
+   const IntEbm * m_aCountCuts;
+   const size_t * m_aiCutsStart;
+   const double * m_aCutsLowerBoundInclusive;
+   IntEbm * m_aBinIndexes;
+};
+
+static ErrorEbm DiscretizeMatrixChunk(void * const pContext, const size_t iTask) {
+   const DiscretizeMatrixTask * const pTask = static_cast<const DiscretizeMatrixTask *>(pContext);
+
+   const size_t cSamples = pTask->m_cSamples;
+   const size_t cFeatures = pTask->m_cFeatures;
+   const size_t iSampleStart = pTask->m_cSamplesPerTask * iTask;
+   EBM_ASSERT(iSampleStart < cSamples);
+   const size_t iSampleEnd = iSampleStart + EbmMin(pTask->m_cSamplesPerTask, cSamples - iSampleStart);
+
+   ErrorEbm error;
+   if(MatrixOrder_Fortran == pTask->m_order) {
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         error = DiscretizeInternal<IntEbm>(
+            static_cast<IntEbm>(iSampleEnd - iSampleStart),
+            pTask->m_aFeatureVals + iFeature * cSamples + iSampleStart,
+            pTask->m_aCountCuts[iFeature],
+            pTask->m_aCutsLowerBoundInclusive + pTask->m_aiCutsStart[iFeature],
+            pTask->m_aBinIndexes + iFeature * cSamples + iSampleStart
+         );
+         if(Error_None != error) {
+            return error;
+         }
+      }
+      return Error_None;
+   }
+   EBM_ASSERT(MatrixOrder_C == pTask->m_order);
+
+   double * const aStripe = static_cast<double *>(malloc(sizeof(double) * k_cStripeFeatures * k_cStripeSamples));
+   if(nullptr == aStripe) {
+      LOG_0(Trace_Warning, "WARNING DiscretizeMatrixChunk nullptr == aStripe");
+      return Error_OutOfMemory;
+   }
+
+   error = Error_None;
+   size_t iSampleBlock = iSampleStart;
+   do {
+      const size_t cSamplesBlock = EbmMin(k_cStripeSamples, iSampleEnd - iSampleBlock);
+      size_t iFeatureStripe = 0;
+      do {
+         const size_t cFeaturesStripe = EbmMin(k_cStripeFeatures, cFeatures - iFeatureStripe);
+
+         for(size_t iSample = 0; iSample < cSamplesBlock; ++iSample) {
+            const double * const pRow = 
+               pTask->m_aFeatureVals + (iSampleBlock + iSample) * cFeatures + iFeatureStripe;
+            for(size_t iFeature = 0; iFeature < cFeaturesStripe; ++iFeature) {
+               aStripe[iFeature * k_cStripeSamples + iSample] = pRow[iFeature];
+            }
+         }
+
+         for(size_t iFeature = 0; iFeature < cFeaturesStripe; ++iFeature) {
+            const size_t iFeatureMatrix = iFeatureStripe + iFeature;
+            error = DiscretizeInternal<IntEbm>(
+               static_cast<IntEbm>(cSamplesBlock),
+               &aStripe[iFeature * k_cStripeSamples],
+               pTask->m_aCountCuts[iFeatureMatrix],
+               pTask->m_aCutsLowerBoundInclusive + pTask->m_aiCutsStart[iFeatureMatrix],
+               pTask->m_aBinIndexes + iFeatureMatrix * cSamples + iSampleBlock
+            );
+            if(Error_None != error) {
+               goto exit_free;
+            }
+         }
+         iFeatureStripe += cFeaturesStripe;
+      } while(cFeatures != iFeatureStripe);
+      iSampleBlock += cSamplesBlock;
+   } while(iSampleEnd != iSampleBlock);
+
+exit_free:;
+   free(aStripe);
+   return error;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION DiscretizeMatrix(
+   IntEbm countSamples,
+   IntEbm countFeatures,
+   const double * featureVals,
+   MatrixOrder order,
+   const IntEbm * countCuts,
+   const double * cutsLowerBoundInclusive,
+   ThreadPoolHandle threadPool,
+   IntEbm * binIndexesOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered DiscretizeMatrix: "
+      "countSamples=%" IntEbmPrintf ", "
+      "countFeatures=%" IntEbmPrintf ", "
+      "featureVals=%p, "
+      "order=%" MatrixOrderPrintf ", "
+      "countCuts=%p, "
+      "cutsLowerBoundInclusive=%p, "
+      "threadPool=%p, "
+      "binIndexesOut=%p"
+      ,
+      countSamples,
+      countFeatures,
+      static_cast<const void *>(featureVals),
+      order,
+      static_cast<const void *>(countCuts),
+      static_cast<const void *>(cutsLowerBoundInclusive),
+      static_cast<void *>(threadPool),
+      static_cast<void *>(binIndexesOut)
+   );
+
+   ThreadPool * pThreadPool = nullptr;
+   if(nullptr != threadPool) {
+      pThreadPool = ThreadPool::GetThreadPoolFromHandle(threadPool);
+      if(nullptr == pThreadPool) {
+         // already logged
+         return Error_IllegalParamVal;
+      }
+   }
+
+   if(IsConvertError<size_t>(countSamples)) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix countSamples is outside the range of a valid index");
+      return Error_IllegalParamVal;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   if(IsConvertError<size_t>(countFeatures)) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix countFeatures is outside the range of a valid index");
+      return Error_IllegalParamVal;
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+
+   if(MatrixOrder_C != order && MatrixOrder_Fortran != order) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix order must be MatrixOrder_C or MatrixOrder_Fortran");
+      return Error_IllegalParamVal;
+   }
+
+   if(size_t { 0 } == cSamples || size_t { 0 } == cFeatures) {
+      return Error_None;
+   }
+
+   if(IsMultiplyError(sizeof(*featureVals), cSamples, cFeatures) || 
+      IsMultiplyError(sizeof(*binIndexesOut), cSamples, cFeatures)) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix the matrix is too large to fit into memory");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == featureVals) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix featureVals cannot be null");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == countCuts) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix countCuts cannot be null");
+      return Error_IllegalParamVal;
+   }
+   if(nullptr == binIndexesOut) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix binIndexesOut cannot be null");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsMultiplyError(sizeof(size_t), cFeatures)) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix IsMultiplyError(sizeof(size_t), cFeatures)");
+      return Error_IllegalParamVal;
+   }
+   size_t * const aiCutsStart = static_cast<size_t *>(malloc(sizeof(size_t) * cFeatures));
+   if(nullptr == aiCutsStart) {
+      LOG_0(Trace_Warning, "WARNING DiscretizeMatrix nullptr == aiCutsStart");
+      return Error_OutOfMemory;
+   }
+
+   ErrorEbm error = Error_IllegalParamVal;
+
+   // the cuts of all the features are concatenated in feature order
+   size_t cCutsTotal = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const IntEbm countCutsFeature = countCuts[iFeature];
+      if(IsConvertError<size_t>(countCutsFeature)) {
+         LOG_0(Trace_Error, "ERROR DiscretizeMatrix countCuts contains an invalid count");
+         goto exit_free;
+      }
+      aiCutsStart[iFeature] = cCutsTotal;
+      if(IsAddError(cCutsTotal, static_cast<size_t>(countCutsFeature))) {
+         LOG_0(Trace_Error, "ERROR DiscretizeMatrix IsAddError(cCutsTotal, countCutsFeature)");
+         goto exit_free;
+      }
+      cCutsTotal += static_cast<size_t>(countCutsFeature);
+   }
+   if(size_t { 0 } != cCutsTotal && nullptr == cutsLowerBoundInclusive) {
+      LOG_0(Trace_Error, "ERROR DiscretizeMatrix cutsLowerBoundInclusive cannot be null");
+      goto exit_free;
+   }
+
+   {
+      DiscretizeMatrixTask task;
+      task.m_cSamples = cSamples;
+      task.m_cFeatures = cFeatures;
+      task.m_cSamplesPerTask = cSamples;
+      task.m_aFeatureVals = featureVals;
+      task.m_order = order;
+      task.m_aCountCuts = countCuts;
+      task.m_aiCutsStart = aiCutsStart;
+      task.m_aCutsLowerBoundInclusive = cutsLowerBoundInclusive;
+      task.m_aBinIndexes = binIndexesOut;
+
+      if(nullptr != pThreadPool && size_t { 1 } != pThreadPool->GetCountThreads() &&
+         k_cSamplesPerDiscretizeTaskMin < cSamples * cFeatures) {
+
+         // every sample is discretized independently, so splitting the samples into contiguous chunks gives
+         // results identical to the serial version. The chunks are whole sample blocks so that the stripes of
+         // different threads do not share cache lines of the output
+         const size_t cThreads = pThreadPool->GetCountThreads();
+         size_t cSamplesPerTask = (cSamples + (cThreads - size_t { 1 })) / cThreads;
+         cSamplesPerTask = EbmMax(cSamplesPerTask, k_cSamplesPerDiscretizeTaskMin / cFeatures);
+         cSamplesPerTask = (cSamplesPerTask + (k_cStripeSamples - size_t { 1 })) / k_cStripeSamples * k_cStripeSamples;
+         const size_t cTasks = (cSamples + (cSamplesPerTask - size_t { 1 })) / cSamplesPerTask;
+
+         task.m_cSamplesPerTask = cSamplesPerTask;
+         error = pThreadPool->Run(cTasks, DiscretizeMatrixChunk, &task);
+      } else {
+         error = DiscretizeMatrixChunk(&task, 0);
+      }
+   }
+
+exit_free:;
+   free(aiCutsStart);
+   return error;
+}
+
+struct CutPlan {
+   static constexpr size_t k_handleVerificationOk = 30517; // random 15 bit number
+   static constexpr size_t k_handleVerificationFreed = 5386; // random 15 bit number
+   size_t m_handleVerification; // this needs to be at the top and make it pointer sized to keep best alignment
+
+   size_t m_cLevels;
+   // the cuts as a complete tree with 2^m_cLevels - 1 nodes, laid out by BuildEytzingerTree. Index 0 is unused
+   double m_aTree[1];
+
+   inline static CutPlan * GetCutPlanFromHandle(const CutPlanHandle cutPlanHandle) {
+      if(nullptr == cutPlanHandle) {
+         LOG_0(Trace_Error, "ERROR GetCutPlanFromHandle null cutPlanHandle");
+         return nullptr;
+      }
+      CutPlan * const pCutPlan = reinterpret_cast<CutPlan *>(cutPlanHandle);
+      if(k_handleVerificationOk == pCutPlan->m_handleVerification) {
+         return pCutPlan;
+      }
+      if(k_handleVerificationFreed == pCutPlan->m_handleVerification) {
+         LOG_0(Trace_Error, "ERROR GetCutPlanFromHandle attempt to use freed CutPlanHandle");
+      } else {
+         LOG_0(Trace_Error, "ERROR GetCutPlanFromHandle attempt to use invalid CutPlanHandle");
+      }
+      return nullptr;
+   }
+   inline CutPlanHandle GetHandle() {
+      return reinterpret_cast<CutPlanHandle>(this);
+   }
+};
+static_assert(std::is_standard_layout<CutPlan>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<CutPlan>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateCutPlan(
+   IntEbm countCuts,
+   const double * cutsLowerBoundInclusive,
+   CutPlanHandle * cutPlanHandleOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered CreateCutPlan: "
+      "countCuts=%" IntEbmPrintf ", "
+      "cutsLowerBoundInclusive=%p, "
+      "cutPlanHandleOut=%p"
+      ,
+      countCuts,
+      static_cast<const void *>(cutsLowerBoundInclusive),
+      static_cast<const void *>(cutPlanHandleOut)
+   );
+
+   if(nullptr == cutPlanHandleOut) {
+      LOG_0(Trace_Error, "ERROR CreateCutPlan nullptr == cutPlanHandleOut");
+      return Error_IllegalParamVal;
+   }
+   *cutPlanHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
+
+   if(countCuts < IntEbm { 0 }) {
+      LOG_0(Trace_Error, "ERROR CreateCutPlan countCuts cannot be negative");
+      return Error_IllegalParamVal;
+   }
+   if(std::numeric_limits<IntEbm>::max() - IntEbm { 2 } < countCuts) {
+      // see DiscretizeInternal.  The highest bin index is countCuts + 1, which must be expressible
+      LOG_0(Trace_Error, "ERROR CreateCutPlan countCuts was too large to allow for a missing value placeholder");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countCuts)) {
+      LOG_0(Trace_Error, "ERROR CreateCutPlan IsConvertError<size_t>(countCuts)");
+      return Error_IllegalParamVal;
+   }
+   const size_t cCuts = static_cast<size_t>(countCuts);
+
+   if(size_t { 0 } != cCuts) {
+      if(nullptr == cutsLowerBoundInclusive) {
+         LOG_0(Trace_Error, "ERROR CreateCutPlan cutsLowerBoundInclusive cannot be null");
+         return Error_IllegalParamVal;
+      }
+      if(IsMultiplyError(sizeof(*cutsLowerBoundInclusive), cCuts)) {
+         LOG_0(Trace_Error, "ERROR CreateCutPlan countCuts was too large to fit into cutsLowerBoundInclusive");
+         return Error_IllegalParamVal;
+      }
+
+      // Discretize only asserts these since checking them on every call could cost more than the binning itself, 
+      // but a plan is checked once and then reused for many calls
+      double prev = -std::numeric_limits<double>::infinity();
+      for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+         const double cut = cutsLowerBoundInclusive[iCut];
+         if(std::isnan(cut) || std::isinf(cut)) {
+            LOG_0(Trace_Error, "ERROR CreateCutPlan cutsLowerBoundInclusive must be finite");
+            return Error_IllegalParamVal;
+         }
+         if(cut <= prev) {
+            LOG_0(Trace_Error, "ERROR CreateCutPlan cutsLowerBoundInclusive must be strictly increasing");
+            return Error_IllegalParamVal;
+         }
+         prev = cut;
+      }
+   }
+
+   size_t cLevels = 0;
+   size_t cNodesPadded = 1;
+   while(cNodesPadded <= cCuts) {
+      if(IsMultiplyError(size_t { 2 }, cNodesPadded)) {
+         LOG_0(Trace_Warning, "WARNING CreateCutPlan IsMultiplyError(size_t { 2 }, cNodesPadded)");
+         return Error_OutOfMemory;
+      }
+      cNodesPadded <<= 1;
+      ++cLevels;
+   }
+
+   static constexpr size_t k_cBytesHeader = offsetof(CutPlan, m_aTree);
+   if(IsMultiplyError(sizeof(double), cNodesPadded) || IsAddError(k_cBytesHeader, sizeof(double) * cNodesPadded)) {
+      LOG_0(Trace_Warning, "WARNING CreateCutPlan the tree would be too large to allocate");
+      return Error_OutOfMemory;
+   }
+   CutPlan * const pCutPlan = static_cast<CutPlan *>(malloc(k_cBytesHeader + sizeof(double) * cNodesPadded));
+   if(nullptr == pCutPlan) {
+      LOG_0(Trace_Warning, "WARNING CreateCutPlan nullptr == pCutPlan");
+      return Error_OutOfMemory;
+   }
+   pCutPlan->m_handleVerification = CutPlan::k_handleVerificationOk;
+   pCutPlan->m_cLevels = cLevels;
+   if(size_t { 0 } == cLevels) {
+      pCutPlan->m_aTree[0] = std::numeric_limits<double>::quiet_NaN(); // unused
+   } else {
+      BuildEytzingerTree(cLevels, cCuts, cutsLowerBoundInclusive, pCutPlan->m_aTree);
+   }
+
+   *cutPlanHandleOut = pCutPlan->GetHandle();
+
+   LOG_0(Trace_Info, "Exited CreateCutPlan");
+   return Error_None;
+}
+
+EBM_API_BODY void EBM_CALLING_CONVENTION FreeCutPlan(
+   CutPlanHandle cutPlanHandle
+) {
+   LOG_N(Trace_Info, "Entered FreeCutPlan: cutPlanHandle=%p", static_cast<void *>(cutPlanHandle));
+
+   if(nullptr == cutPlanHandle) {
+      // like free(nullptr), freeing a null handle is legal
+      return;
+   }
+   CutPlan * const pCutPlan = CutPlan::GetCutPlanFromHandle(cutPlanHandle);
+   if(nullptr == pCutPlan) {
+      // already logged
+      return;
+   }
+   pCutPlan->m_handleVerification = CutPlan::k_handleVerificationFreed;
+   free(pCutPlan);
+
+   LOG_0(Trace_Info, "Exited FreeCutPlan");
+}
+
+EBM_API_BODY IntEbm EBM_CALLING_CONVENTION DiscretizeOne(
+   CutPlanHandle cutPlanHandle,
+   double featureVal
+) {
+   // this is the entry point for scoring one sample at a time, so like DiscretizeOneSample we neither check our 
+   // inputs nor log.  CreateCutPlan already validated the cuts, and padded them into a complete tree so that
+   // every search takes exactly m_cLevels branchless steps with no setup
+   EBM_ASSERT(nullptr != cutPlanHandle);
+   const CutPlan * const pCutPlan = reinterpret_cast<const CutPlan *>(cutPlanHandle);
+   EBM_ASSERT(CutPlan::k_handleVerificationOk == pCutPlan->m_handleVerification);
+
+   const double * const aTree = pCutPlan->m_aTree;
+   const size_t cLevels = pCutPlan->m_cLevels;
+   size_t iNode = 1;
+   for(size_t iLevel = 0; iLevel != cLevels; ++iLevel) {
+      iNode = iNode + iNode + (UNPREDICTABLE(aTree[iNode] <= featureVal) ? size_t { 1 } : size_t { 0 });
+   }
+   // after descending, iNode is 2^cLevels plus the number of cuts that are lower or equal to featureVal
+   const IntEbm iBin = static_cast<IntEbm>(iNode - (size_t { 1 } << cLevels)) + IntEbm { 1 };
+   return UNPREDICTABLE(std::isnan(featureVal)) ? IntEbm { 0 } : iBin;
+}
+
 } // DEFINED_ZONE_NAME
@@ -24,6 +24,7 @@
 #include "Term.hpp"
 #include "InnerBag.hpp"
 #include "Tensor.hpp"
+#include "ThreadPool.hpp"
 #include "BoosterCore.hpp"
 #include "BoosterShell.hpp"
 
@@ -32,10 +33,13 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
+extern SIMDFlags GetSIMDFlags() noexcept;
+
 extern void ConvertAddBin(
    const size_t cScores,
    const bool bHessian,
    const size_t cBins,
+   const bool bWeightSrc,
    const bool bUInt64Src,
    const bool bDoubleSrc,
    const void * const aSrc,
@@ -440,6 +444,119 @@ static ErrorEbm BoostRandom(
    return Error_None;
 }
 
+// The work items are all the (inner bag, subset) pairs of a group of inner bags, numbered bag major so that
+// work item iWork bins subset (iWork % m_cSubsets) of inner bag (m_iBagFirst + iWork / m_cSubsets).
+struct BinSumsBoostingTask {
+   BoosterCore * m_pBoosterCore;
+   size_t m_iTerm;
+   size_t m_iBagFirst;
+   bool m_bCollapsed;
+   size_t m_cScores;
+   size_t m_cTensorBins;
+   DataSubsetBoosting * m_aSubsets;
+   size_t m_cSubsets;
+   size_t m_iWorkFirst;
+   size_t m_cBytesFastBinsStride;
+   BinBase * m_aFastBinsThreads;
+};
+
+// The weights passed to the BinSumsBoosting kernels. Unweighted fast bins do not hold the sample counts since they
+// equal the weights, so the fast bins are smaller when this returns nullptr.
+static const void * GetFastBinWeights(const DataSubsetBoosting * const pSubset, const size_t iBag) {
+   const InnerBag * const pInnerBag = pSubset->GetInnerBag(iBag);
+   return pInnerBag->IsCompact() ? pSubset->GetWeights() : pInnerBag->GetWeights();
+}
+
+static size_t GetFastBinSize(
+   const DataSubsetBoosting * const pSubset, 
+   const bool bWeight, 
+   const bool bHessian, 
+   const size_t cScores
+) {
+   if(!bWeight) {
+      if(sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes) {
+         if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
+            return GetBinSize<FloatBig, NoWeight<UIntBig>>(bHessian, cScores);
+         } else {
+            EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
+            return GetBinSize<FloatSmall, NoWeight<UIntBig>>(bHessian, cScores);
+         }
+      } else {
+         EBM_ASSERT(sizeof(UIntSmall) == pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+         if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
+            return GetBinSize<FloatBig, NoWeight<UIntSmall>>(bHessian, cScores);
+         } else {
+            EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
+            return GetBinSize<FloatSmall, NoWeight<UIntSmall>>(bHessian, cScores);
+         }
+      }
+   } else if(sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes) {
+      if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
+         return GetBinSize<FloatBig, UIntBig>(bHessian, cScores);
+      } else {
+         EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
+         return GetBinSize<FloatSmall, UIntBig>(bHessian, cScores);
+      }
+   } else {
+      EBM_ASSERT(sizeof(UIntSmall) == pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+      if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
+         return GetBinSize<FloatBig, UIntSmall>(bHessian, cScores);
+      } else {
+         EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
+         return GetBinSize<FloatSmall, UIntSmall>(bHessian, cScores);
+      }
+   }
+}
+
+// bins the work item at index iTask (relative to m_iWorkFirst) into the fast bins at index iTask. Each task owns its
+// own fast bins, so tasks can run on any thread in any order
+static ErrorEbm BinSumsBoostingSubset(void * const pContext, const size_t iTask) {
+   const BinSumsBoostingTask * const pTask = static_cast<const BinSumsBoostingTask *>(pContext);
+   BoosterCore * const pBoosterCore = pTask->m_pBoosterCore;
+   const size_t iWork = pTask->m_iWorkFirst + iTask;
+   const size_t iBag = pTask->m_iBagFirst + iWork / pTask->m_cSubsets;
+   DataSubsetBoosting * const pSubset = &pTask->m_aSubsets[iWork % pTask->m_cSubsets];
+   BinBase * const aFastBins = IndexBin(pTask->m_aFastBinsThreads, pTask->m_cBytesFastBinsStride * iTask);
+
+   int cPack;
+   if(UNLIKELY(pTask->m_bCollapsed)) {
+      // this is kind of hacky where if any one of a number of things occurs (like we have only 1 leaf)
+      // we sum everything into a single bin. The alternative would be to always sum into the tensor bins
+      // but then collapse them afterwards into a single bin, but that's more work.
+      cPack = k_cItemsPerBitPackNone;
+   } else {
+      const Term * const pTerm = pBoosterCore->GetTerms()[pTask->m_iTerm];
+      EBM_ASSERT(1 <= pTerm->GetBitsRequiredMin());
+      cPack = GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
+   }
+
+   const void * const aWeights = GetFastBinWeights(pSubset, iBag);
+   const size_t cBytesPerFastBin = GetFastBinSize(pSubset, nullptr != aWeights, pBoosterCore->IsHessian(), pTask->m_cScores);
+   EBM_ASSERT(!IsMultiplyError(cBytesPerFastBin, pTask->m_cTensorBins));
+   EBM_ASSERT(cBytesPerFastBin * pTask->m_cTensorBins <= pTask->m_cBytesFastBinsStride);
+
+   aFastBins->ZeroMem(cBytesPerFastBin, pTask->m_cTensorBins);
+
+   BinSumsBoostingBridge params;
+   params.m_bHessian = pBoosterCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
+   params.m_cScores = pTask->m_cScores;
+   params.m_cPack = cPack;
+   params.m_cSamples = pSubset->GetCountSamples();
+   params.m_aGradientsAndHessians = pSubset->GetGradHess();
+   const InnerBag * const pInnerBag = pSubset->GetInnerBag(iBag);
+   params.m_aWeights = aWeights;
+   params.m_bMultiplyOccurrences = pInnerBag->IsCompact() ? EBM_TRUE : EBM_FALSE;
+   params.m_pCountOccurrences = pInnerBag->GetCountOccurrences();
+   params.m_aPacked = pSubset->GetTermData(pTask->m_iTerm);
+   params.m_cBins = k_cItemsPerBitPackNone == cPack ? size_t { 1 } : pTask->m_cTensorBins;
+   params.m_aFastBins = aFastBins;
+   params.m_bLaneBins = 0 == (SIMDFlags_DisableLaneHistograms & GetSIMDFlags()) ? EBM_TRUE : EBM_FALSE;
+#ifndef NDEBUG
+   params.m_pDebugFastBinsEnd = IndexBin(aFastBins, cBytesPerFastBin * pTask->m_cTensorBins);
+#endif // NDEBUG
+   return pSubset->BinSumsBoosting(&params);
+}
+
 // we made this a global because if we had put this variable inside the BoosterCore object, then we would need to dereference that before getting 
 // the count.  By making this global we can send a log message incase a bad BoosterCore object is sent into us we only decrease the count if the 
 // count is non-zero, so at worst if there is a race condition then we'll output this log message more times than desired, but we can live with that
@@ -632,6 +749,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(
 
    pBoosterShell->GetTermUpdate()->SetCountDimensions(cDimensions);
    pBoosterShell->GetTermUpdate()->Reset();
+   pBoosterShell->GetScratchArena()->Reset();
 
    double gainAvg = 0.0;
    if(0 != pBoosterCore->GetTrainingSet()->GetCountSamples()) {
@@ -724,169 +842,184 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION GenerateTermUpdate(
       pBoosterShell->SetDebugMainBinsEnd(IndexBin(aMainBins, cBytesPerMainBin * (cTensorBins + cAuxillaryBins)));
 #endif // NDEBUG
 
+      EBM_ASSERT(1 <= pBoosterCore->GetTrainingSet()->GetCountSubsets());
+      DataSubsetBoosting * const aSubsets = pBoosterCore->GetTrainingSet()->GetSubsets();
+      const size_t cSubsets = pBoosterCore->GetTrainingSet()->GetCountSubsets();
+
+      BinSumsBoostingTask task;
+      task.m_pBoosterCore = pBoosterCore;
+      task.m_iTerm = iTerm;
+      task.m_bCollapsed = IntEbm { 0 } == lastDimensionLeavesMax;
+      task.m_cScores = cScores;
+      task.m_cTensorBins = cTensorBins;
+      task.m_aSubsets = aSubsets;
+      task.m_cSubsets = cSubsets;
+      task.m_cBytesFastBinsStride = pBoosterCore->GetCountBytesFastBins();
+      task.m_aFastBinsThreads = aFastBins;
+
+      // Inner bags are binned in groups of up to GetCountMainBinsBags() bags, with each bag in a group going into
+      // its own main bins. The trees are then grown one bag at a time in bag order since they share the random
+      // number generator, and the inner updates are summed in bag order.
       size_t iBag = 0;
       EBM_ASSERT(1 <= cInnerBagsAfterZero);
       do {
-         memset(aMainBins, 0, cBytesMainBins);
+         const size_t cBagsGroup = EbmMin(pBoosterCore->GetCountMainBinsBags(), cInnerBagsAfterZero - iBag);
+         task.m_iBagFirst = iBag;
 
-         EBM_ASSERT(1 <= pBoosterCore->GetTrainingSet()->GetCountSubsets());
-         DataSubsetBoosting * pSubset = pBoosterCore->GetTrainingSet()->GetSubsets();
-         const DataSubsetBoosting * const pSubsetsEnd = pSubset + pBoosterCore->GetTrainingSet()->GetCountSubsets();
+         BinBase * pMainBinsZero = aMainBins;
+         size_t iBagZero = 0;
          do {
-            int cPack;
-            if(UNLIKELY(IntEbm { 0 } == lastDimensionLeavesMax)) {
-               // this is kind of hacky where if any one of a number of things occurs (like we have only 1 leaf)
-               // we sum everything into a single bin. The alternative would be to always sum into the tensor bins
-               // but then collapse them afterwards into a single bin, but that's more work.
-               cPack = k_cItemsPerBitPackNone;
-            } else {
-               EBM_ASSERT(1 <= pTerm->GetBitsRequiredMin());
-               cPack = GetCountItemsBitPacked(pTerm->GetBitsRequiredMin(), pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-            }
+            memset(pMainBinsZero, 0, cBytesMainBins);
+            pMainBinsZero = IndexBin(pMainBinsZero, pBoosterCore->GetCountBytesMainBins());
+            ++iBagZero;
+         } while(cBagsGroup != iBagZero);
+
+         // Work items are binned in rounds of up to GetCountFastBinsThreads() items, with each item in a round going
+         // into its own fast bins. The fast bins are then added into the main bins of their bag in subset order,
+         // which is the same order of floating point additions as binning the subsets one at a time, so the
+         // results are identical regardless of the number of threads.
+         EBM_ASSERT(!IsMultiplyError(cSubsets, cBagsGroup)); // each subset already holds an InnerBag per bag
+         const size_t cWork = cSubsets * cBagsGroup;
+         size_t iWork = 0;
+         do {
+            const size_t cWorkRound = EbmMin(pBoosterCore->GetCountFastBinsThreads(), cWork - iWork);
+            task.m_iWorkFirst = iWork;
 
-            size_t cBytesPerFastBin;
-            if(sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes) {
-               if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-                  cBytesPerFastBin = GetBinSize<FloatBig, UIntBig>(pBoosterCore->IsHessian(), cScores);
-               } else {
-                  EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-                  cBytesPerFastBin = GetBinSize<FloatSmall, UIntBig>(pBoosterCore->IsHessian(), cScores);
-               }
+            ThreadPool * const pThreadPool = pBoosterCore->GetThreadPool();
+            if(nullptr != pThreadPool) {
+               error = pThreadPool->Run(cWorkRound, BinSumsBoostingSubset, &task);
             } else {
-               EBM_ASSERT(sizeof(UIntSmall) == pSubset->GetObjectiveWrapper()->m_cUIntBytes);
-               if(sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes) {
-                  cBytesPerFastBin = GetBinSize<FloatBig, UIntSmall>(pBoosterCore->IsHessian(), cScores);
-               } else {
-                  EBM_ASSERT(sizeof(FloatSmall) == pSubset->GetObjectiveWrapper()->m_cFloatBytes);
-                  cBytesPerFastBin = GetBinSize<FloatSmall, UIntSmall>(pBoosterCore->IsHessian(), cScores);
-               }
+               EBM_ASSERT(1 == cWorkRound);
+               error = BinSumsBoostingSubset(&task, 0);
             }
-            EBM_ASSERT(!IsMultiplyError(cBytesPerFastBin, cTensorBins));
-
-            aFastBins->ZeroMem(cBytesPerFastBin, cTensorBins);
-
-            BinSumsBoostingBridge params;
-            params.m_bHessian = pBoosterCore->IsHessian() ? EBM_TRUE : EBM_FALSE;
-            params.m_cScores = cScores;
-            params.m_cPack = cPack;
-            params.m_cSamples = pSubset->GetCountSamples();
-            params.m_aGradientsAndHessians = pSubset->GetGradHess();
-            params.m_aWeights = pSubset->GetInnerBag(iBag)->GetWeights();
-            params.m_pCountOccurrences = pSubset->GetInnerBag(iBag)->GetCountOccurrences();
-            params.m_aPacked = pSubset->GetTermData(iTerm);
-            params.m_aFastBins = aFastBins;
-   #ifndef NDEBUG
-            params.m_pDebugFastBinsEnd = IndexBin(aFastBins, cBytesPerFastBin * cTensorBins);
-   #endif // NDEBUG
-            error = pSubset->BinSumsBoosting(&params);
             if(Error_None != error) {
                return error;
             }
 
-            ConvertAddBin(
-               cScores,
-               pBoosterCore->IsHessian(),
-               cTensorBins,
-               sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes,
-               sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes,
-               aFastBins,
-               std::is_same<UIntMain, uint64_t>::value,
-               std::is_same<FloatMain, double>::value,
-               aMainBins
-            );
-            ++pSubset;
-         } while(pSubsetsEnd != pSubset);
+            const BinBase * pFastBins = aFastBins;
+            const size_t iWorkRoundEnd = iWork + cWorkRound;
+            do {
+               const DataSubsetBoosting * const pSubset = &aSubsets[iWork % cSubsets];
+               ConvertAddBin(
+                  cScores,
+                  pBoosterCore->IsHessian(),
+                  cTensorBins,
+                  nullptr != GetFastBinWeights(pSubset, task.m_iBagFirst + iWork / cSubsets),
+                  sizeof(UIntBig) == pSubset->GetObjectiveWrapper()->m_cUIntBytes,
+                  sizeof(FloatBig) == pSubset->GetObjectiveWrapper()->m_cFloatBytes,
+                  pFastBins,
+                  std::is_same<UIntMain, uint64_t>::value,
+                  std::is_same<FloatMain, double>::value,
+                  IndexBin(aMainBins, pBoosterCore->GetCountBytesMainBins() * (iWork / cSubsets))
+               );
+               pFastBins = IndexBin(pFastBins, pBoosterCore->GetCountBytesFastBins());
+               ++iWork;
+            } while(iWorkRoundEnd != iWork);
+         } while(cWork != iWork);
 
-         // TODO: we can exit here back to python to allow caller modification to our histograms
-         //       although having inner bags makes this complicated since each inner bag has it's own
-         //       histogram, so we'd need to exit and re-enter 100 times over if we had 100 inner bags
-         //       and we'd need to have the BinBoosting function be called 100 times, followed by 100 calls
-         //       to cut the tensor, then we'd need to have a single final call to combine the results
-         //       which is more complicated.  It will be nicer if we end up eliminated inner bagging
-         //       or use subsampling each boost step to avoid having multiple inner bags
+         const size_t iBagGroupEnd = iBag + cBagsGroup;
+         do {
+            if(task.m_iBagFirst != iBag) {
+               // the partitioning functions operate on the first main bins, and the auxillary bins after them are
+               // only used as scratch space, so only the tensor bins need to be moved
+               memcpy(
+                  aMainBins, 
+                  IndexBin(aMainBins, pBoosterCore->GetCountBytesMainBins() * (iBag - task.m_iBagFirst)), 
+                  cBytesMainBins
+               );
+            }
 
+            // TODO: we can exit here back to python to allow caller modification to our histograms
+            //       although having inner bags makes this complicated since each inner bag has it's own
+            //       histogram, so we'd need to exit and re-enter 100 times over if we had 100 inner bags
+            //       and we'd need to have the BinBoosting function be called 100 times, followed by 100 calls
+            //       to cut the tensor, then we'd need to have a single final call to combine the results
+            //       which is more complicated.  It will be nicer if we end up eliminated inner bagging
+            //       or use subsampling each boost step to avoid having multiple inner bags
 
-         if(UNLIKELY(IntEbm { 0 } == lastDimensionLeavesMax)) {
-            LOG_0(Trace_Warning, "WARNING GenerateTermUpdate boosting zero dimensional");
-            BoostZeroDimensional(pBoosterShell, flags);
-         } else {
-            const double weightTotal = pBoosterCore->GetTrainingSet()->GetBagWeightTotal(iBag);
-            EBM_ASSERT(0 < weightTotal); // if all are zeros we assume there are no weights and use the count
-
-            double gain;
-            if(0 != (TermBoostFlags_RandomSplits & flags) || 2 < cRealDimensions) {
-               if(size_t { 1 } != cSamplesLeafMin) {
-                  LOG_0(Trace_Warning,
-                     "WARNING GenerateTermUpdate cSamplesLeafMin is ignored when doing random splitting"
-                  );
-               }
-               // THIS RANDOM SPLIT OPTION IS PRIMARILY USED FOR DIFFERENTIAL PRIVACY EBMs
-
-               error = BoostRandom(
-                  pRng,
-                  pBoosterShell,
-                  iTerm,
-                  flags,
-                  leavesMax,
-                  &gain
-               );
-               if(Error_None != error) {
-                  return error;
-               }
-            } else if(1 == cRealDimensions) {
-               EBM_ASSERT(nullptr != leavesMax); // otherwise we'd use BoostZeroDimensional above
-               EBM_ASSERT(IntEbm { 2 } <= lastDimensionLeavesMax); // otherwise we'd use BoostZeroDimensional above
-               EBM_ASSERT(size_t { 2 } <= cSignificantBinCount); // otherwise we'd use BoostZeroDimensional above
-
-               EBM_ASSERT(1 == pTerm->GetCountRealDimensions());
-               EBM_ASSERT(cSignificantBinCount == pTerm->GetCountTensorBins());
-               EBM_ASSERT(0 == pTerm->GetCountAuxillaryBins());
-
-               error = BoostSingleDimensional(
-                  pRng,
-                  pBoosterShell,
-                  cSignificantBinCount,
-                  static_cast<FloatMain>(weightTotal),
-                  iDimensionImportant,
-                  cSamplesLeafMin,
-                  lastDimensionLeavesMax,
-                  &gain
-               );
-               if(Error_None != error) {
-                  return error;
-               }
+
+            if(UNLIKELY(IntEbm { 0 } == lastDimensionLeavesMax)) {
+               LOG_0(Trace_Warning, "WARNING GenerateTermUpdate boosting zero dimensional");
+               BoostZeroDimensional(pBoosterShell, flags);
             } else {
-               error = BoostMultiDimensional(
-                  pBoosterShell,
-                  iTerm,
-                  cSamplesLeafMin,
-                  &gain
-               );
-               if(Error_None != error) {
-                  return error;
+               const double weightTotal = pBoosterCore->GetTrainingSet()->GetBagWeightTotal(iBag);
+               EBM_ASSERT(0 < weightTotal); // if all are zeros we assume there are no weights and use the count
+
+               double gain;
+               if(0 != (TermBoostFlags_RandomSplits & flags) || 2 < cRealDimensions) {
+                  if(size_t { 1 } != cSamplesLeafMin) {
+                     LOG_0(Trace_Warning,
+                        "WARNING GenerateTermUpdate cSamplesLeafMin is ignored when doing random splitting"
+                     );
+                  }
+                  // THIS RANDOM SPLIT OPTION IS PRIMARILY USED FOR DIFFERENTIAL PRIVACY EBMs
+
+                  error = BoostRandom(
+                     pRng,
+                     pBoosterShell,
+                     iTerm,
+                     flags,
+                     leavesMax,
+                     &gain
+                  );
+                  if(Error_None != error) {
+                     return error;
+                  }
+               } else if(1 == cRealDimensions) {
+                  EBM_ASSERT(nullptr != leavesMax); // otherwise we'd use BoostZeroDimensional above
+                  EBM_ASSERT(IntEbm { 2 } <= lastDimensionLeavesMax); // otherwise we'd use BoostZeroDimensional above
+                  EBM_ASSERT(size_t { 2 } <= cSignificantBinCount); // otherwise we'd use BoostZeroDimensional above
+
+                  EBM_ASSERT(1 == pTerm->GetCountRealDimensions());
+                  EBM_ASSERT(cSignificantBinCount == pTerm->GetCountTensorBins());
+                  EBM_ASSERT(0 == pTerm->GetCountAuxillaryBins());
+
+                  error = BoostSingleDimensional(
+                     pRng,
+                     pBoosterShell,
+                     cSignificantBinCount,
+                     static_cast<FloatMain>(weightTotal),
+                     iDimensionImportant,
+                     cSamplesLeafMin,
+                     lastDimensionLeavesMax,
+                     &gain
+                  );
+                  if(Error_None != error) {
+                     return error;
+                  }
+               } else {
+                  error = BoostMultiDimensional(
+                     pBoosterShell,
+                     iTerm,
+                     cSamplesLeafMin,
+                     &gain
+                  );
+                  if(Error_None != error) {
+                     return error;
+                  }
                }
-            }
 
-            // gain should be +inf if there was an overflow in our callees
-            EBM_ASSERT(!std::isnan(gain));
-            EBM_ASSERT(0 <= gain);
+               // gain should be +inf if there was an overflow in our callees
+               EBM_ASSERT(!std::isnan(gain));
+               EBM_ASSERT(0 <= gain);
 
-            // this could re-promote gain to be +inf again if weightTotal < 1.0
-            // do the sample count inversion here in case adding all the avgeraged gains pushes us into +inf
-            gain = gain / weightTotal * gainMultiple;
-            gainAvg += gain;
-            EBM_ASSERT(!std::isnan(gainAvg));
-            EBM_ASSERT(0.0 <= gainAvg);
-         }
+               // this could re-promote gain to be +inf again if weightTotal < 1.0
+               // do the sample count inversion here in case adding all the avgeraged gains pushes us into +inf
+               gain = gain / weightTotal * gainMultiple;
+               gainAvg += gain;
+               EBM_ASSERT(!std::isnan(gainAvg));
+               EBM_ASSERT(0.0 <= gainAvg);
+            }
 
-         // TODO : when we thread this code, let's have each thread take a lock and update the combined line segment.  They'll each do it while the 
-         // others are working, so there should be no blocking and our final result won't require adding by the main thread
-         error = pBoosterShell->GetTermUpdate()->Add(*pBoosterShell->GetInnerTermUpdate());
-         if(Error_None != error) {
-            return error;
-         }
+            // the inner updates are always summed in bag order, so the update does not depend on how many bags
+            // were binned concurrently
+            error = pBoosterShell->GetTermUpdate()->Add(*pBoosterShell->GetInnerTermUpdate());
+            if(Error_None != error) {
+               return error;
+            }
 
-         ++iBag;
+            ++iBag;
+         } while(iBagGroupEnd != iBag);
       } while(cInnerBagsAfterZero != iBag);
 
       // gainAvg is +inf on overflow. It cannot be NaN, but check for that anyways since it's free
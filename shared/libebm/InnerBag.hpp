@@ -34,6 +34,11 @@ struct InnerBag final {
    const uint8_t * GetCountOccurrences() const {
       return m_aCountOccurrences;
    }
+   // compact inner bags hold only the occurrence counts. The sample weights are shared by all the bags of a subset
+   // and are multiplied by the occurrence counts while binning.
+   bool IsCompact() const {
+      return nullptr == m_aWeights && nullptr != m_aCountOccurrences;
+   }
 
 private:
 
@@ -16,6 +16,7 @@
 #include "ebm_internal.hpp"
 #include "Feature.hpp" // Feature
 #include "dataset_shared.hpp" // GetDataSetSharedHeader
+#include "ThreadPool.hpp"
 #include "InteractionCore.hpp"
 
 namespace DEFINED_ZONE_NAME {
@@ -34,9 +35,21 @@ extern ErrorEbm GetObjective(
    const Config * const pConfig,
    const char * sObjective,
    ObjectiveWrapper * const pCpuObjectiveWrapperOut,
-   ObjectiveWrapper * const pSIMDObjectiveWrapperOut
+   ObjectiveWrapper * const pSIMDObjectiveWrapperOut,
+   const bool bDoublePrecisionSIMD
 ) noexcept;
 
+InteractionCore::~InteractionCore() {
+   // this only gets called after our reference count has been decremented to zero
+
+   m_dataFrame.DestructDataSetInteraction(m_cFeatures);
+   free(m_aFeatures);
+   FreeObjectiveWrapperInternals(&m_objectiveCpu);
+   FreeObjectiveWrapperInternals(&m_objectiveSIMD);
+
+   ThreadPool::Free(m_pThreadPool);
+}
+
 void InteractionCore::Free(InteractionCore * const pInteractionCore) {
    LOG_0(Trace_Info, "Entered InteractionCore::Free");
 
@@ -154,6 +167,7 @@ ErrorEbm InteractionCore::Create(
    const CreateInteractionFlags flags,
    const char * const sObjective,
    const double * const experimentalParams,
+   ThreadPool * const pThreadPool,
    InteractionCore ** const ppInteractionCoreOut
 ) {
    // experimentalParams isn't used by default.  It's meant to provide an easy way for python or other higher
@@ -186,6 +200,13 @@ ErrorEbm InteractionCore::Create(
    // give ownership of our object back to the caller, even if there is a failure
    *ppInteractionCoreOut = pInteractionCore;
 
+   if(nullptr != pThreadPool) {
+      // the caller's thread pool stays alive until we release our reference to it in our destructor
+      pThreadPool->AddReferenceCount();
+      pInteractionCore->m_pThreadPool = pThreadPool;
+      pInteractionCore->m_cThreads = pThreadPool->GetCountThreads();
+   }
+
    size_t cBinsMax = 0;
 
    LOG_0(Trace_Info, "InteractionCore::Create starting feature processing");
@@ -223,7 +244,6 @@ ErrorEbm InteractionCore::Create(
             &defaultValSparse,
             &cNonDefaultsSparse
          );
-         EBM_ASSERT(!bSparse); // not handled yet
 
          if(IsConvertError<size_t>(countBins)) {
             LOG_0(Trace_Error, "ERROR InteractionCore::Create IsConvertError<size_t>(countBins)");
@@ -273,7 +293,8 @@ ErrorEbm InteractionCore::Create(
          &config, 
          sObjective, 
          &pInteractionCore->m_objectiveCpu, 
-         0 != (CreateInteractionFlags_DisableSIMD & flags) ? nullptr : &pInteractionCore->m_objectiveSIMD
+         0 != (CreateInteractionFlags_DisableSIMD & flags) ? nullptr : &pInteractionCore->m_objectiveSIMD,
+         0 != (CreateInteractionFlags_DoublePrecisionSIMD & flags)
       );
       if(Error_None != error) {
          // already logged
@@ -320,20 +341,14 @@ ErrorEbm InteractionCore::Create(
             return error;
          }
 
-         // if we have 32 bit floats or ints, then we need to break large datasets into smaller data subsets
-         // because float32 values stop incrementing at 2^24 where the value 1 is below the threshold incrementing a float
-         const bool bForceMultipleSubsets =
-            sizeof(UIntSmall) == pInteractionCore->m_objectiveCpu.m_cUIntBytes ||
-            sizeof(FloatSmall) == pInteractionCore->m_objectiveCpu.m_cFloatBytes ||
-            sizeof(UIntSmall) == pInteractionCore->m_objectiveSIMD.m_cUIntBytes ||
-            sizeof(FloatSmall) == pInteractionCore->m_objectiveSIMD.m_cFloatBytes;
-
          const bool bHessian = pInteractionCore->IsHessian();
 
          error = pInteractionCore->m_dataFrame.InitDataSetInteraction(
             bHessian,
             cScores,
-            bForceMultipleSubsets ? k_cSubsetSamplesMax : SIZE_MAX,
+            // split float64 data the same way with or without a thread pool so that the strengths never depend on
+            // threading. See BoosterCore::Create
+            k_cSubsetSamplesMax,
             &pInteractionCore->m_objectiveCpu,
             &pInteractionCore->m_objectiveSIMD,
             pDataSetShared,
@@ -545,6 +560,7 @@ ErrorEbm InteractionCore::InitializeInteractionGradientsAndHessians(
             data.m_cPack = k_cItemsPerBitPackNone;
             data.m_bHessianNeeded = IsHessian() ? EBM_TRUE : EBM_FALSE;
             data.m_bValidation = EBM_FALSE;
+            data.m_bUniformTarget = EBM_FALSE;
             data.m_cSamples = pSubset->GetCountSamples();
             data.m_aPacked = nullptr;
             data.m_aWeights = nullptr;
@@ -630,6 +646,7 @@ ErrorEbm InteractionCore::InitializeInteractionGradientsAndHessians(
             data.m_cPack = k_cItemsPerBitPackNone;
             data.m_bHessianNeeded = IsHessian() ? EBM_TRUE : EBM_FALSE;
             data.m_bValidation = EBM_FALSE;
+            data.m_bUniformTarget = EBM_FALSE;
             data.m_cSamples = pSubset->GetCountSamples();
             data.m_aPacked = nullptr;
             data.m_aWeights = nullptr;
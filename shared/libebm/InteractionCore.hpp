@@ -21,6 +21,7 @@ namespace DEFINED_ZONE_NAME {
 #endif // DEFINED_ZONE_NAME
 
 class FeatureInteraction;
+class ThreadPool;
 
 class InteractionCore final {
 
@@ -41,20 +42,18 @@ class InteractionCore final {
    ObjectiveWrapper m_objectiveCpu;
    ObjectiveWrapper m_objectiveSIMD;
 
-   inline ~InteractionCore() {
-      // this only gets called after our reference count has been decremented to zero
+   ThreadPool * m_pThreadPool;
+   size_t m_cThreads;
 
-      m_dataFrame.DestructDataSetInteraction(m_cFeatures);
-      free(m_aFeatures);
-      FreeObjectiveWrapperInternals(&m_objectiveCpu);
-      FreeObjectiveWrapperInternals(&m_objectiveSIMD);
-   };
+   ~InteractionCore();
 
    inline InteractionCore() noexcept :
       m_REFERENCE_COUNT(1), // we're not visible on any other thread yet, so no synchronization required
       m_cClasses(0),
       m_cFeatures(0),
-      m_aFeatures(nullptr)
+      m_aFeatures(nullptr),
+      m_pThreadPool(nullptr),
+      m_cThreads(1)
    {
       m_dataFrame.SafeInitDataSetInteraction();
       InitializeObjectiveWrapperUnfailing(&m_objectiveCpu);
@@ -89,6 +88,18 @@ public:
       return m_cFeatures;
    }
 
+   inline ThreadPool * GetThreadPool() const {
+      return m_pThreadPool;
+   }
+
+   inline size_t GetCountThreads() const {
+      return m_cThreads;
+   }
+
+   inline bool IsSIMD() const {
+      return 0 != m_objectiveSIMD.m_cUIntBytes;
+   }
+
    static void Free(InteractionCore * const pInteractionCore);
    static ErrorEbm Create(
       const unsigned char * const pDataSetShared,
@@ -99,6 +110,7 @@ public:
       const CreateInteractionFlags flags,
       const char * const sObjective,
       const double * const experimentalParams,
+      ThreadPool * const pThreadPool,
       InteractionCore ** const ppInteractionCoreOut
    );
 
@@ -11,6 +11,7 @@
 #include "bridge_cpp.hpp"
 
 #include "dataset_shared.hpp" // GetDataSetSharedHeader
+#include "ThreadPool.hpp"
 #include "InteractionCore.hpp"
 #include "InteractionShell.hpp"
 
@@ -31,8 +32,15 @@ void InteractionShell::Free(InteractionShell * const pInteractionShell) {
    LOG_0(Trace_Info, "Entered InteractionShell::Free");
 
    if(nullptr != pInteractionShell) {
-      AlignedFree(pInteractionShell->m_aInteractionFastBinsTemp);
-      AlignedFree(pInteractionShell->m_aInteractionMainBins);
+      InteractionWorkerBins * const aWorkerBins = pInteractionShell->m_aWorkerBins;
+      if(nullptr != aWorkerBins) {
+         for(size_t iWorker = 0; iWorker < pInteractionShell->m_cWorkerBins; ++iWorker) {
+            AlignedFree(aWorkerBins[iWorker].m_aInteractionFastBinsTemp);
+            AlignedFree(aWorkerBins[iWorker].m_aInteractionMainBins);
+         }
+         free(aWorkerBins);
+      }
+      pInteractionShell->m_scratchArena.Destruct();
       InteractionCore::Free(pInteractionShell->m_pInteractionCore);
       
       // before we free our memory, indicate it was freed so if our higher level language attempts to use it we have
@@ -55,18 +63,44 @@ InteractionShell * InteractionShell::Create(InteractionCore * const pInteraction
 
    pNew->InitializeUnfailing(pInteractionCore);
 
+   // one set of bins for each thread that can calculate interaction strengths simultaneously
+   const size_t cWorkerBins = pInteractionCore->GetCountThreads();
+   EBM_ASSERT(1 <= cWorkerBins);
+   if(IsMultiplyError(sizeof(InteractionWorkerBins), cWorkerBins)) {
+      LOG_0(Trace_Error, "ERROR InteractionShell::Create IsMultiplyError(sizeof(InteractionWorkerBins), cWorkerBins)");
+      free(pNew);
+      return nullptr;
+   }
+   InteractionWorkerBins * const aWorkerBins = 
+      static_cast<InteractionWorkerBins *>(malloc(sizeof(InteractionWorkerBins) * cWorkerBins));
+   if(UNLIKELY(nullptr == aWorkerBins)) {
+      LOG_0(Trace_Error, "ERROR InteractionShell::Create nullptr == aWorkerBins");
+      free(pNew);
+      return nullptr;
+   }
+   for(size_t iWorker = 0; iWorker < cWorkerBins; ++iWorker) {
+      aWorkerBins[iWorker].m_aInteractionFastBinsTemp = nullptr;
+      aWorkerBins[iWorker].m_cBytesFastBins = 0;
+      aWorkerBins[iWorker].m_aInteractionMainBins = nullptr;
+      aWorkerBins[iWorker].m_cAllocatedMainBins = 0;
+   }
+   pNew->m_cWorkerBins = cWorkerBins;
+   pNew->m_aWorkerBins = aWorkerBins;
+
    LOG_0(Trace_Info, "Exited InteractionShell::Create");
 
    return pNew;
 }
 
-BinBase * InteractionShell::GetInteractionFastBinsTemp(const size_t cBytes) {
+BinBase * InteractionShell::GetInteractionFastBinsTemp(const size_t iWorker, const size_t cBytes) {
    ANALYSIS_ASSERT(0 != cBytes);
+   EBM_ASSERT(iWorker < m_cWorkerBins);
 
-   BinBase * aBuffer = m_aInteractionFastBinsTemp;
-   if(UNLIKELY(m_cBytesFastBins < cBytes)) {
+   InteractionWorkerBins * const pWorkerBins = &m_aWorkerBins[iWorker];
+   BinBase * aBuffer = pWorkerBins->m_aInteractionFastBinsTemp;
+   if(UNLIKELY(pWorkerBins->m_cBytesFastBins < cBytes)) {
       AlignedFree(aBuffer);
-      m_aInteractionFastBinsTemp = nullptr;
+      pWorkerBins->m_aInteractionFastBinsTemp = nullptr;
 
       if(IsAddError(cBytes, cBytes)) {
          LOG_0(Trace_Warning, "WARNING InteractionShell::GetInteractionFastBinsTemp IsAddError(cBytes, cBytes)");
@@ -74,7 +108,7 @@ BinBase * InteractionShell::GetInteractionFastBinsTemp(const size_t cBytes) {
       }
       const size_t cNewAllocatedFastBins = cBytes + cBytes;
 
-      m_cBytesFastBins = cNewAllocatedFastBins;
+      pWorkerBins->m_cBytesFastBins = cNewAllocatedFastBins;
       LOG_N(Trace_Info, "Growing Interaction fast bins to %zu", cNewAllocatedFastBins);
 
       aBuffer = static_cast<BinBase *>(AlignedAlloc(cNewAllocatedFastBins));
@@ -82,18 +116,24 @@ BinBase * InteractionShell::GetInteractionFastBinsTemp(const size_t cBytes) {
          LOG_0(Trace_Warning, "WARNING InteractionShell::GetInteractionFastBinsTemp OutOfMemory");
          return nullptr;
       }
-      m_aInteractionFastBinsTemp = aBuffer;
+      pWorkerBins->m_aInteractionFastBinsTemp = aBuffer;
    }
    return aBuffer;
 }
 
-BinBase * InteractionShell::GetInteractionMainBins(const size_t cBytesPerMainBin, const size_t cMainBins) {
+BinBase * InteractionShell::GetInteractionMainBins(
+   const size_t iWorker, 
+   const size_t cBytesPerMainBin, 
+   const size_t cMainBins
+) {
    ANALYSIS_ASSERT(0 != cBytesPerMainBin);
+   EBM_ASSERT(iWorker < m_cWorkerBins);
 
-   BinBase * aBuffer = m_aInteractionMainBins;
-   if(UNLIKELY(m_cAllocatedMainBins < cMainBins)) {
+   InteractionWorkerBins * const pWorkerBins = &m_aWorkerBins[iWorker];
+   BinBase * aBuffer = pWorkerBins->m_aInteractionMainBins;
+   if(UNLIKELY(pWorkerBins->m_cAllocatedMainBins < cMainBins)) {
       AlignedFree(aBuffer);
-      m_aInteractionMainBins = nullptr;
+      pWorkerBins->m_aInteractionMainBins = nullptr;
 
       const size_t cItemsGrowth = (cMainBins >> 2) + 16; // cannot overflow
       if(IsAddError(cItemsGrowth, cMainBins)) {
@@ -102,7 +142,7 @@ BinBase * InteractionShell::GetInteractionMainBins(const size_t cBytesPerMainBin
       }
       const size_t cNewAllocatedMainBins = cMainBins + cItemsGrowth;
 
-      m_cAllocatedMainBins = cNewAllocatedMainBins;
+      pWorkerBins->m_cAllocatedMainBins = cNewAllocatedMainBins;
       LOG_N(Trace_Info, "Growing Interaction big bins to %zu", cNewAllocatedMainBins);
 
       if(IsMultiplyError(cBytesPerMainBin, cNewAllocatedMainBins)) {
@@ -114,7 +154,7 @@ BinBase * InteractionShell::GetInteractionMainBins(const size_t cBytesPerMainBin
          LOG_0(Trace_Warning, "WARNING InteractionShell::GetInteractionMainBins OutOfMemory");
          return nullptr;
       }
-      m_aInteractionMainBins = aBuffer;
+      pWorkerBins->m_aInteractionMainBins = aBuffer;
    }
    return aBuffer;
 }
@@ -126,6 +166,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
    CreateInteractionFlags flags,
    const char * objective,
    const double * experimentalParams,
+   ThreadPoolHandle threadPool,
    InteractionHandle * interactionHandleOut
 ) {
    LOG_N(Trace_Info, "Entered CreateInteractionDetector: "
@@ -135,6 +176,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
       "flags=0x%" UCreateInteractionFlagsPrintf ", "
       "objective=%p, "
       "experimentalParams=%p, "
+      "threadPool=%p, "
       "interactionHandleOut=%p"
       ,
       static_cast<const void *>(dataSet),
@@ -143,6 +185,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
       static_cast<UCreateInteractionFlags>(flags), // signed to unsigned conversion is defined behavior in C++
       static_cast<const void *>(objective), // do not print the string for security reasons
       static_cast<const void *>(experimentalParams),
+      static_cast<void *>(threadPool),
       static_cast<const void *>(interactionHandleOut)
    );
 
@@ -155,7 +198,9 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
    *interactionHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
 
    if(0 != (static_cast<UCreateInteractionFlags>(flags) & static_cast<UCreateInteractionFlags>(~(
-      static_cast<UCreateInteractionFlags>(CreateInteractionFlags_DifferentialPrivacy)
+      static_cast<UCreateInteractionFlags>(CreateInteractionFlags_DifferentialPrivacy) |
+      static_cast<UCreateInteractionFlags>(CreateInteractionFlags_DisableSIMD) |
+      static_cast<UCreateInteractionFlags>(CreateInteractionFlags_DoublePrecisionSIMD)
    )))) {
       LOG_0(Trace_Error, "ERROR CreateInteractionDetector flags contains unknown flags. Ignoring extras.");
    }
@@ -190,6 +235,15 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
       return Error_IllegalParamVal;
    }
 
+   ThreadPool * pThreadPool = nullptr;
+   if(nullptr != threadPool) {
+      pThreadPool = ThreadPool::GetThreadPoolFromHandle(threadPool);
+      if(nullptr == pThreadPool) {
+         // already logged
+         return Error_IllegalParamVal;
+      }
+   }
+
    InteractionCore * pInteractionCore = nullptr;
    error = InteractionCore::Create(
       static_cast<const unsigned char *>(dataSet),
@@ -200,6 +254,7 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
       flags,
       objective,
       experimentalParams,
+      pThreadPool,
       &pInteractionCore
    );
    if(Error_None != error) {
@@ -11,6 +11,8 @@
 #include "logging.h" // LOG_0
 #include "zones.h"
 
+#include "ScratchArena.hpp"
+
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
 #error DEFINED_ZONE_NAME must be defined
@@ -19,6 +21,20 @@ namespace DEFINED_ZONE_NAME {
 struct BinBase;
 class InteractionCore;
 
+// Each thread that calculates interaction strengths concurrently owns one of these so that the bins of the terms
+// being evaluated on different threads never overlap
+struct InteractionWorkerBins {
+   BinBase * m_aInteractionFastBinsTemp;
+   size_t m_cBytesFastBins;
+
+   BinBase * m_aInteractionMainBins;
+   size_t m_cAllocatedMainBins;
+};
+static_assert(std::is_standard_layout<InteractionWorkerBins>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<InteractionWorkerBins>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
 class InteractionShell final {
    static constexpr size_t k_handleVerificationOk = 21773; // random 15 bit number
    static constexpr size_t k_handleVerificationFreed = 27913; // random 15 bit number
@@ -26,11 +42,11 @@ class InteractionShell final {
 
    InteractionCore * m_pInteractionCore;
 
-   BinBase * m_aInteractionFastBinsTemp;
-   size_t m_cBytesFastBins;
+   size_t m_cWorkerBins;
+   InteractionWorkerBins * m_aWorkerBins;
 
-   BinBase * m_aInteractionMainBins;
-   size_t m_cAllocatedMainBins;
+   // per call scratch memory that is used on the calling thread, outside of the parallel section
+   ScratchArena m_scratchArena;
 
    int m_cLogEnterMessages;
    int m_cLogExitMessages;
@@ -46,11 +62,10 @@ public:
       m_handleVerification = k_handleVerificationOk;
       m_pInteractionCore = pInteractionCore;
 
-      m_aInteractionFastBinsTemp = nullptr;
-      m_cBytesFastBins = 0;
+      m_cWorkerBins = 0;
+      m_aWorkerBins = nullptr;
 
-      m_aInteractionMainBins = nullptr;
-      m_cAllocatedMainBins = 0;
+      m_scratchArena.InitializeUnfailing();
 
       m_cLogEnterMessages = 1000;
       m_cLogExitMessages = 1000;
@@ -94,9 +109,17 @@ public:
       return &m_cLogExitMessages;
    }
 
-   BinBase * GetInteractionFastBinsTemp(const size_t cBytes);
+   inline size_t GetCountWorkerBins() const {
+      return m_cWorkerBins;
+   }
+
+   inline ScratchArena * GetScratchArena() {
+      return &m_scratchArena;
+   }
+
+   BinBase * GetInteractionFastBinsTemp(const size_t iWorker, const size_t cBytes);
 
-   BinBase * GetInteractionMainBins(const size_t cBytesPerMainBin, const size_t cMainBins);
+   BinBase * GetInteractionMainBins(const size_t iWorker, const size_t cBytesPerMainBin, const size_t cMainBins);
 };
 static_assert(std::is_standard_layout<InteractionShell>::value,
    "We use the struct hack in several places, so disallow non-standard_layout types in general");
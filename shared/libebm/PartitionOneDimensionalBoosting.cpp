@@ -7,8 +7,7 @@
 #include <type_traits> // std::is_standard_layout
 #include <stddef.h> // size_t, ptrdiff_t
 #include <string.h> // memcpy
-#include <vector>
-#include <queue>
+#include <algorithm> // std::push_heap, std::pop_heap
 
 #include "libebm.h" // ErrorEbm
 #include "logging.h" // EBM_ASSERT
@@ -24,6 +23,7 @@
 #include "TreeNode.hpp"
 #include "SplitPosition.hpp"
 #include "BoosterCore.hpp"
+#include "ScratchArena.hpp"
 #include "BoosterShell.hpp"
 
 namespace DEFINED_ZONE_NAME {
@@ -601,15 +601,19 @@ public:
          EBM_ASSERT(!std::isinf(pRootTreeNode->AFTER_GetSplitGain()));
          EBM_ASSERT(0 <= pRootTreeNode->AFTER_GetSplitGain());
 
-         try {
-            // TODO: someday see if we can replace this with an in-class priority queue that stores it's info inside
-            //       the TreeNode datastructure
-            std::priority_queue<
-               TreeNode<bHessian> *,
-               std::vector<TreeNode<bHessian> *>,
-               CompareNodeGain<bHessian>
-            > nodeGainRanking;
-
+         // the nodes that can still be split are kept in a max heap ordered by gain. Every node in the heap is a 
+         // leaf of the tree, so it never holds more than cBins nodes. FillAllocations sized the scratch arena for 
+         // the largest single dimensional term, so this does not touch the heap memory allocator.
+         ScratchArena * const pScratchArena = pBoosterShell->GetScratchArena();
+         const size_t markScratch = pScratchArena->GetMark();
+         TreeNode<bHessian> ** const apNodeGainRanking = 
+            static_cast<TreeNode<bHessian> **>(pScratchArena->Allocate(sizeof(TreeNode<bHessian> *) * cBins));
+         if(UNLIKELY(nullptr == apNodeGainRanking)) {
+            LOG_0(Trace_Warning, "WARNING PartitionOneDimensionalBoosting nullptr == apNodeGainRanking");
+            return Error_OutOfMemory;
+         }
+         size_t cNodeGainRanking = 0;
+         {
             auto * pTreeNode = pRootTreeNode;
 
             // The root node used a left and right leaf, so reserve it here
@@ -618,8 +622,7 @@ public:
             goto skip_first_push_pop;
 
             do {
-               // there is no way to get the top and pop at the same time.. would be good to get a better queue, but our code isn't bottlenecked by it
-               pTreeNode = nodeGainRanking.top()->template Upgrade<GetArrayScores(cCompilerScores)>();
+               pTreeNode = apNodeGainRanking[0]->template Upgrade<GetArrayScores(cCompilerScores)>();
                // In theory we can have nodes with equal gain values here, but this is very very rare to occur in practice
                // We handle equal gain values in FindBestSplitGain because we 
                // can have zero instances in bins, in which case it occurs, but those equivalent situations have been cleansed by
@@ -629,7 +632,8 @@ public:
                // Even if all of these things are true, after one non-symetric split, we won't see that scenario anymore since the gradients won't be
                // symetric anymore.  This is so rare, and limited to one split, so we shouldn't bother to handle it since the complexity of doing so
                // outweights the benefits.
-               nodeGainRanking.pop();
+               std::pop_heap(apNodeGainRanking, apNodeGainRanking + cNodeGainRanking, CompareNodeGain<bHessian>());
+               --cNodeGainRanking;
 
             skip_first_push_pop:
 
@@ -662,7 +666,10 @@ public:
                   EBM_ASSERT(!std::isnan(pLeftChild->AFTER_GetSplitGain()));
                   EBM_ASSERT(!std::isinf(pLeftChild->AFTER_GetSplitGain()));
                   EBM_ASSERT(0 <= pLeftChild->AFTER_GetSplitGain());
-                  nodeGainRanking.push(pLeftChild->Downgrade());
+                  EBM_ASSERT(cNodeGainRanking < cBins);
+                  apNodeGainRanking[cNodeGainRanking] = pLeftChild->Downgrade();
+                  ++cNodeGainRanking;
+                  std::push_heap(apNodeGainRanking, apNodeGainRanking + cNodeGainRanking, CompareNodeGain<bHessian>());
                }
 
                auto * const pRightChild = GetRightNode(pTreeNode->AFTER_GetChildren(), cBytesPerTreeNode);
@@ -683,25 +690,21 @@ public:
                   EBM_ASSERT(!std::isnan(pRightChild->AFTER_GetSplitGain()));
                   EBM_ASSERT(!std::isinf(pRightChild->AFTER_GetSplitGain()));
                   EBM_ASSERT(0 <= pRightChild->AFTER_GetSplitGain());
-                  nodeGainRanking.push(pRightChild->Downgrade());
+                  EBM_ASSERT(cNodeGainRanking < cBins);
+                  apNodeGainRanking[cNodeGainRanking] = pRightChild->Downgrade();
+                  ++cNodeGainRanking;
+                  std::push_heap(apNodeGainRanking, apNodeGainRanking + cNodeGainRanking, CompareNodeGain<bHessian>());
                }
 
                --cSplitsRemaining;
-            } while(0 != cSplitsRemaining && UNLIKELY(!nodeGainRanking.empty()));
+            } while(0 != cSplitsRemaining && UNLIKELY(0 != cNodeGainRanking));
 
             EBM_ASSERT(!std::isnan(totalGain));
             EBM_ASSERT(0 <= totalGain);
 
             EBM_ASSERT(CountBytes(pTreeNodeScratchSpace, pRootTreeNode) <= pBoosterCore->GetCountBytesTreeNodes());
-         } catch(const std::bad_alloc &) {
-            // calling anything inside nodeGainRanking can throw exceptions
-            LOG_0(Trace_Warning, "WARNING PartitionOneDimensionalBoosting out of memory exception");
-            return Error_OutOfMemory;
-         } catch(...) {
-            // calling anything inside nodeGainRanking can throw exceptions
-            LOG_0(Trace_Warning, "WARNING PartitionOneDimensionalBoosting exception");
-            return Error_UnexpectedInternal;
          }
+         pScratchArena->Rewind(markScratch);
       }
       *pTotalGain = static_cast<double>(totalGain);
       const size_t cSplits = cSplitsMax - cSplitsRemaining;
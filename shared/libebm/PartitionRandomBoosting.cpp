@@ -21,6 +21,7 @@
 #include "Term.hpp"
 #include "Tensor.hpp"
 #include "BoosterCore.hpp"
+#include "ScratchArena.hpp"
 #include "BoosterShell.hpp"
 
 namespace DEFINED_ZONE_NAME {
@@ -157,8 +158,11 @@ public:
 
       const size_t cBytesBuffer = EbmMax(cBytesSlicesAndCollapsedTensor, cBytesSlicesPlusRandom);
 
-      // TODO: use GrowThreadByteBuffer2 for this, but first we need to change that to allocate void or bytes
-      char * const pBuffer = static_cast<char *>(malloc(cBytesBuffer));
+      // the scratch arena keeps the largest buffer from previous terms, so this only allocates on the heap the
+      // first time a term needs more memory than any term before it
+      ScratchArena * const pScratchArena = pBoosterShell->GetScratchArena();
+      const size_t markScratch = pScratchArena->GetMark();
+      char * const pBuffer = static_cast<char *>(pScratchArena->Allocate(cBytesBuffer));
       if(UNLIKELY(nullptr == pBuffer)) {
          LOG_0(Trace_Warning, "WARNING PartitionRandomBoostingInternal nullptr == pBuffer");
          return Error_OutOfMemory;
@@ -453,7 +457,7 @@ public:
       error = pInnerTermUpdate->SetCountSlices(iDimensionWrite, cFirstSlices);
       if(UNLIKELY(Error_None != error)) {
          // already logged
-         free(pBuffer);
+         pScratchArena->Rewind(markScratch);
          return error;
       }
       const size_t * pcBytesInSlice2 = acItemsInNextSliceOrBytesInCurrentSlice;
@@ -491,7 +495,7 @@ public:
             error = pInnerTermUpdate->SetCountSlices(iDimensionWrite, pcItemsInNextSliceEnd - pcBytesInSlice2);
             if(Error_None != error) {
                // already logged
-               free(pBuffer);
+               pScratchArena->Rewind(markScratch);
                return error;
             }
             const size_t * pcItemsInNextSliceLast = pcItemsInNextSliceEnd - size_t { 1 };
@@ -568,7 +572,7 @@ public:
          } while(pCollapsedBinEnd != pCollapsedBin2);
       }
 
-      free(pBuffer);
+      pScratchArena->Rewind(markScratch);
       *pTotalGain = static_cast<double>(gain);
       return Error_None;
    }
@@ -0,0 +1,110 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef SCRATCH_ARENA_HPP
+#define SCRATCH_ARENA_HPP
+
+#include <type_traits> // std::is_standard_layout
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "libebm.h" // ErrorEbm
+#include "logging.h" // EBM_ASSERT
+#include "common_c.h" // AlignedAlloc
+#include "zones.h"
+
+#include "ebm_internal.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// Bump allocator for the scratch memory that a single call into the library needs. Allocations are released in bulk
+// by rewinding to a mark taken earlier. The buffer is only replaced while nothing is allocated from it, and it never
+// shrinks, so once it has grown to fit the largest call, later calls are served without touching the heap.
+struct ScratchArena {
+   unsigned char * m_aBuffer;
+   size_t m_cBytesCapacity;
+   size_t m_cBytesUsed;
+
+   inline void InitializeUnfailing() {
+      m_aBuffer = nullptr;
+      m_cBytesCapacity = 0;
+      m_cBytesUsed = 0;
+   }
+
+   inline void Destruct() {
+      AlignedFree(m_aBuffer);
+   }
+
+   inline size_t GetMark() const {
+      return m_cBytesUsed;
+   }
+
+   inline void Rewind(const size_t mark) {
+      EBM_ASSERT(mark <= m_cBytesUsed);
+      m_cBytesUsed = mark;
+   }
+
+   inline void Reset() {
+      m_cBytesUsed = 0;
+   }
+
+   inline ErrorEbm Reserve(const size_t cBytes) {
+      EBM_ASSERT(0 == m_cBytesUsed);
+      if(m_cBytesCapacity < cBytes) {
+         AlignedFree(m_aBuffer);
+         m_aBuffer = nullptr;
+         m_cBytesCapacity = 0;
+
+         unsigned char * const aBuffer = static_cast<unsigned char *>(AlignedAlloc(cBytes));
+         if(UNLIKELY(nullptr == aBuffer)) {
+            LOG_0(Trace_Warning, "WARNING ScratchArena::Reserve nullptr == aBuffer");
+            return Error_OutOfMemory;
+         }
+         m_aBuffer = aBuffer;
+         m_cBytesCapacity = cBytes;
+      }
+      return Error_None;
+   }
+
+   // returns memory aligned to SIMD_BYTE_ALIGNMENT, or nullptr on failure
+   inline void * Allocate(const size_t cBytes) {
+      if(IsAddError(cBytes, SIMD_BYTE_ALIGNMENT - size_t { 1 })) {
+         LOG_0(Trace_Warning, "WARNING ScratchArena::Allocate IsAddError(cBytes, SIMD_BYTE_ALIGNMENT - 1)");
+         return nullptr;
+      }
+      const size_t cBytesAligned = (cBytes + (SIMD_BYTE_ALIGNMENT - size_t { 1 })) / SIMD_BYTE_ALIGNMENT *
+         SIMD_BYTE_ALIGNMENT;
+
+      if(UNLIKELY(m_cBytesCapacity - m_cBytesUsed < cBytesAligned)) {
+         if(0 != m_cBytesUsed) {
+            // outstanding allocations point into the current buffer, so we cannot replace it. Callers are
+            // structured so that only the first allocation after a rewind to zero can need more memory
+            LOG_0(Trace_Warning, "WARNING ScratchArena::Allocate cannot grow while allocations are outstanding");
+            return nullptr;
+         }
+         // grow by 50% since the next call is likely to ask for a similar amount
+         if(IsAddError(cBytesAligned, cBytesAligned >> 1)) {
+            LOG_0(Trace_Warning, "WARNING ScratchArena::Allocate IsAddError(cBytesAligned, cBytesAligned >> 1)");
+            return nullptr;
+         }
+         if(Error_None != Reserve(cBytesAligned + (cBytesAligned >> 1))) {
+            // already logged
+            return nullptr;
+         }
+      }
+      void * const p = m_aBuffer + m_cBytesUsed;
+      m_cBytesUsed += cBytesAligned;
+      return p;
+   }
+};
+static_assert(std::is_standard_layout<ScratchArena>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ScratchArena>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+} // DEFINED_ZONE_NAME
+
+#endif // SCRATCH_ARENA_HPP
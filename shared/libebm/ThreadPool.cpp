@@ -0,0 +1,338 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h> // pthread_setaffinity_np
+#include <sched.h> // cpu_set_t, sched_getaffinity
+#endif // __linux__
+
+#include "libebm.h" // EBM_API_BODY
+#include "logging.h" // EBM_ASSERT
+#include "common_cpp.hpp" // IsConvertError
+
+#include "ThreadPool.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// set while a thread is executing tasks so that a task which calls Run again executes its subtasks serially
+// instead of deadlocking on m_runMutex
+static thread_local bool t_bInsideTask = false;
+
+ThreadPool::~ThreadPool() {
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_bShutdown = true;
+   }
+   m_workAvailable.notify_all();
+
+   for(size_t iWorker = 0; iWorker < m_cWorkers; ++iWorker) {
+      m_aWorkers[iWorker].join();
+   }
+   delete[] m_aWorkers;
+}
+
+void ThreadPool::Free(ThreadPool * const pThreadPool) {
+   LOG_0(Trace_Info, "Entered ThreadPool::Free");
+   if(nullptr != pThreadPool) {
+      // see BoosterCore::Free for the reasoning behind the memory ordering used here
+      if(size_t { 1 } == pThreadPool->m_REFERENCE_COUNT.fetch_sub(1, std::memory_order_release)) {
+         std::atomic_thread_fence(std::memory_order_acquire);
+         LOG_0(Trace_Info, "INFO ThreadPool::Free deleting ThreadPool");
+
+         // before we free our memory, indicate it was freed so if our higher level language attempts to use it we 
+         // have a chance to detect the error
+         pThreadPool->m_handleVerification = k_handleVerificationFreed;
+         delete pThreadPool;
+      }
+   }
+   LOG_0(Trace_Info, "Exited ThreadPool::Free");
+}
+
+ErrorEbm ThreadPool::Create(const size_t cThreads, const bool bPinThreads, ThreadPool ** const ppThreadPoolOut) {
+   LOG_0(Trace_Info, "Entered ThreadPool::Create");
+
+   EBM_ASSERT(nullptr != ppThreadPoolOut);
+   EBM_ASSERT(nullptr == *ppThreadPoolOut);
+   EBM_ASSERT(1 <= cThreads);
+
+   ThreadPool * pThreadPool;
+   try {
+      pThreadPool = new ThreadPool();
+   } catch(const std::bad_alloc &) {
+      LOG_0(Trace_Warning, "WARNING ThreadPool::Create Out of memory allocating ThreadPool");
+      return Error_OutOfMemory;
+   } catch(...) {
+      LOG_0(Trace_Warning, "WARNING ThreadPool::Create Unknown error");
+      return Error_UnexpectedInternal;
+   }
+   if(nullptr == pThreadPool) {
+      // this should be impossible since bad_alloc should have been thrown, but let's be untrusting
+      LOG_0(Trace_Warning, "WARNING ThreadPool::Create nullptr == pThreadPool");
+      return Error_OutOfMemory;
+   }
+
+   const size_t cWorkers = cThreads - size_t { 1 };
+   if(size_t { 0 } != cWorkers) {
+      try {
+         pThreadPool->m_aWorkers = new std::thread[cWorkers];
+      } catch(const std::bad_alloc &) {
+         LOG_0(Trace_Warning, "WARNING ThreadPool::Create Out of memory allocating m_aWorkers");
+         delete pThreadPool;
+         return Error_OutOfMemory;
+      } catch(...) {
+         LOG_0(Trace_Warning, "WARNING ThreadPool::Create Unknown error allocating m_aWorkers");
+         delete pThreadPool;
+         return Error_UnexpectedInternal;
+      }
+
+      // m_cWorkers only counts threads that started, so the destructor joins exactly those if we fail part way
+      do {
+         try {
+            pThreadPool->m_aWorkers[pThreadPool->m_cWorkers] = std::thread(&ThreadPool::WorkerLoop, pThreadPool);
+         } catch(const std::bad_alloc &) {
+            LOG_0(Trace_Warning, "WARNING ThreadPool::Create thread start out of memory");
+            delete pThreadPool;
+            return Error_OutOfMemory;
+         } catch(...) {
+            // the C++ standard doesn't really seem to say what kind of exceptions we'd get for various errors, so
+            // about the best we can do is catch(...) since the exact exceptions seem to be implementation specific
+            LOG_0(Trace_Warning, "WARNING ThreadPool::Create thread start failed");
+            delete pThreadPool;
+            return Error_ThreadStartFailed;
+         }
+         ++pThreadPool->m_cWorkers;
+      } while(cWorkers != pThreadPool->m_cWorkers);
+
+      if(bPinThreads) {
+#if defined(__linux__)
+         // pin only to processors that the process is allowed to run on, since cgroups, taskset, or a container
+         // can restrict us to a subset of the machine that does not start at processor 0
+         cpu_set_t cpuSetAllowed;
+         CPU_ZERO(&cpuSetAllowed);
+         if(0 != sched_getaffinity(0, sizeof(cpuSetAllowed), &cpuSetAllowed)) {
+            // pinning is only a performance hint, so continue unpinned
+            LOG_0(Trace_Warning, "WARNING ThreadPool::Create sched_getaffinity failed");
+         } else {
+            int aiCpusAllowed[CPU_SETSIZE];
+            size_t cCpusAllowed = 0;
+            for(int iCpu = 0; iCpu < CPU_SETSIZE; ++iCpu) {
+               if(CPU_ISSET(iCpu, &cpuSetAllowed)) {
+                  aiCpusAllowed[cCpusAllowed] = iCpu;
+                  ++cCpusAllowed;
+               }
+            }
+            // the calling thread is not ours to pin, so it is left alone and the workers take the processors after it
+            for(size_t iWorker = 0; size_t { 0 } != cCpusAllowed && iWorker < cWorkers; ++iWorker) {
+               cpu_set_t cpuSet;
+               CPU_ZERO(&cpuSet);
+               CPU_SET(aiCpusAllowed[(iWorker + size_t { 1 }) % cCpusAllowed], &cpuSet);
+               const pthread_t thread = pThreadPool->m_aWorkers[iWorker].native_handle();
+               if(0 != pthread_setaffinity_np(thread, sizeof(cpuSet), &cpuSet)) {
+                  // pinning is only a performance hint, so continue unpinned
+                  LOG_0(Trace_Warning, "WARNING ThreadPool::Create pthread_setaffinity_np failed");
+                  break;
+               }
+            }
+         }
+#else // __linux__
+         LOG_0(Trace_Warning, "WARNING ThreadPool::Create thread pinning is not supported on this platform");
+#endif // __linux__
+      }
+   }
+
+   *ppThreadPoolOut = pThreadPool;
+
+   LOG_0(Trace_Info, "Exited ThreadPool::Create");
+   return Error_None;
+}
+
+void ThreadPool::ExecuteTasks() {
+   const bool bInsideTaskPrev = t_bInsideTask;
+   t_bInsideTask = true;
+
+   const size_t cTasks = m_cTasks;
+   const ThreadPoolTaskFunction pTaskFunction = m_pTaskFunction;
+   void * const pTaskContext = m_pTaskContext;
+   while(true) {
+      const size_t iTask = m_iTaskNext.fetch_add(size_t { 1 }, std::memory_order_relaxed);
+      if(cTasks <= iTask) {
+         break;
+      }
+      ErrorEbm error;
+      try {
+         error = (*pTaskFunction)(pTaskContext, iTask);
+      } catch(...) {
+         error = Error_UnexpectedInternal;
+      }
+      if(Error_None != error) {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         if(Error_None == m_error || iTask < m_iTaskError) {
+            m_error = error;
+            m_iTaskError = iTask;
+         }
+      }
+   }
+
+   t_bInsideTask = bInsideTaskPrev;
+}
+
+void ThreadPool::WorkerLoop() {
+   size_t iGenerationSeen = 0;
+   while(true) {
+      {
+         std::unique_lock<std::mutex> lock(m_mutex);
+         while(!m_bShutdown && iGenerationSeen == m_iGeneration) {
+            m_workAvailable.wait(lock);
+         }
+         if(m_bShutdown) {
+            return;
+         }
+         iGenerationSeen = m_iGeneration;
+      }
+
+      ExecuteTasks();
+
+      bool bLast;
+      {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         EBM_ASSERT(1 <= m_cWorkersPending);
+         --m_cWorkersPending;
+         bLast = size_t { 0 } == m_cWorkersPending;
+      }
+      if(bLast) {
+         m_workFinished.notify_one();
+      }
+   }
+}
+
+ErrorEbm ThreadPool::Run(const size_t cTasks, const ThreadPoolTaskFunction pTaskFunction, void * const pTaskContext) {
+   EBM_ASSERT(nullptr != pTaskFunction);
+
+   if(size_t { 0 } == m_cWorkers || cTasks <= size_t { 1 } || t_bInsideTask) {
+      for(size_t iTask = 0; iTask < cTasks; ++iTask) {
+         const ErrorEbm error = (*pTaskFunction)(pTaskContext, iTask);
+         if(Error_None != error) {
+            return error;
+         }
+      }
+      return Error_None;
+   }
+
+   std::lock_guard<std::mutex> runLock(m_runMutex);
+
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_pTaskFunction = pTaskFunction;
+      m_pTaskContext = pTaskContext;
+      m_cTasks = cTasks;
+      m_iTaskNext.store(size_t { 0 }, std::memory_order_relaxed);
+      m_iTaskError = 0;
+      m_error = Error_None;
+      m_cWorkersPending = m_cWorkers;
+      ++m_iGeneration;
+   }
+   m_workAvailable.notify_all();
+
+   ExecuteTasks();
+
+   ErrorEbm error;
+   {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while(size_t { 0 } != m_cWorkersPending) {
+         m_workFinished.wait(lock);
+      }
+      error = m_error;
+   }
+   return error;
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CreateThreadPool(
+   IntEbm countThreads,
+   AffinityFlags affinityFlags,
+   ThreadPoolHandle * threadPoolHandleOut
+) {
+   LOG_N(
+      Trace_Info,
+      "Entered CreateThreadPool: "
+      "countThreads=%" IntEbmPrintf ", "
+      "affinityFlags=0x%" UAffinityFlagsPrintf ", "
+      "threadPoolHandleOut=%p"
+      ,
+      countThreads,
+      static_cast<UAffinityFlags>(affinityFlags), // signed to unsigned conversion is defined behavior in C++
+      static_cast<void *>(threadPoolHandleOut)
+   );
+
+   if(nullptr == threadPoolHandleOut) {
+      LOG_0(Trace_Error, "ERROR CreateThreadPool nullptr == threadPoolHandleOut");
+      return Error_IllegalParamVal;
+   }
+   *threadPoolHandleOut = nullptr; // set this to nullptr as soon as possible so the caller doesn't attempt to free it
+
+   if(0 != (static_cast<UAffinityFlags>(affinityFlags) & static_cast<UAffinityFlags>(~(
+      static_cast<UAffinityFlags>(AffinityFlags_PinThreads)
+   )))) {
+      LOG_0(Trace_Error, "ERROR CreateThreadPool affinityFlags contains unknown flags. Ignoring extras.");
+   }
+
+   if(countThreads < IntEbm { 0 }) {
+      LOG_0(Trace_Error, "ERROR CreateThreadPool countThreads must be positive or zero");
+      return Error_IllegalParamVal;
+   }
+   if(IsConvertError<size_t>(countThreads)) {
+      LOG_0(Trace_Error, "ERROR CreateThreadPool IsConvertError<size_t>(countThreads)");
+      return Error_IllegalParamVal;
+   }
+   size_t cThreads = static_cast<size_t>(countThreads);
+   if(size_t { 0 } == cThreads) {
+      // zero means use all the processors. hardware_concurrency is allowed to return 0 if it is not computable
+      cThreads = EbmMax(size_t { 1 }, static_cast<size_t>(std::thread::hardware_concurrency()));
+   }
+
+   ThreadPool * pThreadPool = nullptr;
+   const ErrorEbm error = ThreadPool::Create(
+      cThreads,
+      0 != (AffinityFlags_PinThreads & affinityFlags),
+      &pThreadPool
+   );
+   if(Error_None != error) {
+      // already logged
+      return error;
+   }
+
+   const ThreadPoolHandle handle = pThreadPool->GetHandle();
+   *threadPoolHandleOut = handle;
+
+   LOG_N(Trace_Info, "Exited CreateThreadPool: *threadPoolHandleOut=%p", static_cast<void *>(handle));
+
+   return Error_None;
+}
+
+EBM_API_BODY void EBM_CALLING_CONVENTION FreeThreadPool(
+   ThreadPoolHandle threadPoolHandle
+) {
+   LOG_N(Trace_Info, "Entered FreeThreadPool: threadPoolHandle=%p", static_cast<void *>(threadPoolHandle));
+
+   ThreadPool * const pThreadPool = ThreadPool::GetThreadPoolFromHandle(threadPoolHandle);
+   // if the conversion above doesn't work, it'll return null, and our free will not in fact free any memory,
+   // but it will not crash. We'll leak memory, but at least we'll log that.
+
+   // any boosters or interaction detectors that were given this thread pool keep it alive until they are freed
+   ThreadPool::Free(pThreadPool);
+
+   LOG_0(Trace_Info, "Exited FreeThreadPool");
+}
+
+} // DEFINED_ZONE_NAME
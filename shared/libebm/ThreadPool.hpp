@@ -0,0 +1,126 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "libebm.h" // ErrorEbm
+#include "logging.h" // EBM_ASSERT
+#include "common_c.h"
+#include "zones.h"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+// Tasks are identified by their index [0, cTasks). The calling thread does not know which thread will execute
+// any given task, so callers that need deterministic results should write each task's output into memory owned
+// by that task index and then combine the outputs in index order after Run returns.
+typedef ErrorEbm (* ThreadPoolTaskFunction)(void * const pContext, const size_t iTask);
+
+class ThreadPool final {
+   static constexpr size_t k_handleVerificationOk = 14387; // random 15 bit number
+   static constexpr size_t k_handleVerificationFreed = 27461; // random 15 bit number
+   size_t m_handleVerification; // this needs to be at the top and make it pointer sized to keep best alignment
+
+   // the thread pool can be shared between the caller and any number of boosters and interaction detectors
+   std::atomic_size_t m_REFERENCE_COUNT;
+
+   // Run is allowed to be called from multiple threads on the same ThreadPool, but only one parallel section
+   // executes at a time. m_runMutex serializes those callers.
+   std::mutex m_runMutex;
+
+   std::mutex m_mutex;
+   std::condition_variable m_workAvailable;
+   std::condition_variable m_workFinished;
+
+   size_t m_cWorkers;
+   std::thread * m_aWorkers;
+
+   // everything below is protected by m_mutex, except m_iTaskNext which workers use to claim tasks
+   bool m_bShutdown;
+   size_t m_iGeneration;
+   size_t m_cWorkersPending;
+   ThreadPoolTaskFunction m_pTaskFunction;
+   void * m_pTaskContext;
+   size_t m_cTasks;
+   std::atomic_size_t m_iTaskNext;
+   size_t m_iTaskError;
+   ErrorEbm m_error;
+
+   void WorkerLoop();
+   void ExecuteTasks();
+
+   ~ThreadPool();
+
+   inline ThreadPool() noexcept :
+      m_handleVerification(k_handleVerificationOk),
+      m_REFERENCE_COUNT(1), // we're not visible on any other thread yet, so no synchronization required
+      m_cWorkers(0),
+      m_aWorkers(nullptr),
+      m_bShutdown(false),
+      m_iGeneration(0),
+      m_cWorkersPending(0),
+      m_pTaskFunction(nullptr),
+      m_pTaskContext(nullptr),
+      m_cTasks(0),
+      m_iTaskNext(0),
+      m_iTaskError(0),
+      m_error(Error_None) {
+   }
+
+public:
+
+   static ErrorEbm Create(const size_t cThreads, const bool bPinThreads, ThreadPool ** const ppThreadPoolOut);
+   static void Free(ThreadPool * const pThreadPool);
+
+   inline static ThreadPool * GetThreadPoolFromHandle(const ThreadPoolHandle threadPoolHandle) {
+      if(nullptr == threadPoolHandle) {
+         LOG_0(Trace_Error, "ERROR GetThreadPoolFromHandle null threadPoolHandle");
+         return nullptr;
+      }
+      ThreadPool * const pThreadPool = reinterpret_cast<ThreadPool *>(threadPoolHandle);
+      if(k_handleVerificationOk == pThreadPool->m_handleVerification) {
+         return pThreadPool;
+      }
+      if(k_handleVerificationFreed == pThreadPool->m_handleVerification) {
+         LOG_0(Trace_Error, "ERROR GetThreadPoolFromHandle attempt to use freed ThreadPoolHandle");
+      } else {
+         LOG_0(Trace_Error, "ERROR GetThreadPoolFromHandle attempt to use invalid ThreadPoolHandle");
+      }
+      return nullptr;
+   }
+   inline ThreadPoolHandle GetHandle() {
+      return reinterpret_cast<ThreadPoolHandle>(this);
+   }
+
+   inline void AddReferenceCount() {
+      // incrementing reference counts can be relaxed memory order since we're guaranteed to be above 1, 
+      // so no result will change our behavior below
+      // https://www.boost.org/doc/libs/1_59_0/doc/html/atomic/usage_examples.html
+      m_REFERENCE_COUNT.fetch_add(1, std::memory_order_relaxed);
+   };
+
+   // Returns the number of threads that can simultaneously execute tasks, including the thread that calls Run
+   inline size_t GetCountThreads() const noexcept {
+      return m_cWorkers + size_t { 1 };
+   }
+
+   // Executes pTaskFunction for each task index in [0, cTasks) and returns after all tasks have completed.
+   // The calling thread participates in the work. If any tasks fail, the error from the lowest failing task index
+   // is returned. Tasks must not call Run on the same ThreadPool. If they do, the nested tasks execute serially
+   // on the calling thread.
+   ErrorEbm Run(const size_t cTasks, const ThreadPoolTaskFunction pTaskFunction, void * const pTaskContext);
+};
+
+} // DEFINED_ZONE_NAME
+
+#endif // THREAD_POOL_HPP
@@ -37,6 +37,7 @@ struct ApplyUpdateBridge {
    BoolEbm m_bHessianNeeded;
 
    BoolEbm m_bValidation;
+   BoolEbm m_bUniformTarget; // every sample has the same target, so the objective can read m_aTargets[0] only
    void * m_aMulticlassMidwayTemp; // float or double
    const void * m_aUpdateTensorScores; // float or double
    size_t m_cSamples;
@@ -59,10 +60,14 @@ struct BinSumsBoostingBridge {
    const void * m_aGradientsAndHessians; // float or double
    const void * m_aWeights; // float or double
    const uint8_t * m_pCountOccurrences;
+   BoolEbm m_bMultiplyOccurrences; // m_aWeights excludes the occurrences, so multiply them in while binning
    const void * m_aPacked; // uint64_t or uint32_t
 
+   size_t m_cBins;
    void * m_aFastBins; // Bin<...> (can't use BinBase * since this is only C here)
 
+   BoolEbm m_bLaneBins; // allow private per SIMD lane histograms (cleared by SIMDFlags_DisableLaneHistograms)
+
 #ifndef NDEBUG
    const void * m_pDebugFastBinsEnd;
 #endif // NDEBUG
@@ -81,6 +86,10 @@ struct BinSumsInteractionBridge {
    int m_acItemsPerBitPack[k_cDimensionsMax];
    const void * m_aaPacked[k_cDimensionsMax]; // uint64_t or uint32_t
 
+   // if non-zero, m_cPairs two dimensional tensors are binned in one pass over the samples. Pair iPair uses
+   // dimensions 2 * iPair and 2 * iPair + 1, and its tensor follows the tensor of the previous pair in m_aFastBins
+   size_t m_cPairs;
+
    void * m_aFastBins; // Bin<...> (can't use BinBase * since this is only C here)
 
 #ifndef NDEBUG
@@ -197,6 +206,20 @@ INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Avx2_32(
    ObjectiveWrapper * const pObjectiveWrapperOut
 );
 
+INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Avx512f_64(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const char * const sObjectiveEnd,
+   ObjectiveWrapper * const pObjectiveWrapperOut
+);
+
+INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Avx2_64(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const char * const sObjectiveEnd,
+   ObjectiveWrapper * const pObjectiveWrapperOut
+);
+
 INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateObjective_Cuda_32(
    const Config * const pConfig,
    const char * const sObjective,
@@ -211,6 +234,54 @@ INTERNAL_IMPORT_EXPORT_INCLUDE ErrorEbm CreateMetric_Cpu_64(
    //   MetricWrapper * const pMetricWrapperOut,
 );
 
+// Discretize kernels write the same bin indexes as DiscretizeOneSample.  The broadcast kernels take the sorted
+// cuts directly and are only used for small numbers of cuts.  The Eytzinger kernels take a complete binary tree
+// with 2^cLevels - 1 nodes stored breadth first starting at index 1, where unused nodes hold NaN.
+typedef void (* DISCRETIZE_KERNEL_C)(
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cCutsOrLevels,
+   const double * const aCutsOrTree,
+   IntEbm * const aBinIndexesOut
+);
+
+struct DiscretizeKernels {
+   DISCRETIZE_KERNEL_C m_pDiscretizeBroadcastC;
+   DISCRETIZE_KERNEL_C m_pDiscretizeEytzingerC;
+};
+
+INTERNAL_IMPORT_EXPORT_INCLUDE void DiscretizeBroadcast_Avx512f_64(
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cCuts,
+   const double * const aCutsLowerBoundInclusive,
+   IntEbm * const aBinIndexesOut
+);
+
+INTERNAL_IMPORT_EXPORT_INCLUDE void DiscretizeEytzinger_Avx512f_64(
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cLevels,
+   const double * const aTree,
+   IntEbm * const aBinIndexesOut
+);
+
+INTERNAL_IMPORT_EXPORT_INCLUDE void DiscretizeBroadcast_Avx2_64(
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cCuts,
+   const double * const aCutsLowerBoundInclusive,
+   IntEbm * const aBinIndexesOut
+);
+
+INTERNAL_IMPORT_EXPORT_INCLUDE void DiscretizeEytzinger_Avx2_64(
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cLevels,
+   const double * const aTree,
+   IntEbm * const aBinIndexesOut
+);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif // __cplusplus
@@ -69,15 +69,13 @@ GPU_BOTH inline constexpr static size_t GetBinSize(const bool bHessian, const si
 
 template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores>
 struct Bin final : BinBase {
-   // TODO: Use the type std::nullptr_t for TUInt to indicate that the m_cSamples field should be dropped
-   //       and add a bool bWeight template parameter to indicate if weight should be kept
-
    friend void ConvertAddBin(
       const size_t,
       const bool,
       const size_t,
       const bool,
       const bool,
+      const bool,
       const void * const,
       const bool,
       const bool,
@@ -285,6 +283,100 @@ static_assert(std::is_standard_layout<Bin<double, uint64_t, false>>::value,
 static_assert(std::is_trivial<Bin<double, uint64_t, false>>::value,
    "We use memcpy in several places, so disallow non-trivial types in general");
 
+// Using NoWeight<TUInt> for TUInt drops the m_weight field. Unweighted data adds the same integer amount (1 or the 
+// occurrence count) to the count and the weight of a bin, so the fast bins that hold unweighted sums keep only the 
+// exact integer count and ConvertAddBin restores the weights from the counts when adding them into the main bins.
+template<typename TUInt>
+struct NoWeight final {
+   static_assert(std::is_integral<TUInt>::value, "TUInt must be an integer type");
+   static_assert(std::is_unsigned<TUInt>::value, "TUInt must be unsigned");
+};
+
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores>
+struct Bin<TFloat, NoWeight<TUInt>, bHessian, cCompilerScores> final : BinBase {
+   friend void ConvertAddBin(
+      const size_t,
+      const bool,
+      const size_t,
+      const bool,
+      const bool,
+      const bool,
+      const void * const,
+      const bool,
+      const bool,
+      void * const
+   );
+   template<typename, typename> friend bool IsOverflowBinSize(const bool, const size_t);
+   template<typename, typename> GPU_BOTH friend inline constexpr size_t GetBinSize(const bool, const size_t);
+
+   static_assert(std::is_floating_point<TFloat>::value, "TFloat must be a float type");
+
+private:
+
+   TUInt m_cSamples;
+
+   // IMPORTANT: m_aGradientPairs must be in the last position for the struct hack and this must be standard layout
+   GradientPair<TFloat, bHessian> m_aGradientPairs[cCompilerScores];
+
+public:
+
+   Bin() = default; // preserve our POD status
+   ~Bin() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   GPU_BOTH inline TUInt GetCountSamples() const {
+      return m_cSamples;
+   }
+   GPU_BOTH inline void SetCountSamples(const TUInt cSamples) {
+      m_cSamples = cSamples;
+   }
+
+   GPU_BOTH inline const GradientPair<TFloat, bHessian> * GetGradientPairs() const {
+      return ArrayToPointer(m_aGradientPairs);
+   }
+   GPU_BOTH inline GradientPair<TFloat, bHessian> * GetGradientPairs() {
+      return ArrayToPointer(m_aGradientPairs);
+   }
+};
+static_assert(std::is_standard_layout<Bin<float, NoWeight<uint32_t>, true>>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<Bin<float, NoWeight<uint32_t>, true>>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+// the kernels update counts and weights through these so that the same code can fill bins with and without the 
+// m_weight field
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores, typename TCount>
+GPU_BOTH inline static void AddCountSamples(Bin<TFloat, TUInt, bHessian, cCompilerScores> * const pBin, const TCount cSamples) {
+   pBin->SetCountSamples(pBin->GetCountSamples() + static_cast<TUInt>(cSamples));
+}
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores, typename TCount>
+GPU_BOTH inline static void AddCountSamples(Bin<TFloat, NoWeight<TUInt>, bHessian, cCompilerScores> * const pBin, const TCount cSamples) {
+   pBin->SetCountSamples(pBin->GetCountSamples() + static_cast<TUInt>(cSamples));
+}
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores, typename TCount>
+GPU_BOTH inline static void SubtractCountSamples(Bin<TFloat, TUInt, bHessian, cCompilerScores> * const pBin, const TCount cSamples) {
+   pBin->SetCountSamples(pBin->GetCountSamples() - static_cast<TUInt>(cSamples));
+}
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores, typename TCount>
+GPU_BOTH inline static void SubtractCountSamples(Bin<TFloat, NoWeight<TUInt>, bHessian, cCompilerScores> * const pBin, const TCount cSamples) {
+   pBin->SetCountSamples(pBin->GetCountSamples() - static_cast<TUInt>(cSamples));
+}
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores>
+GPU_BOTH inline static void AddWeight(Bin<TFloat, TUInt, bHessian, cCompilerScores> * const pBin, const TFloat weight) {
+   pBin->SetWeight(pBin->GetWeight() + weight);
+}
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores>
+GPU_BOTH inline static void AddWeight(Bin<TFloat, NoWeight<TUInt>, bHessian, cCompilerScores> * const, const TFloat) {
+}
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores>
+GPU_BOTH inline static void SubtractWeight(Bin<TFloat, TUInt, bHessian, cCompilerScores> * const pBin, const TFloat weight) {
+   pBin->SetWeight(pBin->GetWeight() - weight);
+}
+template<typename TFloat, typename TUInt, bool bHessian, size_t cCompilerScores>
+GPU_BOTH inline static void SubtractWeight(Bin<TFloat, NoWeight<TUInt>, bHessian, cCompilerScores> * const, const TFloat) {
+}
+
 template<typename TFloat, typename TUInt>
 inline static bool IsOverflowBinSize(const bool bHessian, const size_t cScores) {
    const size_t cBytesPerGradientPair = GetGradientPairSize<TFloat>(bHessian);
@@ -98,6 +98,10 @@ inline constexpr static size_t GetArrayScores(const size_t cScores) noexcept {
 static constexpr int k_cItemsPerBitPackNone = -1; // this is for when there is only 1 bin
 static constexpr int k_cItemsPerBitPackDynamic = 0;
 
+// the most pairs that can be binned in one pass over the samples (see BinSumsInteractionBridge::m_cPairs). Each pair
+// count has its own compiled kernel, which lets the compiler keep every dimension of the pass in registers
+static constexpr size_t k_cPairsPerPassMax = 4;
+
 inline constexpr static bool IsRegressionOutput(const LinkEbm link) noexcept {
    return 
       Link_custom_regression == link ||
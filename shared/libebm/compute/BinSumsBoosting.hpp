@@ -6,6 +6,8 @@
 #define BIN_SUMS_BOOSTING_HPP
 
 #include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memset
+#include <type_traits> // std::enable_if
 
 #include "logging.h" // EBM_ASSERT
 #include "zones.h"
@@ -20,16 +22,383 @@ namespace DEFINED_ZONE_NAME {
 #error DEFINED_ZONE_NAME must be defined
 #endif // DEFINED_ZONE_NAME
 
-template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, int cCompilerPack>
+// Without weights every sample adds the same integer amount (1 or its occurrence count) to both the count and the 
+// weight of its bin, so the fast bins keep only the exact count and ConvertAddBin restores the weight from it.
+template<typename TFloat, bool bWeight>
+using FastBinUInt = typename std::conditional<bWeight, typename TFloat::TInt::T, NoWeight<typename TFloat::TInt::T>>::type;
+
+// Lane histograms larger than this are not used and we fall back to a single histogram shared by all the SIMD lanes.
+// This keeps the lane histograms in L1 cache and bounds the stack memory that they consume.
+static constexpr size_t k_cBytesLaneBinsMax = 16384;
+
+// SIMD lanes can point to the same bin, so a single shared histogram requires updating the bins one lane at a time.
+// When the histogram is small enough we instead give each SIMD lane its own private copy of the histogram. The lanes
+// then never collide, so we can update all of them with gather/add/scatter operations and sum the lane copies once
+// at the end. Within a bin the items are ordered count, weight (if kept), and then the gradient and hessian of each score.
+// Each item is held k_cSIMDPack times consecutively, once for each lane.
+// Without a hardware scatter (AVX2) the stores still happen one lane at a time and the lanes were no faster than the
+// shared histogram, and with multiple scores they weren't faster on AVX-512 either, so we only use them for single
+// score terms in the zones that have a scatter instruction (see SIMDFlags_DisableLaneHistograms to compare them).
+template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, 
+   bool bMultiplyOccurrences, int cCompilerPack, typename TEnable = void>
+struct BinSumsBoostingLanes final {
+   GPU_DEVICE INLINE_ALWAYS static bool Func(BinSumsBoostingBridge * const) {
+      // zones without a hardware scatter, multiple scores, and the zero dimensional case use the single histogram
+      return false;
+   }
+};
+template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, 
+   bool bMultiplyOccurrences, int cCompilerPack>
+struct BinSumsBoostingLanes<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, 
+   cCompilerPack, typename std::enable_if<TFloat::k_bScatter && k_oneScore == cCompilerScores && 
+   k_cItemsPerBitPackNone != cCompilerPack>::type> final {
+
+   NEVER_INLINE static bool Func(BinSumsBoostingBridge * const pParams) {
+      if(EBM_FALSE == pParams->m_bLaneBins) {
+         return false;
+      }
+
+      static constexpr size_t cArrayScores = GetArrayScores(cCompilerScores);
+      static constexpr size_t cSIMDPack = static_cast<size_t>(TFloat::k_cSIMDPack);
+      static constexpr bool bApplyWeight = bWeight || bMultiplyOccurrences;
+      static_assert(sizeof(typename TFloat::T) == sizeof(typename TFloat::TInt::T), 
+         "the lane histograms require the same number of lanes for floats and integers");
+
+      const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pParams->m_cScores);
+      const size_t cBins = pParams->m_cBins;
+      EBM_ASSERT(1 <= cBins);
+
+      const size_t cItemsPerLaneBin = ((bWeight ? size_t { 2 } : size_t { 1 }) + (bHessian ? size_t { 2 } : size_t { 1 }) * cScores) * cSIMDPack;
+      if(IsMultiplyError(cItemsPerLaneBin, cBins) || 
+         k_cBytesLaneBinsMax / sizeof(typename TFloat::T) < cItemsPerLaneBin * cBins) 
+      {
+         return false;
+      }
+      const size_t cItemsLaneBins = cItemsPerLaneBin * cBins;
+
+      // use raw bytes since we hold both the integer counts and the floating point sums in this memory
+      alignas(SIMD_BYTE_ALIGNMENT) unsigned char aLaneBinsBytes[k_cBytesLaneBinsMax];
+      memset(aLaneBinsBytes, 0, cItemsLaneBins * sizeof(typename TFloat::T));
+      typename TFloat::TInt::T * const aLaneCounts = reinterpret_cast<typename TFloat::TInt::T *>(aLaneBinsBytes);
+      typename TFloat::T * const aLaneFloats = reinterpret_cast<typename TFloat::T *>(aLaneBinsBytes);
+
+      const size_t cSamples = pParams->m_cSamples;
+
+      const typename TFloat::T * pGradientAndHessian = 
+         reinterpret_cast<const typename TFloat::T *>(pParams->m_aGradientsAndHessians);
+      const typename TFloat::T * const pGradientsAndHessiansEnd = 
+         pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cScores * cSamples;
+
+      const int cItemsPerBitPack = GET_ITEMS_PER_BIT_PACK(cCompilerPack, pParams->m_cPack);
+      EBM_ASSERT(1 <= cItemsPerBitPack);
+      EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(typename TFloat::TInt::T));
+
+      const int cBitsPerItemMax = GetCountBits<typename TFloat::TInt::T>(cItemsPerBitPack);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(typename TFloat::TInt::T));
+
+      int cShift = static_cast<int>(((cSamples >> TFloat::k_cSIMDShift) - size_t { 1 }) % 
+         static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+      const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+
+      const typename TFloat::TInt maskBits = MakeLowMask<typename TFloat::TInt::T>(cBitsPerItemMax);
+
+      const typename TFloat::TInt::T * pInputData = 
+         reinterpret_cast<const typename TFloat::TInt::T *>(pParams->m_aPacked);
+      EBM_ASSERT(nullptr != pInputData);
+
+      const typename TFloat::T * pWeight;
+      if(bWeight) {
+         pWeight = reinterpret_cast<const typename TFloat::T *>(pParams->m_aWeights);
+         EBM_ASSERT(nullptr != pWeight);
+      }
+      const uint8_t * pCountOccurrences;
+      if(bReplication) {
+         pCountOccurrences = pParams->m_pCountOccurrences;
+         EBM_ASSERT(nullptr != pCountOccurrences);
+      }
+
+      const typename TFloat::TInt iLanes = TFloat::TInt::MakeIndexes();
+      const typename TFloat::TInt iNextItem = typename TFloat::TInt::T { cSIMDPack };
+
+      do {
+         const typename TFloat::TInt iTensorBinCombined = TFloat::TInt::Load(pInputData);
+         pInputData += TFloat::TInt::k_cSIMDPack;
+         while(true) {
+            const typename TFloat::TInt iTensorBin = (iTensorBinCombined >> cShift) & maskBits;
+#ifndef NDEBUG
+            TFloat::TInt::Execute([cBins](int, const typename TFloat::TInt::T x) {
+               EBM_ASSERT(static_cast<size_t>(x) < cBins);
+            }, iTensorBin);
+#endif // NDEBUG
+
+            // the index of the first item within each lane's own copy of the bin
+            typename TFloat::TInt iItem = 
+               iTensorBin * static_cast<typename TFloat::TInt::T>(cItemsPerLaneBin) + iLanes;
+
+            typename TFloat::TInt count = TFloat::TInt::Load(aLaneCounts, iItem);
+            if(bReplication) {
+               count = count + TFloat::TInt::LoadBytes(pCountOccurrences);
+            } else {
+               count = count + typename TFloat::TInt::T { 1 };
+            }
+            count.Store(aLaneCounts, iItem);
+
+            TFloat weight;
+            if(bWeight) {
+               weight = TFloat::Load(pWeight);
+               pWeight += TFloat::k_cSIMDPack;
+            }
+            if(bMultiplyOccurrences) {
+               const TFloat occurrences = TFloat::LoadBytes(pCountOccurrences);
+               if(bWeight) {
+                  weight *= occurrences;
+               } else {
+                  weight = occurrences;
+               }
+            }
+            if(bReplication) {
+               pCountOccurrences += TFloat::k_cSIMDPack;
+            }
+            if(bWeight) {
+               iItem = iItem + iNextItem;
+               (TFloat::Load(aLaneFloats, iItem) + weight).Store(aLaneFloats, iItem);
+            }
+
+            size_t iScore = 0;
+            do {
+               iItem = iItem + iNextItem;
+               if(bHessian) {
+                  TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << (TFloat::k_cSIMDShift + 1)]);
+                  TFloat hessian = 
+                     TFloat::Load(&pGradientAndHessian[(iScore << (TFloat::k_cSIMDShift + 1)) + TFloat::k_cSIMDPack]);
+                  if(bApplyWeight) {
+                     gradient *= weight;
+                     hessian *= weight;
+                  }
+                  (TFloat::Load(aLaneFloats, iItem) + gradient).Store(aLaneFloats, iItem);
+                  iItem = iItem + iNextItem;
+                  (TFloat::Load(aLaneFloats, iItem) + hessian).Store(aLaneFloats, iItem);
+               } else {
+                  TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << TFloat::k_cSIMDShift]);
+                  if(bApplyWeight) {
+                     gradient *= weight;
+                  }
+                  (TFloat::Load(aLaneFloats, iItem) + gradient).Store(aLaneFloats, iItem);
+               }
+               ++iScore;
+            } while(cScores != iScore);
+
+            pGradientAndHessian += cScores << (bHessian ? (TFloat::k_cSIMDShift + 1) : TFloat::k_cSIMDShift);
+
+            cShift -= cBitsPerItemMax;
+            if(cShift < 0) {
+               break;
+            }
+         }
+         cShift = cShiftReset;
+      } while(pGradientsAndHessiansEnd != pGradientAndHessian);
+
+      // now sum the lane copies of each bin and add them into the real bins
+      auto * pBin = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<
+         typename TFloat::T, FastBinUInt<TFloat, bWeight>, bHessian, cArrayScores>();
+      const size_t cBytesPerBin = GetBinSize<typename TFloat::T, FastBinUInt<TFloat, bWeight>>(bHessian, cScores);
+      size_t iItemBin = 0;
+      do {
+         ASSERT_BIN_OK(cBytesPerBin, pBin, pParams->m_pDebugFastBinsEnd);
+
+         size_t iItem = iItemBin;
+         typename TFloat::TInt::T cSamplesBin = 0;
+         for(size_t iLane = 0; iLane < cSIMDPack; ++iLane) {
+            cSamplesBin += aLaneCounts[iItemBin + iLane];
+         }
+         AddCountSamples(pBin, cSamplesBin);
+
+         if(bWeight) {
+            iItem += cSIMDPack;
+            AddWeight(pBin, Sum(TFloat::Load(&aLaneFloats[iItem])));
+         }
+
+         auto * const aGradientPair = pBin->GetGradientPairs();
+         size_t iScore = 0;
+         do {
+            iItem += cSIMDPack;
+            aGradientPair[iScore].m_sumGradients += Sum(TFloat::Load(&aLaneFloats[iItem]));
+            if(bHessian) {
+               iItem += cSIMDPack;
+               aGradientPair[iScore].SetHess(aGradientPair[iScore].GetHess() + Sum(TFloat::Load(&aLaneFloats[iItem])));
+            }
+            ++iScore;
+         } while(cScores != iScore);
+
+         pBin = IndexBin(pBin, cBytesPerBin);
+         iItemBin += cItemsPerLaneBin;
+      } while(cItemsLaneBins != iItemBin);
+
+      return true;
+   }
+};
+
+// In the zero dimensional case every sample lands in the same bin, so we keep the running totals in SIMD registers
+// and only touch the bin once at the end. With dynamic scores we handle up to k_cCompilerScoresMax scores per pass 
+// over the data to keep the accumulators in a fixed size array.
+template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, 
+   bool bMultiplyOccurrences>
+GPU_DEVICE NEVER_INLINE static void BinSumsBoostingZeroDimensional(BinSumsBoostingBridge * const pParams) {
+   static_assert(bWeight || !bReplication || bMultiplyOccurrences, 
+      "bReplication cannot be true if bWeight is false unless the weights come from the occurrences");
+   static_assert(bReplication || !bMultiplyOccurrences, "bMultiplyOccurrences requires bReplication");
+   static constexpr bool bApplyWeight = bWeight || bMultiplyOccurrences;
+
+   static constexpr size_t cArrayScores = GetArrayScores(cCompilerScores);
+   static constexpr size_t cBlockScores = k_dynamicScores == cCompilerScores ? k_cCompilerScoresMax : cCompilerScores;
+
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(1 <= pParams->m_cSamples);
+   EBM_ASSERT(0 == pParams->m_cSamples % size_t { TFloat::k_cSIMDPack });
+   EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
+   EBM_ASSERT(nullptr != pParams->m_aFastBins);
+   EBM_ASSERT(k_dynamicScores == cCompilerScores || cCompilerScores == pParams->m_cScores);
+#endif // GPU_COMPILE
+
+   const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pParams->m_cScores);
+
+   auto * const pBin = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, FastBinUInt<TFloat, bWeight>, bHessian, cArrayScores>();
+   auto * const aGradientPair = pBin->GetGradientPairs();
+
+   const size_t cSamples = pParams->m_cSamples;
+   const size_t cItemsPerSample = (bHessian ? size_t { 2 } : size_t { 1 }) * cScores;
+
+   const typename TFloat::T * const aGradientsAndHessians = reinterpret_cast<const typename TFloat::T *>(pParams->m_aGradientsAndHessians);
+   const typename TFloat::T * const pGradientsAndHessiansEnd = aGradientsAndHessians + cItemsPerSample * cSamples;
+
+   size_t iScoreBlock = 0;
+   do {
+      const size_t cScoresBlock = cBlockScores < cScores - iScoreBlock ? cBlockScores : cScores - iScoreBlock;
+
+      TFloat aSumGradients[cBlockScores];
+      TFloat aSumHessians[bHessian ? cBlockScores : size_t { 1 }];
+      for(size_t iScore = 0; iScore < cScoresBlock; ++iScore) {
+         aSumGradients[iScore] = 0.0;
+         if(bHessian) {
+            aSumHessians[iScore] = 0.0;
+         }
+      }
+      TFloat sumWeight = 0.0;
+      typename TFloat::TInt sumOccurrences = typename TFloat::TInt::T { 0 };
+
+      const typename TFloat::T * pWeight;
+      if(bWeight) {
+         pWeight = reinterpret_cast<const typename TFloat::T *>(pParams->m_aWeights);
+#ifndef GPU_COMPILE
+         EBM_ASSERT(nullptr != pWeight);
+#endif // GPU_COMPILE
+      }
+      const uint8_t * pCountOccurrences;
+      if(bReplication) {
+         pCountOccurrences = pParams->m_pCountOccurrences;
+#ifndef GPU_COMPILE
+         EBM_ASSERT(nullptr != pCountOccurrences);
+#endif // GPU_COMPILE
+      }
+
+      const typename TFloat::T * pGradientAndHessian = 
+         aGradientsAndHessians + ((bHessian ? iScoreBlock << 1 : iScoreBlock) << TFloat::k_cSIMDShift);
+      const typename TFloat::T * const pGradientsAndHessiansBlockEnd = 
+         pGradientsAndHessiansEnd + ((bHessian ? iScoreBlock << 1 : iScoreBlock) << TFloat::k_cSIMDShift);
+      do {
+         if(bReplication) {
+            sumOccurrences = sumOccurrences + TFloat::TInt::LoadBytes(pCountOccurrences);
+         }
+
+         TFloat weight;
+         if(bWeight) {
+            weight = TFloat::Load(pWeight);
+            pWeight += TFloat::k_cSIMDPack;
+         }
+         if(bMultiplyOccurrences) {
+            const TFloat occurrences = TFloat::LoadBytes(pCountOccurrences);
+            if(bWeight) {
+               weight *= occurrences;
+            } else {
+               weight = occurrences;
+            }
+         }
+         if(bReplication) {
+            pCountOccurrences += TFloat::k_cSIMDPack;
+         }
+         if(bWeight) {
+            sumWeight += weight;
+         }
+
+         size_t iScore = 0;
+         do {
+            if(bHessian) {
+               TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << (TFloat::k_cSIMDShift + 1)]);
+               TFloat hessian = TFloat::Load(&pGradientAndHessian[(iScore << (TFloat::k_cSIMDShift + 1)) + TFloat::k_cSIMDPack]);
+               if(bApplyWeight) {
+                  gradient *= weight;
+                  hessian *= weight;
+               }
+               aSumGradients[iScore] += gradient;
+               aSumHessians[iScore] += hessian;
+            } else {
+               TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << TFloat::k_cSIMDShift]);
+               if(bApplyWeight) {
+                  gradient *= weight;
+               }
+               aSumGradients[iScore] += gradient;
+            }
+            ++iScore;
+         } while(cScoresBlock != iScore);
+
+         pGradientAndHessian += cItemsPerSample << TFloat::k_cSIMDShift;
+      } while(pGradientsAndHessiansBlockEnd != pGradientAndHessian);
+
+      if(size_t { 0 } == iScoreBlock) {
+         // the counts and weights are the same for every block of scores, so only record them once
+         typename TFloat::TInt::T cSamplesBin;
+         if(bReplication) {
+            cSamplesBin = 0;
+            TFloat::TInt::Execute([&cSamplesBin](int, const typename TFloat::TInt::T x) {
+               cSamplesBin += x;
+            }, sumOccurrences);
+         } else {
+            cSamplesBin = static_cast<typename TFloat::TInt::T>(cSamples);
+         }
+         AddCountSamples(pBin, cSamplesBin);
+
+         if(bWeight) {
+            AddWeight(pBin, Sum(sumWeight));
+         }
+      }
+
+      for(size_t iScore = 0; iScore < cScoresBlock; ++iScore) {
+         auto * const pGradientPair = &aGradientPair[iScoreBlock + iScore];
+         pGradientPair->m_sumGradients += Sum(aSumGradients[iScore]);
+         if(bHessian) {
+            pGradientPair->SetHess(pGradientPair->GetHess() + Sum(aSumHessians[iScore]));
+         }
+      }
+
+      iScoreBlock += cScoresBlock;
+   } while(cScores != iScoreBlock);
+}
+
+template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, 
+   bool bMultiplyOccurrences, int cCompilerPack>
 GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridge * const pParams) {
-   static_assert(bWeight || !bReplication, "bReplication cannot be true if bWeight is false");
-
-   // TODO: we can improve the zero dimensional scenario quite a bit because we know that all the scores added will
-   // eventually be added into the same bin.  Instead of adding the gradients & hessians & weights & counts from
-   // each sample to the bin in order, we can just add those values together for all samples in SIMD variables
-   // and then add the totals into the bins. We probably want to write a completely separate function for handling
-   // it this way though.
-   static constexpr bool bCompilerZeroDimensional = k_cItemsPerBitPackNone == cCompilerPack;
+   static_assert(bWeight || !bReplication || bMultiplyOccurrences, 
+      "bReplication cannot be true if bWeight is false unless the weights come from the occurrences");
+   static_assert(bReplication || !bMultiplyOccurrences, "bMultiplyOccurrences requires bReplication");
+   static_assert(k_cItemsPerBitPackNone != cCompilerPack, "the zero dimensional case uses BinSumsBoostingZeroDimensional");
+
+   if(BinSumsBoostingLanes<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, cCompilerPack>::Func(pParams)) {
+      return;
+   }
+
+   static constexpr bool bApplyWeight = bWeight || bMultiplyOccurrences;
    static constexpr size_t cArrayScores = GetArrayScores(cCompilerScores);
 
 #ifndef GPU_COMPILE
@@ -43,60 +412,50 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
 
    const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pParams->m_cScores);
 
-   auto * const aBins = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores>();
+   auto * const aBins = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, FastBinUInt<TFloat, bWeight>, bHessian, cArrayScores>();
 
    const size_t cSamples = pParams->m_cSamples;
 
    const typename TFloat::T * pGradientAndHessian = reinterpret_cast<const typename TFloat::T *>(pParams->m_aGradientsAndHessians);
    const typename TFloat::T * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cScores * cSamples;
 
-   typename TFloat::TInt::T cBytesPerBin;
-   int cBitsPerItemMax;
-   int cShift;
-   int cShiftReset;
-   typename TFloat::TInt maskBits;
-   const typename TFloat::TInt::T * pInputData;
-
-   if(!bCompilerZeroDimensional) {
-      cBytesPerBin = static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, cScores));
+   const typename TFloat::TInt::T cBytesPerBin = static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, FastBinUInt<TFloat, bWeight>>(bHessian, cScores));
 
-      const int cItemsPerBitPack = GET_ITEMS_PER_BIT_PACK(cCompilerPack, pParams->m_cPack);
+   const int cItemsPerBitPack = GET_ITEMS_PER_BIT_PACK(cCompilerPack, pParams->m_cPack);
 #ifndef GPU_COMPILE
-      EBM_ASSERT(k_cItemsPerBitPackNone != cItemsPerBitPack); // we require this condition to be templated
-      EBM_ASSERT(1 <= cItemsPerBitPack);
-      EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(typename TFloat::TInt::T));
+   EBM_ASSERT(1 <= cItemsPerBitPack);
+   EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(typename TFloat::TInt::T));
 #endif // GPU_COMPILE
 
-      cBitsPerItemMax = GetCountBits<typename TFloat::TInt::T>(cItemsPerBitPack);
+   const int cBitsPerItemMax = GetCountBits<typename TFloat::TInt::T>(cItemsPerBitPack);
 #ifndef GPU_COMPILE
-      EBM_ASSERT(1 <= cBitsPerItemMax);
-      EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(typename TFloat::TInt::T));
+   EBM_ASSERT(1 <= cBitsPerItemMax);
+   EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(typename TFloat::TInt::T));
 #endif // GPU_COMPILE
 
-      cShift = static_cast<int>(((cSamples >> TFloat::k_cSIMDShift) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
-      cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+   int cShift = static_cast<int>(((cSamples >> TFloat::k_cSIMDShift) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+   const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
 
-      maskBits = MakeLowMask<typename TFloat::TInt::T>(cBitsPerItemMax);
+   const typename TFloat::TInt maskBits = MakeLowMask<typename TFloat::TInt::T>(cBitsPerItemMax);
 
-      pInputData = reinterpret_cast<const typename TFloat::TInt::T *>(pParams->m_aPacked);
+   const typename TFloat::TInt::T * pInputData = reinterpret_cast<const typename TFloat::TInt::T *>(pParams->m_aPacked);
 #ifndef GPU_COMPILE
-      EBM_ASSERT(nullptr != pInputData);
+   EBM_ASSERT(nullptr != pInputData);
 #endif // GPU_COMPILE
-   }
 
    const typename TFloat::T * pWeight;
-   const uint8_t * pCountOccurrences;
    if(bWeight) {
       pWeight = reinterpret_cast<const typename TFloat::T *>(pParams->m_aWeights);
 #ifndef GPU_COMPILE
       EBM_ASSERT(nullptr != pWeight);
 #endif // GPU_COMPILE
-      if(bReplication) {
-         pCountOccurrences = pParams->m_pCountOccurrences;
+   }
+   const uint8_t * pCountOccurrences;
+   if(bReplication) {
+      pCountOccurrences = pParams->m_pCountOccurrences;
 #ifndef GPU_COMPILE
-         EBM_ASSERT(nullptr != pCountOccurrences);
+      EBM_ASSERT(nullptr != pCountOccurrences);
 #endif // GPU_COMPILE
-      }
    }
 
    do {
@@ -112,119 +471,69 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
       //   (8 times) or the uint64_t level.  This can be done without branching and doesn't require random number generators
 
       // we store the already multiplied dimensional value in *pInputData
-      typename TFloat::TInt iTensorBinCombined;
-      if(!bCompilerZeroDimensional) {
-         iTensorBinCombined = TFloat::TInt::Load(pInputData);
-         pInputData += TFloat::TInt::k_cSIMDPack;
-      }
+      const typename TFloat::TInt iTensorBinCombined = TFloat::TInt::Load(pInputData);
+      pInputData += TFloat::TInt::k_cSIMDPack;
       while(true) {
-         Bin<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores> * apBins[TFloat::k_cSIMDPack];
-         if(!bCompilerZeroDimensional) {
-            typename TFloat::TInt iTensorBin = (iTensorBinCombined >> cShift) & maskBits;
-            
-            // normally the compiler is better at optimimizing multiplications into shifs, but it isn't better
-            // if TFloat is a SIMD type. For SIMD shifts & adds will almost always be better than multiplication if
-            // there are low numbers of shifts, which should be the case for anything with a compile time constant here
-            iTensorBin = Multiply<typename TFloat::TInt, typename TFloat::TInt::T, 
-               k_dynamicScores != cCompilerScores && 1 != TFloat::k_cSIMDPack, 
-               static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, cCompilerScores))>(
-                  iTensorBin, cBytesPerBin);
-            
-            TFloat::TInt::Execute([aBins, &apBins](const int i, const typename TFloat::TInt::T x) {
-               apBins[i] = IndexBin(aBins, static_cast<size_t>(x));
-            }, iTensorBin);
+         Bin<typename TFloat::T, FastBinUInt<TFloat, bWeight>, bHessian, cArrayScores> * apBins[TFloat::k_cSIMDPack];
+         typename TFloat::TInt iTensorBin = (iTensorBinCombined >> cShift) & maskBits;
+         
+         // normally the compiler is better at optimimizing multiplications into shifs, but it isn't better
+         // if TFloat is a SIMD type. For SIMD shifts & adds will almost always be better than multiplication if
+         // there are low numbers of shifts, which should be the case for anything with a compile time constant here
+         iTensorBin = Multiply<typename TFloat::TInt, typename TFloat::TInt::T, 
+            k_dynamicScores != cCompilerScores && 1 != TFloat::k_cSIMDPack, 
+            static_cast<typename TFloat::TInt::T>(GetBinSize<typename TFloat::T, FastBinUInt<TFloat, bWeight>>(bHessian, cCompilerScores))>(
+               iTensorBin, cBytesPerBin);
+         
+         TFloat::TInt::Execute([aBins, &apBins](const int i, const typename TFloat::TInt::T x) {
+            apBins[i] = IndexBin(aBins, static_cast<size_t>(x));
+         }, iTensorBin);
 #ifndef NDEBUG
 #ifndef GPU_COMPILE
-            TFloat::Execute([cBytesPerBin, apBins, pParams](const int i) {
-               ASSERT_BIN_OK(cBytesPerBin, apBins[i], pParams->m_pDebugFastBinsEnd);
-            });
+         TFloat::Execute([cBytesPerBin, apBins, pParams](const int i) {
+            ASSERT_BIN_OK(cBytesPerBin, apBins[i], pParams->m_pDebugFastBinsEnd);
+         });
 #endif // GPU_COMPILE
 #endif // NDEBUG
-         }
 
-         // TODO: the ultimate version of this algorithm would:
-         //   1) Write to k_cSIMDPack histograms simutaneously to avoid collisions of indexes
-         //   2) Sum up the final histograms using SIMD operations in parallel.  If we hvae k_cSIMDPack
-         //      histograms, then we're prefectly suited to sum them, and integers and float32 values shouldn't
-         //      have issues since we stay well away from 2^32 integers, and the float values don't have addition
-         //      issues anymore (where you can't add a 1 to more than 16 million floats)
-         //   3) Only do the above if there aren't too many bins. If we put each sample into it's own bin
-         //      for a feature, then we should prefer using this version that keeps only 1 histogram
+         // if there are few enough bins, SIMD zones use BinSumsBoostingLanes instead, which avoids
+         // the lane collisions that force the serialized updates below
 
          if(bReplication) {
             const typename TFloat::TInt cOccurences = TFloat::TInt::LoadBytes(pCountOccurrences);
-            pCountOccurrences += TFloat::k_cSIMDPack;
 
-            if(!bCompilerZeroDimensional) {
-               TFloat::TInt::Execute([apBins](const int i, const typename TFloat::TInt::T x) {
-                  auto * const pBin = apBins[i];
-                  // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-                  //       such that we can remove that field optionally
-                  pBin->SetCountSamples(pBin->GetCountSamples() + x);
-               }, cOccurences);
-            } else {
-               TFloat::TInt::Execute([aBins](int, const typename TFloat::TInt::T x) {
-                  auto * const pBin = aBins;
-                  // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-                  //       such that we can remove that field optionally
-                  pBin->SetCountSamples(pBin->GetCountSamples() + x);
-               }, cOccurences);
-            }
+            TFloat::TInt::Execute([apBins](const int i, const typename TFloat::TInt::T x) {
+               AddCountSamples(apBins[i], x);
+            }, cOccurences);
          } else {
-            if(!bCompilerZeroDimensional) {
-               TFloat::Execute([apBins](const int i) {
-                  auto * const pBin = apBins[i];
-                  // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-                  //       such that we can remove that field optionally
-                  pBin->SetCountSamples(pBin->GetCountSamples() + typename TFloat::TInt::T { 1 });
-               });
-            } else {
-               TFloat::Execute([aBins](int) {
-                  auto * const pBin = aBins;
-                  // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-                  //       such that we can remove that field optionally
-                  pBin->SetCountSamples(pBin->GetCountSamples() + typename TFloat::TInt::T { 1 });
-               });
-            }
+            TFloat::Execute([apBins](const int i) {
+               AddCountSamples(apBins[i], typename TFloat::TInt::T { 1 });
+            });
          }
 
          TFloat weight;
          if(bWeight) {
             weight = TFloat::Load(pWeight);
             pWeight += TFloat::k_cSIMDPack;
-
-            if(!bCompilerZeroDimensional) {
-               TFloat::Execute([apBins](const int i, const typename TFloat::T x) {
-                  auto * const pBin = apBins[i];
-                  // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-                  //       such that we can remove that field optionally
-                  pBin->SetWeight(pBin->GetWeight() + x);
-               }, weight);
-            } else {
-               TFloat::Execute([aBins](int, const typename TFloat::T x) {
-                  auto * const pBin = aBins;
-                  // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-                  //       such that we can remove that field optionally
-                  pBin->SetWeight(pBin->GetWeight() + x);
-               }, weight);
-            }
-         } else {
-            if(!bCompilerZeroDimensional) {
-               TFloat::Execute([apBins](const int i) {
-                  auto * const pBin = apBins[i];
-                  // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-                  //       such that we can remove that field optionally
-                  pBin->SetWeight(pBin->GetWeight() + typename TFloat::T { 1.0 });
-               });
+         }
+         if(bMultiplyOccurrences) {
+            const TFloat occurrences = TFloat::LoadBytes(pCountOccurrences);
+            if(bWeight) {
+               weight *= occurrences;
             } else {
-               TFloat::Execute([aBins](int) {
-                  auto * const pBin = aBins;
-                  // TODO: In the future we'd like to eliminate this but we need the ability to change the Bin class
-                  //       such that we can remove that field optionally
-                  pBin->SetWeight(pBin->GetWeight() + typename TFloat::T { 1.0 });
-               });
+               weight = occurrences;
             }
          }
+         if(bReplication) {
+            pCountOccurrences += TFloat::k_cSIMDPack;
+         }
+
+         if(bWeight) {
+            // without weights the bins have no m_weight field and ConvertAddBin derives the weight from the count
+            TFloat::Execute([apBins](const int i, const typename TFloat::T x) {
+               AddWeight(apBins[i], x);
+            }, weight);
+         }
 
          // TODO: we probably want a templated version of this function for Bins with only 1 cScore so that
          //       we don't have a loop here, which will mean that the cCompilerPack will be the only loop which
@@ -232,132 +541,118 @@ GPU_DEVICE NEVER_INLINE static void BinSumsBoostingInternal(BinSumsBoostingBridg
 
          size_t iScore = 0;
          do {
-            if(!bCompilerZeroDimensional) {
-               if(bHessian) {
-                  TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << (TFloat::k_cSIMDShift + 1)]);
-                  TFloat hessian = TFloat::Load(&pGradientAndHessian[(iScore << (TFloat::k_cSIMDShift + 1)) + TFloat::k_cSIMDPack]);
-                  if(bWeight) {
-                     gradient *= weight;
-                     hessian *= weight;
-                  }
-                  TFloat::Execute([apBins, iScore](const int i, const typename TFloat::T grad, const typename TFloat::T hess) {
-                     // BEWARE: unless we generate a separate histogram for each SIMD stream and later merge them, pBin can 
-                     // point to the same bin in multiple samples within the SIMD pack, so we need to serialize fetching sums
-                     auto * const pBin = apBins[i];
-                     auto * const aGradientPair = pBin->GetGradientPairs();
-                     auto * const pGradientPair = &aGradientPair[iScore];
-                     typename TFloat::T binGrad = pGradientPair->m_sumGradients;
-                     typename TFloat::T binHess = pGradientPair->GetHess();
-                     binGrad += grad;
-                     binHess += hess;
-                     pGradientPair->m_sumGradients = binGrad;
-                     pGradientPair->SetHess(binHess);
-                  }, gradient, hessian);
-               } else {
-                  TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << TFloat::k_cSIMDShift]);
-                  if(bWeight) {
-                     gradient *= weight;
-                  }
-                  TFloat::Execute([apBins, iScore](const int i, const typename TFloat::T grad) {
-                     // TODO: for this special case of having just 1 bin, we could sum all the gradients and hessians
-                     // before then adding them to the only bin
-                     auto * const pBin = apBins[i];
-                     auto * const aGradientPair = pBin->GetGradientPairs();
-                     auto * const pGradientPair = &aGradientPair[iScore];
-                     pGradientPair->m_sumGradients += grad;
-                  }, gradient);
+            if(bHessian) {
+               TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << (TFloat::k_cSIMDShift + 1)]);
+               TFloat hessian = TFloat::Load(&pGradientAndHessian[(iScore << (TFloat::k_cSIMDShift + 1)) + TFloat::k_cSIMDPack]);
+               if(bApplyWeight) {
+                  gradient *= weight;
+                  hessian *= weight;
                }
+               TFloat::Execute([apBins, iScore](const int i, const typename TFloat::T grad, const typename TFloat::T hess) {
+                  // BEWARE: unless we generate a separate histogram for each SIMD stream and later merge them, pBin can 
+                  // point to the same bin in multiple samples within the SIMD pack, so we need to serialize fetching sums
+                  auto * const pBin = apBins[i];
+                  auto * const aGradientPair = pBin->GetGradientPairs();
+                  auto * const pGradientPair = &aGradientPair[iScore];
+                  typename TFloat::T binGrad = pGradientPair->m_sumGradients;
+                  typename TFloat::T binHess = pGradientPair->GetHess();
+                  binGrad += grad;
+                  binHess += hess;
+                  pGradientPair->m_sumGradients = binGrad;
+                  pGradientPair->SetHess(binHess);
+               }, gradient, hessian);
             } else {
-               if(bHessian) {
-                  TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << (TFloat::k_cSIMDShift + 1)]);
-                  TFloat hessian = TFloat::Load(&pGradientAndHessian[(iScore << (TFloat::k_cSIMDShift + 1)) + TFloat::k_cSIMDPack]);
-                  if(bWeight) {
-                     gradient *= weight;
-                     hessian *= weight;
-                  }
-                  TFloat::Execute([aBins, iScore](int, const typename TFloat::T grad, const typename TFloat::T hess) {
-                     // BEWARE: unless we generate a separate histogram for each SIMD stream and later merge them, pBin can 
-                     // point to the same bin in multiple samples within the SIMD pack, so we need to serialize fetching sums
-                     auto * const pBin = aBins;
-                     auto * const aGradientPair = pBin->GetGradientPairs();
-                     auto * const pGradientPair = &aGradientPair[iScore];
-                     typename TFloat::T binGrad = pGradientPair->m_sumGradients;
-                     typename TFloat::T binHess = pGradientPair->GetHess();
-                     binGrad += grad;
-                     binHess += hess;
-                     pGradientPair->m_sumGradients = binGrad;
-                     pGradientPair->SetHess(binHess);
-                  }, gradient, hessian);
-               } else {
-                  TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << TFloat::k_cSIMDShift]);
-                  if(bWeight) {
-                     gradient *= weight;
-                  }
-                  TFloat::Execute([aBins, iScore](int, const typename TFloat::T grad) {
-                     // TODO: for this special case of having just 1 bin, we could sum all the gradients and hessians
-                     // before then adding them to the only bin
-                     auto * const pBin = aBins;
-                     auto * const aGradientPair = pBin->GetGradientPairs();
-                     auto * const pGradientPair = &aGradientPair[iScore];
-                     pGradientPair->m_sumGradients += grad;
-                  }, gradient);
+               TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << TFloat::k_cSIMDShift]);
+               if(bApplyWeight) {
+                  gradient *= weight;
                }
+               TFloat::Execute([apBins, iScore](const int i, const typename TFloat::T grad) {
+                  auto * const pBin = apBins[i];
+                  auto * const aGradientPair = pBin->GetGradientPairs();
+                  auto * const pGradientPair = &aGradientPair[iScore];
+                  pGradientPair->m_sumGradients += grad;
+               }, gradient);
             }
             ++iScore;
          } while(cScores != iScore);
 
          pGradientAndHessian += cScores << (bHessian ? (TFloat::k_cSIMDShift + 1) : TFloat::k_cSIMDShift);
 
-         if(bCompilerZeroDimensional) {
-            if(pGradientsAndHessiansEnd == pGradientAndHessian) {
-               break;
-            }
-         } else {
-            cShift -= cBitsPerItemMax;
-            if(cShift < 0) {
-               break;
-            }
+         cShift -= cBitsPerItemMax;
+         if(cShift < 0) {
+            break;
          }
       }
-      if(bCompilerZeroDimensional) {
-         break;
-      }
       cShift = cShiftReset;
    } while(pGradientsAndHessiansEnd != pGradientAndHessian);
 }
 
-template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, int cCompilerPack>
+// the zero dimensional case is not bit packed and gets its own kernel
+template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, 
+   bool bMultiplyOccurrences, int cCompilerPack>
+struct BinSumsBoostingPack final {
+   GPU_DEVICE INLINE_ALWAYS static void Func(BinSumsBoostingBridge * const pParams) {
+      BinSumsBoostingInternal<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, cCompilerPack>(pParams);
+   }
+};
+template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, 
+   bool bMultiplyOccurrences>
+struct BinSumsBoostingPack<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, k_cItemsPerBitPackNone> final {
+   GPU_DEVICE INLINE_ALWAYS static void Func(BinSumsBoostingBridge * const pParams) {
+      BinSumsBoostingZeroDimensional<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences>(pParams);
+   }
+};
+
+template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, 
+   bool bMultiplyOccurrences, int cCompilerPack>
 GPU_GLOBAL static void RemoteBinSumsBoosting(BinSumsBoostingBridge * const pParams) {
-   BinSumsBoostingInternal<TFloat, bHessian, cCompilerScores, bWeight, bReplication, cCompilerPack>(pParams);
+   BinSumsBoostingPack<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, cCompilerPack>::Func(pParams);
 }
 
-template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, int cCompilerPack>
+template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, 
+   bool bMultiplyOccurrences, int cCompilerPack>
 INLINE_RELEASE_TEMPLATED ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) {
-   return TFloat::template OperatorBinSumsBoosting<bHessian, cCompilerScores, bWeight, bReplication, cCompilerPack>(pParams);
+   return TFloat::template OperatorBinSumsBoosting<bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, cCompilerPack>(pParams);
 }
 
-template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication>
+template<typename TFloat, bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, 
+   bool bMultiplyOccurrences>
 INLINE_RELEASE_TEMPLATED static ErrorEbm BitPackBoosting(BinSumsBoostingBridge * const pParams) {
    if(k_cItemsPerBitPackNone != pParams->m_cPack) {
-      return OperatorBinSumsBoosting<TFloat, bHessian, cCompilerScores, bWeight, bReplication, k_cItemsPerBitPackDynamic>(pParams);
+      return OperatorBinSumsBoosting<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, k_cItemsPerBitPackDynamic>(pParams);
    } else {
       // this needs to be special cased because otherwise we would inject comparisons into the dynamic version
-      return OperatorBinSumsBoosting<TFloat, bHessian, cCompilerScores, bWeight, bReplication, k_cItemsPerBitPackNone>(pParams);
+      return OperatorBinSumsBoosting<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, k_cItemsPerBitPackNone>(pParams);
    }
 }
 
 
 template<typename TFloat, bool bHessian, size_t cCompilerScores>
 INLINE_RELEASE_TEMPLATED static ErrorEbm FinalOptionsBoosting(BinSumsBoostingBridge * const pParams) {
+   if(EBM_FALSE != pParams->m_bMultiplyOccurrences) {
+      // compact inner bags keep only the occurrence counts per bag, so we derive the bag weights here
+      EBM_ASSERT(nullptr != pParams->m_pCountOccurrences);
+      static constexpr bool bReplication = true;
+      static constexpr bool bMultiplyOccurrences = true;
+      if(nullptr != pParams->m_aWeights) {
+         static constexpr bool bWeight = true;
+         return BitPackBoosting<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences>(pParams);
+      } else {
+         static constexpr bool bWeight = false;
+         return BitPackBoosting<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences>(pParams);
+      }
+   }
+
+   static constexpr bool bMultiplyOccurrences = false;
    if(nullptr != pParams->m_aWeights) {
       static constexpr bool bWeight = true;
 
       if(nullptr != pParams->m_pCountOccurrences) {
          static constexpr bool bReplication = true;
-         return BitPackBoosting<TFloat, bHessian, cCompilerScores, bWeight, bReplication>(pParams);
+         return BitPackBoosting<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences>(pParams);
       } else {
          static constexpr bool bReplication = false;
-         return BitPackBoosting<TFloat, bHessian, cCompilerScores, bWeight, bReplication>(pParams);
+         return BitPackBoosting<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences>(pParams);
       }
    } else {
       static constexpr bool bWeight = false;
@@ -366,7 +661,7 @@ INLINE_RELEASE_TEMPLATED static ErrorEbm FinalOptionsBoosting(BinSumsBoostingBri
       EBM_ASSERT(nullptr == pParams->m_pCountOccurrences);
       static constexpr bool bReplication = false;
 
-      return BitPackBoosting<TFloat, bHessian, cCompilerScores, bWeight, bReplication>(pParams);
+      return BitPackBoosting<TFloat, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences>(pParams);
    }
 }
 
@@ -268,9 +268,241 @@ GPU_DEVICE NEVER_INLINE static void BinSumsInteractionInternal(BinSumsInteractio
 }
 WARNING_POP
 
+// BinSumsInteractionPairs is reached through OperatorBinSumsInteraction with k_cDimensionsPairs + cPairs in place
+// of the dimension count, which can never be mistaken for a real dimension count
+static constexpr size_t k_cDimensionsPairs = k_cDimensionsMax;
+
+// Bins BinSumsInteractionBridge::m_cPairs pair tensors in one pass over the samples, so the gradients, hessians and
+// weights are read once for all of the pairs instead of once per pair. Each bin receives its samples in the same
+// order as BinSumsInteractionInternal would give them, so the sums are identical to binning each pair separately.
+WARNING_PUSH
+WARNING_DISABLE_UNINITIALIZED_MEMBER_VARIABLE
+template<typename TFloat, bool bHessian, size_t cCompilerScores, size_t cCompilerPairs, bool bWeight>
+GPU_DEVICE NEVER_INLINE static void BinSumsInteractionPairs(BinSumsInteractionBridge * const pParams) {
+   static_assert(2 <= cCompilerPairs && cCompilerPairs <= k_cPairsPerPassMax, "cCompilerPairs out of range");
+   static constexpr size_t cArrayScores = GetArrayScores(cCompilerScores);
+   static constexpr size_t cDimensions = cCompilerPairs * size_t { 2 };
+
+#ifndef GPU_COMPILE
+   EBM_ASSERT(nullptr != pParams);
+   EBM_ASSERT(1 <= pParams->m_cSamples);
+   EBM_ASSERT(0 == pParams->m_cSamples % size_t { TFloat::k_cSIMDPack });
+   EBM_ASSERT(nullptr != pParams->m_aGradientsAndHessians);
+   EBM_ASSERT(nullptr != pParams->m_aFastBins);
+   EBM_ASSERT(k_dynamicScores == cCompilerScores || cCompilerScores == pParams->m_cScores);
+   EBM_ASSERT(cCompilerPairs == pParams->m_cPairs);
+   EBM_ASSERT(cDimensions == pParams->m_cRuntimeRealDimensions);
+#endif // GPU_COMPILE
+
+   const size_t cScores = GET_COUNT_SCORES(cCompilerScores, pParams->m_cScores);
+
+   auto * const aBins = reinterpret_cast<BinBase *>(pParams->m_aFastBins)->Specialize<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores>();
+
+   const size_t cSamples = pParams->m_cSamples;
+
+   const typename TFloat::T * pGradientAndHessian = reinterpret_cast<const typename TFloat::T *>(pParams->m_aGradientsAndHessians);
+   const typename TFloat::T * const pGradientsAndHessiansEnd = pGradientAndHessian + (bHessian ? size_t { 2 } : size_t { 1 }) * cScores * cSamples;
+
+   struct alignas(EbmMax(alignof(typename TFloat::TInt), alignof(void *), alignof(size_t), alignof(int))) DimensionalData {
+      int m_cShift;
+      int m_cBitsPerItemMax;
+      int m_cShiftReset;
+      const typename TFloat::TInt::T * m_pData;
+#ifndef NDEBUG
+      size_t m_cBins;
+#endif // NDEBUG
+
+      typename TFloat::TInt iBinCombined;
+      typename TFloat::TInt maskBits;
+   };
+
+   const size_t cBytesPerBin = GetBinSize<typename TFloat::T, typename TFloat::TInt::T>(bHessian, cScores);
+
+   // this is on the stack and the compiler should be able to optimize these as if they were variables or registers
+   DimensionalData aDimensionalData[cDimensions];
+   Bin<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores> * aaPairBins[cCompilerPairs];
+   size_t acBytesStride1[cCompilerPairs];
+
+   auto * pPairBins = aBins;
+   size_t iDimensionInit = 0;
+   do {
+      DimensionalData * const pDimensionalData = &aDimensionalData[iDimensionInit];
+
+      const typename TFloat::TInt::T * const pData = reinterpret_cast<const typename TFloat::TInt::T *>(pParams->m_aaPacked[iDimensionInit]);
+      pDimensionalData->iBinCombined = TFloat::TInt::Load(pData);
+      pDimensionalData->m_pData = pData + TFloat::TInt::k_cSIMDPack;
+
+      const int cItemsPerBitPack = pParams->m_acItemsPerBitPack[iDimensionInit];
+#ifndef GPU_COMPILE
+      EBM_ASSERT(1 <= cItemsPerBitPack);
+      EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(typename TFloat::TInt::T));
+#endif // GPU_COMPILE
+
+      const int cBitsPerItemMax = GetCountBits<typename TFloat::TInt::T>(cItemsPerBitPack);
+      pDimensionalData->m_cBitsPerItemMax = cBitsPerItemMax;
+      pDimensionalData->m_cShift = (static_cast<int>(((cSamples >> TFloat::k_cSIMDShift) - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) + 1) * cBitsPerItemMax;
+      pDimensionalData->m_cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+      pDimensionalData->maskBits = MakeLowMask<typename TFloat::TInt::T>(cBitsPerItemMax);
+#ifndef NDEBUG
+      pDimensionalData->m_cBins = pParams->m_acBins[iDimensionInit];
+#endif // NDEBUG
+
+      if(size_t { 1 } == (iDimensionInit & size_t { 1 })) {
+         const size_t cBins0 = pParams->m_acBins[iDimensionInit - size_t { 1 }];
+         const size_t cBins1 = pParams->m_acBins[iDimensionInit];
+#ifndef GPU_COMPILE
+         EBM_ASSERT(size_t { 2 } <= cBins0);
+         EBM_ASSERT(size_t { 2 } <= cBins1);
+#endif // GPU_COMPILE
+         const size_t iPair = iDimensionInit >> 1;
+         aaPairBins[iPair] = pPairBins;
+         acBytesStride1[iPair] = cBytesPerBin * cBins0;
+         pPairBins = IndexBin(pPairBins, cBytesPerBin * cBins0 * cBins1);
+      }
+
+      ++iDimensionInit;
+   } while(cDimensions != iDimensionInit);
+
+#ifndef NDEBUG
+#ifndef GPU_COMPILE
+   EBM_ASSERT(reinterpret_cast<const void *>(pPairBins) <= pParams->m_pDebugFastBinsEnd);
+#endif // GPU_COMPILE
+#endif // NDEBUG
+
+   const typename TFloat::T * pWeight;
+   if(bWeight) {
+      pWeight = reinterpret_cast<const typename TFloat::T *>(pParams->m_aWeights);
+#ifndef GPU_COMPILE
+      EBM_ASSERT(nullptr != pWeight);
+#endif // GPU_COMPILE
+   }
+
+   while(true) {
+      typename TFloat::TInt aiBins[cDimensions];
+
+      size_t iDimension = 0;
+      do {
+         DimensionalData * const pDimensionalData = &aDimensionalData[iDimension];
+
+         const int shift = pDimensionalData->m_cShift - pDimensionalData->m_cBitsPerItemMax;
+         pDimensionalData->m_cShift = shift;
+         if(shift < 0) {
+            if(size_t { 0 } == iDimension && pGradientsAndHessiansEnd == pGradientAndHessian) {
+               // we only need to check this for the first dimension since all dimensions will reach
+               // this point simultaneously
+               return;
+            }
+            const typename TFloat::TInt::T * const pData = pDimensionalData->m_pData;
+            pDimensionalData->iBinCombined = TFloat::TInt::Load(pData);
+            pDimensionalData->m_pData = pData + TFloat::TInt::k_cSIMDPack;
+            pDimensionalData->m_cShift = pDimensionalData->m_cShiftReset;
+         }
+
+         const typename TFloat::TInt iBin = (pDimensionalData->iBinCombined >> pDimensionalData->m_cShift) & pDimensionalData->maskBits;
+#ifndef NDEBUG
+#ifndef GPU_COMPILE
+         const size_t cBins = pDimensionalData->m_cBins;
+         TFloat::TInt::Execute([cBins](int, const typename TFloat::TInt::T x) {
+            EBM_ASSERT(static_cast<size_t>(x) < cBins);
+         }, iBin);
+#endif // GPU_COMPILE
+#endif // NDEBUG
+         aiBins[iDimension] = iBin;
+
+         ++iDimension;
+      } while(cDimensions != iDimension);
+
+      TFloat weight;
+      if(bWeight) {
+         weight = TFloat::Load(pWeight);
+         pWeight += TFloat::k_cSIMDPack;
+      }
+
+      size_t iPair = 0;
+      do {
+         Bin<typename TFloat::T, typename TFloat::TInt::T, bHessian, cArrayScores> * apBins[TFloat::k_cSIMDPack];
+         auto * const aPairBins = aaPairBins[iPair];
+         TFloat::TInt::Execute([&apBins, aPairBins, cBytesPerBin](const int i, const typename TFloat::TInt::T x) {
+            apBins[i] = IndexByte(aPairBins, static_cast<size_t>(x) * cBytesPerBin);
+         }, aiBins[iPair << 1]);
+         const size_t cBytesStride1 = acBytesStride1[iPair];
+         TFloat::TInt::Execute([&apBins, cBytesStride1](const int i, const typename TFloat::TInt::T x) {
+            apBins[i] = IndexByte(apBins[i], static_cast<size_t>(x) * cBytesStride1);
+         }, aiBins[(iPair << 1) + size_t { 1 }]);
+
+         TFloat::Execute([apBins](const int i) {
+            auto * const pBin = apBins[i];
+            pBin->SetCountSamples(pBin->GetCountSamples() + typename TFloat::TInt::T { 1 });
+         });
+
+         if(bWeight) {
+            TFloat::Execute([apBins](const int i, const typename TFloat::T x) {
+               auto * const pBin = apBins[i];
+               pBin->SetWeight(pBin->GetWeight() + x);
+            }, weight);
+         } else {
+            TFloat::Execute([apBins](const int i) {
+               auto * const pBin = apBins[i];
+               pBin->SetWeight(pBin->GetWeight() + typename TFloat::T { 1.0 });
+            });
+         }
+
+         // only the first pair reads the gradients from memory. The other pairs find them in the cache
+         size_t iScore = 0;
+         do {
+            if(bHessian) {
+               const TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << (TFloat::k_cSIMDShift + 1)]);
+               const TFloat hessian = TFloat::Load(&pGradientAndHessian[(iScore << (TFloat::k_cSIMDShift + 1)) + TFloat::k_cSIMDPack]);
+               TFloat::Execute([apBins, iScore](const int i, const typename TFloat::T grad, const typename TFloat::T hess) {
+                  // pBin can point to the same bin in multiple samples within the SIMD pack, so serialize the sums
+                  auto * const pBin = apBins[i];
+                  auto * const aGradientPair = pBin->GetGradientPairs();
+                  auto * const pGradientPair = &aGradientPair[iScore];
+                  typename TFloat::T binGrad = pGradientPair->m_sumGradients;
+                  typename TFloat::T binHess = pGradientPair->GetHess();
+                  binGrad += grad;
+                  binHess += hess;
+                  pGradientPair->m_sumGradients = binGrad;
+                  pGradientPair->SetHess(binHess);
+               }, gradient, hessian);
+            } else {
+               const TFloat gradient = TFloat::Load(&pGradientAndHessian[iScore << TFloat::k_cSIMDShift]);
+               TFloat::Execute([apBins, iScore](const int i, const typename TFloat::T grad) {
+                  auto * const pBin = apBins[i];
+                  auto * const aGradientPair = pBin->GetGradientPairs();
+                  auto * const pGradientPair = &aGradientPair[iScore];
+                  pGradientPair->m_sumGradients += grad;
+               }, gradient);
+            }
+            ++iScore;
+         } while(cScores != iScore);
+
+         ++iPair;
+      } while(cCompilerPairs != iPair);
+
+      pGradientAndHessian += cScores << (bHessian ? (TFloat::k_cSIMDShift + 1) : TFloat::k_cSIMDShift);
+   }
+}
+WARNING_POP
+
+// the pair passes are not a dimension count and get their own kernel
+template<typename TFloat, bool bHessian, size_t cCompilerScores, size_t cCompilerDimensions, bool bWeight, 
+   bool bPairs = k_cDimensionsPairs < cCompilerDimensions>
+struct BinSumsInteractionDimensions final {
+   GPU_DEVICE INLINE_ALWAYS static void Func(BinSumsInteractionBridge * const pParams) {
+      BinSumsInteractionInternal<TFloat, bHessian, cCompilerScores, cCompilerDimensions, bWeight>(pParams);
+   }
+};
+template<typename TFloat, bool bHessian, size_t cCompilerScores, size_t cCompilerDimensions, bool bWeight>
+struct BinSumsInteractionDimensions<TFloat, bHessian, cCompilerScores, cCompilerDimensions, bWeight, true> final {
+   GPU_DEVICE INLINE_ALWAYS static void Func(BinSumsInteractionBridge * const pParams) {
+      BinSumsInteractionPairs<TFloat, bHessian, cCompilerScores, cCompilerDimensions - k_cDimensionsPairs, bWeight>(pParams);
+   }
+};
+
 template<typename TFloat, bool bHessian, size_t cCompilerScores, size_t cCompilerDimensions, bool bWeight>
 GPU_GLOBAL static void RemoteBinSumsInteraction(BinSumsInteractionBridge * const pParams) {
-   BinSumsInteractionInternal<TFloat, bHessian, cCompilerScores, cCompilerDimensions, bWeight>(pParams);
+   BinSumsInteractionDimensions<TFloat, bHessian, cCompilerScores, cCompilerDimensions, bWeight>::Func(pParams);
 }
 
 template<typename TFloat, bool bHessian, size_t cCompilerScores, size_t cCompilerDimensions, bool bWeight>
@@ -325,6 +557,19 @@ struct CountClassesInteraction<TFloat, bHessian, k_cCompilerScoresMax + 1> final
    }
 };
 
+template<typename TFloat, bool bHessian, size_t cCompilerScores>
+INLINE_RELEASE_TEMPLATED static ErrorEbm PairsInteraction(BinSumsInteractionBridge * const pParams) {
+   static_assert(4 == k_cPairsPerPassMax, "update the dispatch below");
+   if(size_t { 2 } == pParams->m_cPairs) {
+      return FinalOptionsInteraction<TFloat, bHessian, cCompilerScores, k_cDimensionsPairs + 2>(pParams);
+   } else if(size_t { 3 } == pParams->m_cPairs) {
+      return FinalOptionsInteraction<TFloat, bHessian, cCompilerScores, k_cDimensionsPairs + 3>(pParams);
+   } else {
+      EBM_ASSERT(size_t { 4 } == pParams->m_cPairs);
+      return FinalOptionsInteraction<TFloat, bHessian, cCompilerScores, k_cDimensionsPairs + 4>(pParams);
+   }
+}
+
 template<typename TFloat>
 INLINE_RELEASE_TEMPLATED static ErrorEbm BinSumsInteraction(BinSumsInteractionBridge * const pParams) {
    LOG_0(Trace_Verbose, "Entered BinSumsInteraction");
@@ -342,7 +587,21 @@ INLINE_RELEASE_TEMPLATED static ErrorEbm BinSumsInteraction(BinSumsInteractionBr
    ErrorEbm error;
 
    EBM_ASSERT(1 <= pParams->m_cScores);
-   if(EBM_FALSE != pParams->m_bHessian) {
+   if(size_t { 0 } != pParams->m_cPairs) {
+      if(EBM_FALSE != pParams->m_bHessian) {
+         if(size_t { 1 } != pParams->m_cScores) {
+            error = PairsInteraction<TFloat, true, k_dynamicScores>(pParams);
+         } else {
+            error = PairsInteraction<TFloat, true, k_oneScore>(pParams);
+         }
+      } else {
+         if(size_t { 1 } != pParams->m_cScores) {
+            error = PairsInteraction<TFloat, false, k_dynamicScores>(pParams);
+         } else {
+            error = PairsInteraction<TFloat, false, k_oneScore>(pParams);
+         }
+      }
+   } else if(EBM_FALSE != pParams->m_bHessian) {
       if(size_t { 1 } != pParams->m_cScores) {
          // muticlass
          error = CountClassesInteraction<TFloat, true, k_cCompilerScoresStart>::Func(pParams);
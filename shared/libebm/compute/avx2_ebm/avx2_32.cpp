@@ -43,6 +43,7 @@ struct alignas(k_cAlignment) Avx2_32_Int final {
    static_assert(std::is_same<UIntBig, T>::value || std::is_same<UIntSmall, T>::value, 
       "T must be either UIntBig or UIntSmall");
    static constexpr bool k_bCpu = false;
+   static constexpr bool k_bScatter = false;
    static constexpr int k_cSIMDShift = 3;
    static constexpr int k_cSIMDPack = 1 << k_cSIMDShift;
 
@@ -61,6 +62,28 @@ struct alignas(k_cAlignment) Avx2_32_Int final {
       _mm256_store_si256(reinterpret_cast<TPack *>(a), m_data);
    }
 
+   inline static Avx2_32_Int Load(const T * const a, const Avx2_32_Int & i) noexcept {
+      // i is treated as signed, so we should only use the lower 31 bits otherwise we'll read from memory before a
+      return Avx2_32_Int(_mm256_i32gather_epi32(reinterpret_cast<const int *>(a), i.m_data, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const Avx2_32_Int & i) const noexcept {
+      alignas(k_cAlignment) T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T vals[k_cSIMDPack];
+
+      i.Store(ints);
+      Store(vals);
+
+      a[ints[0]] = vals[0];
+      a[ints[1]] = vals[1];
+      a[ints[2]] = vals[2];
+      a[ints[3]] = vals[3];
+      a[ints[4]] = vals[4];
+      a[ints[5]] = vals[5];
+      a[ints[6]] = vals[6];
+      a[ints[7]] = vals[7];
+   }
+
    inline static Avx2_32_Int LoadBytes(const uint8_t * const a) noexcept {
       return Avx2_32_Int(_mm256_cvtepu8_epi32(_mm_loadu_si64(a)));
    }
@@ -122,6 +145,7 @@ struct alignas(k_cAlignment) Avx2_32_Float final {
    static_assert(std::is_same<FloatBig, T>::value || std::is_same<FloatSmall, T>::value,
       "T must be either FloatBig or FloatSmall");
    static constexpr bool k_bCpu = TInt::k_bCpu;
+   static constexpr bool k_bScatter = TInt::k_bScatter;
    static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
    static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
 
@@ -226,6 +250,10 @@ struct alignas(k_cAlignment) Avx2_32_Float final {
       _mm256_store_ps(a, m_data);
    }
 
+   inline static Avx2_32_Float LoadBytes(const uint8_t * const a) noexcept {
+      return Avx2_32_Float(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadu_si64(a))));
+   }
+
    inline static Avx2_32_Float Load(const T * const a, const TInt & i) noexcept {
       // i is treated as signed, so we should only use the lower 31 bits otherwise we'll read from memory before a
       return Avx2_32_Float(_mm256_i32gather_ps(a, i.m_data, sizeof(a[0])));
@@ -492,9 +520,11 @@ struct alignas(k_cAlignment) Avx2_32_Float final {
    }
 
 
-   template<bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, int cCompilerPack>
+   template<bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, bool bMultiplyOccurrences, 
+      int cCompilerPack>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
-      RemoteBinSumsBoosting<Avx2_32_Float, bHessian, cCompilerScores, bWeight, bReplication, cCompilerPack>(pParams);
+      RemoteBinSumsBoosting<Avx2_32_Float, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, 
+         cCompilerPack>(pParams);
       return Error_None;
    }
 
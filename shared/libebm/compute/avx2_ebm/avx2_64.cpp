@@ -0,0 +1,643 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <cmath> // exp, log
+#include <limits> // numeric_limits
+#include <type_traits> // is_unsigned
+#include <string.h> // memcpy
+#include <immintrin.h> // SIMD.  Do not include in precompiled_header_cpp.hpp!
+
+#include "libebm.h"
+#include "logging.h"
+#include "common_c.h"
+#include "bridge_c.h"
+#include "zones.h"
+
+#include "common_cpp.hpp"
+#include "bridge_cpp.hpp"
+
+#include "Registration.hpp"
+#include "Objective.hpp"
+
+#include "approximate_math.hpp"
+#include "compute_wrapper.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+static constexpr size_t k_cAlignment = 32;
+
+struct alignas(k_cAlignment) Avx2_64_Float;
+
+struct alignas(k_cAlignment) Avx2_64_Int final {
+   friend Avx2_64_Float;
+   friend inline Avx2_64_Float IfEqual(const Avx2_64_Int & cmp1, const Avx2_64_Int & cmp2, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept;
+
+   using T = uint64_t;
+   using TPack = __m256i;
+   static_assert(std::is_unsigned<T>::value, "T must be an unsigned integer type");
+   static_assert(std::is_same<UIntBig, T>::value || std::is_same<UIntSmall, T>::value, 
+      "T must be either UIntBig or UIntSmall");
+   static constexpr bool k_bCpu = false;
+   static constexpr bool k_bScatter = false;
+   static constexpr int k_cSIMDShift = 2;
+   static constexpr int k_cSIMDPack = 1 << k_cSIMDShift;
+
+   ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
+   inline Avx2_64_Int() noexcept {
+   }
+
+   inline Avx2_64_Int(const T & val) noexcept : m_data(_mm256_set1_epi64x(static_cast<int64_t>(val))) {
+   }
+
+   inline static Avx2_64_Int Load(const T * const a) noexcept {
+      return Avx2_64_Int(_mm256_load_si256(reinterpret_cast<const TPack *>(a)));
+   }
+
+   inline void Store(T * const a) const noexcept {
+      _mm256_store_si256(reinterpret_cast<TPack *>(a), m_data);
+   }
+
+   inline static Avx2_64_Int Load(const T * const a, const Avx2_64_Int & i) noexcept {
+      // i is treated as signed, so we should only use the lower 63 bits otherwise we'll read from memory before a
+      return Avx2_64_Int(_mm256_i64gather_epi64(reinterpret_cast<const long long *>(a), i.m_data, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const Avx2_64_Int & i) const noexcept {
+      alignas(k_cAlignment) T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T vals[k_cSIMDPack];
+
+      i.Store(ints);
+      Store(vals);
+
+      a[ints[0]] = vals[0];
+      a[ints[1]] = vals[1];
+      a[ints[2]] = vals[2];
+      a[ints[3]] = vals[3];
+   }
+
+   inline static Avx2_64_Int LoadBytes(const uint8_t * const a) noexcept {
+      // only 4 bytes are needed, and _mm_loadu_si32 is missing from older compilers
+      int32_t bytes;
+      memcpy(&bytes, a, sizeof(bytes));
+      return Avx2_64_Int(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes)));
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Int & val0) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+
+      // no loops because this will disable optimizations for loops in the caller
+      func(0, a0[0]);
+      func(1, a0[1]);
+      func(2, a0[2]);
+      func(3, a0[3]);
+   }
+
+   inline static Avx2_64_Int MakeIndexes() noexcept {
+      return Avx2_64_Int(_mm256_set_epi64x(3, 2, 1, 0));
+   }
+
+   inline Avx2_64_Int operator+ (const Avx2_64_Int & other) const noexcept {
+      return Avx2_64_Int(_mm256_add_epi64(m_data, other.m_data));
+   }
+
+   inline Avx2_64_Int operator* (const T & other) const noexcept {
+      // AVX2 has no 64 bit low multiply, so build it from 32 bit multiplies. The high 32 bits of each 
+      // partial product that crosses the halves fall off the top when shifted, which is the wrapping we want
+      const __m256i otherPack = _mm256_set1_epi64x(static_cast<int64_t>(other));
+      const __m256i low = _mm256_mul_epu32(m_data, otherPack);
+      const __m256i cross = _mm256_add_epi64(
+         _mm256_mul_epu32(_mm256_srli_epi64(m_data, 32), otherPack),
+         _mm256_mul_epu32(m_data, _mm256_srli_epi64(otherPack, 32))
+      );
+      return Avx2_64_Int(_mm256_add_epi64(low, _mm256_slli_epi64(cross, 32)));
+   }
+
+   inline Avx2_64_Int operator>> (int shift) const noexcept {
+      return Avx2_64_Int(_mm256_srli_epi64(m_data, shift));
+   }
+
+   inline Avx2_64_Int operator<< (int shift) const noexcept {
+      return Avx2_64_Int(_mm256_slli_epi64(m_data, shift));
+   }
+
+   inline Avx2_64_Int operator& (const Avx2_64_Int & other) const noexcept {
+      return Avx2_64_Int(_mm256_and_si256(m_data, other.m_data));
+   }
+
+private:
+   inline Avx2_64_Int(const TPack & data) noexcept : m_data(data) {
+   }
+
+   TPack m_data;
+};
+static_assert(std::is_standard_layout<Avx2_64_Int>::value && std::is_trivially_copyable<Avx2_64_Int>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+
+struct alignas(k_cAlignment) Avx2_64_Float final {
+   using T = double;
+   using TPack = __m256d;
+   using TInt = Avx2_64_Int;
+   static_assert(std::is_same<FloatBig, T>::value || std::is_same<FloatSmall, T>::value,
+      "T must be either FloatBig or FloatSmall");
+   static constexpr bool k_bCpu = TInt::k_bCpu;
+   static constexpr bool k_bScatter = TInt::k_bScatter;
+   static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
+   static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
+
+   ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
+   inline Avx2_64_Float() noexcept {
+   }
+
+   inline Avx2_64_Float(const double val) noexcept : m_data(_mm256_set1_pd(static_cast<T>(val))) {
+   }
+   inline Avx2_64_Float(const float val) noexcept : m_data(_mm256_set1_pd(static_cast<T>(val))) {
+   }
+   inline Avx2_64_Float(const int val) noexcept : m_data(_mm256_set1_pd(static_cast<T>(val))) {
+   }
+
+
+   inline Avx2_64_Float operator+() const noexcept {
+      return *this;
+   }
+
+   inline Avx2_64_Float operator-() const noexcept {
+      return Avx2_64_Float(_mm256_xor_pd(m_data, _mm256_set1_pd(-0.0)));
+   }
+
+
+   inline Avx2_64_Float operator+ (const Avx2_64_Float & other) const noexcept {
+      return Avx2_64_Float(_mm256_add_pd(m_data, other.m_data));
+   }
+
+   inline Avx2_64_Float operator- (const Avx2_64_Float & other) const noexcept {
+      return Avx2_64_Float(_mm256_sub_pd(m_data, other.m_data));
+   }
+
+   inline Avx2_64_Float operator* (const Avx2_64_Float & other) const noexcept {
+      return Avx2_64_Float(_mm256_mul_pd(m_data, other.m_data));
+   }
+
+   inline Avx2_64_Float operator/ (const Avx2_64_Float & other) const noexcept {
+      return Avx2_64_Float(_mm256_div_pd(m_data, other.m_data));
+   }
+
+
+   inline Avx2_64_Float & operator+= (const Avx2_64_Float & other) noexcept {
+      *this = (*this) + other;
+      return *this;
+   }
+
+   inline Avx2_64_Float & operator-= (const Avx2_64_Float & other) noexcept {
+      *this = (*this) - other;
+      return *this;
+   }
+
+   inline Avx2_64_Float & operator*= (const Avx2_64_Float & other) noexcept {
+      *this = (*this) * other;
+      return *this;
+   }
+
+   inline Avx2_64_Float & operator/= (const Avx2_64_Float & other) noexcept {
+      *this = (*this) / other;
+      return *this;
+   }
+
+
+   friend inline Avx2_64_Float operator+ (const double val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) + other;
+   }
+
+   friend inline Avx2_64_Float operator- (const double val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) - other;
+   }
+
+   friend inline Avx2_64_Float operator* (const double val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) * other;
+   }
+
+   friend inline Avx2_64_Float operator/ (const double val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) / other;
+   }
+
+
+   friend inline Avx2_64_Float operator+ (const float val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) + other;
+   }
+
+   friend inline Avx2_64_Float operator- (const float val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) - other;
+   }
+
+   friend inline Avx2_64_Float operator* (const float val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) * other;
+   }
+
+   friend inline Avx2_64_Float operator/ (const float val, const Avx2_64_Float & other) noexcept {
+      return Avx2_64_Float(val) / other;
+   }
+
+
+   inline static Avx2_64_Float Load(const T * const a) noexcept {
+      return Avx2_64_Float(_mm256_load_pd(a));
+   }
+
+   inline void Store(T * const a) const noexcept {
+      _mm256_store_pd(a, m_data);
+   }
+
+   inline static Avx2_64_Float LoadBytes(const uint8_t * const a) noexcept {
+      // only 4 bytes are needed, and _mm_loadu_si32 is missing from older compilers
+      int32_t bytes;
+      memcpy(&bytes, a, sizeof(bytes));
+      return Avx2_64_Float(_mm256_cvtepi32_pd(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes))));
+   }
+
+   inline static Avx2_64_Float Load(const T * const a, const TInt & i) noexcept {
+      // i is treated as signed, so we should only use the lower 63 bits otherwise we'll read from memory before a
+      return Avx2_64_Float(_mm256_i64gather_pd(a, i.m_data, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const TInt & i) const noexcept {
+      alignas(k_cAlignment) TInt::T ints[k_cSIMDPack];
+      alignas(k_cAlignment) T floats[k_cSIMDPack];
+
+      i.Store(ints);
+      Store(floats);
+
+      a[ints[0]] = floats[0];
+      a[ints[1]] = floats[1];
+      a[ints[2]] = floats[2];
+      a[ints[3]] = floats[3];
+   }
+
+   template<typename TFunc>
+   friend inline Avx2_64_Float ApplyFunc(const TFunc & func, const Avx2_64_Float & val) noexcept {
+      alignas(k_cAlignment) T aTemp[k_cSIMDPack];
+      val.Store(aTemp);
+
+      aTemp[0] = func(aTemp[0]);
+      aTemp[1] = func(aTemp[1]);
+      aTemp[2] = func(aTemp[2]);
+      aTemp[3] = func(aTemp[3]);
+
+      return Load(aTemp);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func) noexcept {
+      func(0);
+      func(1);
+      func(2);
+      func(3);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Float & val0) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+
+      func(0, a0[0]);
+      func(1, a0[1]);
+      func(2, a0[2]);
+      func(3, a0[3]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx2_64_Float & val0, const Avx2_64_Float & val1) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+
+      func(0, a0[0], a1[0]);
+      func(1, a0[1], a1[1]);
+      func(2, a0[2], a1[2]);
+      func(3, a0[3], a1[3]);
+   }
+
+   friend inline Avx2_64_Float IfLess(const Avx2_64_Float & cmp1, const Avx2_64_Float & cmp2, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept {
+      const __m256d mask = _mm256_cmp_pd(cmp1.m_data, cmp2.m_data, _CMP_LT_OQ);
+      return Avx2_64_Float(_mm256_blendv_pd(falseVal.m_data, trueVal.m_data, mask));
+   }
+
+   friend inline Avx2_64_Float IfEqual(const Avx2_64_Float & cmp1, const Avx2_64_Float & cmp2, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept {
+      const __m256d mask = _mm256_cmp_pd(cmp1.m_data, cmp2.m_data, _CMP_EQ_OQ);
+      return Avx2_64_Float(_mm256_blendv_pd(falseVal.m_data, trueVal.m_data, mask));
+   }
+
+   friend inline Avx2_64_Float IfNaN(const Avx2_64_Float & cmp, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept {
+      // rely on the fact that a == a can only be false if a is a NaN
+      //
+      return IfEqual(cmp, cmp, falseVal, trueVal);
+   }
+
+   friend inline Avx2_64_Float IfEqual(const Avx2_64_Int & cmp1, const Avx2_64_Int & cmp2, const Avx2_64_Float & trueVal, const Avx2_64_Float & falseVal) noexcept {
+      const __m256i mask = _mm256_cmpeq_epi64(cmp1.m_data, cmp2.m_data);
+      return Avx2_64_Float(_mm256_blendv_pd(falseVal.m_data, trueVal.m_data, _mm256_castsi256_pd(mask)));
+   }
+
+   friend inline Avx2_64_Float Abs(const Avx2_64_Float & val) noexcept {
+      return Avx2_64_Float(_mm256_andnot_pd(_mm256_set1_pd(-0.0), val.m_data));
+   }
+
+   friend inline Avx2_64_Float FastApproxReciprocal(const Avx2_64_Float & val) noexcept {
+      // there is no double precision reciprocal approximation in AVX2, and anyone choosing this zone wants the 
+      // precision anyways, so divide exactly like the Cpu_64 zone does
+      return Avx2_64_Float(1.0) / val;
+   }
+
+   friend inline Avx2_64_Float FastApproxDivide(const Avx2_64_Float & dividend, const Avx2_64_Float & divisor) noexcept {
+      return dividend / divisor;
+   }
+
+   friend inline Avx2_64_Float FusedMultiplyAdd(const Avx2_64_Float & mul1, const Avx2_64_Float & mul2, const Avx2_64_Float & add) noexcept {
+      // For AVX, Intel initially built FMA3, and AMD built FMA4, but AMD later depricated FMA4 and supported
+      // FMA3 by the time AVX2 rolled out.  We only support AVX2 and above (not AVX) since we benefit from the
+      // integer parts of AVX2. Just to be sure though we also check the cpuid for FMA3 during init
+      return Avx2_64_Float(_mm256_fmadd_pd(mul1.m_data, mul2.m_data, add.m_data));
+   }
+
+   friend inline Avx2_64_Float FusedNegateMultiplyAdd(const Avx2_64_Float & mul1, const Avx2_64_Float & mul2, const Avx2_64_Float & add) noexcept {
+      // For AVX, Intel initially built FMA3, and AMD built FMA4, but AMD later depricated FMA4 and supported
+      // FMA3 by the time AVX2 rolled out.  We only support AVX2 and above (not AVX) since we benefit from the
+      // integer parts of AVX2. Just to be sure though we also check the cpuid for FMA3 during init
+
+      // equivalent to: -(mul1 * mul2) + add
+      return Avx2_64_Float(_mm256_fnmadd_pd(mul1.m_data, mul2.m_data, add.m_data));
+   }
+
+   friend inline Avx2_64_Float Sqrt(const Avx2_64_Float & val) noexcept {
+      return Avx2_64_Float(_mm256_sqrt_pd(val.m_data));
+   }
+
+   friend inline Avx2_64_Float Exp(const Avx2_64_Float & val) noexcept {
+      return ApplyFunc([](T x) { return std::exp(x); }, val);
+   }
+
+   friend inline Avx2_64_Float Log(const Avx2_64_Float & val) noexcept {
+      return ApplyFunc([](T x) { return std::log(x); }, val);
+   }
+
+   template<
+      bool bNegateInput = false,
+      bool bNaNPossible = true,
+      bool bUnderflowPossible = true,
+      bool bOverflowPossible = true,
+      bool bSpecialCaseZero = false
+   >
+   static inline Avx2_64_Float ApproxExp(
+      const Avx2_64_Float & val, 
+      const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+   ) noexcept {
+      // This code will make no sense until you read the Nicol N. Schraudolph paper:
+      // https://citeseerx.ist.psu.edu/viewdoc/download?doi=10.1.1.9.4508&rep=rep1&type=pdf
+      // and also see approximate_math.hpp
+#ifdef FAST_LOG
+      // Like the Cpu_64 zone, the approximation is built from the bits of a float, which we then widen to double.
+      // Inputs outside of the float range convert to garbage here, but they are replaced below.
+      static constexpr float signedExpMultiple = bNegateInput ? -k_expMultiple : k_expMultiple;
+      const __m256d retDouble = FusedMultiplyAdd(val, signedExpMultiple, static_cast<T>(addExpSchraudolphTerm)).m_data;
+      const __m128i retInt = _mm256_cvttpd_epi32(retDouble);
+      Avx2_64_Float result = Avx2_64_Float(_mm256_cvtps_pd(_mm_castsi128_ps(retInt)));
+      if(bSpecialCaseZero) {
+         result = IfEqual(0.0, val, 1.0, result);
+      }
+      if(bOverflowPossible) {
+         if(bNegateInput) {
+            result = IfLess(val, static_cast<T>(-k_expOverflowPoint), std::numeric_limits<T>::infinity(), result);
+         } else {
+            result = IfLess(static_cast<T>(k_expOverflowPoint), val, std::numeric_limits<T>::infinity(), result);
+         }
+      }
+      if(bUnderflowPossible) {
+         if(bNegateInput) {
+            result = IfLess(static_cast<T>(-k_expUnderflowPoint), val, 0.0, result);
+         } else {
+            result = IfLess(val, static_cast<T>(k_expUnderflowPoint), 0.0, result);
+         }
+      }
+      if(bNaNPossible) {
+         result = IfNaN(val, val, result);
+      }
+      return result;
+#else // FAST_LOG
+      UNUSED(addExpSchraudolphTerm);
+      return Exp(bNegateInput ? -val : val);
+#endif // FAST_LOG
+   }
+
+   template<
+      bool bNegateOutput = false,
+      bool bNaNPossible = true,
+      bool bNegativePossible = false,
+      bool bZeroPossible = false, // if false, positive zero returns a big negative number, negative zero returns a big positive number
+      bool bPositiveInfinityPossible = false // if false, +inf returns a big positive number.  If val can be a double that is above the largest representable float, then setting this is necessary to avoid undefined behavior
+   >
+   static inline Avx2_64_Float ApproxLog(
+      const Avx2_64_Float & val, 
+      const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+   ) noexcept {
+      // This code will make no sense until you read the Nicol N. Schraudolph paper:
+      // https://citeseerx.ist.psu.edu/viewdoc/download?doi=10.1.1.9.4508&rep=rep1&type=pdf
+      // and also see approximate_math.hpp
+#ifdef FAST_LOG
+      // Like the Cpu_64 zone, the approximation is built from the bits of val narrowed to a float
+      const __m128i retInt = _mm_castps_si128(_mm256_cvtpd_ps(val.m_data));
+      Avx2_64_Float result = Avx2_64_Float(_mm256_cvtepi32_pd(retInt));
+      if(bNegateOutput) {
+         result = FusedMultiplyAdd(result, -k_logMultiple, -addLogSchraudolphTerm);
+      } else {
+         result = FusedMultiplyAdd(result, k_logMultiple, addLogSchraudolphTerm);
+      }
+      // doubles above the largest float (including +inf) would otherwise narrow to the float infinity bits
+      result = IfLess(static_cast<T>(std::numeric_limits<float>::max()), val, bNegateOutput ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity(), result);
+      if(bZeroPossible) {
+         result = IfEqual(0.0, val, bNegateOutput ? std::numeric_limits<T>::infinity() : -std::numeric_limits<T>::infinity(), result);
+      }
+      if(bNegativePossible) {
+         result = IfLess(val, 0.0, std::numeric_limits<T>::quiet_NaN(), result);
+      }
+      if(bNaNPossible) {
+         result = IfNaN(val, val, result);
+      }
+      return result;
+#else // FAST_LOG
+      UNUSED(addLogSchraudolphTerm);
+      const Avx2_64_Float ret = Log(val);
+      return bNegateOutput ? -ret : ret;
+#endif // FAST_LOG
+   }
+
+   friend inline T Sum(const Avx2_64_Float & val) noexcept {
+      const __m128d vlow = _mm256_castpd256_pd128(val.m_data);
+      const __m128d vhigh = _mm256_extractf128_pd(val.m_data, 1);
+      const __m128d sum = _mm_add_pd(vlow, vhigh);
+      const __m128d sum1 = _mm_hadd_pd(sum, sum);
+      return _mm_cvtsd_f64(sum1);
+   }
+
+
+   template<typename TObjective, size_t cCompilerScores, bool bValidation, bool bWeight, bool bHessian, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorApplyUpdate(const Objective * const pObjective, ApplyUpdateBridge * const pData) noexcept {
+      RemoteApplyUpdate<TObjective, cCompilerScores, bValidation, bWeight, bHessian, cCompilerPack>(pObjective, pData);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, bool bMultiplyOccurrences, 
+      int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoosting<Avx2_64_Float, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, 
+         cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, size_t cCompilerScores, size_t cCompilerDimensions, bool bWeight>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteraction(BinSumsInteractionBridge * const pParams) noexcept {
+      RemoteBinSumsInteraction<Avx2_64_Float, bHessian, cCompilerScores, cCompilerDimensions, bWeight>(pParams);
+      return Error_None;
+   }
+
+
+private:
+
+   inline Avx2_64_Float(const TPack & data) noexcept : m_data(data) {
+   }
+
+   TPack m_data;
+};
+static_assert(std::is_standard_layout<Avx2_64_Float>::value && std::is_trivially_copyable<Avx2_64_Float>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+// FIRST, define the RegisterObjective function that we'll be calling from our registrations.  This is a static 
+// function, so we can have duplicate named functions in other files and they'll refer to different functions
+template<template <typename> class TRegistrable, bool bCpuOnly, typename... Args>
+INLINE_ALWAYS static typename std::enable_if<bCpuOnly, std::shared_ptr<const Registration>>::type RegisterObjective(const char * const, const Args &...) {
+   return nullptr;
+}
+template<template <typename> class TRegistrable, bool bCpuOnly, typename... Args>
+INLINE_ALWAYS static typename std::enable_if<!bCpuOnly, std::shared_ptr<const Registration>>::type RegisterObjective(const char * const sRegistrationName, const Args &... args) {
+   return Register<TRegistrable, Avx2_64_Float>(bCpuOnly, sRegistrationName, args...);
+}
+
+// now include all our special objective registrations which will use the RegisterObjective function we defined above!
+#include "objective_registrations.hpp"
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Avx2_64(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const char * const sObjectiveEnd,
+   ObjectiveWrapper * const pObjectiveWrapperOut
+) {
+   ErrorEbm error = ComputeWrapper<Avx2_64_Float>::FillWrapper(pObjectiveWrapperOut);
+   if(Error_None != error) {
+      return error;
+   }
+   return Objective::CreateObjective(&RegisterObjectives, pConfig, sObjective, sObjectiveEnd, pObjectiveWrapperOut);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY void DiscretizeBroadcast_Avx2_64(
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cCuts,
+   const double * const aCutsLowerBoundInclusive,
+   IntEbm * const aBinIndexesOut
+) {
+   // each cut is broadcast and compared against 4 values at once.  The comparison mask is all ones (-1) where the
+   // cut is lower or equal, so subtracting the masks counts the cuts below each value.  NaN fails every ordered
+   // comparison, which leaves it in bin 1 until the final mask moves it into the missing bin 0
+   EBM_ASSERT(1 <= cCuts);
+
+   const double * pVal = aFeatureVals;
+   const double * const pValsEnd = aFeatureVals + cSamples;
+   IntEbm * piBin = aBinIndexesOut;
+   const double * const pCutsEnd = aCutsLowerBoundInclusive + cCuts;
+
+   const __m256i one = _mm256_set1_epi64x(1);
+   while(size_t { 4 } <= static_cast<size_t>(pValsEnd - pVal)) {
+      const __m256d val = _mm256_loadu_pd(pVal);
+      __m256i iBin = one;
+      const double * pCut = aCutsLowerBoundInclusive;
+      do {
+         const __m256d cut = _mm256_broadcast_sd(pCut);
+         iBin = _mm256_sub_epi64(iBin, _mm256_castpd_si256(_mm256_cmp_pd(cut, val, _CMP_LE_OQ)));
+         ++pCut;
+      } while(pCutsEnd != pCut);
+      const __m256i missing = _mm256_castpd_si256(_mm256_cmp_pd(val, val, _CMP_UNORD_Q));
+      iBin = _mm256_andnot_si256(missing, iBin);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(piBin), iBin);
+      pVal += 4;
+      piBin += 4;
+   }
+   while(pValsEnd != pVal) {
+      const double val = *pVal;
+      IntEbm iBin = 1;
+      const double * pCut = aCutsLowerBoundInclusive;
+      do {
+         iBin += *pCut <= val ? IntEbm { 1 } : IntEbm { 0 };
+         ++pCut;
+      } while(pCutsEnd != pCut);
+      *piBin = std::isnan(val) ? IntEbm { 0 } : iBin;
+      ++pVal;
+      ++piBin;
+   }
+}
+
+INTERNAL_IMPORT_EXPORT_BODY void DiscretizeEytzinger_Avx2_64(
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cLevels,
+   const double * const aTree,
+   IntEbm * const aBinIndexesOut
+) {
+   // every search descends exactly cLevels levels, so 4 searches proceed in lockstep with one gather per level.
+   // After descending, the node index is 2^cLevels plus the number of cuts that are lower or equal to the value
+   EBM_ASSERT(1 <= cLevels);
+
+   const double * pVal = aFeatureVals;
+   const double * const pValsEnd = aFeatureVals + cSamples;
+   IntEbm * piBin = aBinIndexesOut;
+   const IntEbm firstLeaf = IntEbm { 1 } << cLevels;
+
+   const __m256i one = _mm256_set1_epi64x(1);
+   const __m256i leafToBin = _mm256_set1_epi64x(firstLeaf - IntEbm { 1 });
+   while(size_t { 4 } <= static_cast<size_t>(pValsEnd - pVal)) {
+      const __m256d val = _mm256_loadu_pd(pVal);
+      __m256i iNode = one;
+      size_t iLevel = cLevels;
+      do {
+         const __m256d cut = _mm256_i64gather_pd(aTree, iNode, sizeof(double));
+         iNode = _mm256_sub_epi64(_mm256_add_epi64(iNode, iNode), _mm256_castpd_si256(_mm256_cmp_pd(cut, val, _CMP_LE_OQ)));
+         --iLevel;
+      } while(0 != iLevel);
+      const __m256i missing = _mm256_castpd_si256(_mm256_cmp_pd(val, val, _CMP_UNORD_Q));
+      const __m256i iBin = _mm256_andnot_si256(missing, _mm256_sub_epi64(iNode, leafToBin));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(piBin), iBin);
+      pVal += 4;
+      piBin += 4;
+   }
+   while(pValsEnd != pVal) {
+      const double val = *pVal;
+      size_t iNode = 1;
+      size_t iLevel = cLevels;
+      do {
+         iNode = iNode + iNode + (aTree[iNode] <= val ? size_t { 1 } : size_t { 0 });
+         --iLevel;
+      } while(0 != iLevel);
+      *piBin = std::isnan(val) ? IntEbm { 0 } : static_cast<IntEbm>(iNode) - (firstLeaf - IntEbm { 1 });
+      ++pVal;
+      ++piBin;
+   }
+}
+
+} // DEFINED_ZONE_NAME
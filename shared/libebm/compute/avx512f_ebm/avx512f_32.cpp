@@ -43,6 +43,8 @@ struct alignas(k_cAlignment) Avx512f_32_Int final {
    static_assert(std::is_same<UIntBig, T>::value || std::is_same<UIntSmall, T>::value,
       "T must be either UIntBig or UIntSmall");
    static constexpr bool k_bCpu = false;
+   // Store with indexes is a single hardware scatter instruction rather than one store per lane
+   static constexpr bool k_bScatter = true;
    static constexpr int k_cSIMDShift = 4;
    static constexpr int k_cSIMDPack = 1 << k_cSIMDShift;
 
@@ -61,6 +63,15 @@ struct alignas(k_cAlignment) Avx512f_32_Int final {
       _mm512_store_si512(a, m_data);
    }
 
+   inline static Avx512f_32_Int Load(const T * const a, const Avx512f_32_Int & i) noexcept {
+      // i is treated as signed, so we should only use the lower 31 bits otherwise we'll read from memory before a
+      return Avx512f_32_Int(_mm512_i32gather_epi32(i.m_data, a, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const Avx512f_32_Int & i) const noexcept {
+      _mm512_i32scatter_epi32(a, i.m_data, m_data, sizeof(a[0]));
+   }
+
    inline static Avx512f_32_Int LoadBytes(const uint8_t * const a) noexcept {
       return Avx512f_32_Int(_mm512_cvtepu8_epi32(_mm_load_si128(reinterpret_cast<const __m128i *>(a))));
    }
@@ -130,6 +141,7 @@ struct alignas(k_cAlignment) Avx512f_32_Float final {
    static_assert(std::is_same<FloatBig, T>::value || std::is_same<FloatSmall, T>::value,
       "T must be either FloatBig or FloatSmall");
    static constexpr bool k_bCpu = TInt::k_bCpu;
+   static constexpr bool k_bScatter = TInt::k_bScatter;
    static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
    static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
 
@@ -234,6 +246,11 @@ struct alignas(k_cAlignment) Avx512f_32_Float final {
       _mm512_store_ps(a, m_data);
    }
 
+   inline static Avx512f_32_Float LoadBytes(const uint8_t * const a) noexcept {
+      return Avx512f_32_Float(
+         _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_load_si128(reinterpret_cast<const __m128i *>(a)))));
+   }
+
    inline static Avx512f_32_Float Load(const T * const a, const TInt & i) noexcept {
       // i is treated as signed, so we should only use the lower 31 bits otherwise we'll read from memory before a
       return Avx512f_32_Float(_mm512_i32gather_ps(i.m_data, a, sizeof(a[0])));
@@ -508,9 +525,11 @@ struct alignas(k_cAlignment) Avx512f_32_Float final {
    }
 
 
-   template<bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, int cCompilerPack>
+   template<bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, bool bMultiplyOccurrences, 
+      int cCompilerPack>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
-      RemoteBinSumsBoosting<Avx512f_32_Float, bHessian, cCompilerScores, bWeight, bReplication, cCompilerPack>(pParams);
+      RemoteBinSumsBoosting<Avx512f_32_Float, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, 
+         cCompilerPack>(pParams);
       return Error_None;
    }
 
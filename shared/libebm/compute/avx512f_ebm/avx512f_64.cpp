@@ -0,0 +1,612 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_cpp.hpp"
+
+#include <cmath> // exp, log
+#include <limits> // numeric_limits
+#include <type_traits> // is_unsigned
+#include <immintrin.h> // SIMD.  Do not include in precompiled_header_cpp.hpp!
+
+#include "libebm.h"
+#include "logging.h"
+#include "common_c.h"
+#include "bridge_c.h"
+#include "zones.h"
+
+#include "common_cpp.hpp"
+#include "bridge_cpp.hpp"
+
+#include "Registration.hpp"
+#include "Objective.hpp"
+
+#include "approximate_math.hpp"
+#include "compute_wrapper.hpp"
+
+namespace DEFINED_ZONE_NAME {
+#ifndef DEFINED_ZONE_NAME
+#error DEFINED_ZONE_NAME must be defined
+#endif // DEFINED_ZONE_NAME
+
+static constexpr size_t k_cAlignment = 64;
+
+struct alignas(k_cAlignment) Avx512f_64_Float;
+
+struct alignas(k_cAlignment) Avx512f_64_Int final {
+   friend Avx512f_64_Float;
+   friend inline Avx512f_64_Float IfEqual(const Avx512f_64_Int & cmp1, const Avx512f_64_Int & cmp2, const Avx512f_64_Float & trueVal, const Avx512f_64_Float & falseVal) noexcept;
+
+   using T = uint64_t;
+   using TPack = __m512i;
+   static_assert(std::is_unsigned<T>::value, "T must be an unsigned integer type");
+   static_assert(std::is_same<UIntBig, T>::value || std::is_same<UIntSmall, T>::value,
+      "T must be either UIntBig or UIntSmall");
+   static constexpr bool k_bCpu = false;
+   // Store with indexes is a single hardware scatter instruction rather than one store per lane
+   static constexpr bool k_bScatter = true;
+   static constexpr int k_cSIMDShift = 3;
+   static constexpr int k_cSIMDPack = 1 << k_cSIMDShift;
+
+   ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
+   inline Avx512f_64_Int() noexcept {
+   }
+
+   inline Avx512f_64_Int(const T & val) noexcept : m_data(_mm512_set1_epi64(static_cast<int64_t>(val))) {
+   }
+
+   inline static Avx512f_64_Int Load(const T * const a) noexcept {
+      return Avx512f_64_Int(_mm512_load_si512(a));
+   }
+
+   inline void Store(T * const a) const noexcept {
+      _mm512_store_si512(a, m_data);
+   }
+
+   inline static Avx512f_64_Int Load(const T * const a, const Avx512f_64_Int & i) noexcept {
+      // i is treated as signed, so we should only use the lower 63 bits otherwise we'll read from memory before a
+      return Avx512f_64_Int(_mm512_i64gather_epi64(i.m_data, a, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const Avx512f_64_Int & i) const noexcept {
+      _mm512_i64scatter_epi64(a, i.m_data, m_data, sizeof(a[0]));
+   }
+
+   inline static Avx512f_64_Int LoadBytes(const uint8_t * const a) noexcept {
+      return Avx512f_64_Int(_mm512_cvtepu8_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a))));
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx512f_64_Int & val0) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+
+      // no loops because this will disable optimizations for loops in the caller
+      func(0, a0[0]);
+      func(1, a0[1]);
+      func(2, a0[2]);
+      func(3, a0[3]);
+      func(4, a0[4]);
+      func(5, a0[5]);
+      func(6, a0[6]);
+      func(7, a0[7]);
+   }
+
+   inline static Avx512f_64_Int MakeIndexes() noexcept {
+      return Avx512f_64_Int(_mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0));
+   }
+
+   inline Avx512f_64_Int operator+ (const Avx512f_64_Int & other) const noexcept {
+      return Avx512f_64_Int(_mm512_add_epi64(m_data, other.m_data));
+   }
+
+   inline Avx512f_64_Int operator* (const T & other) const noexcept {
+      // the 64 bit low multiply needs AVX512DQ, so build it from 32 bit multiplies. The high 32 bits of each 
+      // partial product that crosses the halves fall off the top when shifted, which is the wrapping we want
+      const __m512i otherPack = _mm512_set1_epi64(static_cast<int64_t>(other));
+      const __m512i low = _mm512_mul_epu32(m_data, otherPack);
+      const __m512i cross = _mm512_add_epi64(
+         _mm512_mul_epu32(_mm512_srli_epi64(m_data, 32), otherPack),
+         _mm512_mul_epu32(m_data, _mm512_srli_epi64(otherPack, 32))
+      );
+      return Avx512f_64_Int(_mm512_add_epi64(low, _mm512_slli_epi64(cross, 32)));
+   }
+
+   inline Avx512f_64_Int operator>> (int shift) const noexcept {
+      return Avx512f_64_Int(_mm512_srli_epi64(m_data, shift));
+   }
+
+   inline Avx512f_64_Int operator<< (int shift) const noexcept {
+      return Avx512f_64_Int(_mm512_slli_epi64(m_data, shift));
+   }
+
+   inline Avx512f_64_Int operator& (const Avx512f_64_Int & other) const noexcept {
+      return Avx512f_64_Int(_mm512_and_si512(m_data, other.m_data));
+   }
+
+private:
+   inline Avx512f_64_Int(const TPack & data) noexcept : m_data(data) {
+   }
+
+   TPack m_data;
+};
+static_assert(std::is_standard_layout<Avx512f_64_Int>::value && std::is_trivially_copyable<Avx512f_64_Int>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+
+struct alignas(k_cAlignment) Avx512f_64_Float final {
+   using T = double;
+   using TPack = __m512d;
+   using TInt = Avx512f_64_Int;
+   static_assert(std::is_same<FloatBig, T>::value || std::is_same<FloatSmall, T>::value,
+      "T must be either FloatBig or FloatSmall");
+   static constexpr bool k_bCpu = TInt::k_bCpu;
+   static constexpr bool k_bScatter = TInt::k_bScatter;
+   static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
+   static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
+
+   ATTRIBUTE_WARNING_DISABLE_UNINITIALIZED_MEMBER
+   inline Avx512f_64_Float() noexcept {
+   }
+
+   inline Avx512f_64_Float(const double val) noexcept : m_data(_mm512_set1_pd(static_cast<T>(val))) {
+   }
+   inline Avx512f_64_Float(const float val) noexcept : m_data(_mm512_set1_pd(static_cast<T>(val))) {
+   }
+   inline Avx512f_64_Float(const int val) noexcept : m_data(_mm512_set1_pd(static_cast<T>(val))) {
+   }
+
+
+   inline Avx512f_64_Float operator+() const noexcept {
+      return *this;
+   }
+
+   inline Avx512f_64_Float operator-() const noexcept {
+      return Avx512f_64_Float(_mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(m_data), _mm512_castpd_si512(_mm512_set1_pd(-0.0)))));
+   }
+
+
+   inline Avx512f_64_Float operator+ (const Avx512f_64_Float & other) const noexcept {
+      return Avx512f_64_Float(_mm512_add_pd(m_data, other.m_data));
+   }
+
+   inline Avx512f_64_Float operator- (const Avx512f_64_Float & other) const noexcept {
+      return Avx512f_64_Float(_mm512_sub_pd(m_data, other.m_data));
+   }
+
+   inline Avx512f_64_Float operator* (const Avx512f_64_Float & other) const noexcept {
+      return Avx512f_64_Float(_mm512_mul_pd(m_data, other.m_data));
+   }
+
+   inline Avx512f_64_Float operator/ (const Avx512f_64_Float & other) const noexcept {
+      return Avx512f_64_Float(_mm512_div_pd(m_data, other.m_data));
+   }
+
+
+   inline Avx512f_64_Float & operator+= (const Avx512f_64_Float & other) noexcept {
+      *this = (*this) + other;
+      return *this;
+   }
+
+   inline Avx512f_64_Float & operator-= (const Avx512f_64_Float & other) noexcept {
+      *this = (*this) - other;
+      return *this;
+   }
+
+   inline Avx512f_64_Float & operator*= (const Avx512f_64_Float & other) noexcept {
+      *this = (*this) * other;
+      return *this;
+   }
+
+   inline Avx512f_64_Float & operator/= (const Avx512f_64_Float & other) noexcept {
+      *this = (*this) / other;
+      return *this;
+   }
+
+
+   friend inline Avx512f_64_Float operator+ (const double val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) + other;
+   }
+
+   friend inline Avx512f_64_Float operator- (const double val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) - other;
+   }
+
+   friend inline Avx512f_64_Float operator* (const double val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) * other;
+   }
+
+   friend inline Avx512f_64_Float operator/ (const double val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) / other;
+   }
+
+
+   friend inline Avx512f_64_Float operator+ (const float val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) + other;
+   }
+
+   friend inline Avx512f_64_Float operator- (const float val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) - other;
+   }
+
+   friend inline Avx512f_64_Float operator* (const float val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) * other;
+   }
+
+   friend inline Avx512f_64_Float operator/ (const float val, const Avx512f_64_Float & other) noexcept {
+      return Avx512f_64_Float(val) / other;
+   }
+
+
+   inline static Avx512f_64_Float Load(const T * const a) noexcept {
+      return Avx512f_64_Float(_mm512_load_pd(a));
+   }
+
+   inline void Store(T * const a) const noexcept {
+      _mm512_store_pd(a, m_data);
+   }
+
+   inline static Avx512f_64_Float LoadBytes(const uint8_t * const a) noexcept {
+      return Avx512f_64_Float(
+         _mm512_cvtepi32_pd(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a)))));
+   }
+
+   inline static Avx512f_64_Float Load(const T * const a, const TInt & i) noexcept {
+      // i is treated as signed, so we should only use the lower 63 bits otherwise we'll read from memory before a
+      return Avx512f_64_Float(_mm512_i64gather_pd(i.m_data, a, sizeof(a[0])));
+   }
+
+   inline void Store(T * const a, const TInt & i) const noexcept {
+      // i is treated as signed, so we should only use the lower 63 bits otherwise we'll write to memory before a
+      _mm512_i64scatter_pd(a, i.m_data, m_data, sizeof(a[0]));
+   }
+
+   template<typename TFunc>
+   friend inline Avx512f_64_Float ApplyFunc(const TFunc & func, const Avx512f_64_Float & val) noexcept {
+      alignas(k_cAlignment) T aTemp[k_cSIMDPack];
+      val.Store(aTemp);
+
+      aTemp[0] = func(aTemp[0]);
+      aTemp[1] = func(aTemp[1]);
+      aTemp[2] = func(aTemp[2]);
+      aTemp[3] = func(aTemp[3]);
+      aTemp[4] = func(aTemp[4]);
+      aTemp[5] = func(aTemp[5]);
+      aTemp[6] = func(aTemp[6]);
+      aTemp[7] = func(aTemp[7]);
+
+      return Load(aTemp);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func) noexcept {
+      func(0);
+      func(1);
+      func(2);
+      func(3);
+      func(4);
+      func(5);
+      func(6);
+      func(7);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx512f_64_Float & val0) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+
+      func(0, a0[0]);
+      func(1, a0[1]);
+      func(2, a0[2]);
+      func(3, a0[3]);
+      func(4, a0[4]);
+      func(5, a0[5]);
+      func(6, a0[6]);
+      func(7, a0[7]);
+   }
+
+   template<typename TFunc>
+   static inline void Execute(const TFunc & func, const Avx512f_64_Float & val0, const Avx512f_64_Float & val1) noexcept {
+      alignas(k_cAlignment) T a0[k_cSIMDPack];
+      val0.Store(a0);
+      alignas(k_cAlignment) T a1[k_cSIMDPack];
+      val1.Store(a1);
+
+      func(0, a0[0], a1[0]);
+      func(1, a0[1], a1[1]);
+      func(2, a0[2], a1[2]);
+      func(3, a0[3], a1[3]);
+      func(4, a0[4], a1[4]);
+      func(5, a0[5], a1[5]);
+      func(6, a0[6], a1[6]);
+      func(7, a0[7], a1[7]);
+   }
+
+   friend inline Avx512f_64_Float IfLess(const Avx512f_64_Float & cmp1, const Avx512f_64_Float & cmp2, const Avx512f_64_Float & trueVal, const Avx512f_64_Float & falseVal) noexcept {
+      const __mmask8 mask = _mm512_cmp_pd_mask(cmp1.m_data, cmp2.m_data, _CMP_LT_OQ);
+      return Avx512f_64_Float(_mm512_mask_blend_pd(mask, falseVal.m_data, trueVal.m_data));
+   }
+
+   friend inline Avx512f_64_Float IfEqual(const Avx512f_64_Float & cmp1, const Avx512f_64_Float & cmp2, const Avx512f_64_Float & trueVal, const Avx512f_64_Float & falseVal) noexcept {
+      const __mmask8 mask = _mm512_cmp_pd_mask(cmp1.m_data, cmp2.m_data, _CMP_EQ_OQ);
+      return Avx512f_64_Float(_mm512_mask_blend_pd(mask, falseVal.m_data, trueVal.m_data));
+   }
+
+   friend inline Avx512f_64_Float IfNaN(const Avx512f_64_Float & cmp, const Avx512f_64_Float & trueVal, const Avx512f_64_Float & falseVal) noexcept {
+      // rely on the fact that a == a can only be false if a is a NaN
+      return IfEqual(cmp, cmp, falseVal, trueVal);
+   }
+
+   friend inline Avx512f_64_Float IfEqual(const Avx512f_64_Int & cmp1, const Avx512f_64_Int & cmp2, const Avx512f_64_Float & trueVal, const Avx512f_64_Float & falseVal) noexcept {
+      const __mmask8 mask = _mm512_cmpeq_epi64_mask(cmp1.m_data, cmp2.m_data);
+      return Avx512f_64_Float(_mm512_mask_blend_pd(mask, falseVal.m_data, trueVal.m_data));
+   }
+
+   friend inline Avx512f_64_Float Abs(const Avx512f_64_Float & val) noexcept {
+      return Avx512f_64_Float(_mm512_abs_pd(val.m_data));
+   }
+
+   friend inline Avx512f_64_Float FastApproxReciprocal(const Avx512f_64_Float & val) noexcept {
+      // _mm512_rcp14_pd only has 14 bits of precision, which defeats the purpose of this zone, so divide exactly 
+      // like the Cpu_64 zone does
+      return Avx512f_64_Float(1.0) / val;
+   }
+
+   friend inline Avx512f_64_Float FastApproxDivide(const Avx512f_64_Float & dividend, const Avx512f_64_Float & divisor) noexcept {
+      return dividend / divisor;
+   }
+
+   friend inline Avx512f_64_Float FusedMultiplyAdd(const Avx512f_64_Float & mul1, const Avx512f_64_Float & mul2, const Avx512f_64_Float & add) noexcept {
+      return Avx512f_64_Float(_mm512_fmadd_pd(mul1.m_data, mul2.m_data, add.m_data));
+   }
+
+   friend inline Avx512f_64_Float FusedNegateMultiplyAdd(const Avx512f_64_Float & mul1, const Avx512f_64_Float & mul2, const Avx512f_64_Float & add) noexcept {
+      // equivalent to: -(mul1 * mul2) + add
+      return Avx512f_64_Float(_mm512_fnmadd_pd(mul1.m_data, mul2.m_data, add.m_data));
+   }
+
+   friend inline Avx512f_64_Float Sqrt(const Avx512f_64_Float & val) noexcept {
+      return Avx512f_64_Float(_mm512_sqrt_pd(val.m_data));
+   }
+
+   friend inline Avx512f_64_Float Exp(const Avx512f_64_Float & val) noexcept {
+      return ApplyFunc([](T x) { return std::exp(x); }, val);
+   }
+
+   friend inline Avx512f_64_Float Log(const Avx512f_64_Float & val) noexcept {
+      return ApplyFunc([](T x) { return std::log(x); }, val);
+   }
+
+   template<
+      bool bNegateInput = false,
+      bool bNaNPossible = true,
+      bool bUnderflowPossible = true,
+      bool bOverflowPossible = true,
+      bool bSpecialCaseZero = false
+   >
+      static inline Avx512f_64_Float ApproxExp(
+         const Avx512f_64_Float & val,
+         const int32_t addExpSchraudolphTerm = k_expTermZeroMeanErrorForSoftmaxWithZeroedLogit
+      ) noexcept {
+      // This code will make no sense until you read the Nicol N. Schraudolph paper:
+      // https://citeseerx.ist.psu.edu/viewdoc/download?doi=10.1.1.9.4508&rep=rep1&type=pdf
+      // and also see approximate_math.hpp
+#ifdef FAST_LOG
+      // Like the Cpu_64 zone, the approximation is built from the bits of a float, which we then widen to double.
+      // Inputs outside of the float range convert to garbage here, but they are replaced below.
+      static constexpr float signedExpMultiple = bNegateInput ? -k_expMultiple : k_expMultiple;
+      const __m512d retDouble = FusedMultiplyAdd(val, signedExpMultiple, static_cast<T>(addExpSchraudolphTerm)).m_data;
+      const __m256i retInt = _mm512_cvttpd_epi32(retDouble);
+      Avx512f_64_Float result = Avx512f_64_Float(_mm512_cvtps_pd(_mm256_castsi256_ps(retInt)));
+      if(bSpecialCaseZero) {
+         result = IfEqual(0.0, val, 1.0, result);
+      }
+      if(bOverflowPossible) {
+         if(bNegateInput) {
+            result = IfLess(val, static_cast<T>(-k_expOverflowPoint), std::numeric_limits<T>::infinity(), result);
+         } else {
+            result = IfLess(static_cast<T>(k_expOverflowPoint), val, std::numeric_limits<T>::infinity(), result);
+         }
+      }
+      if(bUnderflowPossible) {
+         if(bNegateInput) {
+            result = IfLess(static_cast<T>(-k_expUnderflowPoint), val, 0.0, result);
+         } else {
+            result = IfLess(val, static_cast<T>(k_expUnderflowPoint), 0.0, result);
+         }
+      }
+      if(bNaNPossible) {
+         result = IfNaN(val, val, result);
+      }
+      return result;
+#else // FAST_LOG
+      UNUSED(addExpSchraudolphTerm);
+      return Exp(bNegateInput ? -val : val);
+#endif // FAST_LOG
+      }
+
+   template<
+      bool bNegateOutput = false,
+      bool bNaNPossible = true,
+      bool bNegativePossible = false,
+      bool bZeroPossible = false, // if false, positive zero returns a big negative number, negative zero returns a big positive number
+      bool bPositiveInfinityPossible = false // if false, +inf returns a big positive number.  If val can be a double that is above the largest representable float, then setting this is necessary to avoid undefined behavior
+   >
+      static inline Avx512f_64_Float ApproxLog(
+         const Avx512f_64_Float & val,
+         const float addLogSchraudolphTerm = k_logTermLowerBoundInputCloseToOne
+      ) noexcept {
+      // This code will make no sense until you read the Nicol N. Schraudolph paper:
+      // https://citeseerx.ist.psu.edu/viewdoc/download?doi=10.1.1.9.4508&rep=rep1&type=pdf
+      // and also see approximate_math.hpp
+#ifdef FAST_LOG
+      // Like the Cpu_64 zone, the approximation is built from the bits of val narrowed to a float
+      const __m256i retInt = _mm256_castps_si256(_mm512_cvtpd_ps(val.m_data));
+      Avx512f_64_Float result = Avx512f_64_Float(_mm512_cvtepi32_pd(retInt));
+      if(bNegateOutput) {
+         result = FusedMultiplyAdd(result, -k_logMultiple, -addLogSchraudolphTerm);
+      } else {
+         result = FusedMultiplyAdd(result, k_logMultiple, addLogSchraudolphTerm);
+      }
+      // doubles above the largest float (including +inf) would otherwise narrow to the float infinity bits
+      result = IfLess(static_cast<T>(std::numeric_limits<float>::max()), val, bNegateOutput ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity(), result);
+      if(bZeroPossible) {
+         result = IfEqual(0.0, val, bNegateOutput ? std::numeric_limits<T>::infinity() : -std::numeric_limits<T>::infinity(), result);
+      }
+      if(bNegativePossible) {
+         result = IfLess(val, 0.0, std::numeric_limits<T>::quiet_NaN(), result);
+      }
+      if(bNaNPossible) {
+         result = IfNaN(val, val, result);
+      }
+      return result;
+#else // FAST_LOG
+      UNUSED(addLogSchraudolphTerm);
+      const Avx512f_64_Float ret = Log(val);
+      return bNegateOutput ? -ret : ret;
+#endif // FAST_LOG
+   }
+
+   friend inline T Sum(const Avx512f_64_Float & val) noexcept {
+      return _mm512_reduce_add_pd(val.m_data);
+   }
+
+
+   template<typename TObjective, size_t cCompilerScores, bool bValidation, bool bWeight, bool bHessian, int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorApplyUpdate(const Objective * const pObjective, ApplyUpdateBridge * const pData) noexcept {
+      RemoteApplyUpdate<TObjective, cCompilerScores, bValidation, bWeight, bHessian, cCompilerPack>(pObjective, pData);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, bool bMultiplyOccurrences, 
+      int cCompilerPack>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
+      RemoteBinSumsBoosting<Avx512f_64_Float, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, 
+         cCompilerPack>(pParams);
+      return Error_None;
+   }
+
+
+   template<bool bHessian, size_t cCompilerScores, size_t cCompilerDimensions, bool bWeight>
+   INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsInteraction(BinSumsInteractionBridge * const pParams) noexcept {
+      RemoteBinSumsInteraction<Avx512f_64_Float, bHessian, cCompilerScores, cCompilerDimensions, bWeight>(pParams);
+      return Error_None;
+   }
+
+
+private:
+
+   inline Avx512f_64_Float(const TPack & data) noexcept : m_data(data) {
+   }
+
+   TPack m_data;
+};
+static_assert(std::is_standard_layout<Avx512f_64_Float>::value && std::is_trivially_copyable<Avx512f_64_Float>::value,
+   "This allows offsetof, memcpy, memset, inter-language, GPU and cross-machine use where needed");
+
+// FIRST, define the RegisterObjective function that we'll be calling from our registrations.  This is a static 
+// function, so we can have duplicate named functions in other files and they'll refer to different functions
+template<template <typename> class TRegistrable, bool bCpuOnly, typename... Args>
+INLINE_ALWAYS static typename std::enable_if<bCpuOnly, std::shared_ptr<const Registration>>::type RegisterObjective(const char * const, const Args &...) {
+   return nullptr;
+}
+template<template <typename> class TRegistrable, bool bCpuOnly, typename... Args>
+INLINE_ALWAYS static typename std::enable_if<!bCpuOnly, std::shared_ptr<const Registration>>::type RegisterObjective(const char * const sRegistrationName, const Args &... args) {
+   return Register<TRegistrable, Avx512f_64_Float>(bCpuOnly, sRegistrationName, args...);
+}
+
+// now include all our special objective registrations which will use the RegisterObjective function we defined above!
+#include "objective_registrations.hpp"
+
+INTERNAL_IMPORT_EXPORT_BODY ErrorEbm CreateObjective_Avx512f_64(
+   const Config * const pConfig,
+   const char * const sObjective,
+   const char * const sObjectiveEnd,
+   ObjectiveWrapper * const pObjectiveWrapperOut
+) {
+   ErrorEbm error = ComputeWrapper<Avx512f_64_Float>::FillWrapper(pObjectiveWrapperOut);
+   if(Error_None != error) {
+      return error;
+   }
+   return Objective::CreateObjective(&RegisterObjectives, pConfig, sObjective, sObjectiveEnd, pObjectiveWrapperOut);
+}
+
+INTERNAL_IMPORT_EXPORT_BODY void DiscretizeBroadcast_Avx512f_64(
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cCuts,
+   const double * const aCutsLowerBoundInclusive,
+   IntEbm * const aBinIndexesOut
+) {
+   // each cut is broadcast and compared against 8 values at once, and the lanes where the cut is lower or equal
+   // are incremented.  NaN fails every ordered comparison, and is then zeroed into the missing bin 0.  The final
+   // partial group of values uses masked loads and stores instead of a scalar loop
+   EBM_ASSERT(1 <= cCuts);
+
+   const double * pVal = aFeatureVals;
+   const double * const pValsEnd = aFeatureVals + cSamples;
+   IntEbm * piBin = aBinIndexesOut;
+   const double * const pCutsEnd = aCutsLowerBoundInclusive + cCuts;
+
+   const __m512i one = _mm512_set1_epi64(1);
+   while(pValsEnd != pVal) {
+      const size_t cRemaining = static_cast<size_t>(pValsEnd - pVal);
+      const __mmask8 load = size_t { 8 } <= cRemaining ? static_cast<__mmask8>(0xFF) : 
+         static_cast<__mmask8>((1u << cRemaining) - 1u);
+      const __m512d val = _mm512_maskz_loadu_pd(load, pVal);
+      __m512i iBin = one;
+      const double * pCut = aCutsLowerBoundInclusive;
+      do {
+         const __m512d cut = _mm512_set1_pd(*pCut);
+         iBin = _mm512_mask_add_epi64(iBin, _mm512_cmp_pd_mask(cut, val, _CMP_LE_OQ), iBin, one);
+         ++pCut;
+      } while(pCutsEnd != pCut);
+      iBin = _mm512_maskz_mov_epi64(_mm512_cmp_pd_mask(val, val, _CMP_ORD_Q), iBin);
+      _mm512_mask_storeu_epi64(piBin, load, iBin);
+      const size_t cProcessed = size_t { 8 } <= cRemaining ? size_t { 8 } : cRemaining;
+      pVal += cProcessed;
+      piBin += cProcessed;
+   }
+}
+
+INTERNAL_IMPORT_EXPORT_BODY void DiscretizeEytzinger_Avx512f_64(
+   const size_t cSamples,
+   const double * const aFeatureVals,
+   const size_t cLevels,
+   const double * const aTree,
+   IntEbm * const aBinIndexesOut
+) {
+   // every search descends exactly cLevels levels, so 8 searches proceed in lockstep with one gather per level.
+   // After descending, the node index is 2^cLevels plus the number of cuts that are lower or equal to the value
+   EBM_ASSERT(1 <= cLevels);
+
+   const double * pVal = aFeatureVals;
+   const double * const pValsEnd = aFeatureVals + cSamples;
+   IntEbm * piBin = aBinIndexesOut;
+
+   const __m512i one = _mm512_set1_epi64(1);
+   const __m512i leafToBin = _mm512_set1_epi64((IntEbm { 1 } << cLevels) - IntEbm { 1 });
+   while(pValsEnd != pVal) {
+      const size_t cRemaining = static_cast<size_t>(pValsEnd - pVal);
+      const __mmask8 load = size_t { 8 } <= cRemaining ? static_cast<__mmask8>(0xFF) : 
+         static_cast<__mmask8>((1u << cRemaining) - 1u);
+      // lanes past the end load as 0.0, which still descends to a valid node, and their results are not stored
+      const __m512d val = _mm512_maskz_loadu_pd(load, pVal);
+      __m512i iNode = one;
+      size_t iLevel = cLevels;
+      do {
+         const __m512d cut = _mm512_i64gather_pd(iNode, aTree, sizeof(double));
+         const __m512i doubled = _mm512_add_epi64(iNode, iNode);
+         iNode = _mm512_mask_add_epi64(doubled, _mm512_cmp_pd_mask(cut, val, _CMP_LE_OQ), doubled, one);
+         --iLevel;
+      } while(0 != iLevel);
+      const __m512i iBin = _mm512_maskz_sub_epi64(_mm512_cmp_pd_mask(val, val, _CMP_ORD_Q), iNode, leafToBin);
+      _mm512_mask_storeu_epi64(piBin, load, iBin);
+      const size_t cProcessed = size_t { 8 } <= cRemaining ? size_t { 8 } : cRemaining;
+      pVal += cProcessed;
+      piBin += cProcessed;
+   }
+}
+
+} // DEFINED_ZONE_NAME
@@ -40,6 +40,7 @@ struct Cpu_64_Int final {
    static_assert(std::is_same<UIntBig, T>::value || std::is_same<UIntSmall, T>::value,
       "T must be either UIntBig or UIntSmall");
    static constexpr bool k_bCpu = true;
+   static constexpr bool k_bScatter = false;
    static constexpr int k_cSIMDShift = 0;
    static constexpr int k_cSIMDPack = 1 << k_cSIMDShift;
 
@@ -105,6 +106,7 @@ struct Cpu_64_Float final {
    static_assert(std::is_same<FloatBig, T>::value || std::is_same<FloatSmall, T>::value,
       "T must be either FloatBig or FloatSmall");
    static constexpr bool k_bCpu = TInt::k_bCpu;
+   static constexpr bool k_bScatter = TInt::k_bScatter;
    static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
    static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
 
@@ -209,6 +211,10 @@ struct Cpu_64_Float final {
       *a = m_data;
    }
 
+   inline static Cpu_64_Float LoadBytes(const uint8_t * const a) noexcept {
+      return Cpu_64_Float(static_cast<T>(*a));
+   }
+
    inline static Cpu_64_Float Load(const T * const a, const TInt & i) noexcept {
       return Cpu_64_Float(a[i.m_data]);
    }
@@ -331,9 +337,11 @@ struct Cpu_64_Float final {
    }
 
 
-   template<bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, int cCompilerPack>
+   template<bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, bool bMultiplyOccurrences, 
+      int cCompilerPack>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
-      RemoteBinSumsBoosting<Cpu_64_Float, bHessian, cCompilerScores, bWeight, bReplication, cCompilerPack>(pParams);
+      RemoteBinSumsBoosting<Cpu_64_Float, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, 
+         cCompilerPack>(pParams);
       return Error_None;
    }
 
@@ -47,6 +47,7 @@ struct Cuda_32_Int final {
    static_assert(std::is_same<UIntBig, T>::value || std::is_same<UIntSmall, T>::value,
       "T must be either UIntBig or UIntSmall");
    static constexpr bool k_bCpu = false;
+   static constexpr bool k_bScatter = false;
    static constexpr int k_cSIMDShift = 0;
    static constexpr int k_cSIMDPack = 1 << k_cSIMDShift;
 
@@ -115,6 +116,7 @@ struct Cuda_32_Float final {
    static_assert(std::is_same<FloatBig, T>::value || std::is_same<FloatSmall, T>::value,
       "T must be either FloatBig or FloatSmall");
    static constexpr bool k_bCpu = TInt::k_bCpu;
+   static constexpr bool k_bScatter = TInt::k_bScatter;
    static constexpr int k_cSIMDShift = TInt::k_cSIMDShift;
    static constexpr int k_cSIMDPack = TInt::k_cSIMDPack;
 
@@ -219,6 +221,10 @@ struct Cuda_32_Float final {
       *a = m_data;
    }
 
+   GPU_BOTH inline static Cuda_32_Float LoadBytes(const uint8_t * const a) noexcept {
+      return Cuda_32_Float(static_cast<T>(*a));
+   }
+
    GPU_BOTH inline static Cuda_32_Float Load(const T * const a, const TInt & i) noexcept {
       return Cuda_32_Float(a[i.m_data]);
    }
@@ -464,11 +470,13 @@ struct Cuda_32_Float final {
 
 
 
-   template<bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, int cCompilerPack>
+   template<bool bHessian, size_t cCompilerScores, bool bWeight, bool bReplication, bool bMultiplyOccurrences, 
+      int cCompilerPack>
    INLINE_RELEASE_TEMPLATED static ErrorEbm OperatorBinSumsBoosting(BinSumsBoostingBridge * const pParams) noexcept {
       // TODO: move memory to the GPU and return errors
       static constexpr size_t k_cItems = 5;
-      RemoteBinSumsBoosting<Cuda_32_Float, bHessian, cCompilerScores, bWeight, bReplication, cCompilerPack><<<1, k_cItems>>>(pParams);
+      RemoteBinSumsBoosting<Cuda_32_Float, bHessian, cCompilerScores, bWeight, bReplication, bMultiplyOccurrences, 
+         cCompilerPack><<<1, k_cItems>>>(pParams);
       return Error_None;
    }
 
@@ -135,6 +135,13 @@ struct LogLossBinaryObjective : BinaryObjective {
 
       const typename TFloat::TInt::T * pTargetData = reinterpret_cast<const typename TFloat::TInt::T *>(pData->m_aTargets);
 
+      // datasets sorted by target give all the samples in a subset the same target, so we do not need to stream them
+      const bool bUniformTarget = EBM_FALSE != pData->m_bUniformTarget;
+      typename TFloat::TInt target;
+      if(bUniformTarget) {
+         target = pTargetData[0];
+      }
+
       const typename TFloat::T * pWeight;
       TFloat metricSum;
       typename TFloat::T * pGradientAndHessian;
@@ -159,8 +166,8 @@ struct LogLossBinaryObjective : BinaryObjective {
             pInputData += TFloat::TInt::k_cSIMDPack;
          }
          while(true) {
-            // TODO: the speed of this loop can probably be improved by (AFTER eliminating the target by sorting the data):
-            //   0) eliminate the target by sorting the data and making it a templated argument, so it has 0 CPU cost
+            // TODO: the speed of this loop can probably be improved by:
+            //   0) when bUniformTarget, make the target a templated argument, so it has 0 CPU cost
             //   1) fetch the score from memory (predictable load is fast)
             //   2) issue the gather operation FOR THE NEXT loop(unpredictable load is slow)
             //   3) move the fetched gather operation from the previous loop into a new register
@@ -174,8 +181,10 @@ struct LogLossBinaryObjective : BinaryObjective {
                updateScore = TFloat::Load(aUpdateTensorScores, iTensorBin);
             }
 
-            const typename TFloat::TInt target = TFloat::TInt::Load(pTargetData);
-            pTargetData += TFloat::TInt::k_cSIMDPack;
+            if(!bUniformTarget) {
+               target = TFloat::TInt::Load(pTargetData);
+               pTargetData += TFloat::TInt::k_cSIMDPack;
+            }
 
             TFloat sampleScore = TFloat::Load(pSampleScore);
             sampleScore += updateScore;
@@ -154,6 +154,11 @@ struct LogLossMulticlassObjective : MulticlassObjective {
       const typename TFloat::TInt::T * pTargetData = 
          reinterpret_cast<const typename TFloat::TInt::T *>(pData->m_aTargets);
 
+      // datasets sorted by target give all the samples in a subset the same target, so instead of gathering
+      // and scattering through the per-sample targets we can use contiguous loads and stores at a fixed offset
+      const bool bUniformTarget = EBM_FALSE != pData->m_bUniformTarget;
+      const size_t iUniformTarget = static_cast<size_t>(pTargetData[0]);
+
       const typename TFloat::T * pWeight;
       TFloat metricSum;
       typename TFloat::T * pGradientAndHessian;
@@ -178,8 +183,8 @@ struct LogLossMulticlassObjective : MulticlassObjective {
             pInputData += TFloat::TInt::k_cSIMDPack;
          }
          while(true) {
-            // TODO: the speed of this loop can probably be improved by (AFTER eliminating the target by sorting the data):
-            //   0) eliminate the target by sorting the data and making it a templated argument, so it has 0 CPU cost
+            // TODO: the speed of this loop can probably be improved by:
+            //   0) when bUniformTarget, make the target a templated argument, so it has 0 CPU cost
             //   1) fetch the score from memory (predictable load is fast)
             //   2) issue the gather operation FOR THE NEXT loop(unpredictable load is slow)
             //   3) move the fetched gather operation from the previous loop into a new register
@@ -231,8 +236,11 @@ struct LogLossMulticlassObjective : MulticlassObjective {
                ++iScore1;
             } while(cScores != iScore1);
 
-            typename TFloat::TInt target = TFloat::TInt::Load(pTargetData);
-            pTargetData += TFloat::TInt::k_cSIMDPack;
+            typename TFloat::TInt target;
+            if(!bUniformTarget) {
+               target = TFloat::TInt::Load(pTargetData);
+               pTargetData += TFloat::TInt::k_cSIMDPack;
+            }
 
             if(bValidation) {
                // TODO: instead of writing the exp values to memory, since we just need 1 and the sum, 
@@ -240,12 +248,14 @@ struct LogLossMulticlassObjective : MulticlassObjective {
                // to store (or re-load) from memory.  This also saves us a gathering load, which will be expensive
                // in latency
 
-               target = target << TFloat::k_cSIMDShift;
-               target = target + TFloat::TInt::MakeIndexes();
-
-               // TODO: after we finish sorting our dataset, all the target values in this datasubset will be
-               // identical, so instead of calling LoadScattered we'll be able to call LoadAligned
-               const TFloat itemExp = TFloat::Load(aExps, target);
+               TFloat itemExp;
+               if(bUniformTarget) {
+                  itemExp = TFloat::Load(&aExps[iUniformTarget << TFloat::k_cSIMDShift]);
+               } else {
+                  target = target << TFloat::k_cSIMDShift;
+                  target = target + TFloat::TInt::MakeIndexes();
+                  itemExp = TFloat::Load(aExps, target);
+               }
                const TFloat invertedProbability = FastApproxDivide(sumExp, itemExp);
                TFloat metric = TFloat::template ApproxLog<false>(invertedProbability);
 
@@ -286,19 +296,24 @@ struct LogLossMulticlassObjective : MulticlassObjective {
                   ++iScore2;
                } while(cScores != iScore2);
 
-               if(bHessian) {
-                  target = target << (TFloat::k_cSIMDShift + 1);
+               if(bUniformTarget) {
+                  typename TFloat::T * const pAdjust = &pGradientAndHessian[
+                     iUniformTarget << (bHessian ? (TFloat::k_cSIMDShift + 1) : TFloat::k_cSIMDShift)];
+                  TFloat adjust = TFloat::Load(pAdjust);
+                  adjust -= 1.0;
+                  adjust.Store(pAdjust);
                } else {
-                  target = target << TFloat::k_cSIMDShift;
+                  if(bHessian) {
+                     target = target << (TFloat::k_cSIMDShift + 1);
+                  } else {
+                     target = target << TFloat::k_cSIMDShift;
+                  }
+                  target = target + TFloat::TInt::MakeIndexes();
+
+                  TFloat adjust = TFloat::Load(pGradientAndHessian, target);
+                  adjust -= 1.0;
+                  adjust.Store(pGradientAndHessian, target);
                }
-               target = target + TFloat::TInt::MakeIndexes();
-
-               // TODO: after we finish sorting our dataset, all the target values in this datasubset will be
-               // identical, so instead of calling LoadScattered and SaveScattered we'll be able to call
-               // LoadAligned and SaveAligned
-               TFloat adjust = TFloat::Load(pGradientAndHessian, target);
-               adjust -= 1.0;
-               adjust.Store(pGradientAndHessian, target);
 
                pGradientAndHessian += cScores << (bHessian ? (TFloat::k_cSIMDShift + 1) : TFloat::k_cSIMDShift);
             }
@@ -6,7 +6,7 @@
 
 #include <stddef.h> // size_t, ptrdiff_t
 
-#if defined(BRIDGE_AVX512F_32) || defined(BRIDGE_AVX2_32)
+#if defined(BRIDGE_AVX512F_32) || defined(BRIDGE_AVX2_32) || defined(BRIDGE_AVX512F_64) || defined(BRIDGE_AVX2_64)
 #define INTEL_SIMD
 #endif
 
@@ -29,6 +29,15 @@
 
 #include "common_cpp.hpp" // INLINE_RELEASE_UNTEMPLATED
 
+#ifdef WRAP_HEAP_FUNCTIONS
+#include <atomic>
+
+// kept by the malloc/calloc/realloc/free wrappers in special/linux_wrap_functions.cpp
+extern std::atomic<int64_t> g_cHeapCalls;
+extern std::atomic<int64_t> g_cHeapBytes;
+extern std::atomic<int64_t> g_cHeapBytesPeak;
+#endif // WRAP_HEAP_FUNCTIONS
+
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
 #error DEFINED_ZONE_NAME must be defined
@@ -138,11 +147,70 @@ static bool IsFMA3() {
 
 #endif // INTEL_SIMD
 
+// process wide like the trace level. This is only meant for tests and benchmarks, so it isn't synchronized
+static SIMDFlags g_simdFlags = SIMDFlags_Default;
+
+EBM_API_BODY void EBM_CALLING_CONVENTION SetSIMDFlags(SIMDFlags flags) {
+   LOG_N(Trace_Info, "Entered SetSIMDFlags: flags=0x%" USIMDFlagsPrintf, static_cast<USIMDFlags>(flags));
+
+   if(0 != (static_cast<USIMDFlags>(flags) & static_cast<USIMDFlags>(~(
+      static_cast<USIMDFlags>(SIMDFlags_DisableLaneHistograms) |
+      static_cast<USIMDFlags>(SIMDFlags_DisableAVX512F) |
+      static_cast<USIMDFlags>(SIMDFlags_DisableAVX2)
+   )))) {
+      LOG_0(Trace_Error, "ERROR SetSIMDFlags flags contains unknown flags. Ignoring extras.");
+   }
+
+   g_simdFlags = flags;
+}
+
+extern SIMDFlags GetSIMDFlags() noexcept {
+   return g_simdFlags;
+}
+
+EBM_API_BODY void EBM_CALLING_CONVENTION GetHeapCounters(
+   BoolEbm isResetPeak,
+   IntEbm * countCallsOut,
+   IntEbm * countBytesOut,
+   IntEbm * countBytesPeakOut
+) {
+   // no logging here since the log calls themselves could touch the heap and disturb the counts
+
+#ifdef WRAP_HEAP_FUNCTIONS
+   static_assert(sizeof(IntEbm) == sizeof(int64_t), "IntEbm must hold the int64_t counters");
+
+   const int64_t cCalls = g_cHeapCalls.load(std::memory_order_relaxed);
+   const int64_t cBytes = g_cHeapBytes.load(std::memory_order_relaxed);
+   const int64_t cBytesPeak = g_cHeapBytesPeak.load(std::memory_order_relaxed);
+   if(EBM_FALSE != isResetPeak) {
+      g_cHeapBytesPeak.store(cBytes, std::memory_order_relaxed);
+   }
+#else // WRAP_HEAP_FUNCTIONS
+   UNUSED(isResetPeak);
+
+   // this build does not route heap calls through a wrapper, so there is nothing to report
+   const IntEbm cCalls = IntEbm { -1 };
+   const IntEbm cBytes = IntEbm { -1 };
+   const IntEbm cBytesPeak = IntEbm { -1 };
+#endif // WRAP_HEAP_FUNCTIONS
+
+   if(nullptr != countCallsOut) {
+      *countCallsOut = static_cast<IntEbm>(cCalls);
+   }
+   if(nullptr != countBytesOut) {
+      *countBytesOut = static_cast<IntEbm>(cBytes);
+   }
+   if(nullptr != countBytesPeakOut) {
+      *countBytesPeakOut = static_cast<IntEbm>(cBytesPeak);
+   }
+}
+
 extern ErrorEbm GetObjective(
    const Config * const pConfig,
    const char * sObjective,
    ObjectiveWrapper * const pCpuObjectiveWrapperOut,
-   ObjectiveWrapper * const pSIMDObjectiveWrapperOut
+   ObjectiveWrapper * const pSIMDObjectiveWrapperOut,
+   const bool bDoublePrecisionSIMD
 ) noexcept {
    EBM_ASSERT(nullptr != pConfig);
    EBM_ASSERT(nullptr != pCpuObjectiveWrapperOut);
@@ -173,11 +241,44 @@ extern ErrorEbm GetObjective(
       // TODO: add a flag in the pCpuObjectiveWrapperOut struct that indicates if the objective can be SIMDed
       //       we first make the cpu version and if that says it can't be SIMDed then we shouldn't try
       while(true) {
+         if(bDoublePrecisionSIMD) {
+            // the float64 zones process half as many samples per instruction, but they keep the same precision as
+            // the cpu zone and don't require splitting the data into float32 sized subsets. Unlike AVX512F_32 below,
+            // we build AVX512F_64 into the release library since the float64 zones are only reached by callers that
+            // opt in with DoublePrecisionSIMD, and the tests compare it to both AVX2_64 and the cpu zone
+#ifdef BRIDGE_AVX512F_64
+            LOG_0(Trace_Info, "INFO GetObjective checking for AVX512F float64 compatibility");
+            if(0 == (SIMDFlags_DisableAVX512F & g_simdFlags) && 9 <= DetectInstructionset()) {
+               LOG_0(Trace_Info, "INFO GetObjective creating AVX512F float64 SIMD Objective");
+               error = CreateObjective_Avx512f_64(pConfig, sObjective, sObjectiveEnd, pSIMDObjectiveWrapperOut);
+               if(Error_None != error) {
+                  return error;
+               }
+               break;
+            }
+#endif // BRIDGE_AVX512F_64
+
+#ifdef BRIDGE_AVX2_64
+            LOG_0(Trace_Info, "INFO GetObjective checking for AVX2 float64 compatibility");
+            if(0 == (SIMDFlags_DisableAVX2 & g_simdFlags) && 8 <= DetectInstructionset() && IsFMA3()) {
+               LOG_0(Trace_Info, "INFO GetObjective creating AVX2 float64 SIMD Objective");
+               error = CreateObjective_Avx2_64(pConfig, sObjective, sObjectiveEnd, pSIMDObjectiveWrapperOut);
+               if(Error_None != error) {
+                  return error;
+               }
+               break;
+            }
+#endif // BRIDGE_AVX2_64
+
+            LOG_0(Trace_Info, "INFO GetObjective no float64 SIMD option found");
+            break;
+         }
+
 #ifdef BRIDGE_AVX512F_32
          // TODO: enabled AVX512f, but only after we've had some time verifying AVX2 works
          //       before enabling this we need to test that it produces nearly identical results as AVX2
          LOG_0(Trace_Info, "INFO GetObjective checking for AVX512F compatibility");
-         if(9 <= DetectInstructionset()) {
+         if(0 == (SIMDFlags_DisableAVX512F & g_simdFlags) && 9 <= DetectInstructionset()) {
             LOG_0(Trace_Info, "INFO GetObjective creating AVX512F SIMD Objective");
             error = CreateObjective_Avx512f_32(pConfig, sObjective, sObjectiveEnd, pSIMDObjectiveWrapperOut);
             if(Error_None != error) {
@@ -189,7 +290,7 @@ extern ErrorEbm GetObjective(
 
 #ifdef BRIDGE_AVX2_32
          LOG_0(Trace_Info, "INFO GetObjective checking for AVX2 compatibility");
-         if(8 <= DetectInstructionset() && IsFMA3()) {
+         if(0 == (SIMDFlags_DisableAVX2 & g_simdFlags) && 8 <= DetectInstructionset() && IsFMA3()) {
             LOG_0(Trace_Info, "INFO GetObjective creating AVX2 SIMD Objective");
             error = CreateObjective_Avx2_32(pConfig, sObjective, sObjectiveEnd, pSIMDObjectiveWrapperOut);
             if(Error_None != error) {
@@ -207,6 +308,51 @@ extern ErrorEbm GetObjective(
    return Error_None;
 }
 
+static DiscretizeKernels DetectDiscretizeKernels(const SIMDFlags simdFlags) noexcept {
+   DiscretizeKernels kernels;
+   kernels.m_pDiscretizeBroadcastC = nullptr;
+   kernels.m_pDiscretizeEytzingerC = nullptr;
+
+   UNUSED(simdFlags); // unused if none of the SIMD zones are built
+
+#ifdef BRIDGE_AVX512F_64
+   LOG_0(Trace_Info, "INFO DetectDiscretizeKernels checking for AVX512F compatibility");
+   if(0 == (SIMDFlags_DisableAVX512F & simdFlags) && 9 <= DetectInstructionset()) {
+      LOG_0(Trace_Info, "INFO DetectDiscretizeKernels using AVX512F Discretize kernels");
+      kernels.m_pDiscretizeBroadcastC = DiscretizeBroadcast_Avx512f_64;
+      kernels.m_pDiscretizeEytzingerC = DiscretizeEytzinger_Avx512f_64;
+      return kernels;
+   }
+#endif // BRIDGE_AVX512F_64
+
+#ifdef BRIDGE_AVX2_64
+   LOG_0(Trace_Info, "INFO DetectDiscretizeKernels checking for AVX2 compatibility");
+   if(0 == (SIMDFlags_DisableAVX2 & simdFlags) && 8 <= DetectInstructionset() && IsFMA3()) {
+      LOG_0(Trace_Info, "INFO DetectDiscretizeKernels using AVX2 Discretize kernels");
+      kernels.m_pDiscretizeBroadcastC = DiscretizeBroadcast_Avx2_64;
+      kernels.m_pDiscretizeEytzingerC = DiscretizeEytzinger_Avx2_64;
+      return kernels;
+   }
+#endif // BRIDGE_AVX2_64
+
+   LOG_0(Trace_Info, "INFO DetectDiscretizeKernels no SIMD option found");
+   return kernels;
+}
+
+extern const DiscretizeKernels * GetDiscretizeKernels() noexcept {
+   // Discretize can be called once per feature or even once per sample, so only run CPUID the first time. We keep
+   // one choice for each combination of the SIMDFlags that can skip a zone
+   static const DiscretizeKernels s_aKernels[4] = {
+      DetectDiscretizeKernels(SIMDFlags_Default),
+      DetectDiscretizeKernels(SIMDFlags_DisableAVX512F),
+      DetectDiscretizeKernels(SIMDFlags_DisableAVX2),
+      DetectDiscretizeKernels(SIMDFlags_DisableAVX512F | SIMDFlags_DisableAVX2)
+   };
+   const size_t iKernels = (0 == (SIMDFlags_DisableAVX512F & g_simdFlags) ? size_t { 0 } : size_t { 1 }) | 
+      (0 == (SIMDFlags_DisableAVX2 & g_simdFlags) ? size_t { 0 } : size_t { 2 });
+   return &s_aKernels[iKernels];
+}
+
 #ifdef NEVER
 // TODO: eventually enable metrics
 INLINE_RELEASE_UNTEMPLATED static ErrorEbm GetMetrics(
@@ -4,7 +4,7 @@
 
 #include "precompiled_header_cpp.hpp"
 
-#include <stdlib.h> // free
+#include <stdlib.h> // malloc, free
 #include <stddef.h> // size_t, ptrdiff_t
 #include <string.h> // memcpy
 
@@ -16,6 +16,7 @@
 
 #include "ebm_internal.hpp"
 #include "dataset_shared.hpp"
+#include "ThreadPool.hpp"
 
 namespace DEFINED_ZONE_NAME {
 #ifndef DEFINED_ZONE_NAME
@@ -154,7 +155,6 @@ static_assert(std::is_trivial<FeatureDataSetShared>::value,
    "These structs are shared between processes, so they definetly need to be standard layout and trivial");
 
 struct SparseFeatureDataSetShared {
-   // TODO: implement sparse features
    UIntShared m_defaultVal;
    UIntShared m_cNonDefaults;
 
@@ -516,12 +516,20 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION CheckDataSet(IntEbm countBytesAlloc
 
             const SparseFeatureDataSetSharedEntry * pNonDefault = ArrayToPointer(pSparseFeatureDataSetShared->m_nonDefaults);
             const SparseFeatureDataSetSharedEntry * const pNonDefaultEnd = &pNonDefault[cNonDefaults];
+            UIntShared iSampleMin = 0;
             while(pNonDefaultEnd != pNonDefault) {
                if(countSamples <= pNonDefault->m_iSample) {
                   LOG_0(Trace_Error, "ERROR CheckDataSet countSamples <= pNonDefault->m_iSample");
                   return Error_IllegalParamVal;
                }
 
+               // the readers walk the samples in order, so the entries need to be sorted and unique
+               if(pNonDefault->m_iSample < iSampleMin) {
+                  LOG_0(Trace_Error, "ERROR CheckDataSet pNonDefault->m_iSample < iSampleMin");
+                  return Error_IllegalParamVal;
+               }
+               iSampleMin = pNonDefault->m_iSample + UIntShared { 1 };
+
                if(countBins <= pNonDefault->m_nonDefaultVal) {
                   LOG_0(Trace_Error, "ERROR CheckDataSet countBins <= pNonDefault->m_nonDefaultVal");
                   return Error_IllegalParamVal;
@@ -977,26 +985,396 @@ static IntEbm AppendHeader(
 }
 WARNING_POP
 
-static bool DecideIfSparse(const size_t cSamples, const IntEbm * binIndexes) {
+template<typename TBinIndex>
+static bool DecideIfSparse(
+   const size_t cSamples,
+   const TBinIndex * const binIndexes,
+   const size_t cBinIndexStride,
+   const UIntShared cBins,
+   IntEbm * const pDefaultBinIndexOut,
+   size_t * const pcNonDefaultsOut
+) {
+   EBM_ASSERT(1 <= cSamples);
+   EBM_ASSERT(nullptr != binIndexes);
+   EBM_ASSERT(1 <= cBinIndexStride);
+   EBM_ASSERT(UIntShared { 2 } <= cBins);
+   EBM_ASSERT(nullptr != pDefaultBinIndexOut);
+   EBM_ASSERT(nullptr != pcNonDefaultsOut);
+
    // For sparsity in the data set shared memory the only thing that matters is compactness since we don't use
-   // this memory in any high performance loops
+   // this memory in any high performance loops. The readers expand sparse features into the dense form.
+
+   const int cBitsRequiredMin = CountBitsRequired(cBins - UIntShared { 1 });
+   const int cItemsPerBitPack = GetCountItemsBitPacked<UIntShared>(cBitsRequiredMin);
+   const size_t cDataUnits = (cSamples - size_t { 1 }) / static_cast<size_t>(cItemsPerBitPack) + size_t { 1 };
+   // PackFeature checked that sizeof(IntEbm) * cSamples fits, so this cannot overflow
+   static_assert(sizeof(UIntShared) <= sizeof(IntEbm), "the dense size needs to fit into the bin index memory");
+   const size_t cBytesDense = sizeof(UIntShared) * cDataUnits;
+   if(cBytesDense <= offsetof(SparseFeatureDataSetShared, m_nonDefaults)) {
+      return false;
+   }
+   // the sparse form is smaller than the dense one only if there are no more than this many non-default samples
+   const size_t cNonDefaultsMax = (cBytesDense - offsetof(SparseFeatureDataSetShared, m_nonDefaults) - size_t { 1 }) /
+      sizeof(SparseFeatureDataSetSharedEntry);
+   static_assert(size_t { 2 } * sizeof(UIntShared) <= sizeof(SparseFeatureDataSetSharedEntry),
+      "each sparse entry needs to be at least twice the size of the largest dense item for the vote below");
+   EBM_ASSERT(cNonDefaultsMax < cSamples - cNonDefaultsMax);
+
+   // If at most cNonDefaultsMax samples are outside of the default bin, then the default bin holds the majority of
+   // the first 2 * cNonDefaultsMax + 1 samples, so the Boyer-Moore majority vote only needs to visit those. The
+   // count that follows stops as soon as the candidate has too many non-default samples, so dense features only
+   // visit a fraction of their samples here.
+   // the bin indexes can be a strided column of a matrix, so walk them by index rather than forming pointers that
+   // could land beyond the end of the matrix. The caller checked that cSamples * cBinIndexStride does not overflow
+   const size_t iBinIndexVoteEnd = (cNonDefaultsMax * size_t { 2 } + size_t { 1 }) * cBinIndexStride;
+   IntEbm indexCandidate = static_cast<IntEbm>(binIndexes[0]);
+   size_t cVotes = 0;
+   size_t iBinIndex = 0;
+   do {
+      const IntEbm indexBin = static_cast<IntEbm>(binIndexes[iBinIndex]);
+      if(size_t { 0 } == cVotes) {
+         indexCandidate = indexBin;
+      }
+      cVotes = indexCandidate == indexBin ? cVotes + size_t { 1 } : cVotes - size_t { 1 };
+      iBinIndex += cBinIndexStride;
+   } while(iBinIndexVoteEnd != iBinIndex);
+
+   const size_t iBinIndexEnd = cSamples * cBinIndexStride;
+   size_t cNonDefaults = 0;
+   iBinIndex = 0;
+   do {
+      if(indexCandidate != static_cast<IntEbm>(binIndexes[iBinIndex])) {
+         ++cNonDefaults;
+         if(cNonDefaultsMax < cNonDefaults) {
+            return false;
+         }
+      }
+      iBinIndex += cBinIndexStride;
+   } while(iBinIndexEnd != iBinIndex);
 
-   UNUSED(cSamples);
-   UNUSED(binIndexes);
+   *pDefaultBinIndexOut = indexCandidate;
+   *pcNonDefaultsOut = cNonDefaults;
+   return true;
+}
 
-   // TODO: evalute the data to decide if the feature should be sparse or not
-   return false;
+// Validates a single feature and returns the number of bytes it occupies, including its FeatureDataSetShared. When 
+// pFeatureMem is not nullptr the feature is also written there. Nothing in the dataset header is read or written, 
+// so features whose offsets are already known can be packed concurrently.
+WARNING_PUSH
+WARNING_REDUNDANT_CODE
+template<typename TBinIndex>
+static IntEbm PackFeature(
+   const IntEbm countBins,
+   const BoolEbm isMissing,
+   const BoolEbm isUnknown,
+   const BoolEbm isNominal,
+   const size_t cSamples,
+   const TBinIndex * const binIndexes,
+   const size_t cBinIndexStride,
+   const size_t cBytesAvailable,
+   unsigned char * const pFeatureMem
+) {
+   EBM_ASSERT(1 <= cBinIndexStride);
+   EBM_ASSERT(!IsMultiplyError(cSamples, cBinIndexStride));
+   EBM_ASSERT(!IsConvertError<UIntShared>(cSamples));
+
+   if(countBins <= IntEbm { 1 }) {
+      LOG_0(Trace_Error, "ERROR PackFeature countBins must be 2 or larger");
+      return Error_IllegalParamVal;
+   }
+   // we do not need to access memory based on the value of countBins, so we do not need to check if fits into size_t
+   if(IsConvertError<UIntShared>(countBins)) {
+      LOG_0(Trace_Error, "ERROR PackFeature countBins is outside the range of a valid index");
+      return Error_IllegalParamVal;
+   }
+   UIntShared cBins = static_cast<UIntShared>(countBins);
+   cBins -= EBM_FALSE != isMissing ? UIntShared { 0 } : UIntShared { 1 };
+   cBins -= EBM_FALSE != isUnknown ? UIntShared { 0 } : UIntShared { 1 };
+
+   if(EBM_FALSE != isMissing && EBM_TRUE != isMissing) {
+      LOG_0(Trace_Error, "ERROR PackFeature isMissing is not EBM_FALSE or EBM_TRUE");
+      return Error_IllegalParamVal;
+   }
+   if(EBM_FALSE != isUnknown && EBM_TRUE != isUnknown) {
+      LOG_0(Trace_Error, "ERROR PackFeature isUnknown is not EBM_FALSE or EBM_TRUE");
+      return Error_IllegalParamVal;
+   }
+   if(EBM_FALSE != isNominal && EBM_TRUE != isNominal) {
+      LOG_0(Trace_Error, "ERROR PackFeature isNominal is not EBM_FALSE or EBM_TRUE");
+      return Error_IllegalParamVal;
+   }
+
+   bool bSparse = false;
+   IntEbm indexBinDefault = 0;
+   size_t cNonDefaults = 0;
+   if(size_t { 0 } != cSamples) {
+      if(nullptr == binIndexes) {
+         LOG_0(Trace_Error, "ERROR PackFeature nullptr == binIndexes");
+         return Error_IllegalParamVal;
+      }
+      // narrow bin indexes can hold more samples in memory than the sizes computed in DecideIfSparse allow for
+      if(IsMultiplyError(sizeof(IntEbm), cSamples)) {
+         LOG_0(Trace_Error, "ERROR PackFeature IsMultiplyError(sizeof(IntEbm), cSamples)");
+         return Error_IllegalParamVal;
+      }
+
+      if(UIntShared { 1 } < cBins) {
+         bSparse = DecideIfSparse(cSamples, binIndexes, cBinIndexStride, cBins, &indexBinDefault, &cNonDefaults);
+      }
+   }
+
+   size_t iByteCur = sizeof(FeatureDataSetShared);
+   if(nullptr != pFeatureMem) {
+      // if we're going to access FeatureDataSetShared, then check if we have the space
+      if(cBytesAvailable < iByteCur) {
+         LOG_0(Trace_Error, "ERROR PackFeature cBytesAvailable < iByteCur");
+         return Error_IllegalParamVal;
+      }
+
+      FeatureDataSetShared * const pFeatureDataSetShared = reinterpret_cast<FeatureDataSetShared *>(pFeatureMem);
+
+      pFeatureDataSetShared->m_id = GetFeatureId(
+         EBM_FALSE != isMissing,
+         EBM_FALSE != isUnknown,
+         EBM_FALSE != isNominal,
+         bSparse
+      );
+      pFeatureDataSetShared->m_cBins = cBins;
+   }
+
+   // if there is only 1 bin we always know what it will be and we do not need to store anything
+   if(size_t { 0 } != cSamples) {
+      // the bin indexes can be a strided column of a matrix, so walk them by index rather than forming pointers that
+      // could land beyond the end of the matrix
+      const size_t iBinIndexEnd = cSamples * cBinIndexStride;
+      size_t iBinIndex = 0;
+      if(cBins <= UIntShared { 1 }) {
+         if(UIntShared { 0 } == cBins) {
+            LOG_0(Trace_Error, "ERROR PackFeature UIntShared { 0 } == cBins");
+            return Error_IllegalParamVal;
+         }
+         const IntEbm indexBinLegal = EBM_FALSE != isMissing ? IntEbm { 0 } : IntEbm { 1 };
+         do {
+            const IntEbm indexBin = static_cast<IntEbm>(binIndexes[iBinIndex]);
+            if(indexBinLegal != indexBin) {
+               LOG_0(Trace_Error, "ERROR PackFeature indexBinLegal != indexBin");
+               return Error_IllegalParamVal;
+            }
+            iBinIndex += cBinIndexStride;
+         } while(iBinIndexEnd != iBinIndex);
+      } else if(bSparse) {
+         EBM_ASSERT(cNonDefaults < cSamples);
+
+         // DecideIfSparse checked that the sparse form is smaller than the dense form, so no overflow here
+         const size_t cBytesSparse = offsetof(SparseFeatureDataSetShared, m_nonDefaults) +
+            sizeof(SparseFeatureDataSetSharedEntry) * cNonDefaults;
+
+         if(IsAddError(iByteCur, cBytesSparse)) {
+            LOG_0(Trace_Error, "ERROR PackFeature IsAddError(iByteCur, cBytesSparse)");
+            return Error_IllegalParamVal;
+         }
+         const size_t iByteNext = iByteCur + cBytesSparse;
+
+         if(nullptr != pFeatureMem) {
+            if(cBytesAvailable < iByteNext) {
+               LOG_0(Trace_Error, "ERROR PackFeature cBytesAvailable < iByteNext");
+               return Error_IllegalParamVal;
+            }
+
+            const IntEbm indexBinIllegal = countBins - (EBM_FALSE != isUnknown ? IntEbm { 0 } : IntEbm { 1 });
+            const IntEbm indexBinShift = EBM_FALSE != isMissing ? IntEbm { 0 } : IntEbm { 1 };
+
+            SparseFeatureDataSetShared * const pSparseFeatureDataSetShared =
+               reinterpret_cast<SparseFeatureDataSetShared *>(pFeatureMem + iByteCur);
+
+            // the default bin is the value of most samples, so it gets checked in the loop below
+            pSparseFeatureDataSetShared->m_defaultVal = static_cast<UIntShared>(indexBinDefault - indexBinShift);
+            pSparseFeatureDataSetShared->m_cNonDefaults = static_cast<UIntShared>(cNonDefaults);
+
+            // the entries are in increasing sample order, which is what our readers rely upon
+            SparseFeatureDataSetSharedEntry * pNonDefault = ArrayToPointer(pSparseFeatureDataSetShared->m_nonDefaults);
+            size_t iSample = 0;
+            do {
+               const IntEbm indexBin = static_cast<IntEbm>(binIndexes[iBinIndex]);
+               if(indexBinIllegal <= indexBin) {
+                  LOG_0(Trace_Error, "ERROR PackFeature indexBinIllegal <= indexBin");
+                  return Error_IllegalParamVal;
+               }
+               if(EBM_FALSE != isMissing) {
+                  if(indexBin < IntEbm { 0 }) {
+                     LOG_0(Trace_Error, "ERROR PackFeature indexBin can't be negative");
+                     return Error_IllegalParamVal;
+                  }
+               } else {
+                  if(indexBin <= IntEbm { 0 }) {
+                     LOG_0(Trace_Error, "ERROR PackFeature indexBin <= IntEbm { 0 }");
+                     return Error_IllegalParamVal;
+                  }
+               }
+               if(indexBinDefault != indexBin) {
+                  // since countBins can be converted to these, so now can indexBin
+                  EBM_ASSERT(!IsConvertError<UIntShared>(indexBin - indexBinShift));
+
+                  pNonDefault->m_iSample = static_cast<UIntShared>(iSample);
+                  pNonDefault->m_nonDefaultVal = static_cast<UIntShared>(indexBin - indexBinShift);
+                  ++pNonDefault;
+               }
+               iBinIndex += cBinIndexStride;
+               ++iSample;
+            } while(iBinIndexEnd != iBinIndex);
+            EBM_ASSERT(reinterpret_cast<unsigned char *>(pNonDefault) == pFeatureMem + iByteNext);
+         }
+         iByteCur = iByteNext;
+      } else {
+         const int cBitsRequiredMin = CountBitsRequired(cBins - UIntShared { 1 });
+         EBM_ASSERT(1 <= cBitsRequiredMin);
+         EBM_ASSERT(cBitsRequiredMin <= COUNT_BITS(UIntShared));
+
+         const int cItemsPerBitPack = GetCountItemsBitPacked<UIntShared>(cBitsRequiredMin);
+         EBM_ASSERT(1 <= cItemsPerBitPack);
+         EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(UIntShared));
+
+         const int cBitsPerItemMax = GetCountBits<UIntShared>(cItemsPerBitPack);
+         EBM_ASSERT(1 <= cBitsPerItemMax);
+         EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(UIntShared));
+
+         EBM_ASSERT(1 <= cSamples);
+         const size_t cDataUnits = (cSamples - size_t { 1 }) / static_cast<size_t>(cItemsPerBitPack) + size_t { 1 };
+
+         if(IsMultiplyError(sizeof(UIntShared), cDataUnits)) {
+            LOG_0(Trace_Error, "ERROR PackFeature IsMultiplyError(sizeof(UIntShared), cDataUnits)");
+            return Error_IllegalParamVal;
+         }
+         const size_t cBytesAllSamples = sizeof(UIntShared) * cDataUnits;
+
+         if(IsAddError(iByteCur, cBytesAllSamples)) {
+            LOG_0(Trace_Error, "ERROR PackFeature IsAddError(iByteCur, cBytesAllSamples)");
+            return Error_IllegalParamVal;
+         }
+         const size_t iByteNext = iByteCur + cBytesAllSamples;
+
+         if(nullptr != pFeatureMem) {
+            if(cBytesAvailable < iByteNext) {
+               LOG_0(Trace_Error, "ERROR PackFeature cBytesAvailable < iByteNext");
+               return Error_IllegalParamVal;
+            }
+
+            if(IsMultiplyError(sizeof(binIndexes[0]), cSamples)) {
+               LOG_0(Trace_Error, "ERROR PackFeature IsMultiplyError(sizeof(binIndexes[0]), cSamples)");
+               return Error_IllegalParamVal;
+            }
+            UIntShared * pFillData = reinterpret_cast<UIntShared *>(pFeatureMem + iByteCur);
+
+            int cShift = static_cast<int>((cSamples - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
+            const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
+            const IntEbm indexBinIllegal = countBins - (EBM_FALSE != isUnknown ? IntEbm { 0 } : IntEbm { 1 });
+            do {
+               UIntShared bits = 0;
+               do {
+                  IntEbm indexBin = static_cast<IntEbm>(binIndexes[iBinIndex]);
+                  if(indexBinIllegal <= indexBin) {
+                     LOG_0(Trace_Error, "ERROR PackFeature indexBinIllegal <= indexBin");
+                     return Error_IllegalParamVal;
+                  }
+                  if(EBM_FALSE != isMissing) {
+                     if(indexBin < IntEbm { 0 }) {
+                        LOG_0(Trace_Error, "ERROR PackFeature indexBin can't be negative");
+                        return Error_IllegalParamVal;
+                     }
+                  } else {
+                     if(indexBin <= IntEbm { 0 }) {
+                        LOG_0(Trace_Error, "ERROR PackFeature indexBin <= IntEbm { 0 }");
+                        return Error_IllegalParamVal;
+                     }
+                     --indexBin;
+                  }
+                  iBinIndex += cBinIndexStride;
+
+                  // since countBins can be converted to these, so now can indexBin
+                  EBM_ASSERT(!IsConvertError<UIntShared>(indexBin));
+
+                  EBM_ASSERT(0 <= cShift);
+                  EBM_ASSERT(cShift < COUNT_BITS(UIntShared));
+                  bits |= static_cast<UIntShared>(indexBin) << cShift;
+                  cShift -= cBitsPerItemMax;
+               } while(0 <= cShift);
+               cShift = cShiftReset;
+               *pFillData = bits;
+               ++pFillData;
+            } while(iBinIndexEnd != iBinIndex);
+            EBM_ASSERT(reinterpret_cast<unsigned char *>(pFillData) == pFeatureMem + iByteNext);
+         }
+         iByteCur = iByteNext;
+      }
+   }
+
+   if(IsConvertError<IntEbm>(iByteCur)) {
+      LOG_0(Trace_Error, "ERROR PackFeature IsConvertError<IntEbm>(iByteCur)");
+      return Error_IllegalParamVal;
+   }
+   return static_cast<IntEbm>(iByteCur);
+}
+WARNING_POP
+
+// Records that the features up to, but not including, iOffset have been filled and that the next section starts at
+// iByteCur. If that was the last section the dataset is locked.
+static ErrorEbm AdvanceFeatureOffset(
+   const size_t iOffset,
+   const size_t iByteCur,
+   const size_t cBytesAllocated,
+   unsigned char * const pFillMem
+) {
+   HeaderDataSetShared * const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared *>(pFillMem);
+   EBM_ASSERT(k_sharedDataSetWorkingId == pHeaderDataSetShared->m_id);
+
+   const size_t cOffsets = static_cast<size_t>(pHeaderDataSetShared->m_cFeatures) + 
+      static_cast<size_t>(pHeaderDataSetShared->m_cWeights) + 
+      static_cast<size_t>(pHeaderDataSetShared->m_cTargets);
+   
+   if(iOffset == cOffsets) {
+      if(cBytesAllocated != iByteCur) {
+         LOG_0(Trace_Error, "ERROR AdvanceFeatureOffset buffer size and fill size do not agree");
+         goto return_bad;
+      }
+
+      return LockDataSetShared(cBytesAllocated, pFillMem);
+   } else {
+      if(cBytesAllocated - sizeof(UIntShared) < iByteCur) {
+         LOG_0(Trace_Error, "ERROR AdvanceFeatureOffset cBytesAllocated - sizeof(UIntShared) < iByteNext");
+         goto return_bad;
+      }
+
+      if(IsConvertError<UIntShared>(iOffset)) {
+         LOG_0(Trace_Error, "ERROR AdvanceFeatureOffset IsConvertError<IntEbm>(iOffset)");
+         goto return_bad;
+      }
+      if(IsConvertError<UIntShared>(iByteCur)) {
+         LOG_0(Trace_Error, "ERROR AdvanceFeatureOffset IsConvertError<UIntShared>(iByteCur)");
+         goto return_bad;
+      }
+      ArrayToPointer(pHeaderDataSetShared->m_offsets)[iOffset] = static_cast<UIntShared>(iByteCur);
+      UIntShared * const pInternalState =
+         reinterpret_cast<UIntShared *>(pFillMem + cBytesAllocated - sizeof(UIntShared));
+      *pInternalState = static_cast<UIntShared>(iOffset); // the offset index is our state
+   }
+   return Error_None;
+
+return_bad:;
+
+   pHeaderDataSetShared->m_id = k_sharedDataSetErrorId;
+   return Error_IllegalParamVal;
 }
 
 WARNING_PUSH
 WARNING_REDUNDANT_CODE
+template<typename TBinIndex>
 static IntEbm AppendFeature(
    const IntEbm countBins,
    const BoolEbm isMissing,
    const BoolEbm isUnknown,
    const BoolEbm isNominal,
    const IntEbm countSamples,
-   const IntEbm * binIndexes,
+   const TBinIndex * binIndexes,
    const size_t cBytesAllocated,
    unsigned char * const pFillMem
 ) {
@@ -1026,252 +1404,364 @@ static IntEbm AppendFeature(
    );
 
    {
-      if(countBins <= IntEbm { 1 }) {
-         LOG_0(Trace_Error, "ERROR AppendFeature countBins must be 2 or larger");
+      if(IsConvertError<size_t>(countSamples) || IsConvertError<UIntShared>(countSamples)) {
+         LOG_0(Trace_Error, "ERROR AppendFeature countSamples is outside the range of a valid index");
          goto return_bad;
       }
-      // we do not need to access memory based on the value of countBins, so we do not need to check if fits into size_t
-      if(IsConvertError<UIntShared>(countBins)) {
-         LOG_0(Trace_Error, "ERROR AppendFeature countBins is outside the range of a valid index");
-         goto return_bad;
+      const size_t cSamples = static_cast<size_t>(countSamples);
+
+      if(nullptr == pFillMem) {
+         return PackFeature(countBins, isMissing, isUnknown, isNominal, cSamples, binIndexes, 1, 0, nullptr);
       }
-      UIntShared cBins = static_cast<UIntShared>(countBins);
-      cBins -= EBM_FALSE != isMissing ? UIntShared { 0 } : UIntShared { 1 };
-      cBins -= EBM_FALSE != isUnknown ? UIntShared { 0 } : UIntShared { 1 };
 
-      if(EBM_FALSE != isMissing && EBM_TRUE != isMissing) {
-         LOG_0(Trace_Error, "ERROR AppendFeature isMissing is not EBM_FALSE or EBM_TRUE");
+      if(IsHeaderError(static_cast<UIntShared>(cSamples), cBytesAllocated, pFillMem)) {
          goto return_bad;
       }
-      if(EBM_FALSE != isUnknown && EBM_TRUE != isUnknown) {
-         LOG_0(Trace_Error, "ERROR AppendFeature isUnknown is not EBM_FALSE or EBM_TRUE");
+
+      UIntShared * const pInternalState =
+         reinterpret_cast<UIntShared *>(pFillMem + cBytesAllocated - sizeof(UIntShared));
+      const size_t iOffset = static_cast<size_t>(*pInternalState);
+
+      HeaderDataSetShared * const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared *>(pFillMem);
+
+      const size_t cFeatures = static_cast<size_t>(pHeaderDataSetShared->m_cFeatures);
+
+      // check that we haven't exceeded the number of features
+      if(cFeatures <= iOffset) {
+         LOG_0(Trace_Error, "ERROR AppendFeature cFeatures <= iOffset");
          goto return_bad;
       }
-      if(EBM_FALSE != isNominal && EBM_TRUE != isNominal) {
-         LOG_0(Trace_Error, "ERROR AppendFeature isNominal is not EBM_FALSE or EBM_TRUE");
+
+      const size_t iHighestOffset = static_cast<size_t>(ArrayToPointer(pHeaderDataSetShared->m_offsets)[iOffset]);
+      if(cBytesAllocated < iHighestOffset) {
+         LOG_0(Trace_Error, "ERROR AppendFeature cBytesAllocated < iHighestOffset");
          goto return_bad;
       }
-      if(IsConvertError<size_t>(countSamples) || IsConvertError<UIntShared>(countSamples)) {
-         LOG_0(Trace_Error, "ERROR AppendFeature countSamples is outside the range of a valid index");
+
+      EBM_ASSERT(size_t { 0 } == iOffset && UIntShared { 0 } == pHeaderDataSetShared->m_cSamples ||
+         static_cast<UIntShared>(cSamples) == pHeaderDataSetShared->m_cSamples);
+      pHeaderDataSetShared->m_cSamples = static_cast<UIntShared>(cSamples);
+
+      const IntEbm cBytesFeature = PackFeature(
+         countBins,
+         isMissing,
+         isUnknown,
+         isNominal,
+         cSamples,
+         binIndexes,
+         1,
+         cBytesAllocated - iHighestOffset,
+         pFillMem + iHighestOffset
+      );
+      if(cBytesFeature < IntEbm { 0 }) {
          goto return_bad;
       }
-      const size_t cSamples = static_cast<size_t>(countSamples);
+      // PackFeature kept the feature within cBytesAllocated, so this cannot overflow
+      const size_t iByteCur = iHighestOffset + static_cast<size_t>(cBytesFeature);
 
-      bool bSparse = false;
-      if(size_t { 0 } != cSamples) {
-         if(nullptr == binIndexes) {
-            LOG_0(Trace_Error, "ERROR AppendFeature nullptr == binIndexes");
-            goto return_bad;
-         }
+      return AdvanceFeatureOffset(iOffset + size_t { 1 }, iByteCur, cBytesAllocated, pFillMem);
+   }
 
-         // TODO: handle sparse data someday
-         bSparse = DecideIfSparse(cSamples, binIndexes);
-      }
+return_bad:;
 
-      size_t iOffset = 0;
-      size_t iByteCur = sizeof(FeatureDataSetShared);
-      if(nullptr != pFillMem) {
-         if(IsHeaderError(static_cast<UIntShared>(cSamples), cBytesAllocated, pFillMem)) {
-            goto return_bad;
-         }
+   if(nullptr != pFillMem) {
+      HeaderDataSetShared * const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared *>(pFillMem);
+      pHeaderDataSetShared->m_id = k_sharedDataSetErrorId;
+   }
+   return Error_IllegalParamVal;
+}
+WARNING_POP
 
-         UIntShared * const pInternalState =
-            reinterpret_cast<UIntShared *>(pFillMem + cBytesAllocated - sizeof(UIntShared));
-         iOffset = static_cast<size_t>(*pInternalState);
+// below this many bin indexes the cost of waking the worker threads exceeds the time spent packing the features
+static constexpr size_t k_cBinIndexesPackFeaturesThreadedMin = size_t { 1 } << 16;
+
+static constexpr UFeatureFlags k_featureFlagsAll = static_cast<UFeatureFlags>(FeatureFlags_Missing) | 
+   static_cast<UFeatureFlags>(FeatureFlags_Unknown) | static_cast<UFeatureFlags>(FeatureFlags_Nominal);
+
+struct PackFeaturesTask {
+   size_t m_cSamples;
+   size_t m_cBinIndexStride;
+   size_t m_cBinIndexFeatureStride;
+   const IntEbm * m_aBinCounts;
+   const FeatureFlags * m_aFlags;
+   const IntEbm * m_aBinIndexes;
+   IntEbm * m_aFeatureBytes;
+   // the features are only measured when m_pFillMem is nullptr
+   const UIntShared * m_aOffsets;
+   unsigned char * m_pFillMem;
+};
 
-         HeaderDataSetShared * const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared *>(pFillMem);
+static ErrorEbm PackFeaturesTaskFunction(void * const pContext, const size_t iTask) {
+   const PackFeaturesTask * const pTask = static_cast<const PackFeaturesTask *>(pContext);
+
+   const UFeatureFlags flags = static_cast<UFeatureFlags>(pTask->m_aFlags[iTask]);
+   const BoolEbm isMissing = 0 != (static_cast<UFeatureFlags>(FeatureFlags_Missing) & flags) ? EBM_TRUE : EBM_FALSE;
+   const BoolEbm isUnknown = 0 != (static_cast<UFeatureFlags>(FeatureFlags_Unknown) & flags) ? EBM_TRUE : EBM_FALSE;
+   const BoolEbm isNominal = 0 != (static_cast<UFeatureFlags>(FeatureFlags_Nominal) & flags) ? EBM_TRUE : EBM_FALSE;
+
+   const IntEbm * const aBinIndexes = 
+      nullptr == pTask->m_aBinIndexes ? nullptr : pTask->m_aBinIndexes + pTask->m_cBinIndexFeatureStride * iTask;
+
+   if(nullptr == pTask->m_pFillMem) {
+      const IntEbm ret = PackFeature(
+         pTask->m_aBinCounts[iTask],
+         isMissing,
+         isUnknown,
+         isNominal,
+         pTask->m_cSamples,
+         aBinIndexes,
+         pTask->m_cBinIndexStride,
+         0,
+         nullptr
+      );
+      pTask->m_aFeatureBytes[iTask] = ret;
+      return ret < IntEbm { 0 } ? static_cast<ErrorEbm>(ret) : Error_None;
+   }
+
+   const IntEbm cBytesFeature = pTask->m_aFeatureBytes[iTask];
+   EBM_ASSERT(IntEbm { 0 } < cBytesFeature);
+   const IntEbm ret = PackFeature(
+      pTask->m_aBinCounts[iTask],
+      isMissing,
+      isUnknown,
+      isNominal,
+      pTask->m_cSamples,
+      aBinIndexes,
+      pTask->m_cBinIndexStride,
+      static_cast<size_t>(cBytesFeature),
+      pTask->m_pFillMem + static_cast<size_t>(pTask->m_aOffsets[iTask])
+   );
+   if(ret < IntEbm { 0 }) {
+      return static_cast<ErrorEbm>(ret);
+   }
+   EBM_ASSERT(cBytesFeature == ret);
+   return Error_None;
+}
 
-         const size_t cFeatures = static_cast<size_t>(pHeaderDataSetShared->m_cFeatures);
+static ErrorEbm RunPackFeaturesTask(
+   ThreadPool * const pThreadPool,
+   const size_t cFeatures,
+   PackFeaturesTask * const pTask
+) {
+   if(nullptr != pThreadPool && size_t { 1 } != pThreadPool->GetCountThreads() && size_t { 1 } != cFeatures &&
+      k_cBinIndexesPackFeaturesThreadedMin <= pTask->m_cSamples * cFeatures) {
+      // each feature lands in its own precomputed region, so packing them concurrently gives bytes identical
+      // to calling FillFeature once per feature
+      return pThreadPool->Run(cFeatures, PackFeaturesTaskFunction, pTask);
+   }
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const ErrorEbm error = PackFeaturesTaskFunction(pTask, iFeature);
+      if(Error_None != error) {
+         return error;
+      }
+   }
+   return Error_None;
+}
 
-         // check that we haven't exceeded the number of features
-         if(cFeatures <= iOffset) {
-            LOG_0(Trace_Error, "ERROR AppendFeature cFeatures <= iOffset");
-            goto return_bad;
-         }
+WARNING_PUSH
+WARNING_REDUNDANT_CODE
+static IntEbm AppendFeatures(
+   const IntEbm countFeatures,
+   const IntEbm * const binCounts,
+   const FeatureFlags * const flags,
+   const IntEbm countSamples,
+   const IntEbm * const binIndexesMatrix,
+   const MatrixOrder order,
+   const ThreadPoolHandle threadPool,
+   const size_t cBytesAllocated,
+   unsigned char * const pFillMem
+) {
+   EBM_ASSERT(size_t { 0 } == cBytesAllocated && nullptr == pFillMem || 
+      nullptr != pFillMem && k_cBytesHeaderId <= cBytesAllocated);
 
-         const size_t iHighestOffset = static_cast<size_t>(ArrayToPointer(pHeaderDataSetShared->m_offsets)[iOffset]);
+   LOG_N(
+      Trace_Info,
+      "Entered AppendFeatures: "
+      "countFeatures=%" IntEbmPrintf ", "
+      "binCounts=%p, "
+      "flags=%p, "
+      "countSamples=%" IntEbmPrintf ", "
+      "binIndexesMatrix=%p, "
+      "order=%" MatrixOrderPrintf ", "
+      "threadPool=%p, "
+      "cBytesAllocated=%zu, "
+      "pFillMem=%p"
+      ,
+      countFeatures,
+      static_cast<const void *>(binCounts),
+      static_cast<const void *>(flags),
+      countSamples,
+      static_cast<const void *>(binIndexesMatrix),
+      order,
+      static_cast<void *>(threadPool),
+      cBytesAllocated,
+      static_cast<void *>(pFillMem)
+   );
 
-         if(IsAddError(iByteCur, iHighestOffset)) {
-            LOG_0(Trace_Error, "ERROR AppendFeature IsAddError(iByteCur, iHighestOffset)");
-            goto return_bad;
-         }
-         iByteCur += iHighestOffset; // if we're going to access FeatureDataSetShared, then check if we have the space
-         if(cBytesAllocated < iByteCur) {
-            LOG_0(Trace_Error, "ERROR AppendFeature cBytesAllocated < iByteCur");
+   ErrorEbm error;
+   IntEbm * aFeatureBytes = nullptr;
+   {
+      ThreadPool * pThreadPool = nullptr;
+      if(nullptr != threadPool) {
+         pThreadPool = ThreadPool::GetThreadPoolFromHandle(threadPool);
+         if(nullptr == pThreadPool) {
+            // already logged
             goto return_bad;
          }
+      }
 
-         EBM_ASSERT(size_t { 0 } == iOffset && UIntShared { 0 } == pHeaderDataSetShared->m_cSamples ||
-            static_cast<UIntShared>(cSamples) == pHeaderDataSetShared->m_cSamples);
-         pHeaderDataSetShared->m_cSamples = static_cast<UIntShared>(cSamples);
+      if(IsConvertError<size_t>(countFeatures)) {
+         LOG_0(Trace_Error, "ERROR AppendFeatures countFeatures is outside the range of a valid index");
+         goto return_bad;
+      }
+      const size_t cFeatures = static_cast<size_t>(countFeatures);
 
-         FeatureDataSetShared * const pFeatureDataSetShared = 
-            reinterpret_cast<FeatureDataSetShared *>(pFillMem + iHighestOffset);
+      if(IsConvertError<size_t>(countSamples) || IsConvertError<UIntShared>(countSamples)) {
+         LOG_0(Trace_Error, "ERROR AppendFeatures countSamples is outside the range of a valid index");
+         goto return_bad;
+      }
+      const size_t cSamples = static_cast<size_t>(countSamples);
 
-         pFeatureDataSetShared->m_id = GetFeatureId(
-            EBM_FALSE != isMissing,
-            EBM_FALSE != isUnknown,
-            EBM_FALSE != isNominal,
-            bSparse
-         );
-         pFeatureDataSetShared->m_cBins = cBins;
+      if(MatrixOrder_C != order && MatrixOrder_Fortran != order) {
+         LOG_0(Trace_Error, "ERROR AppendFeatures order must be MatrixOrder_C or MatrixOrder_Fortran");
+         goto return_bad;
       }
 
-      // if there is only 1 bin we always know what it will be and we do not need to store anything
-      if(size_t { 0 } != cSamples) {
-         const IntEbm * pBinIndex = binIndexes;
-         const IntEbm * const pBinIndexsEnd = binIndexes + cSamples;
-         if(cBins <= UIntShared { 1 }) {
-            if(UIntShared { 0 } == cBins) {
-               LOG_0(Trace_Error, "ERROR AppendFeature UIntShared { 0 } == cBins");
-               goto return_bad;
-            }
-            const IntEbm indexBinLegal = EBM_FALSE != isMissing ? IntEbm { 0 } : IntEbm { 1 };
-            do {
-               const IntEbm indexBin = *pBinIndex;
-               if(indexBinLegal != indexBin) {
-                  LOG_0(Trace_Error, "ERROR AppendFeature indexBinLegal != indexBin");
-                  goto return_bad;
-               }
-               ++pBinIndex;
-            } while(pBinIndexsEnd != pBinIndex);
-         } else {
-            const int cBitsRequiredMin = CountBitsRequired(cBins - UIntShared { 1 });
-            EBM_ASSERT(1 <= cBitsRequiredMin);
-            EBM_ASSERT(cBitsRequiredMin <= COUNT_BITS(UIntShared));
+      if(size_t { 0 } == cFeatures) {
+         // zero bytes when measuring, and Error_None when filling
+         return 0;
+      }
 
-            const int cItemsPerBitPack = GetCountItemsBitPacked<UIntShared>(cBitsRequiredMin);
-            EBM_ASSERT(1 <= cItemsPerBitPack);
-            EBM_ASSERT(cItemsPerBitPack <= COUNT_BITS(UIntShared));
+      if(nullptr == binCounts) {
+         LOG_0(Trace_Error, "ERROR AppendFeatures nullptr == binCounts");
+         goto return_bad;
+      }
+      if(nullptr == flags) {
+         LOG_0(Trace_Error, "ERROR AppendFeatures nullptr == flags");
+         goto return_bad;
+      }
+      if(IsMultiplyError(sizeof(*binIndexesMatrix), cSamples, cFeatures)) {
+         LOG_0(Trace_Error, "ERROR AppendFeatures IsMultiplyError(sizeof(*binIndexesMatrix), cSamples, cFeatures)");
+         goto return_bad;
+      }
 
-            const int cBitsPerItemMax = GetCountBits<UIntShared>(cItemsPerBitPack);
-            EBM_ASSERT(1 <= cBitsPerItemMax);
-            EBM_ASSERT(cBitsPerItemMax <= COUNT_BITS(UIntShared));
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         if(0 != (~k_featureFlagsAll & static_cast<UFeatureFlags>(flags[iFeature]))) {
+            LOG_0(Trace_Error, "ERROR AppendFeatures flags contains unknown FeatureFlags");
+            goto return_bad;
+         }
+      }
 
-            EBM_ASSERT(1 <= cSamples);
-            const size_t cDataUnits = (cSamples - size_t { 1 }) / static_cast<size_t>(cItemsPerBitPack) + size_t { 1 };
+      if(IsMultiplyError(sizeof(*aFeatureBytes), cFeatures)) {
+         LOG_0(Trace_Error, "ERROR AppendFeatures IsMultiplyError(sizeof(*aFeatureBytes), cFeatures)");
+         goto return_bad;
+      }
+      aFeatureBytes = static_cast<IntEbm *>(malloc(sizeof(*aFeatureBytes) * cFeatures));
+      if(nullptr == aFeatureBytes) {
+         LOG_0(Trace_Warning, "WARNING AppendFeatures nullptr == aFeatureBytes");
+         error = Error_OutOfMemory;
+         goto return_error;
+      }
 
-            if(IsMultiplyError(sizeof(UIntShared), cDataUnits)) {
-               LOG_0(Trace_Error, "ERROR AppendFeature IsMultiplyError(sizeof(UIntShared), cDataUnits)");
-               goto return_bad;
-            }
-            const size_t cBytesAllSamples = sizeof(UIntShared) * cDataUnits;
+      PackFeaturesTask task;
+      task.m_cSamples = cSamples;
+      // in C order each row holds one sample of every feature, and in Fortran order each column is one feature
+      task.m_cBinIndexStride = MatrixOrder_C == order ? cFeatures : size_t { 1 };
+      task.m_cBinIndexFeatureStride = MatrixOrder_C == order ? size_t { 1 } : cSamples;
+      task.m_aBinCounts = binCounts;
+      task.m_aFlags = flags;
+      task.m_aBinIndexes = size_t { 0 } == cSamples ? nullptr : binIndexesMatrix;
+      task.m_aFeatureBytes = aFeatureBytes;
+      task.m_aOffsets = nullptr;
+      task.m_pFillMem = nullptr;
+
+      // measure every feature first since the offset of each feature depends on the size of the ones before it
+      error = RunPackFeaturesTask(pThreadPool, cFeatures, &task);
+      if(Error_None != error) {
+         goto return_error;
+      }
 
-            if(IsAddError(iByteCur, cBytesAllSamples)) {
-               LOG_0(Trace_Error, "ERROR AppendFeature IsAddError(iByteCur, cBytesAllSamples)");
+      if(nullptr == pFillMem) {
+         size_t cBytes = 0;
+         for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+            const size_t cBytesFeature = static_cast<size_t>(aFeatureBytes[iFeature]);
+            if(IsAddError(cBytes, cBytesFeature)) {
+               LOG_0(Trace_Error, "ERROR AppendFeatures IsAddError(cBytes, cBytesFeature)");
                goto return_bad;
             }
-            const size_t iByteNext = iByteCur + cBytesAllSamples;
-
-            if(nullptr != pFillMem) {
-               if(cBytesAllocated < iByteNext) {
-                  LOG_0(Trace_Error, "ERROR AppendFeature cBytesAllocated < iByteNext");
-                  goto return_bad;
-               }
-
-               if(IsMultiplyError(sizeof(binIndexes[0]), cSamples)) {
-                  LOG_0(Trace_Error, "ERROR AppendFeature IsMultiplyError(sizeof(binIndexes[0]), cSamples)");
-                  goto return_bad;
-               }
-               UIntShared * pFillData = reinterpret_cast<UIntShared *>(pFillMem + iByteCur);
-
-               int cShift = static_cast<int>((cSamples - size_t { 1 }) % static_cast<size_t>(cItemsPerBitPack)) * cBitsPerItemMax;
-               const int cShiftReset = (cItemsPerBitPack - 1) * cBitsPerItemMax;
-               const IntEbm indexBinIllegal = countBins - (EBM_FALSE != isUnknown ? IntEbm { 0 } : IntEbm { 1 });
-               do {
-                  UIntShared bits = 0;
-                  do {
-                     IntEbm indexBin = *pBinIndex;
-                     if(indexBinIllegal <= indexBin) {
-                        LOG_0(Trace_Error, "ERROR AppendFeature indexBinIllegal <= indexBin");
-                        goto return_bad;
-                     }
-                     if(EBM_FALSE != isMissing) {
-                        if(indexBin < IntEbm { 0 }) {
-                           LOG_0(Trace_Error, "ERROR AppendFeature indexBin can't be negative");
-                           goto return_bad;
-                        }
-                     } else {
-                        if(indexBin <= IntEbm { 0 }) {
-                           LOG_0(Trace_Error, "ERROR AppendFeature indexBin <= IntEbm { 0 }");
-                           goto return_bad;
-                        }
-                        --indexBin;
-                     }
-                     ++pBinIndex;
-
-                     // since countBins can be converted to these, so now can indexBin
-                     EBM_ASSERT(!IsConvertError<UIntShared>(indexBin));
-
-                     EBM_ASSERT(0 <= cShift);
-                     EBM_ASSERT(cShift < COUNT_BITS(UIntShared));
-                     bits |= static_cast<UIntShared>(indexBin) << cShift;
-                     cShift -= cBitsPerItemMax;
-                  } while(0 <= cShift);
-                  cShift = cShiftReset;
-                  *pFillData = bits;
-                  ++pFillData;
-               } while(pBinIndexsEnd != pBinIndex);
-               EBM_ASSERT(reinterpret_cast<unsigned char *>(pFillData) == pFillMem + iByteNext);
-            }
-            iByteCur = iByteNext;
+            cBytes += cBytesFeature;
+         }
+         free(aFeatureBytes);
+         if(IsConvertError<IntEbm>(cBytes)) {
+            LOG_0(Trace_Error, "ERROR AppendFeatures IsConvertError<IntEbm>(cBytes)");
+            return Error_IllegalParamVal;
          }
+         return static_cast<IntEbm>(cBytes);
       }
 
-      if(nullptr != pFillMem) {
-         HeaderDataSetShared * const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared *>(pFillMem);
-         EBM_ASSERT(k_sharedDataSetWorkingId == pHeaderDataSetShared->m_id);
+      if(IsHeaderError(static_cast<UIntShared>(cSamples), cBytesAllocated, pFillMem)) {
+         goto return_bad;
+      }
 
-         ++iOffset;
-         const size_t cOffsets = static_cast<size_t>(pHeaderDataSetShared->m_cFeatures) + 
-            static_cast<size_t>(pHeaderDataSetShared->m_cWeights) + 
-            static_cast<size_t>(pHeaderDataSetShared->m_cTargets);
-         
-         if(iOffset == cOffsets) {
-            if(cBytesAllocated != iByteCur) {
-               LOG_0(Trace_Error, "ERROR AppendFeature buffer size and fill size do not agree");
-               goto return_bad;
-            }
+      UIntShared * const pInternalState =
+         reinterpret_cast<UIntShared *>(pFillMem + cBytesAllocated - sizeof(UIntShared));
+      const size_t iOffset = static_cast<size_t>(*pInternalState);
 
-            const ErrorEbm error = LockDataSetShared(cBytesAllocated, pFillMem);
-            if(Error_None != error) {
-               return error;
-            }
-         } else {
-            if(cBytesAllocated - sizeof(UIntShared) < iByteCur) {
-               LOG_0(Trace_Error, "ERROR AppendFeature cBytesAllocated - sizeof(UIntShared) < iByteNext");
-               goto return_bad;
-            }
+      HeaderDataSetShared * const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared *>(pFillMem);
 
-            if(IsConvertError<UIntShared>(iOffset)) {
-               LOG_0(Trace_Error, "ERROR AppendFeature IsConvertError<IntEbm>(iOffset)");
-               goto return_bad;
-            }
-            if(IsConvertError<UIntShared>(iByteCur)) {
-               LOG_0(Trace_Error, "ERROR AppendFeature IsConvertError<UIntShared>(iByteCur)");
-               goto return_bad;
-            }
-            ArrayToPointer(pHeaderDataSetShared->m_offsets)[iOffset] = static_cast<UIntShared>(iByteCur);
-            UIntShared * const pInternalState =
-               reinterpret_cast<UIntShared *>(pFillMem + cBytesAllocated - sizeof(UIntShared));
-            *pInternalState = static_cast<UIntShared>(iOffset); // the offset index is our state
+      // check that we haven't exceeded the number of features. IsHeaderError checked iOffset < cOffsets
+      if(static_cast<size_t>(pHeaderDataSetShared->m_cFeatures) - iOffset < cFeatures) {
+         LOG_0(Trace_Error, "ERROR AppendFeatures too many features");
+         goto return_bad;
+      }
+
+      UIntShared * const aOffsets = ArrayToPointer(pHeaderDataSetShared->m_offsets) + iOffset;
+      size_t iByteCur = static_cast<size_t>(aOffsets[0]);
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         if(cBytesAllocated < iByteCur) {
+            LOG_0(Trace_Error, "ERROR AppendFeatures cBytesAllocated < iByteCur");
+            goto return_bad;
          }
-         return Error_None;
+         if(size_t { 0 } != iFeature) {
+            // cBytesAllocated fits into UIntShared since IsHeaderError placed our state within it
+            aOffsets[iFeature] = static_cast<UIntShared>(iByteCur);
+         }
+         const size_t cBytesFeature = static_cast<size_t>(aFeatureBytes[iFeature]);
+         if(cBytesAllocated - iByteCur < cBytesFeature) {
+            LOG_0(Trace_Error, "ERROR AppendFeatures cBytesAllocated - iByteCur < cBytesFeature");
+            goto return_bad;
+         }
+         iByteCur += cBytesFeature;
       }
-      if(IsConvertError<IntEbm>(iByteCur)) {
-         LOG_0(Trace_Error, "ERROR AppendFeature IsConvertError<IntEbm>(iByteCur)");
-         goto return_bad;
+
+      EBM_ASSERT(size_t { 0 } == iOffset && UIntShared { 0 } == pHeaderDataSetShared->m_cSamples ||
+         static_cast<UIntShared>(cSamples) == pHeaderDataSetShared->m_cSamples);
+      pHeaderDataSetShared->m_cSamples = static_cast<UIntShared>(cSamples);
+
+      task.m_aOffsets = aOffsets;
+      task.m_pFillMem = pFillMem;
+      error = RunPackFeaturesTask(pThreadPool, cFeatures, &task);
+      free(aFeatureBytes);
+      aFeatureBytes = nullptr;
+      if(Error_None != error) {
+         goto return_error;
       }
-      return static_cast<IntEbm>(iByteCur);
+
+      return AdvanceFeatureOffset(iOffset + cFeatures, iByteCur, cBytesAllocated, pFillMem);
    }
 
 return_bad:;
 
+   error = Error_IllegalParamVal;
+
+return_error:;
+
+   free(aFeatureBytes);
    if(nullptr != pFillMem) {
       HeaderDataSetShared * const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared *>(pFillMem);
       pHeaderDataSetShared->m_id = k_sharedDataSetErrorId;
    }
-   return Error_IllegalParamVal;
+   return error;
 }
 WARNING_POP
 
@@ -1814,6 +2304,214 @@ EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION FillFeature(
    return static_cast<ErrorEbm>(ret);
 }
 
+EBM_API_BODY IntEbm EBM_CALLING_CONVENTION MeasureFeatureUInt8(
+   IntEbm countBins,
+   BoolEbm isMissing,
+   BoolEbm isUnknown,
+   BoolEbm isNominal,
+   IntEbm countSamples,
+   const uint8_t * binIndexes
+) {
+   return AppendFeature(
+      countBins,
+      isMissing,
+      isUnknown,
+      isNominal,
+      countSamples,
+      binIndexes,
+      0,
+      nullptr
+   );
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION FillFeatureUInt8(
+   IntEbm countBins,
+   BoolEbm isMissing,
+   BoolEbm isUnknown,
+   BoolEbm isNominal,
+   IntEbm countSamples,
+   const uint8_t * binIndexes,
+   IntEbm countBytesAllocated,
+   void * fillMem
+) {
+   if(nullptr == fillMem) {
+      LOG_0(Trace_Error, "ERROR FillFeatureUInt8 nullptr == fillMem");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsConvertError<size_t>(countBytesAllocated)) {
+      LOG_0(Trace_Error, "ERROR FillFeatureUInt8 countBytesAllocated is outside the range of a valid size");
+      // don't set the header to bad if we don't have enough memory for the header itself
+      return Error_IllegalParamVal;
+   }
+   const size_t cBytesAllocated = static_cast<size_t>(countBytesAllocated);
+
+   if(cBytesAllocated < k_cBytesHeaderId) {
+      LOG_0(Trace_Error, "ERROR FillFeatureUInt8 cBytesAllocated < k_cBytesHeaderId");
+      // don't check or set the header to bad if we don't have enough memory for the header id itself
+      return Error_IllegalParamVal;
+   }
+
+   HeaderDataSetShared * const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared *>(fillMem);
+   if(k_sharedDataSetWorkingId != pHeaderDataSetShared->m_id) {
+      LOG_0(Trace_Error, "ERROR FillFeatureUInt8 k_sharedDataSetWorkingId != pHeaderDataSetShared->m_id");
+      // don't set the header to bad since it's already set to something invalid and we don't know why
+      return Error_IllegalParamVal;
+   }
+
+   const IntEbm ret = AppendFeature(
+      countBins,
+      isMissing,
+      isUnknown,
+      isNominal,
+      countSamples,
+      binIndexes,
+      cBytesAllocated,
+      static_cast<unsigned char *>(fillMem)
+   );
+   return static_cast<ErrorEbm>(ret);
+}
+
+EBM_API_BODY IntEbm EBM_CALLING_CONVENTION MeasureFeatureUInt16(
+   IntEbm countBins,
+   BoolEbm isMissing,
+   BoolEbm isUnknown,
+   BoolEbm isNominal,
+   IntEbm countSamples,
+   const uint16_t * binIndexes
+) {
+   return AppendFeature(
+      countBins,
+      isMissing,
+      isUnknown,
+      isNominal,
+      countSamples,
+      binIndexes,
+      0,
+      nullptr
+   );
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION FillFeatureUInt16(
+   IntEbm countBins,
+   BoolEbm isMissing,
+   BoolEbm isUnknown,
+   BoolEbm isNominal,
+   IntEbm countSamples,
+   const uint16_t * binIndexes,
+   IntEbm countBytesAllocated,
+   void * fillMem
+) {
+   if(nullptr == fillMem) {
+      LOG_0(Trace_Error, "ERROR FillFeatureUInt16 nullptr == fillMem");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsConvertError<size_t>(countBytesAllocated)) {
+      LOG_0(Trace_Error, "ERROR FillFeatureUInt16 countBytesAllocated is outside the range of a valid size");
+      // don't set the header to bad if we don't have enough memory for the header itself
+      return Error_IllegalParamVal;
+   }
+   const size_t cBytesAllocated = static_cast<size_t>(countBytesAllocated);
+
+   if(cBytesAllocated < k_cBytesHeaderId) {
+      LOG_0(Trace_Error, "ERROR FillFeatureUInt16 cBytesAllocated < k_cBytesHeaderId");
+      // don't check or set the header to bad if we don't have enough memory for the header id itself
+      return Error_IllegalParamVal;
+   }
+
+   HeaderDataSetShared * const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared *>(fillMem);
+   if(k_sharedDataSetWorkingId != pHeaderDataSetShared->m_id) {
+      LOG_0(Trace_Error, "ERROR FillFeatureUInt16 k_sharedDataSetWorkingId != pHeaderDataSetShared->m_id");
+      // don't set the header to bad since it's already set to something invalid and we don't know why
+      return Error_IllegalParamVal;
+   }
+
+   const IntEbm ret = AppendFeature(
+      countBins,
+      isMissing,
+      isUnknown,
+      isNominal,
+      countSamples,
+      binIndexes,
+      cBytesAllocated,
+      static_cast<unsigned char *>(fillMem)
+   );
+   return static_cast<ErrorEbm>(ret);
+}
+
+EBM_API_BODY IntEbm EBM_CALLING_CONVENTION MeasureFeatures(
+   IntEbm countFeatures,
+   const IntEbm * binCounts,
+   const FeatureFlags * flags,
+   IntEbm countSamples,
+   const IntEbm * binIndexesMatrix,
+   MatrixOrder order,
+   ThreadPoolHandle threadPool
+) {
+   return AppendFeatures(
+      countFeatures,
+      binCounts,
+      flags,
+      countSamples,
+      binIndexesMatrix,
+      order,
+      threadPool,
+      0,
+      nullptr
+   );
+}
+
+EBM_API_BODY ErrorEbm EBM_CALLING_CONVENTION FillFeatures(
+   IntEbm countFeatures,
+   const IntEbm * binCounts,
+   const FeatureFlags * flags,
+   IntEbm countSamples,
+   const IntEbm * binIndexesMatrix,
+   MatrixOrder order,
+   ThreadPoolHandle threadPool,
+   IntEbm countBytesAllocated,
+   void * fillMem
+) {
+   if(nullptr == fillMem) {
+      LOG_0(Trace_Error, "ERROR FillFeatures nullptr == fillMem");
+      return Error_IllegalParamVal;
+   }
+
+   if(IsConvertError<size_t>(countBytesAllocated)) {
+      LOG_0(Trace_Error, "ERROR FillFeatures countBytesAllocated is outside the range of a valid size");
+      // don't set the header to bad if we don't have enough memory for the header itself
+      return Error_IllegalParamVal;
+   }
+   const size_t cBytesAllocated = static_cast<size_t>(countBytesAllocated);
+
+   if(cBytesAllocated < k_cBytesHeaderId) {
+      LOG_0(Trace_Error, "ERROR FillFeatures cBytesAllocated < k_cBytesHeaderId");
+      // don't check or set the header to bad if we don't have enough memory for the header id itself
+      return Error_IllegalParamVal;
+   }
+
+   HeaderDataSetShared * const pHeaderDataSetShared = reinterpret_cast<HeaderDataSetShared *>(fillMem);
+   if(k_sharedDataSetWorkingId != pHeaderDataSetShared->m_id) {
+      LOG_0(Trace_Error, "ERROR FillFeatures k_sharedDataSetWorkingId != pHeaderDataSetShared->m_id");
+      // don't set the header to bad since it's already set to something invalid and we don't know why
+      return Error_IllegalParamVal;
+   }
+
+   const IntEbm ret = AppendFeatures(
+      countFeatures,
+      binCounts,
+      flags,
+      countSamples,
+      binIndexesMatrix,
+      order,
+      threadPool,
+      cBytesAllocated,
+      static_cast<unsigned char *>(fillMem)
+   );
+   return static_cast<ErrorEbm>(ret);
+}
+
 EBM_API_BODY IntEbm EBM_CALLING_CONVENTION MeasureWeight(
    IntEbm countSamples,
    const double * weights
@@ -112,6 +112,20 @@ typedef int32_t CalcInteractionFlags;
 // printf hexidecimals must be unsigned, so convert first to unsigned before calling printf
 typedef uint32_t UCalcInteractionFlags;
 #define UCalcInteractionFlagsPrintf PRIx32
+typedef int32_t AffinityFlags;
+// printf hexidecimals must be unsigned, so convert first to unsigned before calling printf
+typedef uint32_t UAffinityFlags;
+#define UAffinityFlagsPrintf PRIx32
+typedef int32_t FeatureFlags;
+// printf hexidecimals must be unsigned, so convert first to unsigned before calling printf
+typedef uint32_t UFeatureFlags;
+#define UFeatureFlagsPrintf PRIx32
+typedef int32_t SIMDFlags;
+// printf hexidecimals must be unsigned, so convert first to unsigned before calling printf
+typedef uint32_t USIMDFlags;
+#define USIMDFlagsPrintf PRIx32
+typedef int32_t MatrixOrder;
+#define MatrixOrderPrintf PRId32
 typedef int32_t LinkEbm;
 #define LinkEbmPrintf PRId32
 typedef int64_t OutputType;
@@ -125,12 +139,36 @@ typedef struct _InteractionHandle {
    uint32_t handleVerification; // should be 21773 if ok. Do not use size_t since that requires an additional header.
 } * InteractionHandle;
 
+typedef struct _ThreadPoolHandle {
+   uint32_t handleVerification; // should be 14387 if ok. Do not use size_t since that requires an additional header.
+} * ThreadPoolHandle;
+
+typedef struct _PreparedDataSetHandle {
+   uint32_t handleVerification; // should be 18541 if ok. Do not use size_t since that requires an additional header.
+} * PreparedDataSetHandle;
+
+typedef struct _DataSetFileHandle {
+   uint32_t handleVerification; // should be 23159 if ok. Do not use size_t since that requires an additional header.
+} * DataSetFileHandle;
+
+typedef struct _CutPlanHandle {
+   uint32_t handleVerification; // should be 30517 if ok. Do not use size_t since that requires an additional header.
+} * CutPlanHandle;
+
+typedef struct _CutQuantileSketchHandle {
+   uint32_t handleVerification; // should be 11953 if ok. Do not use size_t since that requires an additional header.
+} * CutQuantileSketchHandle;
+
 #define BOOL_CAST(val)                             (STATIC_CAST(BoolEbm, (val)))
 #define ERROR_CAST(val)                            (STATIC_CAST(ErrorEbm, (val)))
 #define CREATE_BOOSTER_FLAGS_CAST(val)             (STATIC_CAST(CreateBoosterFlags, (val)))
 #define CREATE_INTERACTION_FLAGS_CAST(val)         (STATIC_CAST(CreateInteractionFlags, (val)))
 #define TERM_BOOST_FLAGS_CAST(val)                 (STATIC_CAST(TermBoostFlags, (val)))
 #define CALC_INTERACTION_FLAGS_CAST(val)           (STATIC_CAST(CalcInteractionFlags, (val)))
+#define AFFINITY_FLAGS_CAST(val)                   (STATIC_CAST(AffinityFlags, (val)))
+#define FEATURE_FLAGS_CAST(val)                    (STATIC_CAST(FeatureFlags, (val)))
+#define SIMD_FLAGS_CAST(val)                       (STATIC_CAST(SIMDFlags, (val)))
+#define MATRIX_ORDER_CAST(val)                     (STATIC_CAST(MatrixOrder, (val)))
 #define TRACE_CAST(val)                            (STATIC_CAST(TraceEbm, (val)))
 #define LINK_CAST(val)                             (STATIC_CAST(LinkEbm, (val)))
 #define OUTPUT_TYPE_CAST(val)                      (STATIC_CAST(OutputType, (val)))
@@ -176,6 +214,8 @@ typedef struct _InteractionHandle {
 // bad input values that are from the end user. These should have been filtered out by our higher level caller
 #define Error_UserParamVal                         (ERROR_CAST(-4))
 #define Error_ThreadStartFailed                    (ERROR_CAST(-5))
+// the operating system could not open, read, write or map a file
+#define Error_FileIO                               (ERROR_CAST(-6))
 
 #define Error_ObjectiveConstructorException        (ERROR_CAST(-10))
 #define Error_ObjectiveParamUnknown                (ERROR_CAST(-11))
@@ -193,6 +233,15 @@ typedef struct _InteractionHandle {
 #define CreateBoosterFlags_Default                 (CREATE_BOOSTER_FLAGS_CAST(0x00000000))
 #define CreateBoosterFlags_DifferentialPrivacy     (CREATE_BOOSTER_FLAGS_CAST(0x00000001))
 #define CreateBoosterFlags_DisableSIMD             (CREATE_BOOSTER_FLAGS_CAST(0x00000002))
+// use the float64 SIMD zones instead of the float32 ones. Ignored if CreateBoosterFlags_DisableSIMD is set
+#define CreateBoosterFlags_DoublePrecisionSIMD     (CREATE_BOOSTER_FLAGS_CAST(0x00000008))
+// store only the occurrence counts for each inner bag and derive the bag weights while binning. This uses much less
+// memory when there are many inner bags, at the cost of a multiplication per sample
+#define CreateBoosterFlags_CompactInnerBags        (CREATE_BOOSTER_FLAGS_CAST(0x00000010))
+// for classification, reorder the internal copy of the samples so that each class is contiguous. The objectives can
+// then skip loading the targets per-sample. Bags and init scores are still given in the caller's sample order.
+// There is no CreateInteractionFlags equivalent since interactions only run the objective once
+#define CreateBoosterFlags_SortByTarget            (CREATE_BOOSTER_FLAGS_CAST(0x00000020))
 
 #define TermBoostFlags_Default                     (TERM_BOOST_FLAGS_CAST(0x00000000))
 #define TermBoostFlags_DisableNewtonGain           (TERM_BOOST_FLAGS_CAST(0x00000001))
@@ -203,11 +252,37 @@ typedef struct _InteractionHandle {
 #define CreateInteractionFlags_Default             (CREATE_INTERACTION_FLAGS_CAST(0x00000000))
 #define CreateInteractionFlags_DifferentialPrivacy (CREATE_INTERACTION_FLAGS_CAST(0x00000001))
 #define CreateInteractionFlags_DisableSIMD         (CREATE_INTERACTION_FLAGS_CAST(0x00000002))
+// use the float64 SIMD zones instead of the float32 ones. Ignored if CreateInteractionFlags_DisableSIMD is set
+#define CreateInteractionFlags_DoublePrecisionSIMD (CREATE_INTERACTION_FLAGS_CAST(0x00000004))
 
 #define CalcInteractionFlags_Default               (CALC_INTERACTION_FLAGS_CAST(0x00000000))
 #define CalcInteractionFlags_Pure                  (CALC_INTERACTION_FLAGS_CAST(0x00000001))
 #define CalcInteractionFlags_EnableNewton          (CALC_INTERACTION_FLAGS_CAST(0x00000002))
 
+#define AffinityFlags_Default                      (AFFINITY_FLAGS_CAST(0x00000000))
+// pin each worker thread to its own processor, chosen from the processors that the process is allowed to use. Only
+// supported on Linux, and ignored elsewhere
+#define AffinityFlags_PinThreads                   (AFFINITY_FLAGS_CAST(0x00000001))
+
+// the same meanings as the isMissing, isUnknown and isNominal parameters of FillFeature
+#define FeatureFlags_Default                       (FEATURE_FLAGS_CAST(0x00000000))
+#define FeatureFlags_Missing                       (FEATURE_FLAGS_CAST(0x00000001))
+#define FeatureFlags_Unknown                       (FEATURE_FLAGS_CAST(0x00000002))
+#define FeatureFlags_Nominal                       (FEATURE_FLAGS_CAST(0x00000004))
+
+#define SIMDFlags_Default                          (SIMD_FLAGS_CAST(0x00000000))
+// bin with a single histogram shared by the SIMD lanes instead of a private histogram per lane
+#define SIMDFlags_DisableLaneHistograms            (SIMD_FLAGS_CAST(0x00000001))
+// skip the AVX-512 zones even if the processor supports them, which selects the AVX2 zones on AVX-512 processors
+#define SIMDFlags_DisableAVX512F                   (SIMD_FLAGS_CAST(0x00000002))
+// skip the AVX2 zones. Together with SIMDFlags_DisableAVX512F this also turns off the SIMD Discretize kernels
+#define SIMDFlags_DisableAVX2                      (SIMD_FLAGS_CAST(0x00000004))
+
+// the layout of a matrix with one row per sample. In C order the rows are contiguous, and in Fortran order the 
+// columns are contiguous
+#define MatrixOrder_C                              (MATRIX_ORDER_CAST(0))
+#define MatrixOrder_Fortran                        (MATRIX_ORDER_CAST(1))
+
 // No messages will be logged. This is the default.
 #define Trace_Off                                  (TRACE_CAST(0))
 // Invalid inputs to the C interface, internal errors, or assert failures before exiting. Cannot continue afterwards.
@@ -255,6 +330,22 @@ typedef void (EBM_CALLING_CONVENTION * LogCallbackFunction)(TraceEbm traceLevel,
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION SetLogCallback(LogCallbackFunction logCallbackFunction);
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION SetTraceLevel(TraceEbm traceLevel);
 EBM_API_INCLUDE const char * EBM_CALLING_CONVENTION GetTraceLevelString(TraceEbm traceLevel);
+// SetSIMDFlags turns off SIMD code paths for the whole process so that they can be tested and benchmarked against the 
+// alternatives on the same hardware. Like SetTraceLevel, only call it while no other libebm calls are running.
+EBM_API_INCLUDE void EBM_CALLING_CONVENTION SetSIMDFlags(SIMDFlags flags);
+// GetHeapCounters reads process wide counters kept by the malloc/calloc/realloc/free wrappers that the Linux x64 
+// builds link in with -Wl,--wrap, so every heap call made from inside libebm is seen, including operator new in the 
+// statically linked C++ runtime. countCallsOut receives the number of malloc, calloc and realloc calls since the 
+// library was loaded. countBytesOut and countBytesPeakOut receive the heap bytes that libebm holds now and the most it 
+// has held since the peak was last reset. Bytes are malloc_usable_size, so they include the allocator's rounding. 
+// If isResetPeak is EBM_TRUE, the peak is reset to the current bytes after it has been read. Builds without the 
+// wrappers set every output to -1. Any of the outputs can be NULL. This is meant for tests and benchmarks.
+EBM_API_INCLUDE void EBM_CALLING_CONVENTION GetHeapCounters(
+   BoolEbm isResetPeak,
+   IntEbm * countCallsOut,
+   IntEbm * countBytesOut,
+   IntEbm * countBytesPeakOut
+);
 
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION CleanFloats(IntEbm count, double * valsInOut);
 
@@ -263,6 +354,18 @@ EBM_API_INCLUDE void EBM_CALLING_CONVENTION InitRNG(SeedEbm seed, void * rngOut)
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION CopyRNG(void * rng, void * rngOut);
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION BranchRNG(void * rng, void * rngOut);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION GenerateSeed(void * rng, SeedEbm * seedOut);
+// countThreads includes the calling thread, which participates in the work. Zero means use all processors.
+// A thread pool can be shared between any number of boosters and interaction detectors, and it remains alive
+// until FreeThreadPool has been called and every booster and interaction detector using it has been freed.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateThreadPool(
+   IntEbm countThreads,
+   AffinityFlags affinityFlags,
+   ThreadPoolHandle * threadPoolHandleOut
+);
+EBM_API_INCLUDE void EBM_CALLING_CONVENTION FreeThreadPool(
+   ThreadPoolHandle threadPoolHandle
+);
+
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION GenerateGaussianRandom(
    void * rng, 
    double stddev,
@@ -290,6 +393,51 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CutQuantile(
    IntEbm * countCutsInOut,
    double * cutsLowerBoundInclusiveOut
 );
+// CutQuantile for columns that are too large to hold in memory. Chunks are added with CutQuantileAccumulate into a 
+// mergeable sketch that keeps at most countItemsPerLevel values on each of about log2(samples / countItemsPerLevel) 
+// levels. Sketches built by separate workers with the same countItemsPerLevel can be combined with CutQuantileMerge.
+// While at most countItemsPerLevel non-missing values have been added, CutQuantileFinish returns exactly the cuts that
+// CutQuantile returns for the same values. Beyond that, each cut is placed within a rank error of at most about 
+// samples * log2(samples / countItemsPerLevel) / countItemsPerLevel samples of the exact algorithm, and typically 
+// much less. CutQuantileFinish does not change the sketch, so more chunks can be added afterwards.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateCutQuantileSketch(
+   IntEbm countItemsPerLevel,
+   CutQuantileSketchHandle * sketchHandleOut
+);
+EBM_API_INCLUDE void EBM_CALLING_CONVENTION FreeCutQuantileSketch(
+   CutQuantileSketchHandle sketchHandle
+);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CutQuantileAccumulate(
+   CutQuantileSketchHandle sketchHandle,
+   IntEbm countSamples,
+   const double * featureVals
+);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CutQuantileMerge(
+   CutQuantileSketchHandle sketchHandle,
+   CutQuantileSketchHandle otherSketchHandle
+);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CutQuantileFinish(
+   CutQuantileSketchHandle sketchHandle,
+   IntEbm minSamplesBin,
+   BoolEbm isRounded,
+   IntEbm * countCutsInOut,
+   double * cutsLowerBoundInclusiveOut
+);
+// Runs CutQuantile on every feature of a countSamples by countFeatures matrix, spreading the features across the 
+// threads of threadPool. countCutsInOut holds the maximum number of cuts for each feature on input, and the number
+// of cuts returned on output. The cuts of each feature are written to cutsLowerBoundInclusiveOut starting after the
+// space requested by the features before it. The results are identical to calling CutQuantile on each column.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CutQuantileMany(
+   IntEbm countSamples,
+   IntEbm countFeatures,
+   const double * featureVals,
+   MatrixOrder order,
+   IntEbm minSamplesBin,
+   BoolEbm isRounded,
+   ThreadPoolHandle threadPool, // can be NULL
+   IntEbm * countCutsInOut,
+   double * cutsLowerBoundInclusiveOut
+);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CutWinsorized(
    IntEbm countSamples,
    const double * featureVals,
@@ -312,8 +460,54 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION Discretize(
    const double * featureVals,
    IntEbm countCuts,
    const double * cutsLowerBoundInclusive,
+   ThreadPoolHandle threadPool, // can be NULL
+   IntEbm * binIndexesOut
+);
+// The same as Discretize, but writes narrower bin indexes. countCuts + 1 must fit into the output type.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION DiscretizeUInt8(
+   IntEbm countSamples,
+   const double * featureVals,
+   IntEbm countCuts,
+   const double * cutsLowerBoundInclusive,
+   ThreadPoolHandle threadPool, // can be NULL
+   uint8_t * binIndexesOut
+);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION DiscretizeUInt16(
+   IntEbm countSamples,
+   const double * featureVals,
+   IntEbm countCuts,
+   const double * cutsLowerBoundInclusive,
+   ThreadPoolHandle threadPool, // can be NULL
+   uint16_t * binIndexesOut
+);
+// Discretizes every feature of a countSamples by countFeatures matrix. countCuts holds the number of cuts of each
+// feature, and cutsLowerBoundInclusive holds the cuts of all the features one after another. binIndexesOut is
+// written in Fortran order, so the bin indexes of each feature are contiguous regardless of the input order.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION DiscretizeMatrix(
+   IntEbm countSamples,
+   IntEbm countFeatures,
+   const double * featureVals,
+   MatrixOrder order,
+   const IntEbm * countCuts,
+   const double * cutsLowerBoundInclusive,
+   ThreadPoolHandle threadPool, // can be NULL
    IntEbm * binIndexesOut
 );
+// Validates the cuts once and stores them in a layout that DiscretizeOne can search without branching.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateCutPlan(
+   IntEbm countCuts,
+   const double * cutsLowerBoundInclusive,
+   CutPlanHandle * cutPlanHandleOut
+);
+EBM_API_INCLUDE void EBM_CALLING_CONVENTION FreeCutPlan(
+   CutPlanHandle cutPlanHandle
+);
+// Returns the same bin index as Discretize for a single value. For speed this neither checks its inputs nor logs, 
+// so cutPlanHandle must be a valid handle from CreateCutPlan.
+EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION DiscretizeOne(
+   CutPlanHandle cutPlanHandle,
+   double featureVal
+);
 
 EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureDataSetHeader(
    IntEbm countFeatures,
@@ -328,6 +522,34 @@ EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureFeature(
    IntEbm countSamples,
    const IntEbm * binIndexes
 );
+// MeasureFeature and FillFeature for bin indexes that have already been narrowed, such as by DiscretizeUInt8
+EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureFeatureUInt8(
+   IntEbm countBins,
+   BoolEbm isMissing,
+   BoolEbm isUnknown,
+   BoolEbm isNominal,
+   IntEbm countSamples,
+   const uint8_t * binIndexes
+);
+EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureFeatureUInt16(
+   IntEbm countBins,
+   BoolEbm isMissing,
+   BoolEbm isUnknown,
+   BoolEbm isNominal,
+   IntEbm countSamples,
+   const uint16_t * binIndexes
+);
+// Equivalent to calling MeasureFeature for each column of the countSamples by countFeatures binIndexesMatrix and 
+// summing the results. binCounts and flags hold one entry per column.
+EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureFeatures(
+   IntEbm countFeatures,
+   const IntEbm * binCounts,
+   const FeatureFlags * flags,
+   IntEbm countSamples,
+   const IntEbm * binIndexesMatrix,
+   MatrixOrder order,
+   ThreadPoolHandle threadPool // can be NULL
+);
 EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureWeight(
    IntEbm countSamples,
    const double * weights
@@ -359,6 +581,39 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION FillFeature(
    IntEbm countBytesAllocated,
    void * fillMem
 );
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION FillFeatureUInt8(
+   IntEbm countBins,
+   BoolEbm isMissing,
+   BoolEbm isUnknown,
+   BoolEbm isNominal,
+   IntEbm countSamples,
+   const uint8_t * binIndexes,
+   IntEbm countBytesAllocated,
+   void * fillMem
+);
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION FillFeatureUInt16(
+   IntEbm countBins,
+   BoolEbm isMissing,
+   BoolEbm isUnknown,
+   BoolEbm isNominal,
+   IntEbm countSamples,
+   const uint16_t * binIndexes,
+   IntEbm countBytesAllocated,
+   void * fillMem
+);
+// Fills the same bytes as calling FillFeature for each column of binIndexesMatrix in order, but packs the columns 
+// in parallel when a threadPool is given.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION FillFeatures(
+   IntEbm countFeatures,
+   const IntEbm * binCounts,
+   const FeatureFlags * flags,
+   IntEbm countSamples,
+   const IntEbm * binIndexesMatrix,
+   MatrixOrder order,
+   ThreadPoolHandle threadPool, // can be NULL
+   IntEbm countBytesAllocated,
+   void * fillMem
+);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION FillWeight(
    IntEbm countSamples,
    const double * weights,
@@ -381,6 +636,25 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION FillRegressionTarget(
 
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CheckDataSet(IntEbm countBytesAllocated, const void * dataSet);
 
+// Writes a completed dataSet to path inside a versioned and checksummed file. countBytesAllocated must be the exact 
+// size of the dataSet.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION WriteDataSetFile(
+   const char * path,
+   IntEbm countBytesAllocated,
+   const void * dataSet
+);
+// Maps a file written by WriteDataSetFile read-only and validates it. dataSetOut can be passed directly to 
+// CreateBooster, CreateInteractionDetector and the other functions that take a dataSet, and it remains valid until 
+// FreeDataSetFile is called. Processes that map the same file share a single copy of it in the page cache.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateDataSetFromFile(
+   const char * path,
+   DataSetFileHandle * dataSetFileHandleOut,
+   const void ** dataSetOut
+);
+EBM_API_INCLUDE void EBM_CALLING_CONVENTION FreeDataSetFile(
+   DataSetFileHandle dataSetFileHandle
+);
+
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION ExtractDataSetHeader(
    const void * dataSet,
    IntEbm * countSamplesOut,
@@ -446,6 +720,59 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateBooster(
    CreateBoosterFlags flags,
    const char * objective,
    const double * experimentalParams,
+   ThreadPoolHandle threadPool, // can be NULL
+   BoosterHandle * boosterHandleOut
+);
+// Returns the peak heap bytes that CreateBooster would allocate with the same parameters, or a negative ErrorEbm.
+// The estimate covers the datasets, bags, tensors and boosting buffers. Small fixed allocations like the objective 
+// and the term descriptions are left out. If maxBytes is non-zero and flagsOut is non-NULL, the flags are 
+// progressively relaxed (compact inner bags, float32 SIMD, no sort by target) until the estimate fits within 
+// maxBytes. flagsOut always receives the flags that the returned estimate is for. The budget is only advisory: 
+// CreateBooster does not take maxBytes and allocates whatever the flags it is given need, so the caller must pass 
+// *flagsOut to CreateBooster to stay within the budget. If even the last step does not fit, the returned estimate 
+// is larger than maxBytes and the caller decides whether to create the booster anyway.
+EBM_API_INCLUDE IntEbm EBM_CALLING_CONVENTION MeasureBooster(
+   const void * dataSet,
+   const BagEbm * bag,
+   IntEbm countTerms,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   IntEbm countInnerBags,
+   CreateBoosterFlags flags,
+   const char * objective,
+   const double * experimentalParams,
+   ThreadPoolHandle threadPool, // can be NULL
+   IntEbm maxBytes, // zero means no budget
+   CreateBoosterFlags * flagsOut // can be NULL
+);
+// Extracts and packs the term data of every sample in dataSet once, so that the boosters of each outer bag can be 
+// created with CreateBoosterPrepared and share it instead of each building their own copy. dataSet must remain valid
+// until FreePreparedDataSet has been called and every booster created from the prepared dataset has been freed.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreatePreparedDataSet(
+   const void * dataSet,
+   IntEbm countTerms,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   CreateBoosterFlags flags,
+   const char * objective,
+   PreparedDataSetHandle * preparedDataSetHandleOut
+);
+EBM_API_INCLUDE void EBM_CALLING_CONVENTION FreePreparedDataSet(
+   PreparedDataSetHandle preparedDataSetHandle
+);
+// Equivalent to CreateBooster with the dataSet, terms and objective of the prepared dataset. The flags must select 
+// the same compute zones that were used to prepare the dataset, and CreateBoosterFlags_SortByTarget is not allowed.
+// This trades speed for memory. The booster keeps a slot for every sample of the dataset, including the validation 
+// and left out samples, and masks them with zero occurrences. Each boosting round visits those slots and uses the 
+// slower occurrence kernels even without replication. Only use it when the term data dominates memory.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateBoosterPrepared(
+   void * rng,
+   PreparedDataSetHandle preparedDataSet,
+   const BagEbm * bag,
+   const double * initScores,
+   IntEbm countInnerBags,
+   CreateBoosterFlags flags,
+   ThreadPoolHandle threadPool, // can be NULL
    BoosterHandle * boosterHandleOut
 );
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateBoosterView(
@@ -485,6 +812,25 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION ApplyTermUpdate(
    BoosterHandle boosterHandle,
    double * avgValidationMetricOut
 );
+// BoostRounds runs up to countRounds rounds of GenerateTermUpdate and ApplyTermUpdate over all the terms using the
+// same cyclic/greedy schedule and early stopping rules as the python boosting loop. leavesMax needs one item per
+// dimension of the term with the most dimensions. metricsOut can be NULL, otherwise it receives the best validation
+// metric seen at the end of each round and needs countRounds items
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION BoostRounds(
+   void * rng,
+   BoosterHandle boosterHandle,
+   IntEbm countRounds,
+   TermBoostFlags flags,
+   double learningRate,
+   IntEbm minSamplesLeaf,
+   const IntEbm * leavesMax,
+   double greediness,
+   IntEbm countSmoothingRounds,
+   IntEbm countEarlyStoppingRounds,
+   double earlyStoppingTolerance,
+   IntEbm * countRoundsOut,
+   double * metricsOut
+);
 EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION GetBestTermScores(
    BoosterHandle boosterHandle, 
    IntEbm indexTerm,
@@ -504,6 +850,7 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CreateInteractionDetector(
    CreateInteractionFlags flags,
    const char * objective,
    const double * experimentalParams,
+   ThreadPoolHandle threadPool, // can be NULL
    InteractionHandle * interactionHandleOut
 );
 EBM_API_INCLUDE void EBM_CALLING_CONVENTION FreeInteractionDetector(
@@ -518,6 +865,33 @@ EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrength(
    IntEbm minSamplesLeaf,
    double * avgInteractionStrengthOut
 );
+// Calculates the strengths of countTuples terms in a single call. The feature indexes of each term are packed back
+// to back in featureIndexes with dimensionCounts[i] entries for term i. strengthsOut receives one value per term.
+// If the InteractionHandle was created with a thread pool the terms are processed concurrently.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION CalcInteractionStrengths(
+   InteractionHandle interactionHandle, 
+   IntEbm countTuples,
+   const IntEbm * dimensionCounts,
+   const IntEbm * featureIndexes,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   double * strengthsOut
+);
+// Calculates the strengths of all pairs of features except the excludedPairs and returns the strongest
+// countPairsMax of them sorted from strongest to weakest. featureIndexesOut receives 2 feature indexes per pair.
+EBM_API_INCLUDE ErrorEbm EBM_CALLING_CONVENTION RankInteractions(
+   InteractionHandle interactionHandle, 
+   IntEbm countExcludedPairs,
+   const IntEbm * excludedPairs,
+   CalcInteractionFlags flags,
+   IntEbm maxCardinality,
+   IntEbm minSamplesLeaf,
+   IntEbm countPairsMax,
+   IntEbm * countPairsOut,
+   IntEbm * featureIndexesOut,
+   double * strengthsOut
+);
 
 #ifdef __cplusplus
 } // extern "C"
@@ -27,10 +27,20 @@
 // https://stackoverflow.com/questions/8823267/linking-against-older-symbol-version-in-a-so-file
 // https://stackoverflow.com/questions/36461555/is-it-possible-to-statically-link-libstdc-and-wrap-memcpy
 //
+// The x64 builds also wrap malloc, calloc, realloc and free (WRAP_HEAP_FUNCTIONS) so that every heap call made from 
+// inside our library, including operator new in the statically linked libstdc++, passes through one place where 
+// it can be counted. GetHeapCounters in compute_accessors.cpp reads the counts.
+//
 
 #include <string.h>
 #include <math.h>
 
+#ifdef WRAP_HEAP_FUNCTIONS
+#include <stdint.h>
+#include <malloc.h> // malloc_usable_size
+#include <atomic>
+#endif // WRAP_HEAP_FUNCTIONS
+
 #if defined(__x86_64__)
 // 64 bit x64
 
@@ -66,6 +76,65 @@ extern "C" {
    }
 }
 
+#ifdef WRAP_HEAP_FUNCTIONS
+
+// these have constant initialization, so they are valid before any static constructor calls malloc
+std::atomic<int64_t> g_cHeapCalls(0);
+std::atomic<int64_t> g_cHeapBytes(0);
+std::atomic<int64_t> g_cHeapBytesPeak(0);
+
+static void AddHeapBytes(const int64_t cBytes) {
+   const int64_t cBytesNow = g_cHeapBytes.fetch_add(cBytes, std::memory_order_relaxed) + cBytes;
+   int64_t cBytesPeak = g_cHeapBytesPeak.load(std::memory_order_relaxed);
+   while(cBytesPeak < cBytesNow && 
+      !g_cHeapBytesPeak.compare_exchange_weak(cBytesPeak, cBytesNow, std::memory_order_relaxed)) {
+   }
+}
+
+extern "C" {
+   void * __real_malloc(size_t size);
+   void * __real_calloc(size_t num, size_t size);
+   void * __real_realloc(void * ptr, size_t size);
+   void __real_free(void * ptr);
+
+   void * __wrap_malloc(size_t size) {
+      g_cHeapCalls.fetch_add(1, std::memory_order_relaxed);
+      void * const ret = __real_malloc(size);
+      if(nullptr != ret) {
+         AddHeapBytes(static_cast<int64_t>(malloc_usable_size(ret)));
+      }
+      return ret;
+   }
+   void * __wrap_calloc(size_t num, size_t size) {
+      g_cHeapCalls.fetch_add(1, std::memory_order_relaxed);
+      void * const ret = __real_calloc(num, size);
+      if(nullptr != ret) {
+         AddHeapBytes(static_cast<int64_t>(malloc_usable_size(ret)));
+      }
+      return ret;
+   }
+   void * __wrap_realloc(void * ptr, size_t size) {
+      g_cHeapCalls.fetch_add(1, std::memory_order_relaxed);
+      // realloc can free ptr, so measure it beforehand. If realloc fails ptr is still held
+      const size_t cBytesOld = nullptr == ptr ? size_t { 0 } : malloc_usable_size(ptr);
+      void * const ret = __real_realloc(ptr, size);
+      if(nullptr != ret) {
+         AddHeapBytes(static_cast<int64_t>(malloc_usable_size(ret)) - static_cast<int64_t>(cBytesOld));
+      } else if(0 == size) {
+         AddHeapBytes(-static_cast<int64_t>(cBytesOld));
+      }
+      return ret;
+   }
+   void __wrap_free(void * ptr) {
+      if(nullptr != ptr) {
+         g_cHeapBytes.fetch_sub(static_cast<int64_t>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+      }
+      __real_free(ptr);
+   }
+}
+
+#endif // WRAP_HEAP_FUNCTIONS
+
 #elif defined(__i386__)
 // 32 bit x86
 
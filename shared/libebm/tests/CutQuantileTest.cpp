@@ -1448,3 +1448,171 @@ TEST_CASE("CutQuantile, chunky randomized check") {
    }
 }
 
+
+TEST_CASE("CutQuantileFinish, small sketches in chunks and merged, identical to CutQuantile") {
+   static constexpr size_t cSamples = 1000;
+   static constexpr IntEbm countItemsPerLevel = 1024;
+   static constexpr size_t cCutsMax = 20;
+
+   ErrorEbm error;
+
+   std::vector<double> featureVals(cSamples);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      // duplicates, missing values and infinities all change which cuts are possible
+      featureVals[iSample] = 0 == iSample % 31 ? std::numeric_limits<double>::quiet_NaN() :
+         0 == iSample % 101 ? std::numeric_limits<double>::infinity() :
+         static_cast<double>(iSample * 7919 % 557) / 8.0;
+   }
+
+   std::vector<double> cutsExact(cCutsMax);
+   IntEbm countCutsExact = cCutsMax;
+   error = CutQuantile(cSamples, &featureVals[0], 3, EBM_TRUE, &countCutsExact, &cutsExact[0]);
+   CHECK(Error_None == error);
+   CHECK(IntEbm { 0 } < countCutsExact);
+
+   CutQuantileSketchHandle sketch1 = nullptr;
+   error = CreateCutQuantileSketch(countItemsPerLevel, &sketch1);
+   CHECK(Error_None == error);
+   CutQuantileSketchHandle sketch2 = nullptr;
+   error = CreateCutQuantileSketch(countItemsPerLevel, &sketch2);
+   CHECK(Error_None == error);
+
+   // the first sketch gets several uneven chunks, and the second sketch the remainder to be merged in
+   static constexpr size_t iSplit = 700;
+   for(size_t iStart = 0; iStart < iSplit; iStart += 97) {
+      error = CutQuantileAccumulate(sketch1, std::min(size_t { 97 }, iSplit - iStart), &featureVals[iStart]);
+      CHECK(Error_None == error);
+   }
+   error = CutQuantileAccumulate(sketch2, cSamples - iSplit, &featureVals[iSplit]);
+   CHECK(Error_None == error);
+   error = CutQuantileMerge(sketch1, sketch2);
+   CHECK(Error_None == error);
+
+   std::vector<double> cutsSketch(cCutsMax);
+   IntEbm countCutsSketch = cCutsMax;
+   error = CutQuantileFinish(sketch1, 3, EBM_TRUE, &countCutsSketch, &cutsSketch[0]);
+   CHECK(Error_None == error);
+
+   CHECK(countCutsExact == countCutsSketch);
+   CHECK(cutsExact == cutsSketch);
+
+   error = CutQuantileMerge(sketch1, sketch1);
+   CHECK(Error_IllegalParamVal == error);
+
+   FreeCutQuantileSketch(sketch2);
+   FreeCutQuantileSketch(sketch1);
+}
+
+TEST_CASE("CutQuantileFinish, compacted sketch, bins are close to equal sized") {
+   static constexpr size_t cSamples = 300000;
+   static constexpr size_t cCutsMax = 9;
+
+   ErrorEbm error;
+
+   // a permutation of 0 .. cSamples - 1, so an exact decile cut at value v has v samples below it
+   std::vector<double> featureVals(cSamples);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      featureVals[iSample] = static_cast<double>(iSample * 7919 % cSamples);
+   }
+
+   CutQuantileSketchHandle sketch = nullptr;
+   error = CreateCutQuantileSketch(1024, &sketch);
+   CHECK(Error_None == error);
+   // merge the second half in from a separate sketch, as parallel workers would
+   CutQuantileSketchHandle sketchWorker = nullptr;
+   error = CreateCutQuantileSketch(1024, &sketchWorker);
+   CHECK(Error_None == error);
+
+   static constexpr size_t cChunk = 4096;
+   for(size_t iStart = 0; iStart < cSamples; iStart += cChunk) {
+      error = CutQuantileAccumulate(
+         iStart < cSamples / 2 ? sketch : sketchWorker, std::min(cChunk, cSamples - iStart), &featureVals[iStart]);
+      CHECK(Error_None == error);
+   }
+   error = CutQuantileMerge(sketch, sketchWorker);
+   CHECK(Error_None == error);
+   FreeCutQuantileSketch(sketchWorker);
+
+   std::vector<double> cuts(cCutsMax);
+   IntEbm countCuts = cCutsMax;
+   error = CutQuantileFinish(sketch, 1, EBM_FALSE, &countCuts, &cuts[0]);
+   CHECK(Error_None == error);
+   FreeCutQuantileSketch(sketch);
+
+   CHECK(static_cast<IntEbm>(cCutsMax) == countCuts);
+   if(static_cast<IntEbm>(cCutsMax) == countCuts) {
+      for(size_t iCut = 0; iCut < cCutsMax; ++iCut) {
+         const double expected = static_cast<double>(cSamples / (cCutsMax + 1) * (iCut + 1));
+         CHECK(std::abs(cuts[iCut] - expected) < 0.02 * static_cast<double>(cSamples));
+      }
+   }
+}
+
+TEST_CASE("CutQuantileMany, C and Fortran order with and without threads, identical to CutQuantile") {
+   // large enough that the matrix is split across the threads of the pool
+   static constexpr size_t cSamples = 20000;
+   static constexpr size_t cFeatures = 7;
+
+   ErrorEbm error;
+
+   std::vector<double> featureValsC(cSamples * cFeatures);
+   std::vector<double> featureValsFortran(cSamples * cFeatures);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         const double val = 0 == (iSample + iFeature) % 53 ? std::numeric_limits<double>::quiet_NaN() :
+            static_cast<double>((iSample * 7919 + iFeature * 104729) % (97 + iFeature * 1000)) / 4.0;
+         featureValsC[iSample * cFeatures + iFeature] = val;
+         featureValsFortran[iFeature * cSamples + iSample] = val;
+      }
+   }
+
+   // a different maximum per feature, including a feature with no cuts allowed
+   const std::vector<IntEbm> countCutsMax { 10, 0, 3, 255, 1, 40, 7 };
+   std::vector<size_t> iCutsStart(cFeatures);
+   size_t cCutsTotal = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      iCutsStart[iFeature] = cCutsTotal;
+      cCutsTotal += static_cast<size_t>(countCutsMax[iFeature]);
+   }
+
+   std::vector<IntEbm> countCutsExpected(countCutsMax);
+   std::vector<double> cutsExpected(cCutsTotal, 0.0);
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      error = CutQuantile(cSamples,
+         &featureValsFortran[iFeature * cSamples],
+         5,
+         EBM_TRUE,
+         &countCutsExpected[iFeature],
+         &cutsExpected[iCutsStart[iFeature]]);
+      CHECK(Error_None == error);
+   }
+
+   ThreadPoolHandle threadPool = nullptr;
+   error = CreateThreadPool(4, AffinityFlags_Default, &threadPool);
+   CHECK(Error_None == error);
+
+   const ThreadPoolHandle threadPools[] = { nullptr, threadPool };
+   for(const ThreadPoolHandle pool : threadPools) {
+      for(const MatrixOrder order : { MatrixOrder_C, MatrixOrder_Fortran }) {
+         const std::vector<double> & featureVals = MatrixOrder_C == order ? featureValsC : featureValsFortran;
+         std::vector<IntEbm> countCuts(countCutsMax);
+         std::vector<double> cuts(cCutsTotal, 0.0);
+         error = CutQuantileMany(
+            cSamples, cFeatures, &featureVals[0], order, 5, EBM_TRUE, pool, &countCuts[0], &cuts[0]);
+         CHECK(Error_None == error);
+         CHECK(countCutsExpected == countCuts);
+         CHECK(cutsExpected == cuts);
+      }
+   }
+
+   FreeThreadPool(threadPool);
+
+   std::vector<IntEbm> countCuts(countCutsMax);
+   std::vector<double> cuts(cCutsTotal);
+   error = CutQuantileMany(cSamples, cFeatures, &featureValsC[0], 2, 5, EBM_TRUE, nullptr, &countCuts[0], &cuts[0]);
+   CHECK(Error_IllegalParamVal == error);
+   countCuts[3] = -1;
+   error = CutQuantileMany(
+      cSamples, cFeatures, &featureValsC[0], MatrixOrder_C, 5, EBM_TRUE, nullptr, &countCuts[0], &cuts[0]);
+   CHECK(Error_IllegalParamVal == error);
+}
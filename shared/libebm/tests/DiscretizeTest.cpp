@@ -40,6 +40,7 @@ TEST_CASE("Discretize, zero samples") {
       nullptr,
       countCuts,
       cutsLowerBoundInclusive,
+      nullptr,
       nullptr
    );
    CHECK(Error_None == error);
@@ -49,6 +50,7 @@ TEST_CASE("Discretize, zero samples") {
       nullptr,
       countCuts,
       cutsLowerBoundInclusive,
+      nullptr,
       nullptr
    );
    CHECK(Error_None == error);
@@ -99,6 +101,7 @@ TEST_CASE("Discretize, increasing lengths") {
          featureVals + cRemoveLow,
          cCuts,
          cutsLowerBoundInclusive,
+         nullptr,
          aiBins + cRemoveLow
       );
       CHECK(Error_None == error);
@@ -122,3 +125,327 @@ TEST_CASE("Discretize, increasing lengths") {
    }
 }
 
+
+TEST_CASE("Discretize, thread pool, identical to serial") {
+   static constexpr size_t cSamples = 300001;
+
+   ErrorEbm error;
+
+   const double cutsLowerBoundInclusive[] { -0.5, 0.0, 0.25, 3.0, 100.0 };
+   static constexpr IntEbm countCuts = sizeof(cutsLowerBoundInclusive) / sizeof(cutsLowerBoundInclusive[0]);
+
+   std::vector<double> featureVals(cSamples);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      featureVals[iSample] = 0 == iSample % 97 ? std::numeric_limits<double>::quiet_NaN() : 
+         static_cast<double>(iSample % 211) / 10.0 - 1.0;
+   }
+
+   std::vector<IntEbm> binsSerial(cSamples);
+   error = Discretize(
+      static_cast<IntEbm>(cSamples),
+      &featureVals[0],
+      countCuts,
+      cutsLowerBoundInclusive,
+      nullptr,
+      &binsSerial[0]
+   );
+   CHECK(Error_None == error);
+
+   ThreadPoolHandle threadPool = nullptr;
+   error = CreateThreadPool(4, AffinityFlags_Default, &threadPool);
+   CHECK(Error_None == error);
+
+   std::vector<IntEbm> binsThreaded(cSamples);
+   error = Discretize(
+      static_cast<IntEbm>(cSamples),
+      &featureVals[0],
+      countCuts,
+      cutsLowerBoundInclusive,
+      threadPool,
+      &binsThreaded[0]
+   );
+   CHECK(Error_None == error);
+
+   FreeThreadPool(threadPool);
+
+   CHECK(binsSerial == binsThreaded);
+}
+
+TEST_CASE("Discretize, narrow bin indexes, identical to IntEbm") {
+   static constexpr size_t cSamples = 1000;
+
+   ErrorEbm error;
+
+   std::vector<double> featureVals(cSamples);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      featureVals[iSample] = 0 == iSample % 97 ? std::numeric_limits<double>::quiet_NaN() : 
+         static_cast<double>(iSample % 311) - 20.0;
+   }
+
+   // cover the unrolled, padded and binary search loops, up to the most cuts that uint8_t can hold
+   for(const size_t cCuts : { size_t { 1 }, size_t { 3 }, size_t { 7 }, size_t { 30 }, size_t { 100 }, size_t { 254 } }) {
+      std::vector<double> cuts(cCuts);
+      for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+         cuts[iCut] = static_cast<double>(iCut) + 0.5;
+      }
+
+      std::vector<IntEbm> bins(cSamples);
+      error = Discretize(cSamples, &featureVals[0], cCuts, &cuts[0], nullptr, &bins[0]);
+      CHECK(Error_None == error);
+
+      std::vector<uint8_t> bins8(cSamples);
+      error = DiscretizeUInt8(cSamples, &featureVals[0], cCuts, &cuts[0], nullptr, &bins8[0]);
+      CHECK(Error_None == error);
+
+      std::vector<uint16_t> bins16(cSamples);
+      error = DiscretizeUInt16(cSamples, &featureVals[0], cCuts, &cuts[0], nullptr, &bins16[0]);
+      CHECK(Error_None == error);
+
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         CHECK(bins[iSample] == static_cast<IntEbm>(bins8[iSample]));
+         CHECK(bins[iSample] == static_cast<IntEbm>(bins16[iSample]));
+      }
+   }
+
+   // 255 cuts make bin index 256, which only the wider types can hold
+   std::vector<double> cuts(255);
+   for(size_t iCut = 0; iCut < cuts.size(); ++iCut) {
+      cuts[iCut] = static_cast<double>(iCut) + 0.5;
+   }
+   std::vector<uint8_t> bins8(cSamples);
+   error = DiscretizeUInt8(cSamples, &featureVals[0], cuts.size(), &cuts[0], nullptr, &bins8[0]);
+   CHECK(Error_IllegalParamVal == error);
+   std::vector<uint16_t> bins16(cSamples);
+   error = DiscretizeUInt16(cSamples, &featureVals[0], cuts.size(), &cuts[0], nullptr, &bins16[0]);
+   CHECK(Error_None == error);
+}
+
+static IntEbm DiscretizeLinear(const double val, const size_t cCuts, const double * const cutsLowerBoundInclusive) {
+   if(std::isnan(val)) {
+      return 0;
+   }
+   IntEbm iBin = 1;
+   for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+      if(cutsLowerBoundInclusive[iCut] <= val) {
+         ++iBin;
+      }
+   }
+   return iBin;
+}
+
+TEST_CASE("Discretize, SIMD kernels, identical to linear search") {
+   // enough samples to build the Eytzinger tree for 5000 cuts, and an odd count so the SIMD loops have a remainder
+   static constexpr size_t cSamples = 4 * 8192 + 3;
+
+   ErrorEbm error;
+
+   // on AVX-512 processors this runs the AVX512F kernels, then forces the AVX2 kernels, and then the scalar searches
+   for(const SIMDFlags simdFlags : { SIMDFlags_Default, SIMDFlags_DisableAVX512F, 
+      SIMDFlags_DisableAVX512F | SIMDFlags_DisableAVX2 }) {
+      SetSIMDFlags(simdFlags);
+
+      // cover the broadcast kernel up to and just past its cut limit, and Eytzinger trees with and without padding
+      for(const size_t cCuts : { size_t { 1 }, size_t { 2 }, size_t { 5 }, size_t { 15 }, size_t { 16 }, size_t { 17 },
+         size_t { 31 }, size_t { 254 }, size_t { 1000 }, size_t { 5000 } }) {
+
+         std::vector<double> cuts(cCuts);
+         for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+            cuts[iCut] = static_cast<double>(iCut) * 0.75 - 3.0;
+         }
+
+         std::vector<double> featureVals(cSamples);
+         for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+            const double cut = cuts[iSample * 7919 % cCuts];
+            double val;
+            switch(iSample % 9) {
+            case 0:
+               val = std::numeric_limits<double>::quiet_NaN();
+               break;
+            case 1:
+               val = FloatTickDecrementTest(cut);
+               break;
+            case 2:
+               // cuts are lower bound inclusive, so this needs to land in the bin above the cut
+               val = cut;
+               break;
+            case 3:
+               val = FloatTickIncrementTest(cut);
+               break;
+            case 4:
+               val = 0 == iSample % 2 ? std::numeric_limits<double>::infinity() : 
+                  -std::numeric_limits<double>::infinity();
+               break;
+            case 5:
+               val = 0 == iSample % 2 ? std::numeric_limits<double>::max() : std::numeric_limits<double>::lowest();
+               break;
+            case 6:
+               val = std::numeric_limits<double>::signaling_NaN();
+               break;
+            default:
+               val = cut + 0.25;
+               break;
+            }
+            featureVals[iSample] = val;
+         }
+
+         std::vector<IntEbm> bins(cSamples);
+         error = Discretize(cSamples, &featureVals[0], cCuts, &cuts[0], nullptr, &bins[0]);
+         CHECK(Error_None == error);
+
+         std::vector<uint16_t> bins16(cSamples);
+         error = DiscretizeUInt16(cSamples, &featureVals[0], cCuts, &cuts[0], nullptr, &bins16[0]);
+         CHECK(Error_None == error);
+
+         for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+            const IntEbm expected = DiscretizeLinear(featureVals[iSample], cCuts, &cuts[0]);
+            CHECK(expected == bins[iSample]);
+            CHECK(expected == static_cast<IntEbm>(bins16[iSample]));
+         }
+
+         // fewer samples than one SIMD register, and too few to build a tree
+         error = Discretize(3, &featureVals[0], cCuts, &cuts[0], nullptr, &bins[0]);
+         CHECK(Error_None == error);
+         for(size_t iSample = 0; iSample < 3; ++iSample) {
+            CHECK(DiscretizeLinear(featureVals[iSample], cCuts, &cuts[0]) == bins[iSample]);
+         }
+      }
+   }
+   SetSIMDFlags(SIMDFlags_Default);
+}
+
+TEST_CASE("DiscretizeMatrix, C and Fortran order, identical to Discretize per feature") {
+   // more features than fit into one stripe, and samples that do not fill the last block
+   static constexpr size_t cSamples = 1000;
+   static constexpr size_t cFeatures = 70;
+
+   ErrorEbm error;
+
+   std::vector<IntEbm> countCuts(cFeatures);
+   std::vector<double> cuts;
+   std::vector<size_t> iCutsStart(cFeatures);
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      // includes features with no cuts and features that use the binary search
+      const size_t cCuts = iFeature * 7 % 41;
+      countCuts[iFeature] = static_cast<IntEbm>(cCuts);
+      iCutsStart[iFeature] = cuts.size();
+      for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+         cuts.push_back(static_cast<double>(iCut) * 3.0 - 20.0);
+      }
+   }
+
+   std::vector<double> featureValsC(cSamples * cFeatures);
+   std::vector<double> featureValsFortran(cSamples * cFeatures);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         const double val = 0 == (iSample + iFeature) % 53 ? std::numeric_limits<double>::quiet_NaN() :
+            static_cast<double>((iSample * 31 + iFeature * 17) % 211) / 2.0 - 30.0;
+         featureValsC[iSample * cFeatures + iFeature] = val;
+         featureValsFortran[iFeature * cSamples + iSample] = val;
+      }
+   }
+
+   std::vector<IntEbm> expected(cSamples * cFeatures);
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      error = Discretize(
+         cSamples,
+         &featureValsFortran[iFeature * cSamples],
+         countCuts[iFeature],
+         cuts.empty() ? nullptr : &cuts[iCutsStart[iFeature]],
+         nullptr,
+         &expected[iFeature * cSamples]
+      );
+      CHECK(Error_None == error);
+   }
+
+   ThreadPoolHandle threadPool = nullptr;
+   error = CreateThreadPool(4, AffinityFlags_Default, &threadPool);
+   CHECK(Error_None == error);
+
+   const ThreadPoolHandle threadPools[] = { nullptr, threadPool };
+   for(const ThreadPoolHandle pool : threadPools) {
+      std::vector<IntEbm> binsC(cSamples * cFeatures, -1);
+      error = DiscretizeMatrix(
+         cSamples, cFeatures, &featureValsC[0], MatrixOrder_C, &countCuts[0], &cuts[0], pool, &binsC[0]);
+      CHECK(Error_None == error);
+      CHECK(expected == binsC);
+
+      std::vector<IntEbm> binsFortran(cSamples * cFeatures, -1);
+      error = DiscretizeMatrix(
+         cSamples, cFeatures, &featureValsFortran[0], MatrixOrder_Fortran, &countCuts[0], &cuts[0], pool, &binsFortran[0]);
+      CHECK(Error_None == error);
+      CHECK(expected == binsFortran);
+   }
+
+   FreeThreadPool(threadPool);
+
+   std::vector<IntEbm> bins(cSamples * cFeatures);
+   error = DiscretizeMatrix(cSamples, cFeatures, &featureValsC[0], 2, &countCuts[0], &cuts[0], nullptr, &bins[0]);
+   CHECK(Error_IllegalParamVal == error);
+   countCuts[3] = -1;
+   error = DiscretizeMatrix(
+      cSamples, cFeatures, &featureValsC[0], MatrixOrder_C, &countCuts[0], &cuts[0], nullptr, &bins[0]);
+   CHECK(Error_IllegalParamVal == error);
+}
+
+TEST_CASE("DiscretizeOne, cut plan, identical to Discretize") {
+   ErrorEbm error;
+
+   const double featureVals[] { std::numeric_limits<double>::quiet_NaN(), -std::numeric_limits<double>::infinity(),
+      std::numeric_limits<double>::lowest(), -3.0, -1.0, 0.0, 0.5, 1.0, 2.0, 2.25, 7.0, 1000.0, 
+      std::numeric_limits<double>::max(), std::numeric_limits<double>::infinity(),
+      std::numeric_limits<double>::signaling_NaN() };
+   static constexpr size_t cSamples = sizeof(featureVals) / sizeof(featureVals[0]);
+
+   // zero cuts, a full tree, and trees with padding
+   for(const size_t cCuts : { size_t { 0 }, size_t { 1 }, size_t { 2 }, size_t { 3 }, size_t { 4 }, size_t { 17 },
+      size_t { 1000 } }) {
+
+      std::vector<double> cuts(cCuts + 1);
+      for(size_t iCut = 0; iCut < cCuts; ++iCut) {
+         cuts[iCut] = static_cast<double>(iCut) * 0.75 - 1.0;
+      }
+
+      IntEbm bins[cSamples];
+      error = Discretize(cSamples, featureVals, cCuts, &cuts[0], nullptr, bins);
+      CHECK(Error_None == error);
+
+      CutPlanHandle cutPlan = nullptr;
+      error = CreateCutPlan(cCuts, &cuts[0], &cutPlan);
+      CHECK(Error_None == error);
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         CHECK(bins[iSample] == DiscretizeOne(cutPlan, featureVals[iSample]));
+      }
+      FreeCutPlan(cutPlan);
+   }
+}
+
+TEST_CASE("CreateCutPlan, illegal cuts") {
+   ErrorEbm error;
+   CutPlanHandle cutPlan;
+
+   const double unsorted[] { 1.0, 3.0, 2.0 };
+   error = CreateCutPlan(3, unsorted, &cutPlan);
+   CHECK(Error_IllegalParamVal == error);
+   CHECK(nullptr == cutPlan);
+
+   const double duplicate[] { 1.0, 2.0, 2.0 };
+   error = CreateCutPlan(3, duplicate, &cutPlan);
+   CHECK(Error_IllegalParamVal == error);
+
+   const double missing[] { 1.0, std::numeric_limits<double>::quiet_NaN() };
+   error = CreateCutPlan(2, missing, &cutPlan);
+   CHECK(Error_IllegalParamVal == error);
+
+   const double infinite[] { 1.0, std::numeric_limits<double>::infinity() };
+   error = CreateCutPlan(2, infinite, &cutPlan);
+   CHECK(Error_IllegalParamVal == error);
+
+   error = CreateCutPlan(-1, unsorted, &cutPlan);
+   CHECK(Error_IllegalParamVal == error);
+
+   error = CreateCutPlan(1, nullptr, &cutPlan);
+   CHECK(Error_IllegalParamVal == error);
+
+   // freeing a null handle is allowed
+   FreeCutPlan(nullptr);
+}
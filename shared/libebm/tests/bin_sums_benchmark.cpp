@@ -0,0 +1,277 @@
+// Copyright (c) 2023 The InterpretML Contributors
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "precompiled_header_test.hpp"
+
+#include <stdlib.h> // getenv
+#include <chrono>
+#include <algorithm> // std::min
+
+#include "libebm.h"
+#include "libebm_test.hpp"
+
+static constexpr TestPriority k_filePriority = TestPriority::BinSumsBenchmark;
+
+// Set the LIBEBM_BENCHMARK environment variable to print timings. Otherwise this only checks that the SIMD binning
+// agrees with the scalar binning at each bin count, which covers both the per lane histograms (few bins) and the
+// single shared histogram (many bins).
+TEST_CASE("BinSumsBoosting microbenchmark, SIMD versus scalar, per bin count") {
+   static constexpr size_t k_cSamples = size_t { 1 } << 17;
+
+   const bool bBenchmark = nullptr != getenv("LIBEBM_BENCHMARK");
+   const size_t cBoosts = bBenchmark ? size_t { 50 } : size_t { 2 };
+
+   for(const IntEbm cBins : { IntEbm { 2 }, IntEbm { 8 }, IntEbm { 32 }, IntEbm { 128 }, IntEbm { 512 }, IntEbm { 2048 } }) {
+      std::vector<TestSample> samples;
+      samples.reserve(k_cSamples);
+      for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+         const IntEbm iBin = static_cast<IntEbm>(iSample * 7919 % static_cast<size_t>(cBins));
+         samples.push_back(TestSample({ iBin }, static_cast<double>(0 == iBin % 3 ? 1 : 0)));
+      }
+
+      double aElapsed[2];
+      double aTermScores[2];
+      for(size_t iFlags = 0; iFlags < 2; ++iFlags) {
+         TestBoost test = TestBoost(OutputType_BinaryClassification,
+            { FeatureTest(cBins) },
+            { { 0 } },
+            samples,
+            {},
+            k_countInnerBagsDefault,
+            0 == iFlags ? CreateBoosterFlags_Default : CreateBoosterFlags_DisableSIMD
+         );
+
+         const auto start = std::chrono::steady_clock::now();
+         for(size_t iBoost = 0; iBoost < cBoosts; ++iBoost) {
+            test.Boost(0);
+         }
+         const auto end = std::chrono::steady_clock::now();
+
+         aElapsed[iFlags] = std::chrono::duration<double, std::milli>(end - start).count() / static_cast<double>(cBoosts);
+         aTermScores[iFlags] = test.GetCurrentTermScore(0, { 0 }, 0);
+      }
+
+      // the SIMD zones bin in float32 while the scalar zone bins in float64
+      CHECK_APPROX_TOLERANCE(aTermScores[0], aTermScores[1], 1e-3);
+
+      if(bBenchmark) {
+         std::cout << std::endl << "bins=" << cBins << 
+            " simd_ms=" << aElapsed[0] << 
+            " scalar_ms=" << aElapsed[1] << 
+            " speedup=" << aElapsed[1] / aElapsed[0];
+      }
+   }
+}
+
+// Compares the private per lane histograms against the single shared histogram within the same SIMD zone. The lanes 
+// are only compiled for single score terms in zones with a hardware scatter, so elsewhere both timings use the shared
+// histogram. Run the release build with LIBEBM_BENCHMARK set for meaningful timings.
+TEST_CASE("BinSumsBoosting microbenchmark, lane versus shared histograms, per bin count") {
+   static constexpr size_t k_cSamples = size_t { 1 } << 17;
+
+   const bool bBenchmark = nullptr != getenv("LIBEBM_BENCHMARK");
+   const size_t cBoosts = bBenchmark ? size_t { 50 } : size_t { 2 };
+
+   for(const CreateBoosterFlags flags : { CreateBoosterFlags_Default, CreateBoosterFlags_DoublePrecisionSIMD }) {
+      for(const IntEbm cBins : { IntEbm { 4 }, IntEbm { 16 }, IntEbm { 64 }, IntEbm { 256 } }) {
+         std::vector<TestSample> samples;
+         samples.reserve(k_cSamples);
+         for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+            const IntEbm iBin = static_cast<IntEbm>(iSample * 7919 % static_cast<size_t>(cBins));
+            samples.push_back(TestSample({ iBin }, static_cast<double>(0 == iBin % 3 ? 1 : 0)));
+         }
+
+         double aElapsed[2];
+         double aTermScores[2];
+         for(size_t iShared = 0; iShared < 2; ++iShared) {
+            SetSIMDFlags(0 == iShared ? SIMDFlags_Default : SIMDFlags_DisableLaneHistograms);
+
+            TestBoost test = TestBoost(OutputType_BinaryClassification,
+               { FeatureTest(cBins) },
+               { { 0 } },
+               samples,
+               {},
+               k_countInnerBagsDefault,
+               flags
+            );
+
+            const auto start = std::chrono::steady_clock::now();
+            for(size_t iBoost = 0; iBoost < cBoosts; ++iBoost) {
+               test.Boost(0);
+            }
+            const auto end = std::chrono::steady_clock::now();
+
+            aElapsed[iShared] = std::chrono::duration<double, std::milli>(end - start).count() / static_cast<double>(cBoosts);
+            aTermScores[iShared] = test.GetCurrentTermScore(0, { 0 }, 0);
+         }
+         SetSIMDFlags(SIMDFlags_Default);
+
+         // the lanes sum the samples of each bin in a different order
+         CHECK_APPROX_TOLERANCE(aTermScores[0], aTermScores[1], 1e-3);
+
+         if(bBenchmark) {
+            std::cout << std::endl << (CreateBoosterFlags_Default == flags ? "float32" : "float64") << 
+               " bins=" << cBins << 
+               " lanes_ms=" << aElapsed[0] << 
+               " shared_ms=" << aElapsed[1] << 
+               " speedup=" << aElapsed[1] / aElapsed[0];
+         }
+      }
+   }
+}
+
+// The intercept and terms limited to a single leaf put every sample into one bin, which uses the zero dimensional
+// kernel. 11 classes exceeds the compiled score counts, so the dynamic scores path accumulates in blocks of scores.
+TEST_CASE("BinSumsBoosting zero dimensional, SIMD versus scalar, weighted and bagged") {
+   static constexpr size_t k_cSamples = size_t { 1 } << 12;
+   static constexpr IntEbm k_cClasses = 11;
+
+   std::vector<TestSample> samples;
+   samples.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      samples.push_back(TestSample({ static_cast<IntEbm>(iSample % 4) }, 
+         static_cast<double>(std::min(iSample % 16, static_cast<size_t>(k_cClasses - 1))), 
+         0.5 + static_cast<double>(iSample % 5)));
+   }
+
+   for(const IntEbm cInnerBags : { IntEbm { 0 }, IntEbm { 2 } }) {
+      double aTermScores[2][k_cClasses];
+      double aInterceptScores[2][k_cClasses];
+      for(size_t iFlags = 0; iFlags < 2; ++iFlags) {
+         TestBoost test = TestBoost(k_cClasses,
+            { FeatureTest(4) },
+            { {}, { 0 } },
+            samples,
+            {},
+            cInnerBags,
+            0 == iFlags ? CreateBoosterFlags_Default : CreateBoosterFlags_DisableSIMD
+         );
+
+         for(size_t iBoost = 0; iBoost < 3; ++iBoost) {
+            test.Boost(0);
+            test.Boost(1, TermBoostFlags_Default, k_learningRateDefault, k_minSamplesLeafDefault, { 1 });
+         }
+         for(IntEbm iClass = 0; iClass < k_cClasses; ++iClass) {
+            aInterceptScores[iFlags][iClass] = test.GetCurrentTermScore(0, {}, static_cast<size_t>(iClass));
+            aTermScores[iFlags][iClass] = test.GetCurrentTermScore(1, { 0 }, static_cast<size_t>(iClass));
+         }
+      }
+
+      for(IntEbm iClass = 0; iClass < k_cClasses; ++iClass) {
+         // the SIMD zones bin in float32 while the scalar zone bins in float64
+         CHECK_APPROX_TOLERANCE(aInterceptScores[0][iClass], aInterceptScores[1][iClass], 1e-3);
+         CHECK_APPROX_TOLERANCE(aTermScores[0][iClass], aTermScores[1][iClass], 1e-3);
+      }
+   }
+}
+
+// Prepared boosters keep a slot for every shared sample and mask the left out samples with zero occurrences, so 
+// their bin sums visit the validation samples too and always use the occurrence multiplying kernels. This times a 
+// boosting round and counts the heap bytes of each booster for a train/validation split and for a bootstrap bag. 
+// Run the release build with LIBEBM_BENCHMARK set for meaningful timings.
+TEST_CASE("prepared dataset benchmark, outer bag boosters, prepared versus direct") {
+   const bool bBenchmark = nullptr != getenv("LIBEBM_BENCHMARK");
+   const IntEbm cSamples = bBenchmark ? IntEbm { 1 } << 18 : IntEbm { 1 } << 11;
+   const size_t cRounds = bBenchmark ? size_t { 20 } : size_t { 2 };
+   static constexpr IntEbm k_cFeatures = 4;
+   static constexpr IntEbm k_cBins = 32;
+
+   std::vector<std::vector<IntEbm>> bins(k_cFeatures);
+   std::vector<IntEbm> targets;
+   std::vector<BagEbm> bagSplit;
+   std::vector<BagEbm> bagBootstrap;
+   for(IntEbm iSample = 0; iSample < cSamples; ++iSample) {
+      for(IntEbm iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+         bins[static_cast<size_t>(iFeature)].push_back((iSample * (7919 + 2 * iFeature) + iFeature) % k_cBins);
+      }
+      targets.push_back(iSample * 31 % 7 < 3 ? 1 : 0);
+      // the default EBM outer bags hold out 15% of the samples for validation
+      const bool bValidation = iSample * 13 % 100 < 15;
+      bagSplit.push_back(bValidation ? BagEbm { -1 } : BagEbm { 1 });
+      // a bootstrap draw leaves out about a third of the training samples and replicates others
+      const IntEbm draw = iSample * 17 % 8;
+      bagBootstrap.push_back(bValidation ? BagEbm { -1 } : 
+         static_cast<BagEbm>(draw < 3 ? 0 : draw < 6 ? 1 : draw < 7 ? 2 : 3));
+   }
+
+   IntEbm sum = 0;
+   sum += MeasureDataSetHeader(k_cFeatures, 0, 1);
+   for(IntEbm iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+      sum += MeasureFeature(k_cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, &bins[static_cast<size_t>(iFeature)][0]);
+   }
+   sum += MeasureClassificationTarget(2, cSamples, &targets[0]);
+   std::vector<char> dataSet(static_cast<size_t>(sum));
+   CHECK(Error_None == FillDataSetHeader(k_cFeatures, 0, 1, sum, &dataSet[0]));
+   for(IntEbm iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+      CHECK(Error_None == FillFeature(k_cBins, EBM_TRUE, EBM_TRUE, EBM_FALSE, cSamples, 
+         &bins[static_cast<size_t>(iFeature)][0], sum, &dataSet[0]));
+   }
+   CHECK(Error_None == FillClassificationTarget(2, cSamples, &targets[0], sum, &dataSet[0]));
+
+   const IntEbm dimensionCounts[] { 1, 1, 1, 1 };
+   const IntEbm featureIndexes[] { 0, 1, 2, 3 };
+   const IntEbm leavesMax[] { 3 };
+
+   IntEbm cBytesHeapStart = -1;
+   GetHeapCounters(EBM_FALSE, nullptr, &cBytesHeapStart, nullptr);
+   PreparedDataSetHandle preparedHandle = nullptr;
+   CHECK(Error_None == CreatePreparedDataSet(&dataSet[0], k_cFeatures, dimensionCounts, featureIndexes, 
+      CreateBoosterFlags_Default, "log_loss", &preparedHandle));
+   IntEbm cBytesPrepared = -1;
+   GetHeapCounters(EBM_FALSE, nullptr, &cBytesPrepared, nullptr);
+   cBytesPrepared -= cBytesHeapStart;
+
+   const BagEbm * const apBags[] { &bagSplit[0], &bagBootstrap[0] };
+   for(const BagEbm * const aBag : apBags) {
+      double aElapsed[2];
+      double aMetrics[2];
+      IntEbm acBytes[2];
+      for(size_t iPrepared = 0; iPrepared < 2; ++iPrepared) {
+         IntEbm cBytesBefore = -1;
+         GetHeapCounters(EBM_FALSE, nullptr, &cBytesBefore, nullptr);
+         BoosterHandle boosterHandle = nullptr;
+         if(0 == iPrepared) {
+            CHECK(Error_None == CreateBooster(nullptr, &dataSet[0], aBag, nullptr, k_cFeatures, dimensionCounts, 
+               featureIndexes, 0, CreateBoosterFlags_Default, "log_loss", nullptr, nullptr, &boosterHandle));
+         } else {
+            CHECK(Error_None == CreateBoosterPrepared(nullptr, preparedHandle, aBag, nullptr, 0, 
+               CreateBoosterFlags_Default, nullptr, &boosterHandle));
+         }
+         IntEbm cBytesAfter = -1;
+         GetHeapCounters(EBM_FALSE, nullptr, &cBytesAfter, nullptr);
+         acBytes[iPrepared] = cBytesAfter - cBytesBefore;
+
+         double metric = 0.0;
+         const auto start = std::chrono::steady_clock::now();
+         for(size_t iRound = 0; iRound < cRounds; ++iRound) {
+            for(IntEbm iTerm = 0; iTerm < k_cFeatures; ++iTerm) {
+               CHECK(Error_None == GenerateTermUpdate(nullptr, boosterHandle, iTerm, TermBoostFlags_Default, 
+                  k_learningRateDefault, k_minSamplesLeafDefault, leavesMax, nullptr));
+               CHECK(Error_None == ApplyTermUpdate(boosterHandle, &metric));
+            }
+         }
+         const auto end = std::chrono::steady_clock::now();
+         FreeBooster(boosterHandle);
+
+         aElapsed[iPrepared] = std::chrono::duration<double, std::milli>(end - start).count() / 
+            static_cast<double>(cRounds);
+         aMetrics[iPrepared] = metric;
+      }
+
+      // the prepared subsets hold different samples, so the float32 sums are added in a different order
+      CHECK_APPROX_TOLERANCE(aMetrics[0], aMetrics[1], 1e-3);
+
+      if(bBenchmark) {
+         std::cout << std::endl << (&bagSplit[0] == aBag ? "split" : "bootstrap") << 
+            " samples=" << cSamples << 
+            " direct_ms=" << aElapsed[0] << 
+            " prepared_ms=" << aElapsed[1] << 
+            " slowdown=" << aElapsed[1] / aElapsed[0] << 
+            " direct_bytes=" << acBytes[0] << 
+            " prepared_bytes=" << acBytes[1] << 
+            " shared_bytes=" << cBytesPrepared;
+      }
+   }
+   FreePreparedDataSet(preparedHandle);
+}
@@ -1902,3 +1902,1014 @@ TEST_CASE("tweedie, boosting") {
    termScore = test.GetCurrentTermScore(0, {0}, 0);
    CHECK_APPROX(termScore, 2.3025076860047466);
 }
+
+TEST_CASE("thread pool, boosting, multiclass, identical to serial") {
+   // enough samples to require multiple data subsets in both the training and validation sets
+   static constexpr size_t k_cSamples = 300000;
+
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   train.reserve(k_cSamples);
+   validation.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const IntEbm iBin = static_cast<IntEbm>(iSample * 7 % 4);
+      train.push_back(TestSample({ iBin }, static_cast<double>(iSample * 11 % 5 % 3)));
+      validation.push_back(TestSample({ iBin }, static_cast<double>(iSample * 13 % 5 % 3)));
+   }
+
+   ThreadPoolHandle threadPool = nullptr;
+   const ErrorEbm error = CreateThreadPool(4, AffinityFlags_Default, &threadPool);
+   CHECK(Error_None == error);
+
+   TestBoost testSerial = TestBoost(3,
+      { FeatureTest(4) },
+      { { 0 } },
+      train,
+      validation,
+      k_countInnerBagsDefault,
+      CreateBoosterFlags_Default
+   );
+   TestBoost testThreaded = TestBoost(3,
+      { FeatureTest(4) },
+      { { 0 } },
+      train,
+      validation,
+      k_countInnerBagsDefault,
+      CreateBoosterFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      threadPool
+   );
+
+   // the booster holds its own reference to the thread pool
+   FreeThreadPool(threadPool);
+
+   for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+      const BoostRet retSerial = testSerial.Boost(0);
+      const BoostRet retThreaded = testThreaded.Boost(0);
+      CHECK(retSerial.gainAvg == retThreaded.gainAvg);
+      CHECK(retSerial.validationMetric == retThreaded.validationMetric);
+      for(size_t iBin = 0; iBin < 4; ++iBin) {
+         for(size_t iClass = 0; iClass < 3; ++iClass) {
+            CHECK(testSerial.GetCurrentTermScore(0, { iBin }, iClass) == 
+               testThreaded.GetCurrentTermScore(0, { iBin }, iClass));
+         }
+      }
+   }
+}
+
+TEST_CASE("thread pool, boosting, binary, identical to serial") {
+   // enough samples to require multiple data subsets
+   static constexpr size_t k_cSamples = 300000;
+
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   train.reserve(k_cSamples);
+   validation.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const IntEbm iBin = static_cast<IntEbm>(iSample * 7 % 5);
+      train.push_back(TestSample({ iBin }, static_cast<double>(iSample * 11 % 3 % 2)));
+      validation.push_back(TestSample({ iBin }, static_cast<double>(iSample * 13 % 3 % 2)));
+   }
+
+   ThreadPoolHandle threadPool = nullptr;
+   const ErrorEbm error = CreateThreadPool(4, AffinityFlags_Default, &threadPool);
+   CHECK(Error_None == error);
+
+   TestBoost testSerial = TestBoost(OutputType_BinaryClassification,
+      { FeatureTest(5) },
+      { { 0 } },
+      train,
+      validation,
+      2,
+      CreateBoosterFlags_Default
+   );
+   TestBoost testThreaded = TestBoost(OutputType_BinaryClassification,
+      { FeatureTest(5) },
+      { { 0 } },
+      train,
+      validation,
+      2,
+      CreateBoosterFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      threadPool
+   );
+
+   // the booster holds its own reference to the thread pool
+   FreeThreadPool(threadPool);
+
+   for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+      const BoostRet retSerial = testSerial.Boost(0);
+      const BoostRet retThreaded = testThreaded.Boost(0);
+      CHECK(retSerial.gainAvg == retThreaded.gainAvg);
+      CHECK(retSerial.validationMetric == retThreaded.validationMetric);
+      for(size_t iBin = 0; iBin < 5; ++iBin) {
+         CHECK(testSerial.GetCurrentTermScore(0, { iBin }, 0) == testThreaded.GetCurrentTermScore(0, { iBin }, 0));
+      }
+   }
+}
+
+TEST_CASE("thread pool, boosting, float64 zones, identical to serial") {
+   // float64 zones do not need subsets for precision, so this checks that the pool does not change the split
+   static constexpr size_t k_cSamples = 300000;
+
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   train.reserve(k_cSamples);
+   validation.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const IntEbm iBin = static_cast<IntEbm>(iSample * 7 % 5);
+      train.push_back(TestSample({ iBin }, static_cast<double>(iSample * 11 % 3 % 2)));
+      validation.push_back(TestSample({ iBin }, static_cast<double>(iSample * 13 % 3 % 2)));
+   }
+
+   ThreadPoolHandle threadPool = nullptr;
+   const ErrorEbm error = CreateThreadPool(4, AffinityFlags_Default, &threadPool);
+   CHECK(Error_None == error);
+
+   for(const CreateBoosterFlags flags : { CreateBoosterFlags_DisableSIMD, CreateBoosterFlags_DoublePrecisionSIMD }) {
+      TestBoost testSerial = TestBoost(OutputType_BinaryClassification,
+         { FeatureTest(5) },
+         { { 0 } },
+         train,
+         validation,
+         2,
+         flags
+      );
+      TestBoost testThreaded = TestBoost(OutputType_BinaryClassification,
+         { FeatureTest(5) },
+         { { 0 } },
+         train,
+         validation,
+         2,
+         flags,
+         nullptr,
+         k_iZeroClassificationLogitDefault,
+         threadPool
+      );
+
+      for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+         const BoostRet retSerial = testSerial.Boost(0);
+         const BoostRet retThreaded = testThreaded.Boost(0);
+         CHECK(retSerial.gainAvg == retThreaded.gainAvg);
+         CHECK(retSerial.validationMetric == retThreaded.validationMetric);
+         for(size_t iBin = 0; iBin < 5; ++iBin) {
+            CHECK(testSerial.GetCurrentTermScore(0, { iBin }, 0) == testThreaded.GetCurrentTermScore(0, { iBin }, 0));
+         }
+      }
+   }
+
+   FreeThreadPool(threadPool);
+}
+
+TEST_CASE("thread pool, boosting, inner bags, multiclass, identical to serial") {
+   // more inner bags than threads so that the bags are binned in more than one group
+   static constexpr IntEbm k_cInnerBags = 7;
+   static constexpr size_t k_cSamples = 1000;
+
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   train.reserve(k_cSamples);
+   validation.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample * 7 % 6);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample * 5 % 3);
+      train.push_back(TestSample({ iBin0, iBin1 }, static_cast<double>(iSample * 11 % 5 % 3)));
+      validation.push_back(TestSample({ iBin0, iBin1 }, static_cast<double>(iSample * 13 % 5 % 3)));
+   }
+
+   ThreadPoolHandle threadPool = nullptr;
+   const ErrorEbm error = CreateThreadPool(4, AffinityFlags_Default, &threadPool);
+   CHECK(Error_None == error);
+
+   TestBoost testSerial = TestBoost(3,
+      { FeatureTest(6), FeatureTest(3) },
+      { { 0 }, { 0, 1 } },
+      train,
+      validation,
+      k_cInnerBags
+   );
+   TestBoost testThreaded = TestBoost(3,
+      { FeatureTest(6), FeatureTest(3) },
+      { { 0 }, { 0, 1 } },
+      train,
+      validation,
+      k_cInnerBags,
+      CreateBoosterFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      threadPool
+   );
+
+   FreeThreadPool(threadPool);
+
+   for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+      for(size_t iTerm = 0; iTerm < 2; ++iTerm) {
+         const BoostRet retSerial = testSerial.Boost(iTerm);
+         const BoostRet retThreaded = testThreaded.Boost(iTerm);
+         CHECK(retSerial.gainAvg == retThreaded.gainAvg);
+         CHECK(retSerial.validationMetric == retThreaded.validationMetric);
+      }
+   }
+   for(size_t iBin0 = 0; iBin0 < 6; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 3; ++iBin1) {
+         for(size_t iClass = 0; iClass < 3; ++iClass) {
+            CHECK(testSerial.GetCurrentTermScore(1, { iBin0, iBin1 }, iClass) == 
+               testThreaded.GetCurrentTermScore(1, { iBin0, iBin1 }, iClass));
+         }
+      }
+   }
+}
+
+TEST_CASE("BoostRounds, cyclic and greedy rounds, identical to individual term updates") {
+   static constexpr IntEbm k_cRounds = 4;
+   static constexpr double k_greediness = 0.5;
+   static constexpr size_t k_cTerms = 3;
+
+   std::vector<TestSample> train;
+   std::vector<TestSample> validation;
+   for(size_t iSample = 0; iSample < 100; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample * 7 % 4);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample * 3 % 5);
+      train.push_back(TestSample({ iBin0, iBin1 }, static_cast<double>(iSample * 11 % 17)));
+      validation.push_back(TestSample({ iBin0, iBin1 }, static_cast<double>(iSample * 13 % 17)));
+   }
+
+   TestBoost testRounds = TestBoost(OutputType_Regression,
+      { FeatureTest(4), FeatureTest(5) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      train,
+      validation
+   );
+   TestBoost testSteps = TestBoost(OutputType_Regression,
+      { FeatureTest(4), FeatureTest(5) },
+      { { 0 }, { 1 }, { 0, 1 } },
+      train,
+      validation
+   );
+
+   std::vector<double> metrics;
+   const IntEbm countRounds = testRounds.BoostRounds(k_cRounds, k_greediness, 0, 0, 0.0, &metrics);
+   CHECK(k_cRounds == countRounds);
+   CHECK(static_cast<size_t>(k_cRounds) == metrics.size());
+
+   // replay the same schedule one term update at a time
+   double gains[k_cTerms];
+   double greedyPortion = 0.0;
+   double metricMin = std::numeric_limits<double>::infinity();
+   for(IntEbm iRound = 0; iRound < k_cRounds; ++iRound) {
+      const bool bGreedy = 1.0 <= greedyPortion;
+      for(size_t iStep = 0; iStep < k_cTerms; ++iStep) {
+         size_t iTerm = iStep;
+         if(bGreedy) {
+            iTerm = 0;
+            for(size_t iTermCompare = 1; iTermCompare < k_cTerms; ++iTermCompare) {
+               if(gains[iTerm] < gains[iTermCompare]) {
+                  iTerm = iTermCompare;
+               }
+            }
+         }
+         const BoostRet ret = testSteps.Boost(static_cast<IntEbm>(iTerm));
+         gains[iTerm] = ret.gainAvg;
+         metricMin = metricMin < ret.validationMetric ? metricMin : ret.validationMetric;
+      }
+      CHECK(metricMin == metrics[static_cast<size_t>(iRound)]);
+      if(bGreedy) {
+         greedyPortion -= 1.0;
+      }
+      greedyPortion += k_greediness;
+   }
+
+   for(size_t iBin0 = 0; iBin0 < 4; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 5; ++iBin1) {
+         CHECK(testRounds.GetCurrentTermScore(2, { iBin0, iBin1 }, 0) == 
+            testSteps.GetCurrentTermScore(2, { iBin0, iBin1 }, 0));
+      }
+   }
+}
+
+TEST_CASE("BoostRounds, early stopping") {
+   TestBoost test = TestBoost(OutputType_Regression,
+      { FeatureTest(2) },
+      { { 0 } },
+      { TestSample({ 0 }, 10), TestSample({ 1 }, 12) },
+      { TestSample({ 0 }, 11), TestSample({ 1 }, 12) }
+   );
+
+   // a tolerance this large means that no round counts as an improvement
+   const IntEbm countRounds = test.BoostRounds(100, 0.0, 0, 2, 1e300);
+   CHECK(2 == countRounds);
+}
+
+TEST_CASE("double precision SIMD, boosting, matches the cpu zone") {
+   // not a multiple of any SIMD pack so that the remainder is handled by the cpu zone
+   static constexpr size_t k_cSamples = 1003;
+
+   // on AVX-512 processors this runs the AVX512F_64 zone and then forces the AVX2_64 zone
+   for(const SIMDFlags simdFlags : { SIMDFlags_Default, SIMDFlags_DisableAVX512F }) {
+      SetSIMDFlags(simdFlags);
+
+      for(const OutputType cClasses : { OutputType_Regression, OutputType_BinaryClassification, OutputType { 3 } }) {
+         std::vector<TestSample> samples;
+         samples.reserve(k_cSamples);
+         for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+            const IntEbm iBin0 = static_cast<IntEbm>(iSample * 7 % 5);
+            const IntEbm iBin1 = static_cast<IntEbm>(iSample * 3 % 4);
+            const double target = OutputType_Regression == cClasses ? 
+               static_cast<double>(iSample % 17) * 0.25 + static_cast<double>(iBin0) : 
+               static_cast<double>((iSample * 11 + static_cast<size_t>(iBin1)) % 13 % static_cast<size_t>(cClasses));
+            samples.push_back(TestSample({ iBin0, iBin1 }, target, 0.5 + static_cast<double>(iSample % 3)));
+         }
+
+         TestBoost testCpu = TestBoost(cClasses,
+            { FeatureTest(5), FeatureTest(4) },
+            { { 0 }, { 1 }, { 0, 1 } },
+            samples,
+            samples,
+            2,
+            CreateBoosterFlags_DisableSIMD
+         );
+         TestBoost testDouble = TestBoost(cClasses,
+            { FeatureTest(5), FeatureTest(4) },
+            { { 0 }, { 1 }, { 0, 1 } },
+            samples,
+            samples,
+            2,
+            CreateBoosterFlags_DoublePrecisionSIMD
+         );
+
+         // regression only differs in summation order. Classification also uses the approximate exp and log, which 
+         // the cpu zone evaluates partly in float32 while the SIMD zones evaluate them in float64
+         const double tolerance = OutputType_Regression == cClasses ? 1e-9 : 1e-5;
+
+         for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+            for(size_t iTerm = 0; iTerm < testCpu.GetCountTerms(); ++iTerm) {
+               const double metricCpu = testCpu.Boost(static_cast<IntEbm>(iTerm)).validationMetric;
+               const double metricDouble = testDouble.Boost(static_cast<IntEbm>(iTerm)).validationMetric;
+               CHECK_APPROX_TOLERANCE(metricCpu, metricDouble, tolerance);
+            }
+         }
+
+         const size_t cScores = OutputType_Regression == cClasses || OutputType_BinaryClassification == cClasses ? 
+            size_t { 1 } : static_cast<size_t>(cClasses);
+         for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+            for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+               for(size_t iScore = 0; iScore < cScores; ++iScore) {
+                  // the pair scores can be close to zero, so compare them absolutely instead of relatively
+                  const double scoreCpu = testCpu.GetCurrentTermScore(2, { iBin0, iBin1 }, iScore);
+                  const double scoreDouble = testDouble.GetCurrentTermScore(2, { iBin0, iBin1 }, iScore);
+                  CHECK(std::abs(scoreCpu - scoreDouble) < tolerance);
+               }
+            }
+         }
+      }
+   }
+   SetSIMDFlags(SIMDFlags_Default);
+}
+
+TEST_CASE("compact inner bags, boosting, matches materialized inner bags") {
+   static constexpr size_t k_cSamples = 1003;
+   static constexpr IntEbm k_cInnerBags = 3;
+
+   for(const bool bWeighted : { false, true }) {
+      for(const OutputType cClasses : { OutputType_Regression, OutputType_BinaryClassification, OutputType { 3 } }) {
+         std::vector<TestSample> samples;
+         samples.reserve(k_cSamples);
+         for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+            const IntEbm iBin0 = static_cast<IntEbm>(iSample * 7 % 5);
+            const IntEbm iBin1 = static_cast<IntEbm>(iSample * 3 % 4);
+            const double target = OutputType_Regression == cClasses ? 
+               static_cast<double>(iSample % 17) * 0.25 + static_cast<double>(iBin0) : 
+               static_cast<double>((iSample * 11 + static_cast<size_t>(iBin1)) % 13 % static_cast<size_t>(cClasses));
+            if(bWeighted) {
+               samples.push_back(TestSample({ iBin0, iBin1 }, target, 0.5 + static_cast<double>(iSample % 3)));
+            } else {
+               samples.push_back(TestSample({ iBin0, iBin1 }, target));
+            }
+         }
+
+         TestBoost testMaterialized = TestBoost(cClasses,
+            { FeatureTest(5), FeatureTest(4) },
+            { { 0 }, { 1 }, { 0, 1 } },
+            samples,
+            samples,
+            k_cInnerBags
+         );
+         TestBoost testCompact = TestBoost(cClasses,
+            { FeatureTest(5), FeatureTest(4) },
+            { { 0 }, { 1 }, { 0, 1 } },
+            samples,
+            samples,
+            k_cInnerBags,
+            CreateBoosterFlags_CompactInnerBags
+         );
+
+         for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+            for(size_t iTerm = 0; iTerm < testMaterialized.GetCountTerms(); ++iTerm) {
+               const double metricMaterialized = testMaterialized.Boost(static_cast<IntEbm>(iTerm)).validationMetric;
+               const double metricCompact = testCompact.Boost(static_cast<IntEbm>(iTerm)).validationMetric;
+               if(bWeighted) {
+                  // the compact bags multiply the weights by the occurrences in the SIMD float type, so the 
+                  // rounding can differ slightly from the materialized weights which are multiplied in double
+                  CHECK_APPROX_TOLERANCE(metricMaterialized, metricCompact, 1e-5);
+               } else {
+                  CHECK(metricMaterialized == metricCompact);
+               }
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("sparse feature, boosting, matches dense feature") {
+   static constexpr size_t k_cSamples = 1003;
+   static constexpr IntEbm k_cInnerBags = 2;
+
+   for(const OutputType cClasses : { OutputType_Regression, OutputType_BinaryClassification, OutputType { 3 } }) {
+      // feature 0 is nearly always bin 1, so the shared dataset stores it sparsely
+      std::vector<TestSample> train;
+      train.reserve(k_cSamples);
+      for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+         const IntEbm iBin0 = 0 == iSample % 97 ? static_cast<IntEbm>(iSample / 97 % 4 * 2 % 5) : IntEbm { 1 };
+         const IntEbm iBin1 = static_cast<IntEbm>(iSample * 3 % 4);
+         const double target = OutputType_Regression == cClasses ? 
+            static_cast<double>(iSample % 17) * 0.25 + static_cast<double>(iBin0) : 
+            static_cast<double>((iSample * 11 + static_cast<size_t>(iBin0)) % 13 % static_cast<size_t>(cClasses));
+         train.push_back(TestSample({ iBin0, iBin1 }, target, 0.5 + static_cast<double>(iSample % 3)));
+      }
+
+      // the term updates only depend on the training set, so a validation set with feature 0 spread over all of 
+      // its bins gives us an identical booster whose shared dataset stores feature 0 densely
+      std::vector<TestSample> validationDense;
+      validationDense.reserve(k_cSamples);
+      for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+         validationDense.push_back(TestSample({ static_cast<IntEbm>(iSample % 5), IntEbm { 0 } }, 0.0));
+      }
+
+      TestBoost testSparse = TestBoost(cClasses,
+         { FeatureTest(5), FeatureTest(4) },
+         { { 0 }, { 1 }, { 0, 1 } },
+         train,
+         train,
+         k_cInnerBags
+      );
+      TestBoost testDense = TestBoost(cClasses,
+         { FeatureTest(5), FeatureTest(4) },
+         { { 0 }, { 1 }, { 0, 1 } },
+         train,
+         validationDense,
+         k_cInnerBags
+      );
+
+      for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+         for(size_t iTerm = 0; iTerm < testSparse.GetCountTerms(); ++iTerm) {
+            testSparse.Boost(static_cast<IntEbm>(iTerm));
+            testDense.Boost(static_cast<IntEbm>(iTerm));
+         }
+      }
+
+      // sparse features are expanded into the same dense term data, so the results are identical
+      const size_t cScores = OutputType_Regression == cClasses || OutputType_BinaryClassification == cClasses ? 
+         size_t { 1 } : static_cast<size_t>(cClasses);
+      for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            const double scoreSparse = testSparse.GetCurrentTermScore(0, { iBin0 }, iScore);
+            const double scoreDense = testDense.GetCurrentTermScore(0, { iBin0 }, iScore);
+            CHECK(scoreSparse == scoreDense);
+            for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+               const double pairSparse = testSparse.GetCurrentTermScore(2, { iBin0, iBin1 }, iScore);
+               const double pairDense = testDense.GetCurrentTermScore(2, { iBin0, iBin1 }, iScore);
+               CHECK(pairSparse == pairDense);
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("unweighted fast bins without counts, boosting, min samples leaf matches unit weights") {
+   static constexpr size_t k_cSamples = 1003;
+   static constexpr IntEbm k_minSamplesLeaf = 60;
+
+   for(const CreateBoosterFlags flags : { CreateBoosterFlags_Default, CreateBoosterFlags_CompactInnerBags }) {
+      // materialized inner bags hold bag weights, so only the unbagged and compact cases drop the counts
+      const IntEbm cInnerBags = CreateBoosterFlags_Default == flags ? IntEbm { 0 } : IntEbm { 2 };
+      for(const OutputType cClasses : { OutputType_Regression, OutputType_BinaryClassification, OutputType { 3 } }) {
+         // feature 0 has a few sparsely populated bins so that the min samples leaf checks reject some splits
+         std::vector<TestSample> samplesUnweighted;
+         std::vector<TestSample> samplesUnitWeights;
+         samplesUnweighted.reserve(k_cSamples);
+         samplesUnitWeights.reserve(k_cSamples);
+         for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+            const IntEbm iBin0 = static_cast<IntEbm>(iSample * iSample % 23 % 5);
+            const IntEbm iBin1 = static_cast<IntEbm>(iSample * 3 % 4);
+            const double target = OutputType_Regression == cClasses ? 
+               static_cast<double>(iSample % 17) * 0.25 + static_cast<double>(iBin0) : 
+               static_cast<double>((iSample * 11 + static_cast<size_t>(iBin0)) % 13 % static_cast<size_t>(cClasses));
+            samplesUnweighted.push_back(TestSample({ iBin0, iBin1 }, target));
+            samplesUnitWeights.push_back(TestSample({ iBin0, iBin1 }, target, 1.0));
+         }
+
+         // unit weights keep the counts in the fast bins, while the unweighted booster restores them from the weights
+         TestBoost testUnweighted = TestBoost(cClasses,
+            { FeatureTest(5), FeatureTest(4) },
+            { { 0 }, { 1 }, { 0, 1 } },
+            samplesUnweighted,
+            samplesUnweighted,
+            cInnerBags,
+            flags
+         );
+         TestBoost testUnitWeights = TestBoost(cClasses,
+            { FeatureTest(5), FeatureTest(4) },
+            { { 0 }, { 1 }, { 0, 1 } },
+            samplesUnitWeights,
+            samplesUnitWeights,
+            cInnerBags,
+            flags
+         );
+
+         for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+            for(size_t iTerm = 0; iTerm < testUnweighted.GetCountTerms(); ++iTerm) {
+               testUnweighted.Boost(static_cast<IntEbm>(iTerm), 
+                  TermBoostFlags_Default, k_learningRateDefault, k_minSamplesLeaf);
+               testUnitWeights.Boost(static_cast<IntEbm>(iTerm), 
+                  TermBoostFlags_Default, k_learningRateDefault, k_minSamplesLeaf);
+            }
+         }
+
+         const size_t cScores = OutputType_Regression == cClasses || OutputType_BinaryClassification == cClasses ? 
+            size_t { 1 } : static_cast<size_t>(cClasses);
+         for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               const double scoreUnweighted = testUnweighted.GetCurrentTermScore(0, { iBin0 }, iScore);
+               const double scoreUnitWeights = testUnitWeights.GetCurrentTermScore(0, { iBin0 }, iScore);
+               CHECK(scoreUnweighted == scoreUnitWeights);
+               for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+                  const double pairUnweighted = testUnweighted.GetCurrentTermScore(2, { iBin0, iBin1 }, iScore);
+                  const double pairUnitWeights = testUnitWeights.GetCurrentTermScore(2, { iBin0, iBin1 }, iScore);
+                  CHECK(pairUnweighted == pairUnitWeights);
+               }
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("sort by target, boosting, matches the caller's sample order") {
+   static constexpr size_t k_cTrainSamples = 1003;
+   static constexpr size_t k_cValidationSamples = 301;
+   static constexpr IntEbm k_cInnerBags = 2;
+
+   for(const OutputType cClasses : { OutputType_BinaryClassification, OutputType { 3 } }) {
+      const size_t cScores = OutputType_BinaryClassification == cClasses ? size_t { 1 } : static_cast<size_t>(cClasses);
+      for(const bool bWeighted : { false, true }) {
+         // feature 1 is almost always in bin 0, so the sorted dataset also has to look up sparse features
+         std::vector<TestSample> train;
+         std::vector<TestSample> validation;
+         train.reserve(k_cTrainSamples);
+         validation.reserve(k_cValidationSamples);
+         for(size_t iSample = 0; iSample < k_cTrainSamples + k_cValidationSamples; ++iSample) {
+            const IntEbm iBin0 = static_cast<IntEbm>(iSample * iSample % 23 % 5);
+            const IntEbm iBin1 = 0 == iSample % 73 ? static_cast<IntEbm>(iSample % 3 + 1) : IntEbm { 0 };
+            const double target = 
+               static_cast<double>((iSample * 11 + static_cast<size_t>(iBin0)) % 13 % static_cast<size_t>(cClasses));
+            const double weight = static_cast<double>(iSample % 7 + 1) * 0.5;
+            std::vector<double> initScores;
+            for(size_t iScore = 0; iScore < static_cast<size_t>(cClasses); ++iScore) {
+               initScores.push_back(static_cast<double>((iSample + iScore) % 5) * 0.125 - 0.25);
+            }
+            if(iSample < k_cTrainSamples) {
+               // replicate some samples and exclude others so that the bag is not trivially the identity
+               const BagEbm replication = 0 == iSample % 11 ? BagEbm { 0 } : 0 == iSample % 5 ? BagEbm { 3 } : BagEbm { 1 };
+               train.push_back(bWeighted ? TestSample(replication, { iBin0, iBin1 }, target, weight, initScores) :
+                  TestSample(replication, { iBin0, iBin1 }, target, initScores));
+            } else {
+               validation.push_back(bWeighted ? TestSample({ iBin0, iBin1 }, target, weight, initScores) :
+                  TestSample({ iBin0, iBin1 }, target, initScores));
+            }
+         }
+
+         // the SIMD zones use approximate exp and log, and sorting changes which samples fall into the non-SIMD
+         // remainder subsets, so compare both boosters in the CPU zone
+         TestBoost testOriginal = TestBoost(cClasses,
+            { FeatureTest(5), FeatureTest(4) },
+            { { 0 }, { 1 }, { 0, 1 } },
+            train,
+            validation,
+            k_cInnerBags,
+            CreateBoosterFlags_DisableSIMD
+         );
+         TestBoost testSorted = TestBoost(cClasses,
+            { FeatureTest(5), FeatureTest(4) },
+            { { 0 }, { 1 }, { 0, 1 } },
+            train,
+            validation,
+            k_cInnerBags,
+            CreateBoosterFlags_DisableSIMD | CreateBoosterFlags_SortByTarget
+         );
+
+         // the samples are summed in a different order, so the results only match approximately
+         for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+            for(size_t iTerm = 0; iTerm < testOriginal.GetCountTerms(); ++iTerm) {
+               const double metricOriginal = testOriginal.Boost(static_cast<IntEbm>(iTerm)).validationMetric;
+               const double metricSorted = testSorted.Boost(static_cast<IntEbm>(iTerm)).validationMetric;
+               CHECK_APPROX(metricSorted, metricOriginal);
+            }
+         }
+
+         for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+            for(size_t iScore = 0; iScore < cScores; ++iScore) {
+               const double scoreOriginal = testOriginal.GetCurrentTermScore(0, { iBin0 }, iScore);
+               const double scoreSorted = testSorted.GetCurrentTermScore(0, { iBin0 }, iScore);
+               CHECK_APPROX(scoreSorted, scoreOriginal);
+               for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+                  const double pairOriginal = testOriginal.GetCurrentTermScore(2, { iBin0, iBin1 }, iScore);
+                  const double pairSorted = testSorted.GetCurrentTermScore(2, { iBin0, iBin1 }, iScore);
+                  CHECK_APPROX(pairSorted, pairOriginal);
+               }
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("measure booster, memory budget, relaxes the flags until the estimate fits") {
+   static constexpr IntEbm k_cSamples = 200;
+   static constexpr IntEbm k_cClasses = 3;
+
+   std::vector<IntEbm> binsA;
+   std::vector<IntEbm> binsB;
+   std::vector<IntEbm> targets;
+   std::vector<BagEbm> bag;
+   for(IntEbm iSample = 0; iSample < k_cSamples; ++iSample) {
+      binsA.push_back(iSample % 5);
+      binsB.push_back(iSample % 7 < 6 ? 0 : 2);
+      targets.push_back(iSample % 11 % k_cClasses);
+      bag.push_back(0 == iSample % 4 ? BagEbm { -1 } : BagEbm { 1 });
+   }
+
+   IntEbm sum = 0;
+   sum += MeasureDataSetHeader(2, 0, 1);
+   sum += MeasureFeature(5, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binsA[0]);
+   sum += MeasureFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binsB[0]);
+   sum += MeasureClassificationTarget(k_cClasses, k_cSamples, &targets[0]);
+   std::vector<char> dataSet(static_cast<size_t>(sum));
+   CHECK(Error_None == FillDataSetHeader(2, 0, 1, sum, &dataSet[0]));
+   CHECK(Error_None == FillFeature(5, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binsA[0], sum, &dataSet[0]));
+   CHECK(Error_None == FillFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binsB[0], sum, &dataSet[0]));
+   CHECK(Error_None == FillClassificationTarget(k_cClasses, k_cSamples, &targets[0], sum, &dataSet[0]));
+
+   const IntEbm dimensionCounts[] { 1, 1, 2 };
+   const IntEbm featureIndexes[] { 0, 1, 0, 1 };
+   static constexpr IntEbm k_cInnerBags = 3;
+
+   const CreateBoosterFlags flags = CreateBoosterFlags_DoublePrecisionSIMD | CreateBoosterFlags_SortByTarget;
+   CreateBoosterFlags flagsOut = CreateBoosterFlags_Default;
+
+   // without a budget we measure exactly what was asked for
+   const IntEbm cBytes = MeasureBooster(&dataSet[0], &bag[0], 3, dimensionCounts, featureIndexes, k_cInnerBags, 
+      flags, "log_loss", nullptr, nullptr, 0, &flagsOut);
+   CHECK(0 < cBytes);
+   CHECK(flags == flagsOut);
+
+   // a budget that already fits keeps the caller's flags
+   const IntEbm cBytesFits = MeasureBooster(&dataSet[0], &bag[0], 3, dimensionCounts, featureIndexes, 
+      k_cInnerBags, flags, "log_loss", nullptr, nullptr, cBytes, &flagsOut);
+   CHECK(cBytes == cBytesFits);
+   CHECK(flags == flagsOut);
+
+   // compact inner bags do not store a weight per sample per bag
+   const IntEbm cBytesCompact = MeasureBooster(&dataSet[0], &bag[0], 3, dimensionCounts, featureIndexes, 
+      k_cInnerBags, flags | CreateBoosterFlags_CompactInnerBags, "log_loss", nullptr, nullptr, 0, nullptr);
+   CHECK(0 < cBytesCompact);
+   CHECK(cBytesCompact < cBytes);
+
+   // an impossible budget walks the whole ladder and reports the smallest configuration
+   const IntEbm cBytesSmallest = MeasureBooster(&dataSet[0], &bag[0], 3, dimensionCounts, featureIndexes, 
+      k_cInnerBags, flags, "log_loss", nullptr, nullptr, 1, &flagsOut);
+   CHECK(CreateBoosterFlags_CompactInnerBags == flagsOut);
+   CHECK(0 < cBytesSmallest);
+   CHECK(cBytesSmallest < cBytesCompact);
+   CHECK(cBytesSmallest == MeasureBooster(&dataSet[0], &bag[0], 3, dimensionCounts, featureIndexes, 
+      k_cInnerBags, flagsOut, "log_loss", nullptr, nullptr, 0, nullptr));
+
+   BoosterHandle boosterHandle = nullptr;
+   CHECK(Error_None == CreateBooster(nullptr, &dataSet[0], &bag[0], nullptr, 3, dimensionCounts, featureIndexes, 
+      k_cInnerBags, flagsOut, "log_loss", nullptr, nullptr, &boosterHandle));
+   CHECK(nullptr != boosterHandle);
+   FreeBooster(boosterHandle);
+}
+
+TEST_CASE("measure booster, estimate, matches the heap peak of CreateBooster") {
+   static constexpr IntEbm k_cSamples = 20000;
+
+   // MeasureBooster leaves out small fixed allocations like the objective and the term descriptions, and the heap 
+   // counters see the allocator's rounding, so we allow 5% of the peak plus 16 KiB
+   static constexpr IntEbm k_cBytesFixed = 16384;
+
+   IntEbm cBytesHeap = -1;
+   GetHeapCounters(EBM_FALSE, nullptr, &cBytesHeap, nullptr);
+   if(cBytesHeap < IntEbm { 0 }) {
+      // this build does not wrap malloc, so there is nothing to compare against
+      return;
+   }
+
+   for(const IntEbm cClasses : { IntEbm { -1 }, IntEbm { 3 } }) {
+      std::vector<IntEbm> binsA;
+      std::vector<IntEbm> binsB;
+      std::vector<IntEbm> targetsClassification;
+      std::vector<double> targetsRegression;
+      std::vector<BagEbm> bag;
+      for(IntEbm iSample = 0; iSample < k_cSamples; ++iSample) {
+         binsA.push_back(iSample % 5);
+         binsB.push_back(iSample * 7 % 13);
+         targetsClassification.push_back(iSample % 11 % 3);
+         targetsRegression.push_back(static_cast<double>(iSample % 11));
+         bag.push_back(0 == iSample % 4 ? BagEbm { -1 } : BagEbm { 1 });
+      }
+
+      const bool bClassification = IntEbm { 0 } <= cClasses;
+      IntEbm sum = 0;
+      sum += MeasureDataSetHeader(2, 0, 1);
+      sum += MeasureFeature(5, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binsA[0]);
+      sum += MeasureFeature(13, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binsB[0]);
+      sum += bClassification ? MeasureClassificationTarget(cClasses, k_cSamples, &targetsClassification[0]) :
+         MeasureRegressionTarget(k_cSamples, &targetsRegression[0]);
+      std::vector<char> dataSet(static_cast<size_t>(sum));
+      CHECK(Error_None == FillDataSetHeader(2, 0, 1, sum, &dataSet[0]));
+      CHECK(Error_None == FillFeature(5, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binsA[0], sum, &dataSet[0]));
+      CHECK(Error_None == FillFeature(13, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binsB[0], sum, &dataSet[0]));
+      if(bClassification) {
+         CHECK(Error_None == 
+            FillClassificationTarget(cClasses, k_cSamples, &targetsClassification[0], sum, &dataSet[0]));
+      } else {
+         CHECK(Error_None == FillRegressionTarget(k_cSamples, &targetsRegression[0], sum, &dataSet[0]));
+      }
+
+      const IntEbm dimensionCounts[] { 1, 1, 2 };
+      const IntEbm featureIndexes[] { 0, 1, 0, 1 };
+      const char * const sObjective = bClassification ? "log_loss" : "rmse";
+
+      for(const CreateBoosterFlags flags : { 
+         CreateBoosterFlags_Default, 
+         CreateBoosterFlags_CompactInnerBags, 
+         CreateBoosterFlags_DoublePrecisionSIMD, 
+         CreateBoosterFlags_SortByTarget 
+      }) {
+         for(const IntEbm cInnerBags : { IntEbm { 0 }, IntEbm { 3 } }) {
+            const IntEbm cBytesEstimate = MeasureBooster(&dataSet[0], &bag[0], 3, dimensionCounts, 
+               featureIndexes, cInnerBags, flags, sObjective, nullptr, nullptr, 0, nullptr);
+            CHECK(0 < cBytesEstimate);
+
+            IntEbm cBytesBefore = -1;
+            GetHeapCounters(EBM_TRUE, nullptr, &cBytesBefore, nullptr);
+            BoosterHandle boosterHandle = nullptr;
+            CHECK(Error_None == CreateBooster(nullptr, &dataSet[0], &bag[0], nullptr, 3, dimensionCounts, 
+               featureIndexes, cInnerBags, flags, sObjective, nullptr, nullptr, &boosterHandle));
+            IntEbm cBytesPeak = -1;
+            GetHeapCounters(EBM_FALSE, nullptr, nullptr, &cBytesPeak);
+            FreeBooster(boosterHandle);
+
+            const IntEbm cBytesActual = cBytesPeak - cBytesBefore;
+            CHECK(0 < cBytesActual);
+            const IntEbm cBytesDifference = cBytesEstimate < cBytesActual ? 
+               cBytesActual - cBytesEstimate : cBytesEstimate - cBytesActual;
+            CHECK(cBytesDifference <= cBytesActual / 20 + k_cBytesFixed);
+         }
+      }
+   }
+}
+
+TEST_CASE("prepared dataset, outer bags, matches boosters built directly from the dataset") {
+   static constexpr IntEbm k_cSamples = 200;
+   static constexpr IntEbm k_cClasses = 3;
+
+   std::vector<IntEbm> binsA;
+   std::vector<IntEbm> binsB;
+   std::vector<IntEbm> targets;
+   std::vector<double> initScores;
+   std::vector<BagEbm> bagFirst;
+   std::vector<BagEbm> bagSecond;
+   for(IntEbm iSample = 0; iSample < k_cSamples; ++iSample) {
+      binsA.push_back(iSample % 5);
+      binsB.push_back(iSample % 7 < 6 ? 0 : 2);
+      targets.push_back(iSample % 11 % k_cClasses);
+      for(IntEbm iScore = 0; iScore < k_cClasses; ++iScore) {
+         initScores.push_back(0.01 * static_cast<double>((iSample + iScore) % 9));
+      }
+      bagFirst.push_back(0 == iSample % 4 ? BagEbm { -1 } : BagEbm { 1 });
+      bagSecond.push_back(0 == iSample % 5 ? BagEbm { -2 } : 0 == iSample % 3 ? BagEbm { 0 } : BagEbm { 2 });
+   }
+
+   IntEbm sum = 0;
+   sum += MeasureDataSetHeader(2, 0, 1);
+   sum += MeasureFeature(5, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binsA[0]);
+   sum += MeasureFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binsB[0]);
+   sum += MeasureClassificationTarget(k_cClasses, k_cSamples, &targets[0]);
+   std::vector<char> dataSet(static_cast<size_t>(sum));
+   CHECK(Error_None == FillDataSetHeader(2, 0, 1, sum, &dataSet[0]));
+   CHECK(Error_None == FillFeature(5, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binsA[0], sum, &dataSet[0]));
+   CHECK(Error_None == FillFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binsB[0], sum, &dataSet[0]));
+   CHECK(Error_None == FillClassificationTarget(k_cClasses, k_cSamples, &targets[0], sum, &dataSet[0]));
+
+   const IntEbm dimensionCounts[] { 1, 1, 2 };
+   const IntEbm featureIndexes[] { 0, 1, 0, 1 };
+   static constexpr IntEbm k_cTerms = 3;
+   static constexpr IntEbm k_cInnerBags = 3;
+   const IntEbm leavesMax[] { 3, 3 };
+   const CreateBoosterFlags flags = CreateBoosterFlags_DisableSIMD;
+
+   PreparedDataSetHandle preparedHandle = nullptr;
+   CHECK(Error_None == CreatePreparedDataSet(&dataSet[0], k_cTerms, dimensionCounts, featureIndexes, flags, 
+      "log_loss", &preparedHandle));
+   CHECK(nullptr != preparedHandle);
+
+   // sorting by target would reorder the samples that the prepared dataset holds in their original order
+   BoosterHandle boosterSorted = nullptr;
+   CHECK(Error_IllegalParamVal == CreateBoosterPrepared(nullptr, preparedHandle, &bagFirst[0], nullptr, 
+      k_cInnerBags, flags | CreateBoosterFlags_SortByTarget, nullptr, &boosterSorted));
+   CHECK(nullptr == boosterSorted);
+
+   std::vector<unsigned char> rngDirect(static_cast<size_t>(MeasureRNG()));
+   std::vector<unsigned char> rngPrepared(rngDirect.size());
+   const BagEbm * const apBags[] { &bagFirst[0], &bagSecond[0] };
+   for(const BagEbm * const aBag : apBags) {
+      for(const CreateBoosterFlags flagsBag : { flags, flags | CreateBoosterFlags_CompactInnerBags }) {
+         InitRNG(12345, &rngDirect[0]);
+         InitRNG(12345, &rngPrepared[0]);
+
+         BoosterHandle boosterDirect = nullptr;
+         CHECK(Error_None == CreateBooster(&rngDirect[0], &dataSet[0], aBag, &initScores[0], k_cTerms, 
+            dimensionCounts, featureIndexes, k_cInnerBags, flagsBag, "log_loss", nullptr, nullptr, &boosterDirect));
+         BoosterHandle boosterPrepared = nullptr;
+         CHECK(Error_None == CreateBoosterPrepared(&rngPrepared[0], preparedHandle, aBag, &initScores[0], 
+            k_cInnerBags, flagsBag, nullptr, &boosterPrepared));
+
+         for(IntEbm iRound = 0; iRound < 5; ++iRound) {
+            for(IntEbm iTerm = 0; iTerm < k_cTerms; ++iTerm) {
+               double gainDirect;
+               double gainPrepared;
+               CHECK(Error_None == GenerateTermUpdate(&rngDirect[0], boosterDirect, iTerm, TermBoostFlags_Default, 
+                  0.1, 1, leavesMax, &gainDirect));
+               CHECK(Error_None == GenerateTermUpdate(&rngPrepared[0], boosterPrepared, iTerm, 
+                  TermBoostFlags_Default, 0.1, 1, leavesMax, &gainPrepared));
+               CHECK_APPROX(gainDirect, gainPrepared);
+
+               double metricDirect;
+               double metricPrepared;
+               CHECK(Error_None == ApplyTermUpdate(boosterDirect, &metricDirect));
+               CHECK(Error_None == ApplyTermUpdate(boosterPrepared, &metricPrepared));
+               CHECK_APPROX(metricDirect, metricPrepared);
+            }
+         }
+
+         double scoresDirect[5 * 3 * k_cClasses];
+         double scoresPrepared[5 * 3 * k_cClasses];
+         CHECK(Error_None == GetCurrentTermScores(boosterDirect, 2, scoresDirect));
+         CHECK(Error_None == GetCurrentTermScores(boosterPrepared, 2, scoresPrepared));
+         for(size_t iScore = 0; iScore < sizeof(scoresDirect) / sizeof(scoresDirect[0]); ++iScore) {
+            CHECK_APPROX(scoresDirect[iScore], scoresPrepared[iScore]);
+         }
+
+         FreeBooster(boosterDirect);
+         FreeBooster(boosterPrepared);
+      }
+   }
+
+   // boosters keep the prepared term data alive after the handle is freed
+   BoosterHandle boosterLast = nullptr;
+   CHECK(Error_None == CreateBoosterPrepared(nullptr, preparedHandle, &bagFirst[0], nullptr, k_cInnerBags, flags, 
+      nullptr, &boosterLast));
+   FreePreparedDataSet(preparedHandle);
+   double metric;
+   CHECK(Error_None == GenerateTermUpdate(nullptr, boosterLast, 0, TermBoostFlags_Default, 0.1, 1, leavesMax, 
+      nullptr));
+   CHECK(Error_None == ApplyTermUpdate(boosterLast, &metric));
+   FreeBooster(boosterLast);
+}
+
+TEST_CASE("heap calls, boosting, none after every term has been boosted once") {
+   static constexpr size_t k_cSamples = 503;
+
+   for(const OutputType cClasses : { OutputType_Regression, OutputType { 3 } }) {
+      std::vector<TestSample> samples;
+      samples.reserve(k_cSamples);
+      for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+         const IntEbm iBin0 = static_cast<IntEbm>(iSample * 7 % 9);
+         const IntEbm iBin1 = static_cast<IntEbm>(iSample * 3 % 4);
+         const double target = OutputType_Regression == cClasses ? 
+            static_cast<double>(iSample % 17) * 0.25 + static_cast<double>(iBin0) : 
+            static_cast<double>((iSample * 11 + static_cast<size_t>(iBin1)) % 13 % static_cast<size_t>(cClasses));
+         samples.push_back(TestSample({ iBin0, iBin1 }, target));
+      }
+
+      TestBoost test = TestBoost(cClasses,
+         { FeatureTest(9), FeatureTest(4) },
+         { { 0 }, { 1 }, { 0, 1 } },
+         samples,
+         samples,
+         2
+      );
+
+      IntEbm cHeapCallsWarm = -1;
+      for(int iEpoch = 0; iEpoch < 6; ++iEpoch) {
+         if(2 == iEpoch) {
+            GetHeapCounters(EBM_FALSE, &cHeapCallsWarm, nullptr, nullptr);
+         }
+         for(size_t iTerm = 0; iTerm < test.GetCountTerms(); ++iTerm) {
+            test.Boost(static_cast<IntEbm>(iTerm));
+            test.Boost(static_cast<IntEbm>(iTerm), TermBoostFlags_RandomSplits, k_learningRateDefault, 1, { 3, 3 });
+         }
+      }
+      IntEbm cHeapCalls = -1;
+      GetHeapCounters(EBM_FALSE, &cHeapCalls, nullptr, nullptr);
+#if defined(__linux__) && defined(__x86_64__)
+      // only the Linux x64 build wraps malloc, the others report -1
+      CHECK(0 < cHeapCallsWarm);
+#endif // __linux__ && __x86_64__
+#ifdef NDEBUG
+      // debug builds copy the bins onto the heap to verify the tensor totals, so only release builds reach zero
+      CHECK(cHeapCallsWarm == cHeapCalls);
+#endif // NDEBUG
+   }
+}
+
+TEST_CASE("excluded samples with init scores, boosting, matches the samples left out") {
+   // init scores are only given for the samples with non-zero bag entries, so the samples excluded from the bag 
+   // must not shift the init scores of the samples that follow them. This covers both the RMSE path, which turns 
+   // the init scores directly into gradients, and the path that keeps the sample scores.
+   for(const OutputType cClasses : { OutputType_Regression, OutputType_BinaryClassification }) {
+      std::vector<TestSample> trainExcluded;
+      std::vector<TestSample> trainOnly;
+      for(size_t iSample = 0; iSample < 64; ++iSample) {
+         const IntEbm iBin = static_cast<IntEbm>(iSample % 2);
+         const double target = OutputType_Regression == cClasses ? 1.0 : static_cast<double>(iSample % 3 % 2);
+         const double initScore = static_cast<double>(iSample % 5) * 0.5;
+         const std::vector<double> initScores = OutputType_Regression == cClasses ? 
+            std::vector<double> { initScore } : std::vector<double> { 0.0, initScore };
+         if(0 == iSample % 3) {
+            trainExcluded.push_back(TestSample(0, { iBin }, target, initScores));
+         } else {
+            trainExcluded.push_back(TestSample(1, { iBin }, target, initScores));
+            trainOnly.push_back(TestSample(1, { iBin }, target, initScores));
+         }
+      }
+      const std::vector<TestSample> validation = {
+         TestSample({ 0 }, 1.0, OutputType_Regression == cClasses ? std::vector<double> { 0.25 } : std::vector<double> { 0.0, 0.25 }),
+         TestSample({ 1 }, 0.0, OutputType_Regression == cClasses ? std::vector<double> { 0.75 } : std::vector<double> { 0.0, 0.75 })
+      };
+
+      TestBoost testExcluded = TestBoost(cClasses, { FeatureTest(2) }, { { 0 } }, trainExcluded, validation, 0);
+      TestBoost testOnly = TestBoost(cClasses, { FeatureTest(2) }, { { 0 } }, trainOnly, validation, 0);
+
+      for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+         const double metricExcluded = testExcluded.Boost(0).validationMetric;
+         const double metricOnly = testOnly.Boost(0).validationMetric;
+         CHECK_APPROX(metricExcluded, metricOnly);
+      }
+      for(size_t iBin = 0; iBin < 2; ++iBin) {
+         CHECK_APPROX(testExcluded.GetCurrentTermScore(0, { iBin }, 0), testOnly.GetCurrentTermScore(0, { iBin }, 0));
+      }
+   }
+}
+
+TEST_CASE("sort by target, boosting, float32 SIMD, matches the caller's sample order") {
+   // the same comparison as above but in the default float32 SIMD zone, where the sorted layout uses the contiguous 
+   // target loads. Sorting moves samples in and out of the non-SIMD remainder subsets, which use the exact exp and 
+   // log, so we only expect the two layouts to agree to float32 approximation accuracy
+   static constexpr size_t k_cTrainSamples = 1003;
+   static constexpr size_t k_cValidationSamples = 301;
+
+   for(const OutputType cClasses : { OutputType_BinaryClassification, OutputType { 3 } }) {
+      const size_t cScores = OutputType_BinaryClassification == cClasses ? size_t { 1 } : static_cast<size_t>(cClasses);
+      std::vector<TestSample> train;
+      std::vector<TestSample> validation;
+      for(size_t iSample = 0; iSample < k_cTrainSamples + k_cValidationSamples; ++iSample) {
+         const IntEbm iBin0 = static_cast<IntEbm>(iSample * iSample % 23 % 5);
+         const double target = 
+            static_cast<double>((iSample * 11 + static_cast<size_t>(iBin0)) % 13 % static_cast<size_t>(cClasses));
+         if(iSample < k_cTrainSamples) {
+            const BagEbm replication = 0 == iSample % 11 ? BagEbm { 0 } : 0 == iSample % 5 ? BagEbm { 3 } : BagEbm { 1 };
+            train.push_back(TestSample(replication, { iBin0 }, target));
+         } else {
+            validation.push_back(TestSample({ iBin0 }, target));
+         }
+      }
+
+      TestBoost testOriginal = TestBoost(cClasses, { FeatureTest(5) }, { { 0 } }, train, validation, 2);
+      TestBoost testSorted = TestBoost(cClasses, { FeatureTest(5) }, { { 0 } }, train, validation, 2, 
+         CreateBoosterFlags_SortByTarget);
+
+      for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+         const double metricOriginal = testOriginal.Boost(0).validationMetric;
+         const double metricSorted = testSorted.Boost(0).validationMetric;
+         CHECK_APPROX_TOLERANCE(metricSorted, metricOriginal, 1e-3);
+      }
+      for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            CHECK_APPROX_TOLERANCE(testSorted.GetCurrentTermScore(0, { iBin0 }, iScore), 
+               testOriginal.GetCurrentTermScore(0, { iBin0 }, iScore), 1e-3);
+         }
+      }
+   }
+}
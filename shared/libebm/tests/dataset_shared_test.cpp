@@ -569,3 +569,267 @@ TEST_CASE("dataset_shared, two features, 3 samples, weights, classification") {
 
    CHECK(99 == buffer[static_cast<size_t>(sum)]);
 }
+
+TEST_CASE("dataset_shared, dataset file, maps the written dataset without copying and rejects corruption") {
+   static constexpr IntEbm k_cSamples = 5;
+   IntEbm binIndexes[k_cSamples] { 2, 1, 0, 1, 2 };
+   double targets[k_cSamples] { 0.3, 0.2, 0.1, 0.4, 0.5 };
+
+   IntEbm sum = 0;
+   sum += MeasureDataSetHeader(1, 0, 1);
+   sum += MeasureFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binIndexes[0]);
+   sum += MeasureRegressionTarget(k_cSamples, &targets[0]);
+
+   std::vector<char> buffer(static_cast<size_t>(sum));
+   CHECK(Error_None == FillDataSetHeader(1, 0, 1, sum, &buffer[0]));
+   CHECK(Error_None == FillFeature(3, EBM_TRUE, EBM_TRUE, EBM_FALSE, k_cSamples, &binIndexes[0], sum, &buffer[0]));
+   CHECK(Error_None == FillRegressionTarget(k_cSamples, &targets[0], sum, &buffer[0]));
+
+   const char * const sPath = "libebm_test_dataset_file.bin";
+   CHECK(Error_IllegalParamVal == WriteDataSetFile(sPath, sum - 1, &buffer[0]));
+   CHECK(Error_None == WriteDataSetFile(sPath, sum, &buffer[0]));
+
+   DataSetFileHandle dataSetFileHandle = nullptr;
+   const void * dataSet = nullptr;
+   CHECK(Error_None == CreateDataSetFromFile(sPath, &dataSetFileHandle, &dataSet));
+   CHECK(nullptr != dataSetFileHandle);
+   CHECK(nullptr != dataSet);
+   CHECK(0 == reinterpret_cast<uintptr_t>(dataSet) % 64);
+   CHECK(0 == memcmp(dataSet, &buffer[0], buffer.size()));
+
+   // the mapping is read-only, so creating and boosting from it also verifies that nothing writes to the dataSet
+   const IntEbm dimensionCounts[] { 1 };
+   const IntEbm featureIndexes[] { 0 };
+   BoosterHandle boosterHandle = nullptr;
+   CHECK(Error_None == CreateBooster(nullptr, dataSet, nullptr, nullptr, 1, dimensionCounts, featureIndexes, 0,
+      CreateBoosterFlags_Default, "rmse", nullptr, nullptr, &boosterHandle));
+   const IntEbm leavesMax[] { 3 };
+   CHECK(Error_None == GenerateTermUpdate(nullptr, boosterHandle, 0, TermBoostFlags_Default, 0.1, 1, leavesMax,
+      nullptr));
+   CHECK(Error_None == ApplyTermUpdate(boosterHandle, nullptr));
+   FreeBooster(boosterHandle);
+
+   InteractionHandle interactionHandle = nullptr;
+   CHECK(Error_None == CreateInteractionDetector(dataSet, nullptr, nullptr, CreateInteractionFlags_Default, "rmse",
+      nullptr, nullptr, &interactionHandle));
+   FreeInteractionDetector(interactionHandle);
+
+   FreeDataSetFile(dataSetFileHandle);
+
+   // flip one byte of the dataSet that follows the header
+   FILE * const pFile = fopen(sPath, "r+b");
+   CHECK(nullptr != pFile);
+   if(nullptr != pFile) {
+      CHECK(0 == fseek(pFile, 64 + sum - 1, SEEK_SET));
+      const int val = fgetc(pFile);
+      CHECK(EOF != val);
+      CHECK(0 == fseek(pFile, 64 + sum - 1, SEEK_SET));
+      CHECK(EOF != fputc(val ^ 0x1, pFile));
+      fclose(pFile);
+
+      dataSetFileHandle = nullptr;
+      dataSet = nullptr;
+      CHECK(Error_IllegalParamVal == CreateDataSetFromFile(sPath, &dataSetFileHandle, &dataSet));
+      CHECK(nullptr == dataSetFileHandle);
+      CHECK(nullptr == dataSet);
+   }
+   remove(sPath);
+
+   CHECK(Error_FileIO == CreateDataSetFromFile(sPath, &dataSetFileHandle, &dataSet));
+}
+
+TEST_CASE("dataset_shared, FillFeatures, C and Fortran order match FillFeature in serial and parallel") {
+   static constexpr size_t cSamples = 30000;
+   static constexpr size_t cFeatures = 3;
+   ErrorEbm error;
+
+   const IntEbm binCounts[cFeatures] = { 5, 4, 3 };
+   const FeatureFlags flags[cFeatures] = {
+      FeatureFlags_Missing,
+      FeatureFlags_Nominal,
+      FeatureFlags_Missing | FeatureFlags_Unknown
+   };
+
+   // the middle feature is mostly one bin so that it gets stored sparsely
+   std::vector<IntEbm> binIndexesC(cSamples * cFeatures);
+   std::vector<IntEbm> binIndexesFortran(cSamples * cFeatures);
+   std::vector<double> targets(cSamples);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const IntEbm bins[cFeatures] = { 
+         static_cast<IntEbm>(iSample % 4), 
+         0 == iSample % 500 ? IntEbm { 2 } : IntEbm { 1 }, 
+         static_cast<IntEbm>(iSample % 3) 
+      };
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         binIndexesC[iSample * cFeatures + iFeature] = bins[iFeature];
+         binIndexesFortran[iFeature * cSamples + iSample] = bins[iFeature];
+      }
+      targets[iSample] = static_cast<double>(iSample % 7);
+   }
+
+   IntEbm sum = MeasureDataSetHeader(cFeatures, 0, 1);
+   CHECK(0 <= sum);
+   IntEbm cBytesFeatures = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const IntEbm part = MeasureFeature(
+         binCounts[iFeature],
+         0 != (FeatureFlags_Missing & flags[iFeature]) ? EBM_TRUE : EBM_FALSE,
+         0 != (FeatureFlags_Unknown & flags[iFeature]) ? EBM_TRUE : EBM_FALSE,
+         0 != (FeatureFlags_Nominal & flags[iFeature]) ? EBM_TRUE : EBM_FALSE,
+         cSamples,
+         &binIndexesFortran[iFeature * cSamples]
+      );
+      CHECK(0 <= part);
+      cBytesFeatures += part;
+   }
+   sum += cBytesFeatures;
+   sum += MeasureRegressionTarget(cSamples, &targets[0]);
+
+   CHECK(cBytesFeatures == 
+      MeasureFeatures(cFeatures, binCounts, flags, cSamples, &binIndexesC[0], MatrixOrder_C, nullptr));
+   CHECK(cBytesFeatures == 
+      MeasureFeatures(cFeatures, binCounts, flags, cSamples, &binIndexesFortran[0], MatrixOrder_Fortran, nullptr));
+
+   std::vector<char> bufferSerial(static_cast<size_t>(sum));
+   error = FillDataSetHeader(cFeatures, 0, 1, sum, &bufferSerial[0]);
+   CHECK(Error_None == error);
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      error = FillFeature(
+         binCounts[iFeature],
+         0 != (FeatureFlags_Missing & flags[iFeature]) ? EBM_TRUE : EBM_FALSE,
+         0 != (FeatureFlags_Unknown & flags[iFeature]) ? EBM_TRUE : EBM_FALSE,
+         0 != (FeatureFlags_Nominal & flags[iFeature]) ? EBM_TRUE : EBM_FALSE,
+         cSamples,
+         &binIndexesFortran[iFeature * cSamples],
+         sum,
+         &bufferSerial[0]
+      );
+      CHECK(Error_None == error);
+   }
+   error = FillRegressionTarget(cSamples, &targets[0], sum, &bufferSerial[0]);
+   CHECK(Error_None == error);
+   CHECK(Error_None == CheckDataSet(sum, &bufferSerial[0]));
+
+   ThreadPoolHandle threadPool = nullptr;
+   error = CreateThreadPool(4, AffinityFlags_Default, &threadPool);
+   CHECK(Error_None == error);
+
+   const ThreadPoolHandle threadPools[] = { nullptr, threadPool };
+   for(const ThreadPoolHandle pool : threadPools) {
+      std::vector<char> bufferC(static_cast<size_t>(sum));
+      error = FillDataSetHeader(cFeatures, 0, 1, sum, &bufferC[0]);
+      CHECK(Error_None == error);
+      error = FillFeatures(
+         cFeatures, binCounts, flags, cSamples, &binIndexesC[0], MatrixOrder_C, pool, sum, &bufferC[0]);
+      CHECK(Error_None == error);
+      error = FillRegressionTarget(cSamples, &targets[0], sum, &bufferC[0]);
+      CHECK(Error_None == error);
+      CHECK(bufferSerial == bufferC);
+
+      // the features can also be split across several calls
+      std::vector<char> bufferFortran(static_cast<size_t>(sum));
+      error = FillDataSetHeader(cFeatures, 0, 1, sum, &bufferFortran[0]);
+      CHECK(Error_None == error);
+      error = FillFeatures(
+         1, binCounts, flags, cSamples, &binIndexesFortran[0], MatrixOrder_Fortran, pool, sum, &bufferFortran[0]);
+      CHECK(Error_None == error);
+      error = FillFeatures(cFeatures - 1, 
+         &binCounts[1], 
+         &flags[1], 
+         cSamples, 
+         &binIndexesFortran[cSamples], 
+         MatrixOrder_Fortran, 
+         pool, 
+         sum, 
+         &bufferFortran[0]
+      );
+      CHECK(Error_None == error);
+      error = FillRegressionTarget(cSamples, &targets[0], sum, &bufferFortran[0]);
+      CHECK(Error_None == error);
+      CHECK(bufferSerial == bufferFortran);
+   }
+
+   // an illegal bin index in any column marks the dataset as bad
+   binIndexesC[cFeatures * 5 + 2] = 3;
+   std::vector<char> bufferBad(static_cast<size_t>(sum));
+   error = FillDataSetHeader(cFeatures, 0, 1, sum, &bufferBad[0]);
+   CHECK(Error_None == error);
+   error = FillFeatures(
+      cFeatures, binCounts, flags, cSamples, &binIndexesC[0], MatrixOrder_C, threadPool, sum, &bufferBad[0]);
+   CHECK(Error_IllegalParamVal == error);
+   error = FillRegressionTarget(cSamples, &targets[0], sum, &bufferBad[0]);
+   CHECK(Error_None != error);
+
+   FreeThreadPool(threadPool);
+}
+
+TEST_CASE("dataset_shared, narrow bin indexes, identical to IntEbm bin indexes") {
+   static constexpr size_t cSamples = 1000;
+   ErrorEbm error;
+
+   // the first feature is dense and the second is sparse
+   std::vector<IntEbm> binIndexes0(cSamples);
+   std::vector<IntEbm> binIndexes1(cSamples);
+   std::vector<double> targets(cSamples);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      binIndexes0[iSample] = static_cast<IntEbm>(iSample % 200);
+      binIndexes1[iSample] = 0 == iSample % 200 ? IntEbm { 2 } : IntEbm { 1 };
+      targets[iSample] = static_cast<double>(iSample % 7);
+   }
+   const std::vector<uint8_t> binIndexes0UInt8(binIndexes0.begin(), binIndexes0.end());
+   const std::vector<uint8_t> binIndexes1UInt8(binIndexes1.begin(), binIndexes1.end());
+   const std::vector<uint16_t> binIndexes0UInt16(binIndexes0.begin(), binIndexes0.end());
+   const std::vector<uint16_t> binIndexes1UInt16(binIndexes1.begin(), binIndexes1.end());
+
+   const IntEbm cBytes0 = MeasureFeature(201, EBM_TRUE, EBM_FALSE, EBM_FALSE, cSamples, &binIndexes0[0]);
+   CHECK(0 < cBytes0);
+   CHECK(cBytes0 == MeasureFeatureUInt8(201, EBM_TRUE, EBM_FALSE, EBM_FALSE, cSamples, &binIndexes0UInt8[0]));
+   CHECK(cBytes0 == MeasureFeatureUInt16(201, EBM_TRUE, EBM_FALSE, EBM_FALSE, cSamples, &binIndexes0UInt16[0]));
+   const IntEbm cBytes1 = MeasureFeature(4, EBM_FALSE, EBM_FALSE, EBM_TRUE, cSamples, &binIndexes1[0]);
+   CHECK(0 < cBytes1);
+   CHECK(cBytes1 == MeasureFeatureUInt8(4, EBM_FALSE, EBM_FALSE, EBM_TRUE, cSamples, &binIndexes1UInt8[0]));
+   CHECK(cBytes1 == MeasureFeatureUInt16(4, EBM_FALSE, EBM_FALSE, EBM_TRUE, cSamples, &binIndexes1UInt16[0]));
+
+   const IntEbm sum = MeasureDataSetHeader(2, 0, 1) + cBytes0 + cBytes1 + MeasureRegressionTarget(cSamples, &targets[0]);
+
+   std::vector<char> buffer(static_cast<size_t>(sum));
+   error = FillDataSetHeader(2, 0, 1, sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillFeature(201, EBM_TRUE, EBM_FALSE, EBM_FALSE, cSamples, &binIndexes0[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillFeature(4, EBM_FALSE, EBM_FALSE, EBM_TRUE, cSamples, &binIndexes1[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+   error = FillRegressionTarget(cSamples, &targets[0], sum, &buffer[0]);
+   CHECK(Error_None == error);
+
+   std::vector<char> buffer8(static_cast<size_t>(sum));
+   error = FillDataSetHeader(2, 0, 1, sum, &buffer8[0]);
+   CHECK(Error_None == error);
+   error = FillFeatureUInt8(201, EBM_TRUE, EBM_FALSE, EBM_FALSE, cSamples, &binIndexes0UInt8[0], sum, &buffer8[0]);
+   CHECK(Error_None == error);
+   error = FillFeatureUInt8(4, EBM_FALSE, EBM_FALSE, EBM_TRUE, cSamples, &binIndexes1UInt8[0], sum, &buffer8[0]);
+   CHECK(Error_None == error);
+   error = FillRegressionTarget(cSamples, &targets[0], sum, &buffer8[0]);
+   CHECK(Error_None == error);
+   CHECK(buffer == buffer8);
+
+   std::vector<char> buffer16(static_cast<size_t>(sum));
+   error = FillDataSetHeader(2, 0, 1, sum, &buffer16[0]);
+   CHECK(Error_None == error);
+   error = FillFeatureUInt16(201, EBM_TRUE, EBM_FALSE, EBM_FALSE, cSamples, &binIndexes0UInt16[0], sum, &buffer16[0]);
+   CHECK(Error_None == error);
+   error = FillFeatureUInt16(4, EBM_FALSE, EBM_FALSE, EBM_TRUE, cSamples, &binIndexes1UInt16[0], sum, &buffer16[0]);
+   CHECK(Error_None == error);
+   error = FillRegressionTarget(cSamples, &targets[0], sum, &buffer16[0]);
+   CHECK(Error_None == error);
+   CHECK(buffer == buffer16);
+
+   // bin indexes beyond countBins are rejected just like IntEbm ones
+   std::vector<uint8_t> binIndexesBad(binIndexes0UInt8);
+   binIndexesBad[3] = 250;
+   std::vector<char> bufferBad(static_cast<size_t>(sum));
+   error = FillDataSetHeader(2, 0, 1, sum, &bufferBad[0]);
+   CHECK(Error_None == error);
+   error = FillFeatureUInt8(201, EBM_TRUE, EBM_FALSE, EBM_FALSE, cSamples, &binIndexesBad[0], sum, &bufferBad[0]);
+   CHECK(Error_IllegalParamVal == error);
+}
@@ -24,6 +24,9 @@ extern void TestCHeaderConstructs() {
    InteractionHandle interactionHandle = NULL;
    snprintf(buffer, cBytesBuffer, "%p\n", interactionHandle);
 
+   ThreadPoolHandle threadPoolHandle = NULL;
+   snprintf(buffer, cBytesBuffer, "%p\n", threadPoolHandle);
+
    IntEbm testInt = -123;
    snprintf(buffer, cBytesBuffer, "%" IntEbmPrintf "\n", testInt);
 
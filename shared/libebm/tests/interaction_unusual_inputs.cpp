@@ -525,3 +525,390 @@ TEST_CASE("tweedie, interaction") {
    CHECK_APPROX(metricReturn, 1.25);
 }
 
+
+TEST_CASE("thread pool, interaction, binary, identical to serial") {
+   // enough samples to require multiple data subsets
+   static constexpr size_t k_cSamples = 300000;
+
+   std::vector<TestSample> samples;
+   samples.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample * 7 % 5);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample * 3 % 4);
+      samples.push_back(TestSample({ iBin0, iBin1 }, static_cast<double>(iSample * 11 % 3 % 2)));
+   }
+
+   ThreadPoolHandle threadPool = nullptr;
+   const ErrorEbm error = CreateThreadPool(4, AffinityFlags_Default, &threadPool);
+   CHECK(Error_None == error);
+
+   TestInteraction testSerial = TestInteraction(OutputType_BinaryClassification,
+      { FeatureTest(5), FeatureTest(4) },
+      samples
+   );
+   TestInteraction testThreaded = TestInteraction(OutputType_BinaryClassification,
+      { FeatureTest(5), FeatureTest(4) },
+      samples,
+      k_testCreateInteractionFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      threadPool
+   );
+
+   // the interaction detector holds its own reference to the thread pool
+   FreeThreadPool(threadPool);
+
+   const double strengthSerial = testSerial.TestCalcInteractionStrength({ 0, 1 });
+   const double strengthThreaded = testThreaded.TestCalcInteractionStrength({ 0, 1 });
+   CHECK(strengthSerial == strengthThreaded);
+}
+
+TEST_CASE("thread pool, interaction, float64 zones, identical to serial") {
+   // float64 zones do not need subsets for precision, so this checks that the pool does not change the split
+   static constexpr size_t k_cSamples = 300000;
+
+   std::vector<TestSample> samples;
+   samples.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample * 7 % 5);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample * 3 % 4);
+      samples.push_back(TestSample({ iBin0, iBin1 }, static_cast<double>(iSample * 11 % 3 % 2)));
+   }
+
+   ThreadPoolHandle threadPool = nullptr;
+   const ErrorEbm error = CreateThreadPool(4, AffinityFlags_PinThreads, &threadPool);
+   CHECK(Error_None == error);
+
+   for(const CreateInteractionFlags flags :
+      { CreateInteractionFlags_DisableSIMD, CreateInteractionFlags_DoublePrecisionSIMD }) {
+
+      TestInteraction testSerial = TestInteraction(OutputType_BinaryClassification,
+         { FeatureTest(5), FeatureTest(4) },
+         samples,
+         flags
+      );
+      TestInteraction testThreaded = TestInteraction(OutputType_BinaryClassification,
+         { FeatureTest(5), FeatureTest(4) },
+         samples,
+         flags,
+         nullptr,
+         k_iZeroClassificationLogitDefault,
+         threadPool
+      );
+
+      const double strengthSerial = testSerial.TestCalcInteractionStrength({ 0, 1 });
+      const double strengthThreaded = testThreaded.TestCalcInteractionStrength({ 0, 1 });
+      CHECK(strengthSerial == strengthThreaded);
+   }
+
+   FreeThreadPool(threadPool);
+}
+
+TEST_CASE("CalcInteractionStrengths, batched pairs, identical to individual calls") {
+   static constexpr size_t k_cSamples = 1000;
+
+   std::vector<TestSample> samples;
+   samples.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample * 7 % 5);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample * 3 % 4);
+      const IntEbm iBin2 = static_cast<IntEbm>(iSample * 13 % 6);
+      const IntEbm iBin3 = static_cast<IntEbm>(iSample * 5 % 3);
+      samples.push_back(TestSample({ iBin0, iBin1, iBin2, iBin3 }, static_cast<double>(iSample * 11 % 3 % 2)));
+   }
+
+   ThreadPoolHandle threadPool = nullptr;
+   const ErrorEbm errorPool = CreateThreadPool(4, AffinityFlags_Default, &threadPool);
+   CHECK(Error_None == errorPool);
+
+   TestInteraction testSerial = TestInteraction(OutputType_BinaryClassification,
+      { FeatureTest(5), FeatureTest(4), FeatureTest(6), FeatureTest(3) },
+      samples
+   );
+   TestInteraction testThreaded = TestInteraction(OutputType_BinaryClassification,
+      { FeatureTest(5), FeatureTest(4), FeatureTest(6), FeatureTest(3) },
+      samples,
+      k_testCreateInteractionFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      threadPool
+   );
+   FreeThreadPool(threadPool);
+
+   // all pairs plus an empty term
+   std::vector<IntEbm> dimensionCounts;
+   std::vector<IntEbm> featureIndexes;
+   for(IntEbm iFeature0 = 0; iFeature0 < 4; ++iFeature0) {
+      for(IntEbm iFeature1 = iFeature0 + 1; iFeature1 < 4; ++iFeature1) {
+         dimensionCounts.push_back(2);
+         featureIndexes.push_back(iFeature0);
+         featureIndexes.push_back(iFeature1);
+      }
+   }
+   dimensionCounts.push_back(0);
+
+   std::vector<double> strengthsSerial(dimensionCounts.size());
+   ErrorEbm error = CalcInteractionStrengths(testSerial.GetInteractionHandle(),
+      static_cast<IntEbm>(dimensionCounts.size()),
+      &dimensionCounts[0],
+      &featureIndexes[0],
+      CalcInteractionFlags_Default,
+      0,
+      k_minSamplesLeafDefault,
+      &strengthsSerial[0]
+   );
+   CHECK(Error_None == error);
+
+   std::vector<double> strengthsThreaded(dimensionCounts.size());
+   error = CalcInteractionStrengths(testThreaded.GetInteractionHandle(),
+      static_cast<IntEbm>(dimensionCounts.size()),
+      &dimensionCounts[0],
+      &featureIndexes[0],
+      CalcInteractionFlags_Default,
+      0,
+      k_minSamplesLeafDefault,
+      &strengthsThreaded[0]
+   );
+   CHECK(Error_None == error);
+
+   size_t iFeatureIndex = 0;
+   for(size_t iTuple = 0; iTuple < dimensionCounts.size(); ++iTuple) {
+      const size_t cDimensions = static_cast<size_t>(dimensionCounts[iTuple]);
+      const std::vector<IntEbm> features(
+         featureIndexes.begin() + iFeatureIndex, featureIndexes.begin() + iFeatureIndex + cDimensions);
+      iFeatureIndex += cDimensions;
+
+      const double strength = testSerial.TestCalcInteractionStrength(features);
+      CHECK(strength == strengthsSerial[iTuple]);
+      CHECK(strength == strengthsThreaded[iTuple]);
+   }
+   CHECK(0.0 == strengthsSerial[dimensionCounts.size() - 1]);
+}
+
+TEST_CASE("CalcInteractionStrengths, pairs binned in one pass, weighted multiclass, identical to individual calls") {
+   static constexpr size_t k_cSamples = 777;
+   static constexpr IntEbm k_cFeatures = 7;
+
+   std::vector<TestSample> samples;
+   samples.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      std::vector<IntEbm> binIndexes;
+      for(IntEbm iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+         binIndexes.push_back(static_cast<IntEbm>(
+            (iSample * static_cast<size_t>(2 * iFeature + 3) + iSample / 11) % static_cast<size_t>(iFeature + 2)));
+      }
+      samples.push_back(TestSample(binIndexes, static_cast<double>(iSample * 7 % 3), 0.25 + static_cast<double>(iSample % 5)));
+   }
+   std::vector<FeatureTest> features;
+   for(IntEbm iFeature = 0; iFeature < k_cFeatures; ++iFeature) {
+      features.push_back(FeatureTest(iFeature + 2));
+   }
+
+   // every ordered pair, so features repeat within each pass and more pairs exist than fit in one pass, with a
+   // triple and an empty term in the middle to break up the runs of pairs
+   std::vector<IntEbm> dimensionCounts;
+   std::vector<IntEbm> featureIndexes;
+   for(IntEbm iFeature0 = 0; iFeature0 < k_cFeatures; ++iFeature0) {
+      for(IntEbm iFeature1 = 0; iFeature1 < k_cFeatures; ++iFeature1) {
+         if(iFeature0 != iFeature1) {
+            dimensionCounts.push_back(2);
+            featureIndexes.push_back(iFeature0);
+            featureIndexes.push_back(iFeature1);
+         }
+      }
+      if(IntEbm { 3 } == iFeature0) {
+         dimensionCounts.push_back(3);
+         featureIndexes.push_back(0);
+         featureIndexes.push_back(1);
+         featureIndexes.push_back(2);
+         dimensionCounts.push_back(0);
+      }
+   }
+
+   for(const CreateInteractionFlags flags : { CreateInteractionFlags_Default, CreateInteractionFlags_DoublePrecisionSIMD }) {
+      TestInteraction test = TestInteraction(3, features, samples, flags);
+
+      std::vector<double> strengths(dimensionCounts.size());
+      const ErrorEbm error = CalcInteractionStrengths(test.GetInteractionHandle(),
+         static_cast<IntEbm>(dimensionCounts.size()),
+         &dimensionCounts[0],
+         &featureIndexes[0],
+         CalcInteractionFlags_Default,
+         0,
+         k_minSamplesLeafDefault,
+         &strengths[0]
+      );
+      CHECK(Error_None == error);
+
+      size_t iFeatureIndex = 0;
+      for(size_t iTuple = 0; iTuple < dimensionCounts.size(); ++iTuple) {
+         const size_t cDimensions = static_cast<size_t>(dimensionCounts[iTuple]);
+         const std::vector<IntEbm> tuple(
+            featureIndexes.begin() + iFeatureIndex, featureIndexes.begin() + iFeatureIndex + cDimensions);
+         iFeatureIndex += cDimensions;
+
+         const double strength = test.TestCalcInteractionStrength(tuple);
+         CHECK(strength == strengths[iTuple]);
+      }
+   }
+}
+
+TEST_CASE("RankInteractions, top pairs with exclusions, identical to sorted individual calls") {
+   static constexpr size_t k_cSamples = 1000;
+
+   std::vector<TestSample> samples;
+   samples.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample * 7 % 5);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample * 3 % 4);
+      const IntEbm iBin2 = static_cast<IntEbm>(iSample * 13 % 6);
+      const IntEbm iBin3 = static_cast<IntEbm>(iSample * 5 % 3);
+      const IntEbm iBin4 = static_cast<IntEbm>(iSample / 7 % 4);
+      samples.push_back(TestSample({ iBin0, iBin1, iBin2, iBin3, iBin4 }, static_cast<double>(iSample * 11 % 3 % 2)));
+   }
+
+   ThreadPoolHandle threadPool = nullptr;
+   const ErrorEbm errorPool = CreateThreadPool(4, AffinityFlags_Default, &threadPool);
+   CHECK(Error_None == errorPool);
+
+   TestInteraction testSerial = TestInteraction(OutputType_BinaryClassification,
+      { FeatureTest(5), FeatureTest(4), FeatureTest(6), FeatureTest(3), FeatureTest(4) },
+      samples
+   );
+   TestInteraction testThreaded = TestInteraction(OutputType_BinaryClassification,
+      { FeatureTest(5), FeatureTest(4), FeatureTest(6), FeatureTest(3), FeatureTest(4) },
+      samples,
+      k_testCreateInteractionFlags_Default,
+      nullptr,
+      k_iZeroClassificationLogitDefault,
+      threadPool
+   );
+   FreeThreadPool(threadPool);
+
+   // the exclusions are given in both orders
+   const std::vector<IntEbm> excludedPairs = { 0, 1, 4, 2 };
+
+   std::vector<std::pair<double, std::pair<IntEbm, IntEbm>>> expected;
+   for(IntEbm iFeature0 = 0; iFeature0 < 5; ++iFeature0) {
+      for(IntEbm iFeature1 = iFeature0 + 1; iFeature1 < 5; ++iFeature1) {
+         if((0 == iFeature0 && 1 == iFeature1) || (2 == iFeature0 && 4 == iFeature1)) {
+            continue;
+         }
+         const double strength = testSerial.TestCalcInteractionStrength({ iFeature0, iFeature1 });
+         expected.push_back(std::make_pair(strength, std::make_pair(iFeature0, iFeature1)));
+      }
+   }
+   std::sort(expected.begin(), expected.end());
+   std::reverse(expected.begin(), expected.end());
+
+   for(const IntEbm countPairsMax : { IntEbm { 3 }, IntEbm { 100 } }) {
+      for(TestInteraction * const pTest : { &testSerial, &testThreaded }) {
+         IntEbm countPairs = -1;
+         std::vector<IntEbm> featureIndexes(static_cast<size_t>(countPairsMax) * 2);
+         std::vector<double> strengths(static_cast<size_t>(countPairsMax));
+         const ErrorEbm error = RankInteractions(pTest->GetInteractionHandle(),
+            static_cast<IntEbm>(excludedPairs.size() / 2),
+            &excludedPairs[0],
+            CalcInteractionFlags_Default,
+            0,
+            k_minSamplesLeafDefault,
+            countPairsMax,
+            &countPairs,
+            &featureIndexes[0],
+            &strengths[0]
+         );
+         CHECK(Error_None == error);
+
+         const size_t cPairs = std::min(static_cast<size_t>(countPairsMax), expected.size());
+         CHECK(static_cast<IntEbm>(cPairs) == countPairs);
+         for(size_t iPair = 0; iPair < cPairs; ++iPair) {
+            CHECK(expected[iPair].first == strengths[iPair]);
+            CHECK(expected[iPair].second.first == featureIndexes[iPair * 2]);
+            CHECK(expected[iPair].second.second == featureIndexes[iPair * 2 + 1]);
+         }
+      }
+   }
+}
+
+TEST_CASE("double precision SIMD, interaction, binary, matches the cpu zone") {
+   static constexpr size_t k_cSamples = 1003;
+
+   std::vector<TestSample> samples;
+   samples.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample * 7 % 5);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample * 3 % 4);
+      samples.push_back(TestSample({ iBin0, iBin1 }, static_cast<double>((iSample * 11 + iSample / 7) % 3 % 2)));
+   }
+
+   // on AVX-512 processors this runs the AVX512F_64 zone and then forces the AVX2_64 zone
+   for(const SIMDFlags simdFlags : { SIMDFlags_Default, SIMDFlags_DisableAVX512F }) {
+      SetSIMDFlags(simdFlags);
+
+      TestInteraction testCpu = TestInteraction(OutputType_BinaryClassification,
+         { FeatureTest(5), FeatureTest(4) },
+         samples,
+         CreateInteractionFlags_DisableSIMD
+      );
+      TestInteraction testDouble = TestInteraction(OutputType_BinaryClassification,
+         { FeatureTest(5), FeatureTest(4) },
+         samples,
+         CreateInteractionFlags_DoublePrecisionSIMD
+      );
+
+      const double strengthCpu = testCpu.TestCalcInteractionStrength({ 0, 1 });
+      const double strengthDouble = testDouble.TestCalcInteractionStrength({ 0, 1 });
+      CHECK(0.0 < strengthCpu);
+      CHECK_APPROX_TOLERANCE(strengthCpu, strengthDouble, 1e-9);
+   }
+   SetSIMDFlags(SIMDFlags_Default);
+}
+
+TEST_CASE("heap calls, CalcInteractionStrengths, none on repeated calls") {
+   static constexpr size_t k_cSamples = 300;
+
+   std::vector<TestSample> samples;
+   samples.reserve(k_cSamples);
+   for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+      const IntEbm iBin0 = static_cast<IntEbm>(iSample * 7 % 5);
+      const IntEbm iBin1 = static_cast<IntEbm>(iSample * 3 % 4);
+      const IntEbm iBin2 = static_cast<IntEbm>(iSample * 13 % 6);
+      samples.push_back(TestSample({ iBin0, iBin1, iBin2 }, static_cast<double>(iSample * 11 % 3 % 2)));
+   }
+
+   TestInteraction test = TestInteraction(OutputType_BinaryClassification,
+      { FeatureTest(5), FeatureTest(4), FeatureTest(6) },
+      samples
+   );
+
+   const std::vector<IntEbm> dimensionCounts = { 2, 2, 2 };
+   const std::vector<IntEbm> featureIndexes = { 0, 1, 0, 2, 1, 2 };
+   std::vector<double> strengths(dimensionCounts.size());
+
+   IntEbm cHeapCallsWarm = -1;
+   for(int iCall = 0; iCall < 4; ++iCall) {
+      if(1 == iCall) {
+         GetHeapCounters(EBM_FALSE, &cHeapCallsWarm, nullptr, nullptr);
+      }
+      const ErrorEbm error = CalcInteractionStrengths(test.GetInteractionHandle(),
+         static_cast<IntEbm>(dimensionCounts.size()),
+         &dimensionCounts[0],
+         &featureIndexes[0],
+         CalcInteractionFlags_Default,
+         0,
+         k_minSamplesLeafDefault,
+         &strengths[0]
+      );
+      CHECK(Error_None == error);
+   }
+   IntEbm cHeapCalls = -1;
+   GetHeapCounters(EBM_FALSE, &cHeapCalls, nullptr, nullptr);
+#if defined(__linux__) && defined(__x86_64__)
+   // only the Linux x64 build wraps malloc, the others report -1
+   CHECK(0 < cHeapCallsWarm);
+#endif // __linux__ && __x86_64__
+#ifdef NDEBUG
+   // debug builds copy the bins onto the heap to verify the tensor totals, so only release builds reach zero
+   CHECK(cHeapCallsWarm == cHeapCalls);
+#endif // NDEBUG
+}
@@ -229,7 +229,8 @@ TestBoost::TestBoost(
    const IntEbm countInnerBags,
    const CreateBoosterFlags flags,
    const char * const sObjective,
-   const ptrdiff_t iZeroClassificationLogit
+   const ptrdiff_t iZeroClassificationLogit,
+   const ThreadPoolHandle threadPool
 ) :
    m_cClasses(cClasses),
    m_features(features),
@@ -433,6 +434,10 @@ TestBoost::TestBoost(
    if(bInitScores) {
       if(IsClassification(cClasses)) {
          for(const TestSample & sample : train) {
+            if(sample.m_bBag && BagEbm { 0 } == sample.m_bagCount) {
+               // init scores are only given for samples with non-zero bag entries
+               continue;
+            }
             if(sample.m_bScores) {
                if(static_cast<size_t>(cClasses) != sample.m_initScores.size()) {
                   throw TestException(error, "cClasses mismatch with sample.m_initScores");
@@ -473,6 +478,10 @@ TestBoost::TestBoost(
             }
          }
          for(const TestSample & sample : validation) {
+            if(sample.m_bBag && BagEbm { 0 } == sample.m_bagCount) {
+               // init scores are only given for samples with non-zero bag entries
+               continue;
+            }
             if(sample.m_bScores) {
                if(static_cast<size_t>(cClasses) != sample.m_initScores.size()) {
                   throw TestException(error, "cClasses mismatch with sample.m_initScores");
@@ -514,10 +523,18 @@ TestBoost::TestBoost(
          }
       } else {
          for(const TestSample & sample : train) {
+            if(sample.m_bBag && BagEbm { 0 } == sample.m_bagCount) {
+               // init scores are only given for samples with non-zero bag entries
+               continue;
+            }
             const double score = sample.m_initScores[0];
             initScores.push_back(score);
          }
          for(const TestSample & sample : validation) {
+            if(sample.m_bBag && BagEbm { 0 } == sample.m_bagCount) {
+               // init scores are only given for samples with non-zero bag entries
+               continue;
+            }
             const double score = sample.m_initScores[0];
             initScores.push_back(score);
          }
@@ -545,6 +562,7 @@ TestBoost::TestBoost(
       flags,
       nullptr == sObjective ? (IsClassification(cClasses) ? "log_loss" : "rmse") : sObjective,
       nullptr,
+      threadPool,
       &m_boosterHandle
    );
    if(Error_None != error) {
@@ -618,6 +636,41 @@ BoostRet TestBoost::Boost(
    return BoostRet { gainAvg, validationMetricAvg };
 }
 
+IntEbm TestBoost::BoostRounds(
+   const IntEbm countRounds,
+   const double greediness,
+   const IntEbm countSmoothingRounds,
+   const IntEbm countEarlyStoppingRounds,
+   const double earlyStoppingTolerance,
+   std::vector<double> * const pMetrics
+) {
+   std::vector<double> metrics(static_cast<size_t>(countRounds) + 1);
+   IntEbm countRoundsRet = -1;
+   const ErrorEbm error = ::BoostRounds(
+      &m_rng[0],
+      m_boosterHandle,
+      countRounds,
+      TermBoostFlags_Default,
+      k_learningRateDefault,
+      k_minSamplesLeafDefault,
+      &k_leavesMaxDefault[0],
+      greediness,
+      countSmoothingRounds,
+      countEarlyStoppingRounds,
+      earlyStoppingTolerance,
+      &countRoundsRet,
+      &metrics[0]
+   );
+   if(Error_None != error) {
+      throw TestException(error, "BoostRounds");
+   }
+   if(nullptr != pMetrics) {
+      metrics.resize(static_cast<size_t>(countRoundsRet));
+      *pMetrics = metrics;
+   }
+   return countRoundsRet;
+}
+
 
 double TestBoost::GetBestTermScore(
    const size_t iTerm,
@@ -684,7 +737,8 @@ TestInteraction::TestInteraction(
    const std::vector<TestSample> samples,
    const CreateInteractionFlags flags,
    const char * const sObjective,
-   const ptrdiff_t iZeroClassificationLogit
+   const ptrdiff_t iZeroClassificationLogit,
+   const ThreadPoolHandle threadPool
 ) :
    m_interactionHandle(nullptr) 
 {
@@ -846,6 +900,10 @@ TestInteraction::TestInteraction(
    if(bInitScores) {
       if(IsClassification(cClasses)) {
          for(const TestSample & sample : samples) {
+            if(sample.m_bBag && BagEbm { 0 } == sample.m_bagCount) {
+               // init scores are only given for samples with non-zero bag entries
+               continue;
+            }
             if(sample.m_bScores) {
                if(static_cast<size_t>(cClasses) != sample.m_initScores.size()) {
                   throw TestException(error, "cClasses mismatch with sample.m_initScores");
@@ -887,6 +945,10 @@ TestInteraction::TestInteraction(
          }
       } else {
          for(const TestSample & sample : samples) {
+            if(sample.m_bBag && BagEbm { 0 } == sample.m_bagCount) {
+               // init scores are only given for samples with non-zero bag entries
+               continue;
+            }
             const double score = sample.m_initScores[0];
             initScores.push_back(score);
          }
@@ -900,6 +962,7 @@ TestInteraction::TestInteraction(
       flags,
       nullptr == sObjective ? (IsClassification(cClasses) ? "log_loss" : "rmse") : sObjective,
       nullptr,
+      threadPool,
       &m_interactionHandle
    );
 
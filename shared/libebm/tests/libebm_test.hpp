@@ -28,7 +28,8 @@ enum class TestPriority {
    CutUniform,
    CutWinsorized,
    CutQuantile,
-   Discretize
+   Discretize,
+   BinSumsBenchmark
 };
 
 class TestException final : public std::exception {
@@ -441,7 +442,8 @@ public:
       const IntEbm countInnerBags = k_countInnerBagsDefault,
       const CreateBoosterFlags flags = k_testCreateBoosterFlags_Default,
       const char * const sObjective = nullptr,
-      const ptrdiff_t iZeroClassificationLogit = k_iZeroClassificationLogitDefault
+      const ptrdiff_t iZeroClassificationLogit = k_iZeroClassificationLogitDefault,
+      const ThreadPoolHandle threadPool = nullptr
    );
    ~TestBoost();
 
@@ -461,6 +463,15 @@ public:
       const std::vector<IntEbm> leavesMax = k_leavesMaxDefault
    );
 
+   IntEbm BoostRounds(
+      const IntEbm countRounds,
+      const double greediness = 0.0,
+      const IntEbm countSmoothingRounds = 0,
+      const IntEbm countEarlyStoppingRounds = 0,
+      const double earlyStoppingTolerance = 0.0,
+      std::vector<double> * const pMetrics = nullptr
+   );
+
    double GetBestTermScore(
       const size_t iTerm,
       const std::vector<size_t> indexes,
@@ -490,7 +501,8 @@ public:
       const std::vector<TestSample> samples,
       const CreateInteractionFlags flags = k_testCreateInteractionFlags_Default,
       const char * const sObjective = nullptr,
-      const ptrdiff_t iZeroClassificationLogit = k_iZeroClassificationLogitDefault
+      const ptrdiff_t iZeroClassificationLogit = k_iZeroClassificationLogitDefault,
+      const ThreadPoolHandle threadPool = nullptr
    );
    ~TestInteraction();
 